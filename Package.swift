@@ -19,12 +19,17 @@ let package = Package(
             ],
             sources: [
                 "src/natural_time.c",
-                "vendor/astronomy_c/astronomy.c"
+                "src/natural_time_series.c",
+                "src/natural_time_snapshot.c",
+                "src/natural_time_shm.c",
+                "src/natural_time_capture.c",
+                "vendor/astronomy_c/astronomy_core.c"  // Sun/Moon-only ephemeris (natural_time_core)
             ],
             publicHeadersPath: "include",
             cSettings: [
                 .headerSearchPath("vendor/astronomy_c"),
-                .define("NTC_VERSION", to: "swift")
+                .define("NTC_VERSION", to: "swift"),
+                .define("NT_EPHEMERIS_CORE")
             ]
         ),
         // Swift-friendly wrapper over the C API (kept in packages/ios folder)
@@ -0,0 +1,128 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CTest.cmake"
+  "/usr/share/cmake-3.25/Modules/CTestTargets.cmake"
+  "/usr/share/cmake-3.25/Modules/CTestUseLaunchers.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLanguage.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/DartConfiguration.tcl.in"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "DartConfiguration.tcl"
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/natural_time.dir/DependInfo.cmake"
+  "CMakeFiles/natural_time_core.dir/DependInfo.cmake"
+  "CMakeFiles/ntc.dir/DependInfo.cmake"
+  "CMakeFiles/ntd_client.dir/DependInfo.cmake"
+  "CMakeFiles/ntd.dir/DependInfo.cmake"
+  "CMakeFiles/ntreplay.dir/DependInfo.cmake"
+  "CMakeFiles/Experimental.dir/DependInfo.cmake"
+  "CMakeFiles/Nightly.dir/DependInfo.cmake"
+  "CMakeFiles/Continuous.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyMemoryCheck.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyStart.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyUpdate.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyConfigure.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyBuild.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyTest.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyCoverage.dir/DependInfo.cmake"
+  "CMakeFiles/NightlyMemCheck.dir/DependInfo.cmake"
+  "CMakeFiles/NightlySubmit.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalStart.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalUpdate.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalConfigure.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalBuild.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalTest.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalCoverage.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalMemCheck.dir/DependInfo.cmake"
+  "CMakeFiles/ExperimentalSubmit.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousStart.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousUpdate.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousConfigure.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousBuild.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousTest.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousCoverage.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousMemCheck.dir/DependInfo.cmake"
+  "CMakeFiles/ContinuousSubmit.dir/DependInfo.cmake"
+  "CMakeFiles/test_smoke.dir/DependInfo.cmake"
+  "CMakeFiles/test_moon_quarters.dir/DependInfo.cmake"
+  "CMakeFiles/test_fixed_point.dir/DependInfo.cmake"
+  "CMakeFiles/test_scheduler.dir/DependInfo.cmake"
+  "CMakeFiles/test_pack.dir/DependInfo.cmake"
+  "CMakeFiles/test_buckets.dir/DependInfo.cmake"
+  "CMakeFiles/test_track.dir/DependInfo.cmake"
+  "CMakeFiles/test_polar.dir/DependInfo.cmake"
+  "CMakeFiles/test_series.dir/DependInfo.cmake"
+  "CMakeFiles/test_series_small_queue.dir/DependInfo.cmake"
+  "CMakeFiles/test_budget.dir/DependInfo.cmake"
+  "CMakeFiles/test_snapshot.dir/DependInfo.cmake"
+  "CMakeFiles/test_shm.dir/DependInfo.cmake"
+  "CMakeFiles/test_capture.dir/DependInfo.cmake"
+  "CMakeFiles/test_async.dir/DependInfo.cmake"
+  "CMakeFiles/test_threads.dir/DependInfo.cmake"
+  "CMakeFiles/test_ntd_load.dir/DependInfo.cmake"
+  "CMakeFiles/test_smoke_core.dir/DependInfo.cmake"
+  "CMakeFiles/test_moon_quarters_core.dir/DependInfo.cmake"
+  "CMakeFiles/test_polar_core.dir/DependInfo.cmake"
+  "CMakeFiles/test_track_core.dir/DependInfo.cmake"
+  "CMakeFiles/test_series_core.dir/DependInfo.cmake"
+  "CMakeFiles/test_scheduler_core.dir/DependInfo.cmake"
+  "CMakeFiles/test_pack_core.dir/DependInfo.cmake"
+  "CMakeFiles/test_buckets_core.dir/DependInfo.cmake"
+  "CMakeFiles/test_budget_core.dir/DependInfo.cmake"
+  "CMakeFiles/test_snapshot_core.dir/DependInfo.cmake"
+  "CMakeFiles/test_parity_vectors.dir/DependInfo.cmake"
+  "CMakeFiles/test_parity_vectors_core.dir/DependInfo.cmake"
+  "CMakeFiles/ntaccuracy.dir/DependInfo.cmake"
+  "CMakeFiles/ntaccuracy_core.dir/DependInfo.cmake"
+  "CMakeFiles/bench_footprint_natural_time.dir/DependInfo.cmake"
+  "CMakeFiles/bench_footprint_natural_time_core.dir/DependInfo.cmake"
+  "CMakeFiles/bench_fixed_split.dir/DependInfo.cmake"
+  "CMakeFiles/test_cpp_layer.dir/DependInfo.cmake"
+  )
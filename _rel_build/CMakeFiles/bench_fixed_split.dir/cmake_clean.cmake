@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_fixed_split.dir/tests/tools/bench_fixed_split.c.o"
+  "CMakeFiles/bench_fixed_split.dir/tests/tools/bench_fixed_split.c.o.d"
+  "bench_fixed_split"
+  "bench_fixed_split.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/bench_fixed_split.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_footprint_natural_time.dir/tests/tools/bench_footprint.c.o"
+  "CMakeFiles/bench_footprint_natural_time.dir/tests/tools/bench_footprint.c.o.d"
+  "bench_footprint_natural_time"
+  "bench_footprint_natural_time.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/bench_footprint_natural_time.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
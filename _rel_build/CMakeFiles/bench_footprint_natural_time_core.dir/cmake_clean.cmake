@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_footprint_natural_time_core.dir/tests/tools/bench_footprint.c.o"
+  "CMakeFiles/bench_footprint_natural_time_core.dir/tests/tools/bench_footprint.c.o.d"
+  "bench_footprint_natural_time_core"
+  "bench_footprint_natural_time_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/bench_footprint_natural_time_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
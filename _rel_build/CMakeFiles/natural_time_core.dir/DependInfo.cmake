@@ -0,0 +1,30 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/natural_time.c" "CMakeFiles/natural_time_core.dir/src/natural_time.c.o" "gcc" "CMakeFiles/natural_time_core.dir/src/natural_time.c.o.d"
+  "/root/repo/src/natural_time_async.c" "CMakeFiles/natural_time_core.dir/src/natural_time_async.c.o" "gcc" "CMakeFiles/natural_time_core.dir/src/natural_time_async.c.o.d"
+  "/root/repo/src/natural_time_buckets.c" "CMakeFiles/natural_time_core.dir/src/natural_time_buckets.c.o" "gcc" "CMakeFiles/natural_time_core.dir/src/natural_time_buckets.c.o.d"
+  "/root/repo/src/natural_time_budget.c" "CMakeFiles/natural_time_core.dir/src/natural_time_budget.c.o" "gcc" "CMakeFiles/natural_time_core.dir/src/natural_time_budget.c.o.d"
+  "/root/repo/src/natural_time_capture.c" "CMakeFiles/natural_time_core.dir/src/natural_time_capture.c.o" "gcc" "CMakeFiles/natural_time_core.dir/src/natural_time_capture.c.o.d"
+  "/root/repo/src/natural_time_pack.c" "CMakeFiles/natural_time_core.dir/src/natural_time_pack.c.o" "gcc" "CMakeFiles/natural_time_core.dir/src/natural_time_pack.c.o.d"
+  "/root/repo/src/natural_time_scheduler.c" "CMakeFiles/natural_time_core.dir/src/natural_time_scheduler.c.o" "gcc" "CMakeFiles/natural_time_core.dir/src/natural_time_scheduler.c.o.d"
+  "/root/repo/src/natural_time_series.c" "CMakeFiles/natural_time_core.dir/src/natural_time_series.c.o" "gcc" "CMakeFiles/natural_time_core.dir/src/natural_time_series.c.o.d"
+  "/root/repo/src/natural_time_shm.c" "CMakeFiles/natural_time_core.dir/src/natural_time_shm.c.o" "gcc" "CMakeFiles/natural_time_core.dir/src/natural_time_shm.c.o.d"
+  "/root/repo/src/natural_time_snapshot.c" "CMakeFiles/natural_time_core.dir/src/natural_time_snapshot.c.o" "gcc" "CMakeFiles/natural_time_core.dir/src/natural_time_snapshot.c.o.d"
+  "/root/repo/src/natural_time_track.c" "CMakeFiles/natural_time_core.dir/src/natural_time_track.c.o" "gcc" "CMakeFiles/natural_time_core.dir/src/natural_time_track.c.o.d"
+  "/root/repo/vendor/astronomy_c/astronomy_core.c" "CMakeFiles/natural_time_core.dir/vendor/astronomy_c/astronomy_core.c.o" "gcc" "CMakeFiles/natural_time_core.dir/vendor/astronomy_c/astronomy_core.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
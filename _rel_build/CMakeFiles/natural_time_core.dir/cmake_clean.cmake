@@ -0,0 +1,33 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/natural_time_core.dir/src/natural_time.c.o"
+  "CMakeFiles/natural_time_core.dir/src/natural_time.c.o.d"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_async.c.o"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_async.c.o.d"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_buckets.c.o"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_buckets.c.o.d"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_budget.c.o"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_budget.c.o.d"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_capture.c.o"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_capture.c.o.d"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_pack.c.o"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_pack.c.o.d"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_scheduler.c.o"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_scheduler.c.o.d"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_series.c.o"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_series.c.o.d"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_shm.c.o"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_shm.c.o.d"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_snapshot.c.o"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_snapshot.c.o.d"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_track.c.o"
+  "CMakeFiles/natural_time_core.dir/src/natural_time_track.c.o.d"
+  "CMakeFiles/natural_time_core.dir/vendor/astronomy_c/astronomy_core.c.o"
+  "CMakeFiles/natural_time_core.dir/vendor/astronomy_c/astronomy_core.c.o.d"
+  "libnatural_time_core.a"
+  "libnatural_time_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/natural_time_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libnatural_time_core.a"
+)
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ntaccuracy.dir/tests/tools/ntaccuracy.c.o"
+  "CMakeFiles/ntaccuracy.dir/tests/tools/ntaccuracy.c.o.d"
+  "ntaccuracy"
+  "ntaccuracy.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/ntaccuracy.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
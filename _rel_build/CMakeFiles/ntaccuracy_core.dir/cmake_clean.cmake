@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ntaccuracy_core.dir/tests/tools/ntaccuracy.c.o"
+  "CMakeFiles/ntaccuracy_core.dir/tests/tools/ntaccuracy.c.o.d"
+  "ntaccuracy_core"
+  "ntaccuracy_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/ntaccuracy_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
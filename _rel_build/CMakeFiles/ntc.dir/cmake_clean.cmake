@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ntc.dir/tools/ntc/ntc.c.o"
+  "CMakeFiles/ntc.dir/tools/ntc/ntc.c.o.d"
+  "ntc"
+  "ntc.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/ntc.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ntd.dir/tools/ntd/ntd.c.o"
+  "CMakeFiles/ntd.dir/tools/ntd/ntd.c.o.d"
+  "ntd"
+  "ntd.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/ntd.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ntd_client.dir/tools/ntd/ntd_client.c.o"
+  "CMakeFiles/ntd_client.dir/tools/ntd/ntd_client.c.o.d"
+  "libntd_client.a"
+  "libntd_client.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/ntd_client.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
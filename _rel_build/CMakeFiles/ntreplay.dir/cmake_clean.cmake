@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ntreplay.dir/tools/ntreplay/ntreplay.c.o"
+  "CMakeFiles/ntreplay.dir/tools/ntreplay/ntreplay.c.o.d"
+  "ntreplay"
+  "ntreplay.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/ntreplay.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
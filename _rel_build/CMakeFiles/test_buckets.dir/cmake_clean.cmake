@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_buckets.dir/tests/unit/test_buckets.c.o"
+  "CMakeFiles/test_buckets.dir/tests/unit/test_buckets.c.o.d"
+  "test_buckets"
+  "test_buckets.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_buckets.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_buckets_core.dir/tests/unit/test_buckets.c.o"
+  "CMakeFiles/test_buckets_core.dir/tests/unit/test_buckets.c.o.d"
+  "test_buckets_core"
+  "test_buckets_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_buckets_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_budget_core.dir/tests/unit/test_budget.c.o"
+  "CMakeFiles/test_budget_core.dir/tests/unit/test_budget.c.o.d"
+  "test_budget_core"
+  "test_budget_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_budget_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
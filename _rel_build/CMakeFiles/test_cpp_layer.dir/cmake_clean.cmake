@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_cpp_layer.dir/tests/unit/test_cpp_layer.cpp.o"
+  "CMakeFiles/test_cpp_layer.dir/tests/unit/test_cpp_layer.cpp.o.d"
+  "test_cpp_layer"
+  "test_cpp_layer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_cpp_layer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_moon_quarters.dir/tests/unit/test_moon_quarters.c.o"
+  "CMakeFiles/test_moon_quarters.dir/tests/unit/test_moon_quarters.c.o.d"
+  "test_moon_quarters"
+  "test_moon_quarters.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_moon_quarters.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_moon_quarters_core.dir/tests/unit/test_moon_quarters.c.o"
+  "CMakeFiles/test_moon_quarters_core.dir/tests/unit/test_moon_quarters.c.o.d"
+  "test_moon_quarters_core"
+  "test_moon_quarters_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_moon_quarters_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
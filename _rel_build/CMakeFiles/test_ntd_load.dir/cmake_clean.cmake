@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_ntd_load.dir/tests/tools/test_ntd_load.c.o"
+  "CMakeFiles/test_ntd_load.dir/tests/tools/test_ntd_load.c.o.d"
+  "test_ntd_load"
+  "test_ntd_load.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_ntd_load.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
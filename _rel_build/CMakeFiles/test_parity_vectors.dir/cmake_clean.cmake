@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_parity_vectors.dir/tests/unit/test_parity_vectors.c.o"
+  "CMakeFiles/test_parity_vectors.dir/tests/unit/test_parity_vectors.c.o.d"
+  "test_parity_vectors"
+  "test_parity_vectors.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_parity_vectors.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
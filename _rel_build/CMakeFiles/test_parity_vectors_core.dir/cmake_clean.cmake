@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_parity_vectors_core.dir/tests/unit/test_parity_vectors.c.o"
+  "CMakeFiles/test_parity_vectors_core.dir/tests/unit/test_parity_vectors.c.o.d"
+  "test_parity_vectors_core"
+  "test_parity_vectors_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_parity_vectors_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
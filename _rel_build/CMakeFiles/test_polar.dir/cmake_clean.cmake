@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_polar.dir/tests/unit/test_polar.c.o"
+  "CMakeFiles/test_polar.dir/tests/unit/test_polar.c.o.d"
+  "test_polar"
+  "test_polar.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_polar.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_polar_core.dir/tests/unit/test_polar.c.o"
+  "CMakeFiles/test_polar_core.dir/tests/unit/test_polar.c.o.d"
+  "test_polar_core"
+  "test_polar_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_polar_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
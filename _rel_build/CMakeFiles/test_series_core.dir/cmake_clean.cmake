@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_series_core.dir/tests/unit/test_series.c.o"
+  "CMakeFiles/test_series_core.dir/tests/unit/test_series.c.o.d"
+  "test_series_core"
+  "test_series_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_series_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/natural_time_series.c" "CMakeFiles/test_series_small_queue.dir/src/natural_time_series.c.o" "gcc" "CMakeFiles/test_series_small_queue.dir/src/natural_time_series.c.o.d"
+  "/root/repo/tests/unit/test_series.c" "CMakeFiles/test_series_small_queue.dir/tests/unit/test_series.c.o" "gcc" "CMakeFiles/test_series_small_queue.dir/tests/unit/test_series.c.o.d"
+  "/root/repo/vendor/astronomy_c/astronomy.c" "CMakeFiles/test_series_small_queue.dir/vendor/astronomy_c/astronomy.c.o" "gcc" "CMakeFiles/test_series_small_queue.dir/vendor/astronomy_c/astronomy.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_series_small_queue.dir/src/natural_time_series.c.o"
+  "CMakeFiles/test_series_small_queue.dir/src/natural_time_series.c.o.d"
+  "CMakeFiles/test_series_small_queue.dir/tests/unit/test_series.c.o"
+  "CMakeFiles/test_series_small_queue.dir/tests/unit/test_series.c.o.d"
+  "CMakeFiles/test_series_small_queue.dir/vendor/astronomy_c/astronomy.c.o"
+  "CMakeFiles/test_series_small_queue.dir/vendor/astronomy_c/astronomy.c.o.d"
+  "test_series_small_queue"
+  "test_series_small_queue.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_series_small_queue.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,33 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_shm.dir/src/natural_time.c.o"
+  "CMakeFiles/test_shm.dir/src/natural_time.c.o.d"
+  "CMakeFiles/test_shm.dir/src/natural_time_buckets.c.o"
+  "CMakeFiles/test_shm.dir/src/natural_time_buckets.c.o.d"
+  "CMakeFiles/test_shm.dir/src/natural_time_budget.c.o"
+  "CMakeFiles/test_shm.dir/src/natural_time_budget.c.o.d"
+  "CMakeFiles/test_shm.dir/src/natural_time_capture.c.o"
+  "CMakeFiles/test_shm.dir/src/natural_time_capture.c.o.d"
+  "CMakeFiles/test_shm.dir/src/natural_time_pack.c.o"
+  "CMakeFiles/test_shm.dir/src/natural_time_pack.c.o.d"
+  "CMakeFiles/test_shm.dir/src/natural_time_scheduler.c.o"
+  "CMakeFiles/test_shm.dir/src/natural_time_scheduler.c.o.d"
+  "CMakeFiles/test_shm.dir/src/natural_time_series.c.o"
+  "CMakeFiles/test_shm.dir/src/natural_time_series.c.o.d"
+  "CMakeFiles/test_shm.dir/src/natural_time_shm.c.o"
+  "CMakeFiles/test_shm.dir/src/natural_time_shm.c.o.d"
+  "CMakeFiles/test_shm.dir/src/natural_time_snapshot.c.o"
+  "CMakeFiles/test_shm.dir/src/natural_time_snapshot.c.o.d"
+  "CMakeFiles/test_shm.dir/src/natural_time_track.c.o"
+  "CMakeFiles/test_shm.dir/src/natural_time_track.c.o.d"
+  "CMakeFiles/test_shm.dir/tests/unit/test_shm.c.o"
+  "CMakeFiles/test_shm.dir/tests/unit/test_shm.c.o.d"
+  "CMakeFiles/test_shm.dir/vendor/astronomy_c/astronomy.c.o"
+  "CMakeFiles/test_shm.dir/vendor/astronomy_c/astronomy.c.o.d"
+  "test_shm"
+  "test_shm.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_shm.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
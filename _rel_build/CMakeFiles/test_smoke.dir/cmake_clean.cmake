@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_smoke.dir/tests/unit/test_smoke.c.o"
+  "CMakeFiles/test_smoke.dir/tests/unit/test_smoke.c.o.d"
+  "test_smoke"
+  "test_smoke.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_smoke.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_snapshot_core.dir/tests/unit/test_snapshot.c.o"
+  "CMakeFiles/test_snapshot_core.dir/tests/unit/test_snapshot.c.o.d"
+  "test_snapshot_core"
+  "test_snapshot_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_snapshot_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
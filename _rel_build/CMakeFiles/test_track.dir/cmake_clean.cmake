@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_track.dir/tests/unit/test_track.c.o"
+  "CMakeFiles/test_track.dir/tests/unit/test_track.c.o.d"
+  "test_track"
+  "test_track.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/test_track.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,78 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_rel_build
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test([=[smoke]=] "/root/repo/_rel_build/test_smoke")
+set_tests_properties([=[smoke]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;116;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[moon_quarters]=] "/root/repo/_rel_build/test_moon_quarters")
+set_tests_properties([=[moon_quarters]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;120;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[fixed_point]=] "/root/repo/_rel_build/test_fixed_point")
+set_tests_properties([=[fixed_point]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;124;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[scheduler]=] "/root/repo/_rel_build/test_scheduler")
+set_tests_properties([=[scheduler]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;128;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[pack]=] "/root/repo/_rel_build/test_pack")
+set_tests_properties([=[pack]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;132;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[buckets]=] "/root/repo/_rel_build/test_buckets")
+set_tests_properties([=[buckets]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;136;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[track]=] "/root/repo/_rel_build/test_track")
+set_tests_properties([=[track]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;140;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[polar]=] "/root/repo/_rel_build/test_polar")
+set_tests_properties([=[polar]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;144;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[series]=] "/root/repo/_rel_build/test_series")
+set_tests_properties([=[series]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;150;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[series_small_queue]=] "/root/repo/_rel_build/test_series_small_queue")
+set_tests_properties([=[series_small_queue]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;159;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[budget]=] "/root/repo/_rel_build/test_budget")
+set_tests_properties([=[budget]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;164;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[snapshot]=] "/root/repo/_rel_build/test_snapshot")
+set_tests_properties([=[snapshot]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;168;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[shm]=] "/root/repo/_rel_build/test_shm")
+set_tests_properties([=[shm]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;179;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[capture]=] "/root/repo/_rel_build/test_capture" "/root/repo/_rel_build/capture_smoke.ntcap")
+set_tests_properties([=[capture]=] PROPERTIES  FIXTURES_SETUP "capture_trace" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;183;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[async]=] "/root/repo/_rel_build/test_async")
+set_tests_properties([=[async]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;190;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[threads]=] "/root/repo/_rel_build/test_threads")
+set_tests_properties([=[threads]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;194;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[ntc_smoke]=] "/usr/bin/cmake" "-DNTC=/root/repo/_rel_build/ntc" "-DWORK=/root/repo/_rel_build/ntc_smoke" "-P" "/root/repo/tests/tools/ntc_smoke.cmake")
+set_tests_properties([=[ntc_smoke]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;198;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[ntd_load]=] "/root/repo/_rel_build/test_ntd_load" "/root/repo/_rel_build/ntd")
+set_tests_properties([=[ntd_load]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;205;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[ntreplay_smoke]=] "/root/repo/_rel_build/ntreplay" "-j" "4" "-r" "2" "/root/repo/_rel_build/capture_smoke.ntcap")
+set_tests_properties([=[ntreplay_smoke]=] PROPERTIES  FIXTURES_REQUIRED "capture_trace" PASS_REGULAR_EXPRESSION " 0 status mismatches" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;208;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[smoke_core]=] "/root/repo/_rel_build/test_smoke_core")
+set_tests_properties([=[smoke_core]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;217;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[moon_quarters_core]=] "/root/repo/_rel_build/test_moon_quarters_core")
+set_tests_properties([=[moon_quarters_core]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;217;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[polar_core]=] "/root/repo/_rel_build/test_polar_core")
+set_tests_properties([=[polar_core]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;217;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[track_core]=] "/root/repo/_rel_build/test_track_core")
+set_tests_properties([=[track_core]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;217;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[series_core]=] "/root/repo/_rel_build/test_series_core")
+set_tests_properties([=[series_core]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;217;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[scheduler_core]=] "/root/repo/_rel_build/test_scheduler_core")
+set_tests_properties([=[scheduler_core]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;217;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[pack_core]=] "/root/repo/_rel_build/test_pack_core")
+set_tests_properties([=[pack_core]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;217;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[buckets_core]=] "/root/repo/_rel_build/test_buckets_core")
+set_tests_properties([=[buckets_core]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;217;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[budget_core]=] "/root/repo/_rel_build/test_budget_core")
+set_tests_properties([=[budget_core]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;217;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[snapshot_core]=] "/root/repo/_rel_build/test_snapshot_core")
+set_tests_properties([=[snapshot_core]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;217;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[parity_vectors]=] "/root/repo/_rel_build/test_parity_vectors")
+set_tests_properties([=[parity_vectors]=] PROPERTIES  SKIP_RETURN_CODE "77" WORKING_DIRECTORY "/root/repo" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;227;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[parity_vectors_core]=] "/root/repo/_rel_build/test_parity_vectors_core")
+set_tests_properties([=[parity_vectors_core]=] PROPERTIES  SKIP_RETURN_CODE "77" WORKING_DIRECTORY "/root/repo" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;227;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[ntaccuracy_smoke]=] "/root/repo/_rel_build/ntaccuracy" "--lat" "-65:65:32.5" "--lon" "-170:130:100" "--dates" "2024-01-01:2026-01-01:53" "-o" "/root/repo/_rel_build/ntaccuracy_smoke.json")
+set_tests_properties([=[ntaccuracy_smoke]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;238;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[ntaccuracy_core_smoke]=] "/root/repo/_rel_build/ntaccuracy_core" "--lat" "-65:65:32.5" "--lon" "-170:130:100" "--dates" "2024-01-01:2026-01-01:53" "-o" "/root/repo/_rel_build/ntaccuracy_core_smoke.json")
+set_tests_properties([=[ntaccuracy_core_smoke]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;238;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[core_footprint]=] "/usr/bin/cmake" "-DFULL_EXE=/root/repo/_rel_build/bench_footprint_natural_time" "-DCORE_EXE=/root/repo/_rel_build/bench_footprint_natural_time_core" "-DFULL_LIB=/root/repo/_rel_build/libnatural_time.a" "-DCORE_LIB=/root/repo/_rel_build/libnatural_time_core.a" "-DWORK=/root/repo/_rel_build/core_footprint" "-P" "/root/repo/tests/tools/core_footprint.cmake")
+set_tests_properties([=[core_footprint]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;248;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[fixed_split_bench]=] "/root/repo/_rel_build/bench_fixed_split" "200000")
+set_tests_properties([=[fixed_split_bench]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;259;add_test;/root/repo/CMakeLists.txt;0;")
+add_test([=[cpp_layer]=] "/root/repo/_rel_build/test_cpp_layer")
+set_tests_properties([=[cpp_layer]=] PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;269;add_test;/root/repo/CMakeLists.txt;0;")
@@ -29,6 +29,14 @@ typedef struct {
 
 typedef enum { NT_OK=0, NT_ERR_RANGE=1, NT_ERR_TIME=2, NT_ERR_INTERNAL=3 } nt_err;
 
+// Whether the body crosses an event threshold during the natural day. When it
+// does not, the matching *_deg fields hold the seasonal defaults.
+typedef enum {
+  NT_POLAR_NONE         = 0,   // crosses (or at least one of the two events was found)
+  NT_POLAR_ALWAYS_ABOVE = 1,   // e.g. midnight sun for the horizon threshold
+  NT_POLAR_ALWAYS_BELOW = 2    // e.g. polar night
+} nt_polar_regime;
+
 typedef struct {
   double sunrise_deg;
   double sunset_deg;
@@ -36,6 +44,9 @@ typedef struct {
   double night_end_deg;
   double morning_golden_deg;
   double evening_golden_deg;
+  int32_t horizon_regime;    // nt_polar_regime for sunrise/sunset
+  int32_t night_regime;      // nt_polar_regime for the -12° night threshold
+  int32_t golden_regime;     // nt_polar_regime for the +6° golden hour threshold
 } nt_sun_events;
 
 typedef struct {
@@ -52,6 +63,7 @@ typedef struct {
   double moonrise_deg;
   double moonset_deg;
   double highest_altitude; // degrees
+  int32_t horizon_regime;  // nt_polar_regime for moonrise/moonset
 } nt_moon_events;
 
 typedef struct {
@@ -62,16 +74,59 @@ typedef struct {
   double average_angle_deg;
 } nt_mustaches;
 
+// Lunar quarter instant (new, first quarter, full, last quarter).
+typedef struct {
+  int32_t quarter;         // 0=new, 1=first quarter, 2=full, 3=last quarter
+  int32_t day_of_year;     // natural day of year at the requested longitude
+  int64_t unix_time;       // ms UTC of the exact phase crossing
+  double  time_deg;        // natural degree of the day at the requested longitude
+} nt_moon_quarter;
+
+// Upper bound on quarters inside one natural year (≈ 50 in practice).
+#define NT_MOON_QUARTERS_MAX 56
+
 nt_err nt_make_natural_date(int64_t unix_ms_utc, double longitude_deg, nt_natural_date* out);
+// Integer-only variant: longitude in micro-degrees [-180000000, 180000000], shifts and
+// day/week/moon derivation in integer ms. Same results as nt_make_natural_date at
+// longitude_udeg / 1e6. Builds with NT_FIXED_POINT route nt_make_natural_date here.
+nt_err nt_make_natural_date_fixed(int64_t unix_ms_utc, int32_t longitude_udeg, nt_natural_date* out);
 nt_err nt_get_time_of_event(const nt_natural_date* nd, int64_t event_unix_ms_utc, double* out_deg_or_nan);
+// Event searches run on batched Sun/Moon series rather than the Astronomy Engine
+// searches: same crossings and regimes, event angles within 0.0005° of the
+// vendor's (not bit-identical).
 nt_err nt_sun_events_for_date(const nt_natural_date* nd, double latitude_deg, nt_sun_events* out);
 nt_err nt_sun_position_for_date(const nt_natural_date* nd, double latitude_deg, nt_sun_position* out);
 nt_err nt_moon_position_for_date(const nt_natural_date* nd, double latitude_deg, nt_moon_position* out);
 nt_err nt_moon_events_for_date(const nt_natural_date* nd, double latitude_deg, nt_moon_events* out);
 nt_err nt_mustaches_range(const nt_natural_date* nd, double latitude_deg, nt_mustaches* out);
 
+// Moon quarters found by direct phase-crossing searches (≈ 50 per year instead of
+// one ephemeris evaluation per day). Results are in time order. `*out_count` always
+// receives the number of events; NT_ERR_RANGE is returned if it exceeds `capacity`
+// (the first `capacity` events are still written).
+// All quarters inside the natural year of `nd` at nd->longitude (cached per year).
+nt_err nt_moon_quarters_for_year(const nt_natural_date* nd, nt_moon_quarter* out, size_t capacity, size_t* out_count);
+// All quarters in [start_ms, end_ms), natural fields at the given longitude.
+nt_err nt_moon_quarters_range(int64_t start_ms_utc, int64_t end_ms_utc, double longitude_deg,
+                              nt_moon_quarter* out, size_t capacity, size_t* out_count);
+// Illuminated fraction (0..1) at the middle (180°) of each natural day of the year of `nd`,
+// interpolated from the cached quarter instants; out_fraction[i] is day_of_year i+1.
+// Within 0.01 of the ephemeris value.
+nt_err nt_moon_illumination_for_year(const nt_natural_date* nd, double* out_fraction, size_t capacity, size_t* out_count);
+
+// Caches are per thread; the functions above are safe to call from several threads.
+// Resets the calling thread's caches.
 void nt_reset_caches(void);
 
+// Lookups in the calling thread's seasons, sun events and mustaches caches
+// since it started (nt_reset_caches keeps the counts).
+typedef struct {
+  uint64_t seasons_hits, seasons_misses;
+  uint64_t sun_events_hits, sun_events_misses;
+  uint64_t mustaches_hits, mustaches_misses;
+} nt_cache_stats;
+void nt_cache_counters(nt_cache_stats* out);
+
  // Formatting helpers (parity with JS NaturalDate string methods)
  // All functions write a NUL-terminated string into `buffer` up to `buffer_size` bytes
  // and return NT_OK on success. If inputs are invalid or buffer is too small, NT_ERR_RANGE is returned.
@@ -107,6 +162,16 @@ void nt_reset_caches(void);
                              int32_t* out_fraction,
                              int32_t* out_scale);
 
+ // Integer-only split from the exact ms-of-day (unix_time - nadir, wrapped into
+ // the day), rounded to one unit of the last decimal exactly as
+ // nt_time_split_scaled rounds time_deg, ties included. With NT_FIXED_POINT,
+ // nt_time_split_scaled and the time formatters use it for unit (or no) rounding.
+ nt_err nt_time_split_fixed(const nt_natural_date* nd,
+                            int decimals,
+                            int32_t* out_integer,
+                            int32_t* out_fraction,
+                            int32_t* out_scale);
+
  // Formats longitude: "NTZ" when |lon| < 0.5, otherwise "NT±D(.d)?"
  nt_err nt_format_longitude_string(double longitude_deg,
                                    int decimals,
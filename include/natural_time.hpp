@@ -0,0 +1,430 @@
+// Natural Time — header-only C++20 layer (v0.1)
+//
+// Value-returning, constexpr wrappers around the calendar part of the C ABI.
+// Day/week/moon/time_deg derivations and year starts are computed inline from
+// a compile-time solstice table, so constant dates fold at compile time and
+// hot loops avoid the library call. Outside the table range the runtime path
+// falls back to nt_make_natural_date. Results match the C functions exactly.
+#ifndef NATURAL_TIME_HPP
+#define NATURAL_TIME_HPP
+
+#include "natural_time.h"
+#include "natural_time_fixed.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+
+namespace nt {
+
+// nt_natural_date is already a literal aggregate; reuse it so values pass
+// straight through to the C ABI (sun/moon functions) without conversion.
+using natural_date = ::nt_natural_date;
+
+inline constexpr std::int64_t ms_per_day = 86400000LL;
+inline constexpr std::int64_t end_of_artificial_time = 1356091200000LL; // 2012-12-21T12:00:00Z
+
+namespace detail {
+
+// Natural new-year dates (12:00 UTC on the December solstice day, or the next
+// day when the solstice falls after noon) as days since 1970-01-01, indexed by
+// artificial year. Generated from Astronomy_Seasons through
+// nt_make_natural_date at longitude 180 (no shift); the C++ unit test checks
+// every entry against the C library.
+inline constexpr int solstice_table_first_year = 1969;
+inline constexpr std::array<std::int32_t, 233> solstice_new_year_days = {
+       -10,    355,    721,   1086,   1451,   1816,   2181,   2547,   2912,   3277,  // 1969
+      3642,   4008,   4373,   4738,   5103,   5469,   5834,   6199,   6564,   6930,  // 1979
+      7295,   7660,   8025,   8391,   8756,   9121,   9486,   9852,  10217,  10582,  // 1989
+     10947,  11313,  11678,  12043,  12408,  12774,  13139,  13504,  13869,  14235,  // 1999
+     14600,  14965,  15330,  15695,  16061,  16426,  16791,  17156,  17522,  17887,  // 2009
+     18252,  18617,  18983,  19348,  19713,  20078,  20444,  20809,  21174,  21539,  // 2019
+     21905,  22270,  22635,  23000,  23366,  23731,  24096,  24461,  24827,  25192,  // 2029
+     25557,  25922,  26288,  26653,  27018,  27383,  27748,  28114,  28479,  28844,  // 2039
+     29209,  29575,  29940,  30305,  30670,  31036,  31401,  31766,  32131,  32497,  // 2049
+     32862,  33227,  33592,  33958,  34323,  34688,  35053,  35419,  35784,  36149,  // 2059
+     36514,  36880,  37245,  37610,  37975,  38341,  38706,  39071,  39436,  39801,  // 2069
+     40167,  40532,  40897,  41262,  41628,  41993,  42358,  42723,  43089,  43454,  // 2079
+     43819,  44184,  44550,  44915,  45280,  45645,  46011,  46376,  46741,  47106,  // 2089
+     47472,  47837,  48202,  48567,  48933,  49298,  49663,  50028,  50394,  50759,  // 2099
+     51124,  51489,  51855,  52220,  52585,  52950,  53315,  53681,  54046,  54411,  // 2109
+     54776,  55142,  55507,  55872,  56237,  56603,  56968,  57333,  57698,  58064,  // 2119
+     58429,  58794,  59159,  59525,  59890,  60255,  60620,  60986,  61351,  61716,  // 2129
+     62081,  62447,  62812,  63177,  63542,  63908,  64273,  64638,  65003,  65368,  // 2139
+     65734,  66099,  66464,  66829,  67195,  67560,  67925,  68290,  68656,  69021,  // 2149
+     69386,  69751,  70117,  70482,  70847,  71212,  71578,  71943,  72308,  72673,  // 2159
+     73039,  73404,  73769,  74134,  74500,  74865,  75230,  75595,  75961,  76326,  // 2169
+     76691,  77056,  77421,  77787,  78152,  78517,  78882,  79248,  79613,  79978,  // 2179
+     80343,  80709,  81074,  81439,  81804,  82170,  82535,  82900,  83265,  83631,  // 2189
+     83996,  84361,  84726,  // 2199
+};
+inline constexpr int solstice_table_last_year =
+    solstice_table_first_year + static_cast<int>(solstice_new_year_days.size()) - 1;
+
+// Not constexpr on purpose: reaching it during constant evaluation turns an
+// out-of-table date into a compile error instead of a silent fallback.
+inline void solstice_table_out_of_range() noexcept {}
+
+constexpr double floor_d(double x) noexcept {
+  double t = static_cast<double>(static_cast<std::int64_t>(x));
+  return (t > x) ? t - 1.0 : t;
+}
+
+// Round half away from zero, like llround.
+constexpr std::int64_t llround_d(double x) noexcept {
+  std::int64_t t = static_cast<std::int64_t>(x);
+  double diff = x - static_cast<double>(t);
+  if (diff >= 0.5) return t + 1;
+  if (diff <= -0.5) return t - 1;
+  return t;
+}
+
+constexpr std::int64_t floor_div(std::int64_t a, std::int64_t b) noexcept {
+  std::int64_t q = a / b;
+  return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+// Proleptic Gregorian year of a day count since 1970-01-01 (H. Hinnant).
+constexpr int civil_year_from_days(std::int64_t z) noexcept {
+  z += 719468;
+  const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  const std::int64_t doe = z - era * 146097;
+  const std::int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const std::int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const std::int64_t mp = (5 * doy + 2) / 153;
+  const std::int64_t m = mp < 10 ? mp + 3 : mp - 9;
+  return static_cast<int>(yoe + era * 400 + (m <= 2 ? 1 : 0));
+}
+
+// Mirrors utc_year_from_unix_ms (gmtime of the truncated second count).
+constexpr int utc_year_from_unix_ms(std::int64_t unix_ms) noexcept {
+  return civil_year_from_days(floor_div(unix_ms / 1000LL, 86400LL));
+}
+
+constexpr bool in_solstice_table(int artificial_year) noexcept {
+  return artificial_year >= solstice_table_first_year && artificial_year < solstice_table_last_year;
+}
+
+constexpr std::int64_t new_year_noon_ms(int artificial_year) noexcept {
+  std::int64_t days = solstice_new_year_days[static_cast<std::size_t>(artificial_year - solstice_table_first_year)];
+  return days * ms_per_day + ms_per_day / 2;
+}
+
+// Same as calculate_year_start_ms; caller guarantees the table covers the year.
+constexpr std::int64_t year_start_ms(int artificial_year, double longitude_deg, int& duration_days) noexcept {
+  std::int64_t start = new_year_noon_ms(artificial_year);
+  std::int64_t end = new_year_noon_ms(artificial_year + 1);
+  duration_days = static_cast<int>((end - start) / ms_per_day);
+  double shift_ms = (-longitude_deg + 180.0) * static_cast<double>(ms_per_day) / 360.0;
+  return llround_d(static_cast<double>(start) + shift_ms);
+}
+
+constexpr std::int32_t pow10_i32(int n) noexcept {
+  std::int32_t s = 1;
+  for (int i = 0; i < n; ++i) s *= 10;
+  return s;
+}
+
+// Writes `value` left-padded with zeros to `width` digits; returns the new end
+// or nullptr when it does not fit.
+constexpr char* put_padded(char* first, char* last, std::int64_t value, int width) noexcept {
+  char tmp[24] = {};
+  int n = 0;
+  do { tmp[n++] = static_cast<char>('0' + value % 10); value /= 10; } while (value > 0);
+  while (n < width) tmp[n++] = '0';
+  if (last - first < n) return nullptr;
+  while (n > 0) *first++ = tmp[--n];
+  return first;
+}
+
+constexpr char* put_text(char* first, char* last, const char* text) noexcept {
+  for (; *text; ++text) {
+    if (first == last) return nullptr;
+    *first++ = *text;
+  }
+  return first;
+}
+
+constexpr std::to_chars_result too_large(char* last) noexcept {
+  return {last, std::errc::value_too_large};
+}
+
+} // namespace detail
+
+// Same derivation as nt_make_natural_date. Returns std::nullopt for inputs the
+// C function rejects (longitude outside [-180, 180], non-positive timestamp).
+constexpr std::optional<natural_date> make_natural_date(std::int64_t unix_ms_utc, double longitude_deg) noexcept {
+  if (!(longitude_deg >= -180.0 && longitude_deg <= 180.0)) return std::nullopt;
+  if (unix_ms_utc <= 0) return std::nullopt;
+
+  int utc_year = detail::utc_year_from_unix_ms(unix_ms_utc);
+  if (!detail::in_solstice_table(utc_year - 1) || !detail::in_solstice_table(utc_year)) {
+    if (std::is_constant_evaluated()) detail::solstice_table_out_of_range();
+    natural_date c{};
+    if (::nt_make_natural_date(unix_ms_utc, longitude_deg, &c) != NT_OK) return std::nullopt;
+    return c;
+  }
+
+  int duration_days = 365;
+  std::int64_t year_start = detail::year_start_ms(utc_year - 1, longitude_deg, duration_days);
+  if (unix_ms_utc - year_start >= static_cast<std::int64_t>(duration_days) * ms_per_day) {
+    year_start = detail::year_start_ms(utc_year, longitude_deg, duration_days);
+  }
+
+  double days = static_cast<double>(unix_ms_utc - year_start) / static_cast<double>(ms_per_day);
+  std::int32_t whole_days = static_cast<std::int32_t>(detail::floor_d(days));
+  std::int32_t whole_weeks = static_cast<std::int32_t>(detail::floor_d(days / 7.0));
+
+  natural_date out{};
+  out.unix_time = unix_ms_utc;
+  out.longitude = longitude_deg;
+  out.year_start = year_start;
+  out.year_duration = duration_days;
+  out.year = detail::utc_year_from_unix_ms(year_start) - detail::utc_year_from_unix_ms(end_of_artificial_time) + 1;
+
+  out.moon = static_cast<std::int32_t>(detail::floor_d(days / 28.0)) + 1;
+  out.week = whole_weeks + 1;
+  out.week_of_moon = whole_weeks % 4 + 1;
+
+  std::int64_t eat_local = end_of_artificial_time +
+      static_cast<std::int64_t>((-longitude_deg + 180.0) * static_cast<double>(ms_per_day) / 360.0);
+  out.day = static_cast<std::int32_t>(detail::floor_d(static_cast<double>(unix_ms_utc - eat_local) / static_cast<double>(ms_per_day)));
+  out.day_of_year = whole_days + 1;
+  out.day_of_moon = whole_days % 28 + 1;
+  out.day_of_week = whole_days % 7 + 1;
+
+  out.nadir = year_start + static_cast<std::int64_t>(whole_days) * ms_per_day;
+  out.time_deg = static_cast<double>(unix_ms_utc - out.nadir) * 360.0 / static_cast<double>(ms_per_day);
+  if (out.time_deg >= 360.0) out.time_deg = 0.0;
+
+  out.is_rainbow_day = (out.day_of_year > 13 * 28) ? 1 : 0;
+  return out;
+}
+
+// -------------------------
+// std::chrono interop
+// -------------------------
+
+using sys_ms = std::chrono::sys_time<std::chrono::milliseconds>;
+
+template <class Duration>
+constexpr std::optional<natural_date> make_natural_date(std::chrono::sys_time<Duration> tp, double longitude_deg) noexcept {
+  return make_natural_date(std::chrono::floor<std::chrono::milliseconds>(tp).time_since_epoch().count(), longitude_deg);
+}
+
+constexpr sys_ms unix_time(const natural_date& nd) noexcept { return sys_ms{std::chrono::milliseconds{nd.unix_time}}; }
+constexpr sys_ms nadir_time(const natural_date& nd) noexcept { return sys_ms{std::chrono::milliseconds{nd.nadir}}; }
+constexpr sys_ms year_start_time(const natural_date& nd) noexcept { return sys_ms{std::chrono::milliseconds{nd.year_start}}; }
+
+// Same as nt_get_time_of_event: degrees of the natural day, 0 when outside it.
+constexpr double time_of_event(const natural_date& nd, std::int64_t event_unix_ms_utc) noexcept {
+  if (event_unix_ms_utc < nd.nadir || event_unix_ms_utc > nd.nadir + ms_per_day) return 0.0;
+  double deg = static_cast<double>(event_unix_ms_utc - nd.nadir) * 360.0 / static_cast<double>(ms_per_day);
+  return (deg >= 360.0) ? 0.0 : deg;
+}
+
+template <class Duration>
+constexpr double time_of_event(const natural_date& nd, std::chrono::sys_time<Duration> event) noexcept {
+  return time_of_event(nd, std::chrono::floor<std::chrono::milliseconds>(event).time_since_epoch().count());
+}
+
+// -------------------------
+// Formatting
+// -------------------------
+
+struct time_split {
+  std::int32_t integer;
+  std::int32_t fraction;
+  std::int32_t scale;
+};
+
+namespace detail {
+constexpr time_split split_time_fixed(const natural_date& nd, int decimals, bool unit_rounding) noexcept {
+  if (decimals < 0) decimals = 0;
+  if (decimals > 6) decimals = 6;
+  std::int32_t scale = pow10_i32(decimals);
+  std::int64_t ms_of_day = (nd.unix_time - nd.nadir) % ms_per_day;
+  if (ms_of_day < 0) ms_of_day += ms_per_day;
+  std::int64_t total = nt_fixed_time_total(ms_of_day, decimals, unit_rounding);
+  if (total >= static_cast<std::int64_t>(360) * scale) total -= static_cast<std::int64_t>(360) * scale;
+  return {static_cast<std::int32_t>(total / scale), static_cast<std::int32_t>(total % scale), scale};
+}
+} // namespace detail
+
+// Same as nt_time_split_fixed: the unit-rounded split from the exact ms-of-day.
+constexpr time_split split_time_fixed(const natural_date& nd, int decimals) noexcept {
+  return detail::split_time_fixed(nd, decimals, true);
+}
+
+// Same as nt_time_split_scaled (decimals clamped to 0..6, rounding <= 0 disables rounding).
+constexpr time_split split_time(const natural_date& nd, int decimals, double rounding) noexcept {
+  if (decimals < 0) decimals = 0;
+  if (decimals > 6) decimals = 6;
+#if defined(NT_FIXED_POINT)
+  constexpr double unit_increment[7] = {1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001};
+  std::int64_t ms_of_day = nd.unix_time - nd.nadir;
+  if ((rounding <= 0.0 || rounding == unit_increment[decimals]) && ms_of_day >= 0 && ms_of_day < ms_per_day) {
+    return detail::split_time_fixed(nd, decimals, rounding > 0.0);
+  }
+#endif
+  double t = nd.time_deg;
+  if (rounding > 0) t = detail::floor_d(t / rounding + 0.5) * rounding;
+  while (t >= 360.0) t -= 360.0;
+  while (t < 0.0) t += 360.0;
+  std::int32_t scale = detail::pow10_i32(decimals);
+  std::int64_t total = detail::llround_d(t * static_cast<double>(scale));
+  if (total >= static_cast<std::int64_t>(360) * scale) total -= static_cast<std::int64_t>(360) * scale;
+  if (total < 0) total += static_cast<std::int64_t>(360) * scale;
+  return {static_cast<std::int32_t>(total / scale), static_cast<std::int32_t>(total % scale), scale};
+}
+
+// Fixed decimal count with the matching 10^-Decimals rounding increment (the
+// JS defaults: 2 decimals, 0.01 rounding). Scale and divisions fold at compile time.
+template <int Decimals>
+constexpr time_split split_time(const natural_date& nd) noexcept {
+  static_assert(Decimals >= 0 && Decimals <= 6, "natural time supports 0..6 decimals");
+  constexpr std::int32_t scale = detail::pow10_i32(Decimals);
+  return split_time(nd, Decimals, 1.0 / static_cast<double>(scale));
+}
+
+// "TTT°dd" into [out.data(), out.data() + out.size()), no NUL terminator.
+constexpr std::to_chars_result format_time(std::span<char> out, time_split split, int decimals) noexcept {
+  char* first = out.data();
+  char* last = first + out.size();
+  first = detail::put_padded(first, last, split.integer, 3);
+  if (!first) return detail::too_large(last);
+  first = detail::put_text(first, last, "\xC2\xB0"); // UTF-8 degree sign
+  if (!first) return detail::too_large(last);
+  if (decimals > 0 && split.scale > 1) {
+    first = detail::put_padded(first, last, split.fraction, decimals);
+    if (!first) return detail::too_large(last);
+  }
+  return {first, std::errc{}};
+}
+
+template <int Decimals = 2>
+constexpr std::to_chars_result format_time(std::span<char> out, const natural_date& nd) noexcept {
+  return format_time(out, split_time<Decimals>(nd), Decimals);
+}
+
+// "YYY)MM)DD" or "YYY)RAINBOW(+)?", same as nt_format_date_string.
+constexpr std::to_chars_result format_date(std::span<char> out, const natural_date& nd, char separator = ')') noexcept {
+  char* first = out.data();
+  char* last = first + out.size();
+  if (nd.year < 0) {
+    if (first == last) return detail::too_large(last);
+    *first++ = '-';
+  }
+  first = detail::put_padded(first, last, nd.year < 0 ? -static_cast<std::int64_t>(nd.year) : nd.year, 3);
+  if (!first || first == last) return detail::too_large(last);
+  *first++ = separator;
+  if (nd.is_rainbow_day) {
+    first = detail::put_text(first, last, nd.day_of_year == 366 ? "RAINBOW+" : "RAINBOW");
+    if (!first) return detail::too_large(last);
+    return {first, std::errc{}};
+  }
+  first = detail::put_padded(first, last, nd.moon, 2);
+  if (!first || first == last) return detail::too_large(last);
+  *first++ = separator;
+  first = detail::put_padded(first, last, nd.day_of_moon, 2);
+  if (!first) return detail::too_large(last);
+  return {first, std::errc{}};
+}
+
+// "NTZ" or "NT±D(.d)?", same as nt_format_longitude_string. Not constexpr:
+// the fractional digits use std::to_chars, which rounds exactly like printf.
+inline std::to_chars_result format_longitude(std::span<char> out, double longitude_deg, int decimals = 1) noexcept {
+  char* first = out.data();
+  char* last = first + out.size();
+  double abs_lon = longitude_deg < 0.0 ? -longitude_deg : longitude_deg;
+  if (abs_lon < 0.5) {
+    first = detail::put_text(first, last, "NTZ");
+    return first ? std::to_chars_result{first, std::errc{}} : detail::too_large(last);
+  }
+  if (decimals < 0 || decimals > 3) decimals = 1;
+  first = detail::put_text(first, last, longitude_deg >= 0.0 ? "NT+" : "NT-");
+  if (!first) return detail::too_large(last);
+  double int_part = detail::floor_d(abs_lon);
+  first = detail::put_padded(first, last, static_cast<std::int64_t>(int_part), 1);
+  if (!first) return detail::too_large(last);
+  if (decimals == 0) return {first, std::errc{}};
+  char frac[16];
+  auto r = std::to_chars(frac, frac + sizeof(frac), abs_lon - int_part, std::chars_format::fixed, decimals);
+  const char* dot = frac;
+  while (dot != r.ptr && *dot != '.') ++dot;
+  if (last - first < r.ptr - dot) return detail::too_large(last);
+  for (const char* p = dot; p != r.ptr; ++p) *first++ = *p;
+  return {first, std::errc{}};
+}
+
+// Full "YYY)MM)DD TTT°dd NT±LLL.L", same as nt_format_string with
+// time_decimals = Decimals and time_rounding = 10^-Decimals.
+template <int Decimals = 2>
+inline std::to_chars_result format(std::span<char> out, const natural_date& nd) noexcept {
+  char* last = out.data() + out.size();
+  auto r = format_date(out, nd);
+  if (r.ec != std::errc{} || r.ptr == last) return detail::too_large(last);
+  *r.ptr++ = ' ';
+  r = format_time<Decimals>(std::span<char>(r.ptr, last), nd);
+  if (r.ec != std::errc{} || r.ptr == last) return detail::too_large(last);
+  *r.ptr++ = ' ';
+  return format_longitude(std::span<char>(r.ptr, last), nd.longitude, 1);
+}
+
+template <int Decimals = 2>
+inline std::string to_string(const natural_date& nd) {
+  char buf[64];
+  auto r = format<Decimals>(std::span<char>(buf), nd);
+  return std::string(buf, r.ptr);
+}
+
+} // namespace nt
+
+#if defined(__cpp_lib_format)
+// std::format("{}", nd) gives the full string; "{:.N}" picks N time decimals (0..6).
+template <>
+struct std::formatter<nt::natural_date> {
+  int decimals = 2;
+
+  constexpr auto parse(std::format_parse_context& ctx) {
+    auto it = ctx.begin();
+    if (it != ctx.end() && *it == '.') {
+      ++it;
+      if (it == ctx.end() || *it < '0' || *it > '6') throw std::format_error("natural_date: expected .0 to .6");
+      decimals = *it++ - '0';
+    }
+    if (it != ctx.end() && *it != '}') throw std::format_error("natural_date: invalid format spec");
+    return it;
+  }
+
+  template <class FormatContext>
+  auto format(const nt::natural_date& nd, FormatContext& ctx) const {
+    char buf[64];
+    std::span<char> out(buf);
+    auto r = nt::format_date(out, nd);
+    *r.ptr++ = ' ';
+    nt::time_split split = nt::split_time(nd, decimals, 1.0 / static_cast<double>(nt::detail::pow10_i32(decimals)));
+    r = nt::format_time(std::span<char>(r.ptr, buf + sizeof(buf)), split, decimals);
+    *r.ptr++ = ' ';
+    r = nt::format_longitude(std::span<char>(r.ptr, buf + sizeof(buf)), nd.longitude, 1);
+    return std::copy(buf, r.ptr, ctx.out());
+  }
+};
+#endif
+
+#endif // NATURAL_TIME_HPP
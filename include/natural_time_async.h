@@ -0,0 +1,92 @@
+// Natural Time — Asynchronous request queue (v0.1)
+//
+// Submit sun/moon event, mustache and moon-quarter range requests from a
+// latency-sensitive thread (UI) and collect results later. Requests run on
+// library-owned worker threads, highest priority first (FIFO within a
+// priority). Identical requests that are still pending or running are
+// coalesced: the work runs once and every submitter gets its own completion.
+// Completions are delivered through a callback (called on a worker thread) or
+// queued for nt_async_poll, with a file descriptor that becomes readable while
+// completions are waiting (eventfd on Linux, a pipe elsewhere).
+// POSIX threads only; every function is thread-safe.
+#ifndef NATURAL_TIME_ASYNC_H
+#define NATURAL_TIME_ASYNC_H
+
+#include "natural_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  NT_ASYNC_SUN_EVENTS         = 1,  // nt_sun_events_for_date(day of unix_ms at longitude, latitude)
+  NT_ASYNC_MOON_EVENTS        = 2,  // nt_moon_events_for_date(day of unix_ms at longitude, latitude)
+  NT_ASYNC_MUSTACHES          = 3,  // nt_mustaches_range(unix_ms, latitude)
+  NT_ASYNC_MOON_QUARTERS_RANGE = 4  // nt_moon_quarters_range(unix_ms, end_ms, longitude)
+} nt_async_kind;
+
+typedef struct {
+  nt_async_kind kind;
+  int64_t unix_ms;     // any instant of the requested day, or range start
+  int64_t end_ms;      // range end (NT_ASYNC_MOON_QUARTERS_RANGE only)
+  double  longitude;   // [-180, 180]
+  double  latitude;    // [-90, 90] (ignored by ranges)
+  int     priority;    // higher runs first
+} nt_async_request;
+
+typedef struct {
+  uint64_t handle;
+  nt_async_kind kind;
+  nt_err status;
+  void* user_data;
+  union {
+    nt_sun_events sun;
+    nt_moon_events moon_events;
+    nt_mustaches mustaches;
+    struct {
+      size_t count;    // may exceed NT_MOON_QUARTERS_MAX (status NT_ERR_RANGE, first entries filled)
+      nt_moon_quarter q[NT_MOON_QUARTERS_MAX];
+    } quarters;
+  } u;
+} nt_async_completion;
+
+// Called on a worker thread; must not block for long.
+typedef void (*nt_async_callback)(const nt_async_completion* c, void* ctx);
+
+typedef struct {
+  uint64_t submitted;
+  uint64_t coalesced;   // submissions attached to an identical pending/running request
+  uint64_t cancelled;
+  uint64_t computed;    // requests actually evaluated
+  size_t   pending;     // queued, not yet started
+} nt_async_stats;
+
+typedef struct nt_async_queue nt_async_queue;
+
+// `workers` <= 0 selects 1. With `callback` NULL completions are queued for nt_async_poll.
+nt_async_queue* nt_async_create(int workers, nt_async_callback callback, void* callback_ctx);
+// Drops pending requests (no completion), waits for running ones, frees the queue.
+void nt_async_destroy(nt_async_queue* q);
+
+// Validates and enqueues; the handle is never 0. Without a callback the queue
+// reserves room for the completion here, so NT_ERR_INTERNAL (out of memory) is
+// reported by submit and every accepted request is delivered.
+nt_err nt_async_submit(nt_async_queue* q, const nt_async_request* req, void* user_data, uint64_t* out_handle);
+
+// NT_OK when the request was still pending: it will not complete. NT_ERR_RANGE
+// when it is unknown, already running or done (its completion is delivered).
+nt_err nt_async_cancel(nt_async_queue* q, uint64_t handle);
+
+// Non-blocking: moves up to `capacity` queued completions to `out`, in completion order.
+size_t nt_async_poll(nt_async_queue* q, nt_async_completion* out, size_t capacity);
+
+// Readable while completions are queued (for poll/select/epoll/kqueue or a run loop).
+int nt_async_wait_fd(const nt_async_queue* q);
+
+void nt_async_get_stats(nt_async_queue* q, nt_async_stats* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATURAL_TIME_ASYNC_H
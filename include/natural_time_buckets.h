@@ -0,0 +1,58 @@
+// Natural Time — Bucketing / group-by (v0.1)
+//
+// Builds the boundary table of natural days, weeks, moons or years at one
+// longitude over a time range (one year-start lookup per natural year), then
+// maps timestamps to bucket ids without calling nt_make_natural_date per event:
+// sorted input advances a cursor (one or two comparisons), day buckets are a
+// division, anything else falls back to a binary search.
+#ifndef NATURAL_TIME_BUCKETS_H
+#define NATURAL_TIME_BUCKETS_H
+
+#include "natural_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  NT_BUCKET_DAY  = 0,   // nadir to nadir
+  NT_BUCKET_WEEK = 1,   // 7 days from the year start; week 53 holds the rainbow day(s)
+  NT_BUCKET_MOON = 2,   // 28 days from the year start; moon 14 holds the rainbow day(s)
+  NT_BUCKET_YEAR = 3
+} nt_bucket_unit;
+
+#define NT_BUCKET_NONE (-1)   // timestamp outside the table
+
+typedef struct {
+  int64_t start_ms;   // inclusive
+  int64_t end_ms;     // exclusive
+  int32_t year;       // natural year
+  int32_t ordinal;    // day_of_year, week, moon (as in nt_natural_date) or 1 for years
+} nt_bucket;
+
+typedef struct nt_bucket_table nt_bucket_table;
+
+// Buckets covering [start_ms, end_ms) at `longitude_deg`: the first starts at or
+// before start_ms, the last ends at or after end_ms. NULL on error (*err set if non-NULL).
+nt_bucket_table* nt_bucket_table_create(int64_t start_ms, int64_t end_ms, double longitude_deg,
+                                        nt_bucket_unit unit, nt_err* err);
+void nt_bucket_table_destroy(nt_bucket_table* t);
+
+size_t nt_bucket_table_size(const nt_bucket_table* t);
+nt_err nt_bucket_get(const nt_bucket_table* t, size_t id, nt_bucket* out);
+
+// Bucket id per timestamp (NT_BUCKET_NONE outside the table). Any order; sorted is fastest.
+void nt_bucket_assign(const nt_bucket_table* t, const int64_t* unix_ms, size_t count, int32_t* out_ids);
+
+// Same pass, accumulated per bucket: counts[id] += 1 and, when `values` and
+// `sums` are non-NULL, sums[id] += values[i]. Arrays hold nt_bucket_table_size()
+// entries and are not cleared, so calls can be chained over chunks. Returns the
+// number of timestamps that fell outside the table.
+size_t nt_bucket_aggregate(const nt_bucket_table* t, const int64_t* unix_ms, const double* values, size_t count,
+                           uint64_t* counts, double* sums);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATURAL_TIME_BUCKETS_H
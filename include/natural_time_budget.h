@@ -0,0 +1,76 @@
+// Natural Time — Bounded-latency sun and moon events (v0.1)
+//
+// nt_sun_events_for_date and nt_moon_events_for_date run their searches to
+// the end, and how long that takes depends on latitude, season and whether
+// the caches hit. The variants here stop when a per-call budget runs out and
+// return the best estimate so far: `approximate` is set, each event carries
+// an error bound, and the search state is kept in a caller-owned continuation
+// token, so later calls can refine it further. A finished search gives exactly
+// the result of the unbounded function and fills the same caches.
+//
+// The budget counts Sun/Moon instants evaluated by the batched series,
+// including the 3 that set up a search (a full day needs up to about 150 for
+// the Sun, 55 for the Moon), and/or wall-clock time, checked before each batch
+// of at most 8 instants, so a time budget can be exceeded by one batch. The
+// Moon's transit search counts as NT_BUDGET_TRANSIT_EVALUATIONS, and so does
+// each vendor search a threshold falls back to when its interval queue is full.
+
+#ifndef NATURAL_TIME_BUDGET_H
+#define NATURAL_TIME_BUDGET_H
+
+#include "natural_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NT_BUDGET_TRANSIT_EVALUATIONS 4
+#define NT_BUDGET_MIN_EVALUATIONS NT_BUDGET_TRANSIT_EVALUATIONS  // smaller nonzero caps are rejected
+#define NT_CONTINUATION_BYTES 16384
+
+typedef struct {
+  uint32_t max_evaluations;   // 0 = no cap
+  uint32_t max_microseconds;  // 0 = no limit
+} nt_budget;
+
+// Search state between calls; opaque, may be copied, needs no cleanup.
+typedef struct {
+  uint64_t opaque[NT_CONTINUATION_BYTES / 8];
+} nt_continuation;
+
+// error_deg bounds |value - exact| per event, in natural-day degrees, in the
+// order sunrise, sunset, night start, night end, morning golden, evening
+// golden; 360 while it is not yet known whether the event happens.
+typedef struct {
+  nt_sun_events value;
+  int32_t approximate;
+  uint32_t evaluations;  // spent by this call
+  double error_deg[6];
+} nt_sun_events_bounded;
+
+// highest_altitude is the highest sampled altitude until the transit search
+// has run (error 180 when that sample is not a peak yet).
+typedef struct {
+  nt_moon_events value;
+  int32_t approximate;
+  uint32_t evaluations;
+  double moonrise_error_deg;
+  double moonset_error_deg;
+  double highest_altitude_error_deg;
+} nt_moon_events_bounded;
+
+// Starts a search (or answers from the caches) within `budget`; NULL means no
+// budget. Resume with the token while `approximate` is set.
+nt_err nt_sun_events_for_date_bounded(const nt_natural_date* nd, double latitude_deg, const nt_budget* budget,
+                                      nt_continuation* token, nt_sun_events_bounded* out);
+nt_err nt_sun_events_resume(nt_continuation* token, const nt_budget* budget, nt_sun_events_bounded* out);
+
+nt_err nt_moon_events_for_date_bounded(const nt_natural_date* nd, double latitude_deg, const nt_budget* budget,
+                                       nt_continuation* token, nt_moon_events_bounded* out);
+nt_err nt_moon_events_resume(nt_continuation* token, const nt_budget* budget, nt_moon_events_bounded* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATURAL_TIME_BUDGET_H
@@ -0,0 +1,82 @@
+// Natural Time — Workload capture (v0.1)
+//
+// Records the public calls an application makes (which function, its
+// arguments, its status, its latency and which per-thread caches it hit) to a
+// fixed-size ring-buffer file, so real traffic can be replayed later against
+// another build with tools/ntreplay.
+//
+// The file is mapped and written in place: a captured call claims a record with
+// one atomic increment and stores 32 bytes, and once the ring is full the
+// oldest records are overwritten. While capture is off each entry point pays
+// one relaxed atomic load. Only outermost calls are recorded (nt_mustaches_range
+// calling nt_sun_events_for_date is one record), from every thread.
+//
+// Captured: nt_make_natural_date(_fixed), nt_sun_events_for_date,
+// nt_sun_position_for_date, nt_moon_events_for_date, nt_moon_position_for_date,
+// nt_mustaches_range, nt_moon_quarters_for_year and
+// nt_moon_illumination_for_year. Calls taking a natural date record its
+// unix_time and longitude, from which a replay rebuilds it.
+// POSIX only: elsewhere nt_capture_start returns NT_ERR_INTERNAL.
+
+#ifndef NATURAL_TIME_CAPTURE_H
+#define NATURAL_TIME_CAPTURE_H
+
+#include "natural_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NT_CAPTURE_FORMAT 1
+#define NT_CAPTURE_MAX_RECORDS (1u << 26)  // 2 GiB of records
+
+typedef enum {
+  NT_CALL_MAKE_NATURAL_DATE = 1,
+  NT_CALL_MAKE_NATURAL_DATE_FIXED,  // longitude holds the micro-degrees
+  NT_CALL_SUN_EVENTS,
+  NT_CALL_SUN_POSITION,
+  NT_CALL_MOON_EVENTS,
+  NT_CALL_MOON_POSITION,
+  NT_CALL_MUSTACHES,
+  NT_CALL_MOON_QUARTERS_FOR_YEAR,
+  NT_CALL_MOON_ILLUMINATION_FOR_YEAR,
+  NT_CALL_KINDS
+} nt_call_kind;
+
+// Bits of nt_capture_record.caches: a lookup in the thread's cache hit
+// (NT_CACHE_HIT_x) or missed (NT_CACHE_HIT_x << 4) during the call.
+#define NT_CACHE_HIT_SEASONS 0x1
+#define NT_CACHE_HIT_SUN_EVENTS 0x2
+#define NT_CACHE_HIT_MUSTACHES 0x4
+
+typedef struct {
+  int64_t unix_ms;      // the timestamp argument or nd->unix_time
+  double longitude;     // the longitude argument or nd->longitude
+  double latitude;      // 0 for calls without one
+  uint32_t latency_ns;  // saturates
+  uint8_t thread;       // small tag per recording thread (wraps at 256)
+  uint8_t call;         // nt_call_kind; 0 for a record claimed but never written
+  int8_t status;        // nt_err returned
+  uint8_t caches;
+} nt_capture_record;
+
+// Creates (or truncates) `path` with room for `capacity` records and starts
+// capturing from every thread. Fails with NT_ERR_RANGE while a capture runs.
+nt_err nt_capture_start(const char* path, uint32_t capacity);
+// Waits for calls being recorded, then unmaps the file. No-op when idle.
+void nt_capture_stop(void);
+int nt_capture_active(void);
+
+// Reads a capture file into a malloc'd array in call order (oldest first,
+// skipping unwritten records); `*out_dropped` receives the calls overwritten
+// by the ring. Free with nt_capture_free. Readable on every platform.
+nt_err nt_capture_load(const char* path, nt_capture_record** out, size_t* out_count, uint64_t* out_dropped);
+void nt_capture_free(nt_capture_record* records);
+// Writes records as a complete capture file (e.g. after anonymizing them).
+nt_err nt_capture_save(const char* path, const nt_capture_record* records, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATURAL_TIME_CAPTURE_H
@@ -0,0 +1,135 @@
+// Natural Time — Integer time split (v0.1)
+//
+// The scaled total behind nt_time_split_fixed, written once for both the C
+// library and the constexpr C++ layer (natural_time.hpp). Everything is 64-bit
+// integer arithmetic; the few exact ties go through 128-bit compares held as
+// hi:lo pairs. Not an API of its own: include natural_time.h and call
+// nt_time_split_fixed instead.
+#ifndef NATURAL_TIME_FIXED_H
+#define NATURAL_TIME_FIXED_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+#define NT_FIXED_FN constexpr inline
+#else
+#define NT_FIXED_FN static inline
+#endif
+
+#define NT_FIXED_MS_PER_DEGREE 240000  // 86400000 ms / 360
+
+typedef struct {
+  uint64_t hi, lo;
+} nt_fixed_u128;
+
+NT_FIXED_FN int nt_fixed_bit_length(uint64_t x) {
+  int n = 0;
+  if (x >> 32) { x >>= 32; n += 32; }
+  if (x >> 16) { x >>= 16; n += 16; }
+  if (x >> 8) { x >>= 8; n += 8; }
+  if (x >> 4) { x >>= 4; n += 4; }
+  if (x >> 2) { x >>= 2; n += 2; }
+  if (x >> 1) { x >>= 1; n += 1; }
+  return n + (int)x;
+}
+
+NT_FIXED_FN nt_fixed_u128 nt_fixed_mul(uint64_t a, uint64_t b) {
+  uint64_t a0 = a & 0xffffffffULL, a1 = a >> 32, b0 = b & 0xffffffffULL, b1 = b >> 32;
+  uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+  uint64_t mid = (p00 >> 32) + (p01 & 0xffffffffULL) + (p10 & 0xffffffffULL);
+  nt_fixed_u128 r = {p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32), (mid << 32) | (p00 & 0xffffffffULL)};
+  return r;
+}
+
+NT_FIXED_FN nt_fixed_u128 nt_fixed_shl(nt_fixed_u128 x, int n) {  // n in [0, 128)
+  nt_fixed_u128 r = x;
+  if (n >= 64) {
+    r.hi = x.lo << (n - 64);
+    r.lo = 0;
+  } else if (n > 0) {
+    r.hi = (x.hi << n) | (x.lo >> (64 - n));
+    r.lo = x.lo << n;
+  }
+  return r;
+}
+
+// a * 2^ea >= m * ((2q + 1) / 2 - c * 2^ec), or > when `strict`. Callers keep
+// every shifted term below 2^127.
+NT_FIXED_FN int nt_fixed_reaches(nt_fixed_u128 a, int ea, uint64_t m, uint64_t q, uint64_t c, int ec, int strict) {
+  int base = ea < ec ? ea : ec;
+  if (base > -1) base = -1;
+  nt_fixed_u128 lhs = nt_fixed_shl(a, ea - base);
+  nt_fixed_u128 tie = nt_fixed_shl(nt_fixed_mul(m, 2 * q + 1), -1 - base);
+  nt_fixed_u128 off = nt_fixed_shl(nt_fixed_mul(m, c), ec - base);
+  nt_fixed_u128 rhs = {tie.hi - off.hi - (tie.lo < off.lo), tie.lo - off.lo};
+  if (lhs.hi != rhs.hi) return lhs.hi > rhs.hi;
+  return strict ? lhs.lo > rhs.lo : lhs.lo >= rhs.lo;
+}
+
+// floor(ms * 2^s / NT_FIXED_MS_PER_DEGREE) and its remainder, for ms < 2^27
+// and s <= 71, in two 64-bit divisions.
+NT_FIXED_FN uint64_t nt_fixed_div_shifted(uint64_t ms, int s, uint64_t* rem) {
+  int s1 = s < 36 ? s : 36;
+  uint64_t n1 = ms << s1;
+  uint64_t n2 = (n1 % NT_FIXED_MS_PER_DEGREE) << (s - s1);
+  *rem = n2 % NT_FIXED_MS_PER_DEGREE;
+  return ((n1 / NT_FIXED_MS_PER_DEGREE) << (s - s1)) + n2 / NT_FIXED_MS_PER_DEGREE;
+}
+
+// Significand m and exponent -s of the double 10^-decimals (m in [2^52, 2^53)).
+NT_FIXED_FN uint64_t nt_fixed_unit(int decimals, int* s) {
+  switch (decimals) {
+    case 1: *s = 56; return 0x1999999999999aULL;
+    case 2: *s = 59; return 0x147ae147ae147bULL;
+    case 3: *s = 62; return 0x10624dd2f1a9fcULL;
+    case 4: *s = 66; return 0x1a36e2eb1c432dULL;
+    case 5: *s = 69; return 0x14f8b588e368f1ULL;
+    case 6: *s = 72; return 0x10c6f7a0b5ed8dULL;
+    default: *s = 52; return 0x10000000000000ULL;
+  }
+}
+
+// The double split's scaled total for an ms-of-day in [0, day) and decimals
+// in 0..6: time_deg = ms * 360.0 / 86400000, then llround(time_deg * 10^d), or
+// with unit rounding floor(time_deg / 10^-d + 0.5), each operation rounded.
+//
+// 💡 Exact value: v = ms * 10^d / 240000. Its fraction is a multiple of
+// 1/240000 and the double error stays below 2^-21, so away from exact ties
+// (fraction 1/2) the answer is floor(v + 0.5). At a tie the doubles' rounding
+// decides, so it is reproduced there: time_deg = m * 2^-s exactly, compared
+// with the threshold past which round-to-nearest lands on the tie.
+NT_FIXED_FN int64_t nt_fixed_time_total(int64_t ms_of_day, int decimals, int unit_rounding) {
+  uint64_t ms = (uint64_t)ms_of_day, scale = 1;
+  for (int i = 0; i < decimals; ++i) scale *= 10;
+  uint64_t q = ms * scale / NT_FIXED_MS_PER_DEGREE, r = ms * scale % NT_FIXED_MS_PER_DEGREE;
+  if (2 * r != NT_FIXED_MS_PER_DEGREE) return (int64_t)(q + (2 * r > NT_FIXED_MS_PER_DEGREE));
+
+  // time_deg = RN(ms / 240000) = m * 2^-s, and whether it fell below v / 10^d.
+  int s = 71 - nt_fixed_bit_length(ms);
+  uint64_t rem = 0, m = nt_fixed_div_shifted(ms, s, &rem);
+  if (m >> 53) m = nt_fixed_div_shifted(ms, --s, &rem);
+  int below = rem != 0;
+  if (2 * rem > NT_FIXED_MS_PER_DEGREE || (2 * rem == NT_FIXED_MS_PER_DEGREE && (m & 1u))) {
+    below = 0;
+    if (++m >> 53) {
+      m >>= 1;
+      --s;
+    }
+  }
+  // Half an ulp below the tie T = q + 1/2 (T = 1/2 is a power of two).
+  int half_ulp = nt_fixed_bit_length(2 * q + 1) - 2 - 53 - (q == 0);
+  if (!unit_rounding) {
+    // llround(RN(time_deg * 10^d)) is q + 1 once the product rounds to T.
+    if (!below) return (int64_t)q + 1;
+    return (int64_t)(q + nt_fixed_reaches(nt_fixed_mul(m, scale), -s, 1, q, 1, half_ulp, 0));
+  }
+  // floor(RN(RN(time_deg / u) + 0.5)) is q + 1 once the quotient rounds to T,
+  // or, for T = 1/2, to the double below it (the sum then ties up to 1).
+  int us = 0;
+  uint64_t um = nt_fixed_unit(decimals, &us);
+  nt_fixed_u128 tm = {0, m};
+  if (nt_fixed_reaches(tm, us - s, um, q, 1, half_ulp, 0)) return (int64_t)q + 1;
+  return (int64_t)(q + (q == 0 && nt_fixed_reaches(tm, us - s, um, q, 3, half_ulp, 1)));
+}
+
+#endif // NATURAL_TIME_FIXED_H
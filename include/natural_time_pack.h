@@ -0,0 +1,62 @@
+// Natural Time — Packed dates and columnar blocks (v0.1)
+//
+// nt_packed_date stores (unix_ms, longitude in micro-degrees) plus the three
+// values that need an astronomical lookup (natural year, day of year, year
+// length). Every other nt_natural_date field is integer arithmetic on those,
+// so unpacking is a tight loop without any solstice search.
+//
+// Blocks store packed dates column by column: timestamps as frame-of-reference
+// deltas bit-packed to the smallest width, longitudes as zig-zag deltas (zero
+// bits when constant) and derived bits run-length encoded. A sorted one-minute
+// log at a fixed longitude costs a few bytes per natural day.
+#ifndef NATURAL_TIME_PACK_H
+#define NATURAL_TIME_PACK_H
+
+#include "natural_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  int64_t  unix_ms;
+  int32_t  longitude_udeg;  // [-180e6, 180e6]
+  uint32_t bits;            // bit 31 valid, bit 30 leap (366 days), bits 18..29 year + 2048, bits 0..8 day_of_year
+} nt_packed_date;
+
+#define NT_PACKED_YEAR_MIN (-2048)
+#define NT_PACKED_YEAR_MAX 2047
+
+// nt_natural_date -> packed (longitude rounded to micro-degrees). NT_ERR_RANGE
+// for a year outside [NT_PACKED_YEAR_MIN, NT_PACKED_YEAR_MAX]; out[i] is then zeroed.
+nt_err nt_pack_dates(const nt_natural_date* in, nt_packed_date* out, size_t count);
+
+// Packs timestamps at one longitude without building nt_natural_date: the year
+// start is looked up once per natural year touched (any order; fastest sorted).
+nt_err nt_pack_unix_ms(const int64_t* unix_ms, size_t count, int32_t longitude_udeg, nt_packed_date* out);
+
+// Packed -> nt_natural_date, equal to nt_make_natural_date_fixed(unix_ms, longitude_udeg).
+// NT_ERR_RANGE if any entry is not valid (its output is zeroed).
+nt_err nt_unpack_dates(const nt_packed_date* in, nt_natural_date* out, size_t count);
+
+// Columnar blocks
+#define NT_BLOCK_HEADER_SIZE 40
+
+// Upper bound of the encoded size of `count` records.
+size_t nt_block_bound(size_t count);
+
+nt_err nt_block_write(const nt_packed_date* in, size_t count, uint8_t* out, size_t capacity, size_t* out_size);
+
+// Record count of an encoded block (validates the header).
+nt_err nt_block_count(const uint8_t* block, size_t size, size_t* out_count);
+
+nt_err nt_block_read(const uint8_t* block, size_t size, nt_packed_date* out, size_t capacity, size_t* out_count);
+
+// Timestamp column only (scans that filter on time before decoding the rest).
+nt_err nt_block_read_unix_ms(const uint8_t* block, size_t size, int64_t* out, size_t capacity, size_t* out_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATURAL_TIME_PACK_H
@@ -0,0 +1,86 @@
+// Natural Time — Upcoming-event scheduler (v0.1)
+//
+// Register subscriptions (location, event kinds, offset in natural degrees) and
+// pop due events in time order. Each subscription holds one pending entry in a
+// min-heap; its next natural day is computed lazily when the previous one is
+// exhausted, and subscribers in the same quantized location cell share that work.
+// Not thread-safe: use one scheduler per thread or lock around it.
+#ifndef NATURAL_TIME_SCHEDULER_H
+#define NATURAL_TIME_SCHEDULER_H
+
+#include "natural_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  NT_EVENT_NADIR          = 1u << 0,  // natural day begins (0°)
+  NT_EVENT_SUNRISE        = 1u << 1,
+  NT_EVENT_SUNSET         = 1u << 2,
+  NT_EVENT_NIGHT_START    = 1u << 3,  // sun crosses -12° going down
+  NT_EVENT_NIGHT_END      = 1u << 4,  // sun crosses -12° going up
+  NT_EVENT_MORNING_GOLDEN = 1u << 5,  // sun crosses +6° going up
+  NT_EVENT_EVENING_GOLDEN = 1u << 6,  // sun crosses +6° going down
+  NT_EVENT_RAINBOW_DAY    = 1u << 7,  // nadir of a rainbow day
+  NT_EVENT_NEW_MOON       = 1u << 8,
+  NT_EVENT_FIRST_QUARTER  = 1u << 9,
+  NT_EVENT_FULL_MOON      = 1u << 10,
+  NT_EVENT_LAST_QUARTER   = 1u << 11
+} nt_event_kind;
+
+// Returns the current time in ms UTC. Inject a fake clock to drive the scheduler offline.
+typedef int64_t (*nt_clock_fn)(void* ctx);
+
+typedef struct {
+  double   latitude;     // [-90, 90]
+  double   longitude;    // [-180, 180]
+  uint32_t kinds;        // OR of nt_event_kind
+  double   offset_deg;   // fire this many natural degrees before the event (-360, 360); negative = after
+  void*    user_data;    // returned with each event
+} nt_subscription;
+
+typedef struct {
+  uint32_t subscription_id;
+  uint32_t kind;           // one nt_event_kind bit
+  int64_t  fire_time;      // ms UTC = event_time - offset
+  int64_t  event_time;     // ms UTC of the event itself
+  double   event_deg;      // natural degree of the event in its day at the cell longitude
+  void*    user_data;
+} nt_scheduled_event;
+
+typedef struct {
+  size_t   subscriptions;  // active
+  size_t   locations;      // distinct quantized cells
+  uint64_t days_computed;  // natural days evaluated (shared across a cell)
+  size_t   pending;        // heap entries
+} nt_scheduler_stats;
+
+typedef struct nt_scheduler nt_scheduler;
+
+// `clock` may be NULL to use the system clock. `cell_deg` is the location
+// quantum (e.g. 0.01 ≈ 1 km, sunrise shifts < 3 s); <= 0 selects 0.01.
+nt_scheduler* nt_scheduler_create(nt_clock_fn clock, void* clock_ctx, double cell_deg);
+void nt_scheduler_destroy(nt_scheduler* s);
+
+// Events at or after the current clock time are scheduled; the id is never 0.
+nt_err nt_scheduler_subscribe(nt_scheduler* s, const nt_subscription* sub, uint32_t* out_id);
+nt_err nt_scheduler_unsubscribe(nt_scheduler* s, uint32_t id);
+
+// Pops up to `capacity` events with fire_time <= clock(), in (fire_time, id, kind) order,
+// and writes their number to *out_count; remaining due events stay queued.
+// NT_ERR_INTERNAL when the next event of a popped subscription cannot be scheduled
+// (out of memory or a failed day evaluation): the events written are still valid,
+// the rest stay queued, and that subscription fires no more until re-subscribed.
+nt_err nt_scheduler_pop_due(nt_scheduler* s, nt_scheduled_event* out, size_t capacity, size_t* out_count);
+
+// Earliest pending fire time (to sleep until). NT_ERR_RANGE when nothing is pending.
+nt_err nt_scheduler_next_fire_time(nt_scheduler* s, int64_t* out_ms);
+
+void nt_scheduler_get_stats(const nt_scheduler* s, nt_scheduler_stats* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATURAL_TIME_SCHEDULER_H
@@ -0,0 +1,60 @@
+// Natural Time — Shared-memory cache (v0.1)
+//
+// Seasons, per-day sun and moon events and mustaches shared by every process
+// on a host through a named POSIX shared-memory segment, so pre-forked workers
+// compute each popular location once instead of once per process. Lookups go
+// thread cache -> loaded snapshot -> segment -> ephemeris search, and fresh
+// results are published back.
+//
+// The segment is a fixed set of open-addressed tables sized at creation. Every
+// slot is guarded by its own seqlock word: readers never block or write, and a
+// writer claims a slot with one compare-and-swap (giving up on contention — it
+// is only a cache). A slot whose writer died mid-write stays invisible to
+// readers and is reclaimed by the next writer once the owner process is gone.
+//
+// Attach once per process, before spawning threads (attaching in the parent
+// before fork() shares the mapping with the children). Segments created by
+// another library version or build configuration are refused with NT_ERR_RANGE.
+// POSIX only: elsewhere nt_shm_attach returns NT_ERR_INTERNAL.
+
+#ifndef NATURAL_TIME_SHM_H
+#define NATURAL_TIME_SHM_H
+
+#include "natural_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NT_SHM_FORMAT 1
+#define NT_SHM_MAX_SLOTS (1u << 20)  // per table
+#define NT_SHM_PROBES 8              // slots tried per key before evicting
+
+typedef struct {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t publishes;
+  uint64_t evictions;   // publishes that replaced another key
+  uint64_t contended;   // lookups or publishes skipped on a slot another process was writing
+  uint64_t reclaimed;   // slots taken over from a writer that died
+} nt_shm_stats;
+
+// Opens the segment `name` ("/name" as for shm_open), creating it with `slots`
+// slots per table (rounded up to a power of two, at most NT_SHM_MAX_SLOTS) if
+// it does not exist; an existing segment keeps its own size. Replaces any
+// attached segment.
+nt_err nt_shm_attach(const char* name, uint32_t slots);
+void nt_shm_detach(void);
+// Removes the name; processes already attached keep their mapping.
+nt_err nt_shm_unlink(const char* name);
+
+// Counters of this process since it attached.
+void nt_shm_counters(nt_shm_stats* out);
+// Slots per table of the attached segment (0 when none).
+uint32_t nt_shm_slots(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATURAL_TIME_SHM_H
@@ -0,0 +1,64 @@
+// Natural Time — Cache snapshots (v0.1)
+//
+// Seasons, per-day sun and moon events and mustaches computed while recording
+// can be written to a versioned blob and loaded by the next process, so its
+// first requests are answered without an ephemeris search.
+//
+// A snapshot holds native-layout open-addressed tables: loading validates the
+// header (format, library version, build configuration, record layout and
+// table bounds) and then points at the data — one read, or an mmap on POSIX,
+// with no per-entry decoding. Anything that does not match exactly is
+// rejected with NT_ERR_RANGE and never used.
+//
+// Recording is per thread (like the library's caches); a loaded snapshot is
+// shared read-only by every thread. Load before other threads start querying,
+// and unload only when none are.
+
+#ifndef NATURAL_TIME_SNAPSHOT_H
+#define NATURAL_TIME_SNAPSHOT_H
+
+#include "natural_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NT_SNAPSHOT_FORMAT 1
+#define NT_SNAPSHOT_MAX_ENTRIES (1u << 20)  // per table; recording stops adding past this
+
+typedef struct {
+  uint32_t seasons;
+  uint32_t sun_events;
+  uint32_t moon_events;
+  uint32_t mustaches;
+} nt_snapshot_counts;
+
+// Starts (discarding anything recorded before) or stops recording results
+// computed or served from a loaded snapshot on the calling thread.
+void nt_snapshot_record(int enabled);
+// Frees the calling thread's recording.
+void nt_snapshot_discard(void);
+void nt_snapshot_recorded(nt_snapshot_counts* out);
+
+// Upper bound on the size of the blob nt_snapshot_write produces for the
+// current recording (repeated entries are only merged while writing).
+size_t nt_snapshot_bound(void);
+nt_err nt_snapshot_write(uint8_t* out, size_t capacity, size_t* out_size);
+nt_err nt_snapshot_save(const char* path);
+
+// The blob is used in place (8-byte aligned) and must stay valid until
+// nt_snapshot_unload or the next load. Replaces any loaded snapshot.
+nt_err nt_snapshot_load(const uint8_t* blob, size_t size);
+nt_err nt_snapshot_load_file(const char* path);
+void nt_snapshot_unload(void);
+// Entry counts of the loaded snapshot (zeros when none).
+void nt_snapshot_loaded(nt_snapshot_counts* out);
+// Lookups answered from a loaded snapshot on the calling thread since it
+// started (wraps past UINT32_MAX).
+void nt_snapshot_hits(nt_snapshot_counts* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATURAL_TIME_SNAPSHOT_H
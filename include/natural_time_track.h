@@ -0,0 +1,66 @@
+// Natural Time — Moving-observer tracks (v0.1)
+//
+// Natural date, sun altitude and sun events for every fix of a GPS track
+// (ships, flights, hikes). Instead of running the full rise/set/altitude
+// searches per fix, the processor keeps an anchor per natural day: the searches
+// run once at the anchor location, and each following fix refines the anchor's
+// event instants with a few Newton steps on an analytic altitude model (sun
+// right ascension/declination interpolated from hourly ephemeris nodes). The
+// anchor is rebuilt past the distance/time thresholds, at each new natural day,
+// and whenever the refinement cannot be trusted (event leaving the day, grazing
+// crossings, polar days/nights near their threshold).
+//
+// 💡 Error bound (against nt_sun_events_for_date / nt_sun_position_for_date with
+// the default 25 km threshold, ships/flights/hikes up to 70° latitude, see
+// tests/unit/test_track.c): event degrees within 0.001° (0.24 s, measured
+// 0.0005°), sun altitude within 0.001° above the horizon.
+#ifndef NATURAL_TIME_TRACK_H
+#define NATURAL_TIME_TRACK_H
+
+#include "natural_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  int64_t unix_ms;
+  double  latitude;    // [-90, 90]
+  double  longitude;   // [-180, 180]
+} nt_track_point;
+
+typedef struct {
+  double  max_distance_km;   // re-anchor beyond this great-circle distance (<= 0: 25 km)
+  int64_t max_interval_ms;   // re-anchor when the fix is this far from the anchor time (<= 0: only at day change)
+} nt_track_options;
+
+typedef struct {
+  nt_natural_date date;      // at the fix longitude
+  double sun_altitude;       // degrees, refracted; negative below the horizon (not clamped)
+  nt_sun_events sun;         // degrees within the fix's natural day, same defaults as nt_sun_events_for_date
+  int anchored;              // 1 when this fix ran the full event searches
+} nt_track_fix;
+
+typedef struct {
+  uint64_t points;
+  uint64_t anchors;          // full event searches
+  uint64_t ephemeris_nodes;  // hourly sun position evaluations
+} nt_track_stats;
+
+typedef struct nt_track nt_track;
+
+// `options` may be NULL for defaults.
+nt_track* nt_track_create(const nt_track_options* options);
+void nt_track_destroy(nt_track* t);
+
+// Processes `count` fixes in time order (chunks may follow each other). Stops at
+// the first invalid fix and returns its error; earlier outputs are filled.
+nt_err nt_track_process(nt_track* t, const nt_track_point* points, size_t count, nt_track_fix* out);
+
+void nt_track_get_stats(const nt_track* t, nt_track_stats* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATURAL_TIME_TRACK_H
@@ -94,6 +94,13 @@ public struct NaturalDate {
     }
 }
 
+/// Whether the body crosses an event threshold during the natural day (nt_polar_regime).
+public enum PolarRegime: Int32 {
+    case none = 0
+    case alwaysAbove = 1
+    case alwaysBelow = 2
+}
+
 public struct SunEvents {
     public let sunrise: Double
     public let sunset: Double
@@ -101,6 +108,9 @@ public struct SunEvents {
     public let nightEnd: Double
     public let morningGolden: Double
     public let eveningGolden: Double
+    public let horizonRegime: PolarRegime
+    public let nightRegime: PolarRegime
+    public let goldenRegime: PolarRegime
 }
 
 public struct SunPosition {
@@ -117,6 +127,7 @@ public struct MoonEvents {
     public let moonrise: Double
     public let moonset: Double
     public let highestAltitude: Double
+    public let horizonRegime: PolarRegime
 }
 
 public struct MustachesRange {
@@ -142,7 +153,10 @@ public func sunEvents(for nd: NaturalDate, latitude: Double) throws -> SunEvents
         nightStart: out.night_start_deg,
         nightEnd: out.night_end_deg,
         morningGolden: out.morning_golden_deg,
-        eveningGolden: out.evening_golden_deg
+        eveningGolden: out.evening_golden_deg,
+        horizonRegime: PolarRegime(rawValue: out.horizon_regime) ?? .none,
+        nightRegime: PolarRegime(rawValue: out.night_regime) ?? .none,
+        goldenRegime: PolarRegime(rawValue: out.golden_regime) ?? .none
     )
 }
 
@@ -164,7 +178,8 @@ public func moonEvents(for nd: NaturalDate, latitude: Double) throws -> MoonEven
     var c = nd.cStruct
     var out = nt_moon_events()
     try mapErr(nt_moon_events_for_date(&c, latitude, &out))
-    return MoonEvents(moonrise: out.moonrise_deg, moonset: out.moonset_deg, highestAltitude: out.highest_altitude)
+    return MoonEvents(moonrise: out.moonrise_deg, moonset: out.moonset_deg, highestAltitude: out.highest_altitude,
+                      horizonRegime: PolarRegime(rawValue: out.horizon_regime) ?? .none)
 }
 
 public func mustachesRange(for nd: NaturalDate, latitude: Double) throws -> MustachesRange {
@@ -1,4 +1,7 @@
 #include "natural_time.h"
+#include "natural_time_internal.h"
+#include "natural_time_capture.h"
+#include "natural_time_fixed.h"
 #include <math.h>
 #include <time.h>
 #include <string.h>
@@ -9,16 +12,27 @@
 // Constants
 static const int64_t MS_PER_DAY = 86400000LL;
 static const int64_t END_OF_ARTIFICIAL_TIME = 1356091200000LL; // 2012-12-21T12:00:00Z
+static const int64_t J2000_UNIX_MS = 946728000000LL;          // 2000-01-01T12:00:00Z
 
-// Simple caches (not thread-safe). These speed up repeated queries that
+// Simple per-thread caches. These speed up repeated queries that
 // occur frequently in UI loops without meaningfully changing results.
 typedef struct {
   int valid;
   int year;
   astro_seasons_t seasons;
 } seasons_cache_t;
-static seasons_cache_t g_seasons_cache_1 = {0};
-static seasons_cache_t g_seasons_cache_2 = {0};
+static NT_THREAD_LOCAL seasons_cache_t g_seasons_cache_1 = {0};
+static NT_THREAD_LOCAL seasons_cache_t g_seasons_cache_2 = {0};
+
+// New-year noon per artificial year, direct-mapped on the low bits of the year:
+// skips the UTC calendar conversions on every nt_make_natural_date call.
+typedef struct {
+  int valid;
+  int year;
+  int64_t noon_ms;
+} new_year_cache_t;
+#define NEW_YEAR_CACHE_SLOTS 4
+static NT_THREAD_LOCAL new_year_cache_t g_new_year_cache[NEW_YEAR_CACHE_SLOTS] = {{0}};
 
 typedef struct {
   int valid;
@@ -27,7 +41,7 @@ typedef struct {
   double longitude;
   nt_sun_events value;
 } sun_events_cache_t;
-static sun_events_cache_t g_sun_events_cache = {0};
+static NT_THREAD_LOCAL sun_events_cache_t g_sun_events_cache = {0};
 
 typedef struct {
   int valid;
@@ -35,57 +49,102 @@ typedef struct {
   double latitude;
   nt_mustaches value;
 } moustaches_cache_t;
-static moustaches_cache_t g_moustaches_cache = {0};
+static NT_THREAD_LOCAL moustaches_cache_t g_moustaches_cache = {0};
+
+// Quarters around one natural year, padded by ~two quarters on each side so
+// every longitude's year (and the interpolation points at its edges) is covered.
+#define MOON_QUARTERS_CACHE_CAP 64
+typedef struct {
+  int valid;
+  int year;
+  int count;
+  int32_t quarter[MOON_QUARTERS_CACHE_CAP];
+  int64_t unix_ms[MOON_QUARTERS_CACHE_CAP];
+} moon_quarters_cache_t;
+static NT_THREAD_LOCAL moon_quarters_cache_t g_moon_quarters_cache = {0};
+
+static NT_THREAD_LOCAL nt_cache_stats g_cache_stats = {0};
+
+// 💡 UTC calendar conversions in integer arithmetic (proleptic Gregorian,
+// days since 1970-01-01): no timegm/gmtime and no TZ juggling, so they are
+// reentrant on every libc and do not depend on the width of time_t.
+static int64_t days_from_civil(int64_t y, int m, int d) {
+  y -= (m <= 2);
+  int64_t era = (y >= 0 ? y : y - 399) / 400;
+  int64_t yoe = y - era * 400;
+  int64_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;  // days past the day overflow linearly
+  int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+static void civil_from_days(int64_t z, int *y, int *m, int *d) {
+  z += 719468;
+  int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  int64_t doe = z - era * 146097;
+  int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  int64_t mp = (5 * doy + 2) / 153;
+  *d = (int)(doy - (153 * mp + 2) / 5 + 1);
+  *m = (int)(mp < 10 ? mp + 3 : mp - 9);
+  *y = (int)(yoe + era * 400 + (*m <= 2));
+}
 
-// 💡 timegm converts a UTC struct tm to Unix seconds since epoch.
-// It exists on macOS; provide a fallback shim if needed.
 static int64_t to_unix_ms_utc(int y, int m, int d, int hh, int mm, int ss, int ms) {
-  struct tm tmv;
-  memset(&tmv, 0, sizeof(tmv));
-  tmv.tm_year = y - 1900;
-  tmv.tm_mon  = m - 1;
-  tmv.tm_mday = d;
-  tmv.tm_hour = hh;
-  tmv.tm_min  = mm;
-  tmv.tm_sec  = ss;
-#if defined(_BSD_SOURCE) || defined(__APPLE__) || defined(__GNU_LIBRARY__)
-  time_t secs = timegm(&tmv);
-#else
-  // Fallback: temporarily set TZ to UTC
-  char *old_tz = getenv("TZ");
-  setenv("TZ", "UTC", 1);
-  tzset();
-  time_t secs = mktime(&tmv);
-  if (old_tz) { setenv("TZ", old_tz, 1); } else { unsetenv("TZ"); }
-  tzset();
-#endif
-  return (int64_t)secs * 1000LL + (int64_t)ms;
+  return (((days_from_civil(y, m, d) * 24 + hh) * 60 + mm) * 60 + ss) * 1000LL + ms;
+}
+
+// Whole seconds since the epoch -> UTC date and seconds of that day.
+static void utc_from_unix_seconds(int64_t secs, int *y, int *m, int *d, int *second_of_day) {
+  int64_t days = secs / 86400, sod = secs % 86400;
+  if (sod < 0) { sod += 86400; days -= 1; }
+  civil_from_days(days, y, m, d);
+  *second_of_day = (int)sod;
 }
 
 static astro_time_t astro_time_from_unix_ms(int64_t unix_ms) {
-  time_t secs = (time_t)(unix_ms / 1000LL);
+  int64_t secs = unix_ms / 1000LL;
   int ms = (int)(unix_ms % 1000LL);
   if (ms < 0) { ms += 1000; secs -= 1; }
-  struct tm *gmt = gmtime(&secs);
   astro_utc_t utc;
-  utc.year = gmt->tm_year + 1900;
-  utc.month = gmt->tm_mon + 1;
-  utc.day = gmt->tm_mday;
-  utc.hour = gmt->tm_hour;
-  utc.minute = gmt->tm_min;
-  utc.second = (double)gmt->tm_sec + (ms / 1000.0);
+  int sod;
+  utc_from_unix_seconds(secs, &utc.year, &utc.month, &utc.day, &sod);
+  utc.hour = sod / 3600;
+  utc.minute = sod / 60 % 60;
+  utc.second = (double)(sod % 60) + (ms / 1000.0);
   return Astronomy_TimeFromUtc(utc);
 }
 
 static astro_seasons_t seasons_for_year(int year) {
   // Two-entry cache with trivial eviction.
   if (g_seasons_cache_1.valid && g_seasons_cache_1.year == year) {
+    g_cache_stats.seasons_hits++;
     return g_seasons_cache_1.seasons;
   }
   if (g_seasons_cache_2.valid && g_seasons_cache_2.year == year) {
+    g_cache_stats.seasons_hits++;
     return g_seasons_cache_2.seasons;
   }
-  astro_seasons_t s = Astronomy_Seasons(year);
+  g_cache_stats.seasons_misses++;
+  astro_seasons_t s;
+  nt_seasons_record rec;
+  int from_snapshot = nt_internal_snapshot_seasons(year, &rec);  // already recorded
+  if (from_snapshot || nt_internal_shm_seasons(year, &rec)) {
+    s.status = ASTRO_SUCCESS;
+    s.mar_equinox = Astronomy_TimeFromDays(rec.ut[0]);
+    s.jun_solstice = Astronomy_TimeFromDays(rec.ut[1]);
+    s.sep_equinox = Astronomy_TimeFromDays(rec.ut[2]);
+    s.dec_solstice = Astronomy_TimeFromDays(rec.ut[3]);
+  } else {
+    s = Astronomy_Seasons(year);
+    rec.year = year;
+    rec.status = (s.status == ASTRO_SUCCESS) ? 0 : 1;
+    rec.ut[0] = s.mar_equinox.ut;
+    rec.ut[1] = s.jun_solstice.ut;
+    rec.ut[2] = s.sep_equinox.ut;
+    rec.ut[3] = s.dec_solstice.ut;
+    nt_internal_publish_seasons(&rec);
+  }
+  if (!from_snapshot) nt_internal_record_seasons(&rec);
   // Evict the older cache slot.
   g_seasons_cache_2 = g_seasons_cache_1;
   g_seasons_cache_1.valid = 1;
@@ -95,46 +154,29 @@ static astro_seasons_t seasons_for_year(int year) {
 }
 
 static void add_days_to_utc(int *y, int *m, int *d, int days) {
-  // Normalize by constructing a tm and letting timegm handle rollovers
-  struct tm tmv;
-  memset(&tmv, 0, sizeof(tmv));
-  tmv.tm_year = *y - 1900;
-  tmv.tm_mon  = *m - 1;
-  tmv.tm_mday = *d + days;
-  tmv.tm_hour = 12; // keep midday to avoid DST issues in local conversions
-#if defined(_BSD_SOURCE) || defined(__APPLE__) || defined(__GNU_LIBRARY__)
-  time_t secs = timegm(&tmv);
-#else
-  char *old_tz = getenv("TZ");
-  setenv("TZ", "UTC", 1);
-  tzset();
-  time_t secs = mktime(&tmv);
-  if (old_tz) { setenv("TZ", old_tz, 1); } else { unsetenv("TZ"); }
-  tzset();
-#endif
-  struct tm *gmt = gmtime(&secs);
-  *y = gmt->tm_year + 1900;
-  *m = gmt->tm_mon + 1;
-  *d = gmt->tm_mday;
+  civil_from_days(days_from_civil(*y, *m, *d) + days, y, m, d);
+}
+
+// 12:00 UTC on the December solstice date of `artificial_year` (next day if the
+// solstice falls at or after noon): the natural new year at longitude 180.
+static int64_t new_year_noon_ms(int artificial_year) {
+  new_year_cache_t *slot = &g_new_year_cache[(unsigned)artificial_year % NEW_YEAR_CACHE_SLOTS];
+  if (slot->valid && slot->year == artificial_year) return slot->noon_ms;
+  astro_seasons_t s = seasons_for_year(artificial_year);
+  astro_utc_t u = Astronomy_UtcFromTime(s.dec_solstice);
+  int y = u.year, m = u.month, d = u.day;
+  double sol_hour = u.hour + (u.minute/60.0) + (u.second/3600.0);
+  if (sol_hour >= 12.0) add_days_to_utc(&y, &m, &d, 1);
+  slot->valid = 1;
+  slot->year = artificial_year;
+  slot->noon_ms = to_unix_ms_utc(y, m, d, 12, 0, 0, 0);
+  return slot->noon_ms;
 }
 
 static int64_t calculate_year_start_ms(int artificial_year, double longitude_deg, int *out_duration_days) {
   // Get December solstices for Y and Y+1 (cached)
-  astro_seasons_t s0 = seasons_for_year(artificial_year);
-  astro_seasons_t s1 = seasons_for_year(artificial_year + 1);
-  astro_utc_t u0 = Astronomy_UtcFromTime(s0.dec_solstice);
-  astro_utc_t u1 = Astronomy_UtcFromTime(s1.dec_solstice);
-
-  // Start new year: 12:00 UTC on solstice date; if solstice hour >= 12, use next day at 12:00
-  int y0 = u0.year, m0 = u0.month, d0 = u0.day;
-  double sol0_hour = u0.hour + (u0.minute/60.0) + (u0.second/3600.0);
-  if (sol0_hour >= 12.0) add_days_to_utc(&y0, &m0, &d0, 1);
-  int64_t startNewYear = to_unix_ms_utc(y0, m0, d0, 12, 0, 0, 0);
-
-  int y1 = u1.year, m1 = u1.month, d1 = u1.day;
-  double sol1_hour = u1.hour + (u1.minute/60.0) + (u1.second/3600.0);
-  if (sol1_hour >= 12.0) add_days_to_utc(&y1, &m1, &d1, 1);
-  int64_t endNewYear = to_unix_ms_utc(y1, m1, d1, 12, 0, 0, 0);
+  int64_t startNewYear = new_year_noon_ms(artificial_year);
+  int64_t endNewYear = new_year_noon_ms(artificial_year + 1);
 
   int duration = (int)((endNewYear - startNewYear) / MS_PER_DAY);
   if (out_duration_days) *out_duration_days = duration; // 365 or 366
@@ -144,34 +186,51 @@ static int64_t calculate_year_start_ms(int artificial_year, double longitude_deg
   return (int64_t)llround((double)startNewYear + shift_ms);
 }
 
+// 💡 Integer longitude shift: (180° - lon) days/360 with lon in micro-degrees is
+// (180e6 - lon_udeg) * 6/25 ms. The remainder is a multiple of 1/25, never exactly
+// one half, so rounding matches llround of the double shift.
+static int64_t fixed_shift_x25(int32_t longitude_udeg) {
+  return (180000000LL - (int64_t)longitude_udeg) * 6LL;
+}
+
+static int64_t calculate_year_start_ms_fixed(int artificial_year, int32_t longitude_udeg, int *out_duration_days) {
+  int64_t startNewYear = new_year_noon_ms(artificial_year);
+  int64_t endNewYear = new_year_noon_ms(artificial_year + 1);
+  if (out_duration_days) *out_duration_days = (int)((endNewYear - startNewYear) / MS_PER_DAY);
+  return startNewYear + (fixed_shift_x25(longitude_udeg) + 12) / 25;
+}
+
+static int64_t floor_div_i64(int64_t a, int64_t b) {
+  int64_t q = a / b;
+  return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
 static int utc_year_from_unix_ms(int64_t unix_ms) {
-  time_t secs = (time_t)(unix_ms / 1000LL);
-  struct tm *gmt = gmtime(&secs);
-  return gmt->tm_year + 1900;
+  int y, m, d, sod;
+  utc_from_unix_seconds(unix_ms / 1000LL, &y, &m, &d, &sod);
+  return y;
 }
 
 void nt_reset_caches(void) {
   Astronomy_Reset();
   // Invalidate local caches
   g_seasons_cache_1.valid = 0; g_seasons_cache_2.valid = 0;
+  memset(g_new_year_cache, 0, sizeof(g_new_year_cache));
   g_sun_events_cache.valid = 0;
   g_moustaches_cache.valid = 0;
+  g_moon_quarters_cache.valid = 0;
 }
 
-nt_err nt_make_natural_date(int64_t unix_ms_utc, double longitude_deg, nt_natural_date* out) {
-  if (!out) return NT_ERR_INTERNAL;
-  if (!(longitude_deg >= -180.0 && longitude_deg <= 180.0)) return NT_ERR_RANGE;
-  if (unix_ms_utc <= 0) return NT_ERR_TIME;
-
-  // Establish year context using the same two-step approach as JS (Y-1 then maybe Y).
-  int utc_year = utc_year_from_unix_ms(unix_ms_utc);
-  int duration_days = 365;
-  int64_t year_start_ms = calculate_year_start_ms(utc_year - 1, longitude_deg, &duration_days);
-  if (unix_ms_utc - year_start_ms >= (int64_t)duration_days * MS_PER_DAY) {
-    year_start_ms = calculate_year_start_ms(utc_year, longitude_deg, &duration_days);
-  }
+void nt_cache_counters(nt_cache_stats* out) {
+  if (out) *out = g_cache_stats;
+}
 
-  double time_since_year_start_days = (double)(unix_ms_utc - year_start_ms) / (double)MS_PER_DAY;
+// Day/week/moon derivation shared by the double and fixed-point entry points.
+// Integer floor division gives exactly the JS floor(ms / MS_PER_DAY / n) results:
+// at these magnitudes the double quotient can never round across an integer.
+static void fill_natural_date(int64_t unix_ms_utc, double longitude_deg, int64_t year_start_ms,
+                              int duration_days, int64_t eat_local, nt_natural_date* out) {
+  int64_t whole_days = (unix_ms_utc - year_start_ms) / MS_PER_DAY; // >= 0
 
   // Populate fields mirroring JS logic
   out->unix_time = unix_ms_utc;
@@ -183,25 +242,71 @@ nt_err nt_make_natural_date(int64_t unix_ms_utc, double longitude_deg, nt_natura
   int eat_year = utc_year_from_unix_ms(END_OF_ARTIFICIAL_TIME);
   out->year = year_start_utc_year - eat_year + 1;
 
-  out->moon = (int32_t)floor(time_since_year_start_days / 28.0) + 1;
-  out->week = (int32_t)floor(time_since_year_start_days / 7.0) + 1;
-  out->week_of_moon = (int32_t)fmod(floor(time_since_year_start_days / 7.0), 4.0) + 1;
+  out->moon = (int32_t)(whole_days / 28) + 1;
+  out->week = (int32_t)(whole_days / 7) + 1;
+  out->week_of_moon = (int32_t)((whole_days / 7) % 4) + 1;
 
-  int64_t eat_local = END_OF_ARTIFICIAL_TIME + (int64_t)((-longitude_deg + 180.0) * (double)MS_PER_DAY / 360.0);
-  out->day = (int32_t)floor((double)(unix_ms_utc - eat_local) / (double)MS_PER_DAY);
-  out->day_of_year = (int32_t)floor(time_since_year_start_days) + 1;
-  out->day_of_moon = (int32_t)fmod(floor(time_since_year_start_days), 28.0) + 1;
-  out->day_of_week = (int32_t)fmod(floor(time_since_year_start_days), 7.0) + 1;
+  out->day = (int32_t)floor_div_i64(unix_ms_utc - eat_local, MS_PER_DAY);
+  out->day_of_year = (int32_t)whole_days + 1;
+  out->day_of_moon = (int32_t)(whole_days % 28) + 1;
+  out->day_of_week = (int32_t)(whole_days % 7) + 1;
 
-  out->nadir = year_start_ms + (int64_t)floor(time_since_year_start_days) * MS_PER_DAY;
+  out->nadir = year_start_ms + whole_days * MS_PER_DAY;
   out->time_deg = ((double)(unix_ms_utc - out->nadir)) * 360.0 / (double)MS_PER_DAY;
   if (out->time_deg >= 360.0) out->time_deg = 0.0; // formatting wrap safeguard
 
   out->is_rainbow_day = (out->day_of_year > 13 * 28) ? 1 : 0;
+}
 
+static nt_err make_natural_date_fixed(int64_t unix_ms_utc, int32_t longitude_udeg, nt_natural_date* out) {
+  if (!out) return NT_ERR_INTERNAL;
+  if (longitude_udeg < -180000000 || longitude_udeg > 180000000) return NT_ERR_RANGE;
+  if (unix_ms_utc <= 0) return NT_ERR_TIME;
+
+  int utc_year = utc_year_from_unix_ms(unix_ms_utc);
+  int duration_days = 365;
+  int64_t year_start_ms = calculate_year_start_ms_fixed(utc_year - 1, longitude_udeg, &duration_days);
+  if (unix_ms_utc - year_start_ms >= (int64_t)duration_days * MS_PER_DAY) {
+    year_start_ms = calculate_year_start_ms_fixed(utc_year, longitude_udeg, &duration_days);
+  }
+  int64_t eat_local = END_OF_ARTIFICIAL_TIME + fixed_shift_x25(longitude_udeg) / 25;
+  fill_natural_date(unix_ms_utc, (double)longitude_udeg / 1e6, year_start_ms, duration_days, eat_local, out);
+  return NT_OK;
+}
+
+nt_err nt_make_natural_date_fixed(int64_t unix_ms_utc, int32_t longitude_udeg, nt_natural_date* out) {
+  NT_CAPTURED(NT_CALL_MAKE_NATURAL_DATE_FIXED, unix_ms_utc, (double)longitude_udeg, 0.0,
+              make_natural_date_fixed(unix_ms_utc, longitude_udeg, out));
+}
+
+static nt_err make_natural_date(int64_t unix_ms_utc, double longitude_deg, nt_natural_date* out) {
+  if (!out) return NT_ERR_INTERNAL;
+  if (!(longitude_deg >= -180.0 && longitude_deg <= 180.0)) return NT_ERR_RANGE;
+  if (unix_ms_utc <= 0) return NT_ERR_TIME;
+
+#if defined(NT_FIXED_POINT)
+  // Whole micro-degrees take the integer path (same results); any other
+  // longitude is kept as given and takes the double path below.
+  int32_t longitude_udeg = (int32_t)llround(longitude_deg * 1e6);
+  if ((double)longitude_udeg / 1e6 == longitude_deg) return make_natural_date_fixed(unix_ms_utc, longitude_udeg, out);
+#endif
+  // Establish year context using the same two-step approach as JS (Y-1 then maybe Y).
+  int utc_year = utc_year_from_unix_ms(unix_ms_utc);
+  int duration_days = 365;
+  int64_t year_start_ms = calculate_year_start_ms(utc_year - 1, longitude_deg, &duration_days);
+  if (unix_ms_utc - year_start_ms >= (int64_t)duration_days * MS_PER_DAY) {
+    year_start_ms = calculate_year_start_ms(utc_year, longitude_deg, &duration_days);
+  }
+  int64_t eat_local = END_OF_ARTIFICIAL_TIME + (int64_t)((-longitude_deg + 180.0) * (double)MS_PER_DAY / 360.0);
+  fill_natural_date(unix_ms_utc, longitude_deg, year_start_ms, duration_days, eat_local, out);
   return NT_OK;
 }
 
+nt_err nt_make_natural_date(int64_t unix_ms_utc, double longitude_deg, nt_natural_date* out) {
+  NT_CAPTURED(NT_CALL_MAKE_NATURAL_DATE, unix_ms_utc, longitude_deg, 0.0,
+              make_natural_date(unix_ms_utc, longitude_deg, out));
+}
+
 nt_err nt_get_time_of_event(const nt_natural_date* nd, int64_t event_unix_ms_utc, double* out_deg_or_nan) {
   if (!nd || !out_deg_or_nan) return NT_ERR_INTERNAL;
   // Convert an event timestamp to natural degrees within current natural day; return 0 if out of range.
@@ -225,69 +330,221 @@ static int is_summer_season(int day_of_year, double latitude_deg) {
   }
 }
 
-static double event_time_or_default(const nt_natural_date* nd, astro_search_result_t res, int is_summer, int is_summer_default) {
-  if (res.status != ASTRO_SUCCESS) {
-    if (is_summer) {
-      return is_summer_default ? 360.0 : 0.0;
-    } else {
-      return 180.0;
-    }
-  }
-  astro_utc_t u = Astronomy_UtcFromTime(res.time);
-  int64_t ms = to_unix_ms_utc(u.year, u.month, u.day, u.hour, u.minute, (int)floor(u.second), (int)round((u.second - floor(u.second)) * 1000.0));
-  double deg = 0.0;
-  nt_get_time_of_event(nd, ms, &deg);
-  return deg;
+static int64_t unix_ms_from_astro_time(astro_time_t t) {
+  astro_utc_t u = Astronomy_UtcFromTime(t);
+  return to_unix_ms_utc(u.year, u.month, u.day, u.hour, u.minute, (int)floor(u.second), (int)round((u.second - floor(u.second)) * 1000.0));
 }
 
-nt_err nt_sun_events_for_date(const nt_natural_date* nd, double latitude_deg, nt_sun_events* out) {
+// -------------------------
+// Polar regimes
+// -------------------------
+// 💡 A failing search is the slowest call we make: it steps through the whole
+// window in RISE_SET_DT slices and refines every slice. The body's geocentric
+// declination range over the window bounds its altitude for the day (upper
+// culmination 90 - |lat - dec|, lower culmination |lat + dec| - 90), so when a
+// threshold lies outside those bounds with margin no search can succeed and we
+// return the defaults immediately. Inconclusive cases still search, so results
+// are unchanged.
+
+#define POLAR_MARGIN_DEG 0.05
+// Rise/set compares the top of the disc with -34' of refraction: center threshold
+// -34/60 - semidiameter, over the yearly/monthly semidiameter range.
+static const double SUN_HORIZON_LO = -0.5667 - 0.2716, SUN_HORIZON_HI = -0.5667 - 0.2620;
+static const double MOON_HORIZON_LO = -0.5667 - 0.2795, MOON_HORIZON_HI = -0.5667 - 0.2448;
+static const double SUN_PARALLAX_MAX = 0.0025, MOON_PARALLAX_MAX = 1.025;  // topocentric altitude drop
+// Declination between/after the three samples can exceed them by at most this much.
+static const double SUN_DEC_SLACK = 0.01, MOON_DEC_SLACK = 0.1;
+
+// Declination range over the search window from three samples (one batch).
+static void declination_range(const nt_sky_window *w, double slack, double *dmin, double *dmax) {
+  double ut[NT_SKY_BEGIN_EVALUATIONS] = {w->ut0, w->ut0 + 0.5 * w->days, w->ut0 + w->days};
+  nt_sky_sample s[NT_SKY_BEGIN_EVALUATIONS];
+  nt_internal_sky_eval(w, ut, NT_SKY_BEGIN_EVALUATIONS, s);
+  *dmin = fmin(s[0].dec_deg, fmin(s[1].dec_deg, s[2].dec_deg)) - slack;
+  *dmax = fmax(s[0].dec_deg, fmax(s[1].dec_deg, s[2].dec_deg)) + slack;
+}
+
+static double distance_to_interval(double x, double lo, double hi) {
+  return (x < lo) ? lo - x : (x > hi) ? x - hi : 0.0;
+}
+
+static int32_t classify_threshold(double latitude_deg, double dmin, double dmax,
+                                  double thr_lo, double thr_hi, double parallax_max) {
+  double alt_max = 90.0 - distance_to_interval(latitude_deg, dmin, dmax);
+  double alt_min = distance_to_interval(-latitude_deg, dmin, dmax) - 90.0 - parallax_max;
+  if (alt_max + POLAR_MARGIN_DEG < thr_lo) return NT_POLAR_ALWAYS_BELOW;
+  if (alt_min - POLAR_MARGIN_DEG > thr_hi) return NT_POLAR_ALWAYS_ABOVE;
+  return NT_POLAR_NONE;
+}
+
+// Both searches of a threshold failed inside the margin: the side at the start decides.
+static int32_t regime_from_altitude(const nt_sky_window *w, double threshold) {
+  nt_sky_sample s;
+  nt_internal_sky_eval(w, &w->ut0, 1, &s);
+  return (s.altitude_deg >= threshold) ? NT_POLAR_ALWAYS_ABOVE : NT_POLAR_ALWAYS_BELOW;
+}
+
+// -------------------------
+// Event searches
+// -------------------------
+// 💡 The rise/set and altitude searches run through the batched series
+// (natural_time_series.c): every search of a day shares one probe grid, and the
+// Sun/Moon series are evaluated four instants per call instead of one, with
+// the vendor's bracketing rules. Roots agree with Astronomy_SearchRiseSetEx /
+// Astronomy_SearchAltitude within their 0.1 s tolerance, so event angles drift
+// from the vendor's by up to 0.0005° (they are not bit-identical).
+
+static double ut_days_from_unix_ms(int64_t unix_ms) {
+  return (double)(unix_ms - J2000_UNIX_MS) / (double)MS_PER_DAY;
+}
+
+static int64_t unix_ms_from_ut_days(double ut) {
+  return J2000_UNIX_MS + (int64_t)llround(ut * (double)MS_PER_DAY);
+}
+
+// Top-of-disc altitude of rise/set at sea level (Astronomy_SearchRiseSetEx).
+static double rise_set_altitude(void) {
+  return -(34.0 / 60.0) * Astronomy_Atmosphere(0.0).density;
+}
+
+static const double SUN_LIMIT_DAYS[NT_SUN_THRESHOLD_COUNT] = {1.0, 2.0, 2.0};
+static const double SUN_THR_LO[NT_SUN_THRESHOLD_COUNT] = {SUN_HORIZON_LO, -12.0, 6.0};
+static const double SUN_THR_HI[NT_SUN_THRESHOLD_COUNT] = {SUN_HORIZON_HI, -12.0, 6.0};
+
+nt_err nt_internal_sun_search_begin(const nt_natural_date* nd, double latitude_deg, nt_sun_search* out) {
   if (!nd || !out) return NT_ERR_INTERNAL;
   if (!(latitude_deg >= -90.0 && latitude_deg <= 90.0)) return NT_ERR_RANGE;
 
+  // Rise/set search 1 day, night (-12°) and golden hour (+6°) 2 days ahead.
+  nt_sky_window win;
+  nt_err err = nt_internal_sky_window(&win, NT_SKY_SUN, latitude_deg, nd->longitude, ut_days_from_unix_ms(nd->nadir), 2.0);
+  if (err != NT_OK) return err;
+  double dmin, dmax;
+  declination_range(&win, SUN_DEC_SLACK, &dmin, &dmax);
+
+  nt_sky_crossing q[NT_SUN_EVENT_COUNT];
+  size_t nq = 0;
+  for (int k = 0; k < NT_SUN_THRESHOLD_COUNT; ++k) {
+    out->regime[k] = classify_threshold(latitude_deg, dmin, dmax, SUN_THR_LO[k], SUN_THR_HI[k], SUN_PARALLAX_MAX);
+    for (int j = 0; j < 2; ++j) {
+      int i = 2 * k + j;
+      out->query_of[i] = -1;
+      if (out->regime[k] != NT_POLAR_NONE) continue;
+      // Events 2k / 2k+1: rise then set (night: set then rise, the -12° crossing going down starts the night).
+      int rising = (k == NT_SUN_NIGHT) ? (j == 1) : (j == 0);
+      q[nq].target_deg = (k == NT_SUN_HORIZON) ? rise_set_altitude() : SUN_THR_LO[k];
+      q[nq].direction = rising ? +1 : -1;
+      q[nq].disc = (k == NT_SUN_HORIZON);
+      q[nq].limit_days = SUN_LIMIT_DAYS[k];
+      out->query_of[i] = (int)nq++;
+    }
+  }
+  nt_internal_sky_search_begin(&out->search, &win, q, nq);
+  return NT_OK;
+}
+
+void nt_internal_sun_search_times(const nt_sun_search* s, nt_sun_event_times* out) {
+  const nt_sky_crossing* q = s->search.q;
+  for (int k = 0; k < NT_SUN_THRESHOLD_COUNT; ++k) {
+    out->regime[k] = s->regime[k];
+    for (int j = 0; j < 2; ++j) {
+      int i = 2 * k + j;
+      out->found[i] = 0;
+      out->unix_ms[i] = 0;
+      if (s->query_of[i] < 0 || !q[s->query_of[i]].found) continue;
+      out->found[i] = 1;
+      out->unix_ms[i] = unix_ms_from_ut_days(q[s->query_of[i]].ut);
+    }
+    if (out->regime[k] == NT_POLAR_NONE && !out->found[2 * k] && !out->found[2 * k + 1]) {
+      out->regime[k] = regime_from_altitude(&s->search.w, 0.5 * (SUN_THR_LO[k] + SUN_THR_HI[k]));
+    }
+  }
+}
+
+nt_err nt_internal_sun_event_times(const nt_natural_date* nd, double latitude_deg, nt_sun_event_times* out) {
+  if (!out) return NT_ERR_INTERNAL;
+  nt_sun_search s;
+  nt_err err = nt_internal_sun_search_begin(nd, latitude_deg, &s);
+  if (err != NT_OK) return err;
+  nt_internal_sky_search_run(&s.search, NULL);
+  nt_internal_sun_search_times(&s, out);
+  return NT_OK;
+}
+
+void nt_internal_sun_events_from_times(const nt_natural_date* nd, double latitude_deg,
+                                       const nt_sun_event_times* times, nt_sun_events* out) {
+  // Failed searches: 180° in winter (always dark/light through the day), else the
+  // day edge on the side the event would have been (0° for rises, 360° for sets).
+  static const int summer_default_end[NT_SUN_EVENT_COUNT] = {0, 1, 1, 0, 0, 1};
+  double* deg[NT_SUN_EVENT_COUNT] = {&out->sunrise_deg, &out->sunset_deg, &out->night_start_deg,
+                                     &out->night_end_deg, &out->morning_golden_deg, &out->evening_golden_deg};
+  int summer = is_summer_season(nd->day_of_year, latitude_deg);
+  for (int i = 0; i < NT_SUN_EVENT_COUNT; ++i) {
+    if (!times->found[i]) {
+      *deg[i] = summer ? (summer_default_end[i] ? 360.0 : 0.0) : 180.0;
+    } else {
+      nt_get_time_of_event(nd, times->unix_ms[i], deg[i]);
+    }
+  }
+  out->horizon_regime = times->regime[NT_SUN_HORIZON];
+  out->night_regime = times->regime[NT_SUN_NIGHT];
+  out->golden_regime = times->regime[NT_SUN_GOLDEN];
+}
+
+int nt_internal_cached_sun_events(const nt_natural_date* nd, double latitude_deg, nt_sun_events* out) {
   // Cache by (nadir day, latitude, longitude)
   if (g_sun_events_cache.valid &&
       g_sun_events_cache.nadir == nd->nadir &&
       g_sun_events_cache.latitude == latitude_deg &&
       g_sun_events_cache.longitude == nd->longitude) {
+    g_cache_stats.sun_events_hits++;
     *out = g_sun_events_cache.value;
-    return NT_OK;
+    return 1;
   }
+  g_cache_stats.sun_events_misses++;
+  if (nt_internal_snapshot_sun_events(nd->nadir, latitude_deg, nd->longitude, out)) {
+    nt_internal_store_sun_events(nd, latitude_deg, out, 0);
+    return 1;
+  }
+  if (nt_internal_shm_sun_events(nd->nadir, latitude_deg, nd->longitude, out)) {
+    nt_internal_record_sun_events(nd->nadir, latitude_deg, nd->longitude, out);
+    nt_internal_store_sun_events(nd, latitude_deg, out, 0);
+    return 1;
+  }
+  return 0;
+}
 
-  astro_observer_t obs = Astronomy_MakeObserver(latitude_deg, nd->longitude, 0.0);
-  astro_time_t nadir_time = astro_time_from_unix_ms(nd->nadir);
-  int summer = is_summer_season(nd->day_of_year, latitude_deg);
-
-  // Sunrise
-  astro_search_result_t rise = Astronomy_SearchRiseSetEx(BODY_SUN, obs, DIRECTION_RISE, nadir_time, 1.0, 0.0);
-  // Sunset
-  astro_search_result_t set = Astronomy_SearchRiseSetEx(BODY_SUN, obs, DIRECTION_SET, nadir_time, 1.0, 0.0);
-  // Night start: when altitude crosses -12 going down
-  astro_search_result_t night_start = Astronomy_SearchAltitude(BODY_SUN, obs, DIRECTION_SET, nadir_time, 2.0, -12.0);
-  // Night end: when altitude crosses -12 going up
-  astro_search_result_t night_end = Astronomy_SearchAltitude(BODY_SUN, obs, DIRECTION_RISE, nadir_time, 2.0, -12.0);
-  // Morning golden hour: altitude crosses +6 going up
-  astro_search_result_t morning_golden = Astronomy_SearchAltitude(BODY_SUN, obs, DIRECTION_RISE, nadir_time, 2.0, +6.0);
-  // Evening golden hour: altitude crosses +6 going down
-  astro_search_result_t evening_golden = Astronomy_SearchAltitude(BODY_SUN, obs, DIRECTION_SET, nadir_time, 2.0, +6.0);
-
-  out->sunrise_deg = event_time_or_default(nd, rise, summer, 0);
-  out->sunset_deg = event_time_or_default(nd, set, summer, 1);
-  out->night_start_deg = event_time_or_default(nd, night_start, summer, 1);
-  out->night_end_deg = event_time_or_default(nd, night_end, summer, 0);
-  out->morning_golden_deg = event_time_or_default(nd, morning_golden, summer, 0);
-  out->evening_golden_deg = event_time_or_default(nd, evening_golden, summer, 1);
-
-  // Store cache
+void nt_internal_store_sun_events(const nt_natural_date* nd, double latitude_deg, const nt_sun_events* v, int computed) {
+  if (computed) {
+    nt_internal_publish_sun_events(nd->nadir, latitude_deg, nd->longitude, v);
+    nt_internal_record_sun_events(nd->nadir, latitude_deg, nd->longitude, v);
+  }
   g_sun_events_cache.valid = 1;
   g_sun_events_cache.nadir = nd->nadir;
   g_sun_events_cache.latitude = latitude_deg;
   g_sun_events_cache.longitude = nd->longitude;
-  g_sun_events_cache.value = *out;
+  g_sun_events_cache.value = *v;
+}
 
+static nt_err sun_events_for_date(const nt_natural_date* nd, double latitude_deg, nt_sun_events* out) {
+  if (!nd || !out) return NT_ERR_INTERNAL;
+  if (!(latitude_deg >= -90.0 && latitude_deg <= 90.0)) return NT_ERR_RANGE;
+  if (nt_internal_cached_sun_events(nd, latitude_deg, out)) return NT_OK;
+
+  nt_sun_event_times times;
+  nt_err err = nt_internal_sun_event_times(nd, latitude_deg, &times);
+  if (err != NT_OK) return err;
+  nt_internal_sun_events_from_times(nd, latitude_deg, &times, out);
+  nt_internal_store_sun_events(nd, latitude_deg, out, 1);
   return NT_OK;
 }
 
-nt_err nt_sun_position_for_date(const nt_natural_date* nd, double latitude_deg, nt_sun_position* out) {
+nt_err nt_sun_events_for_date(const nt_natural_date* nd, double latitude_deg, nt_sun_events* out) {
+  NT_CAPTURED(NT_CALL_SUN_EVENTS, nd ? nd->unix_time : 0, nd ? nd->longitude : 0.0, latitude_deg,
+              sun_events_for_date(nd, latitude_deg, out));
+}
+
+static nt_err sun_position_for_date(const nt_natural_date* nd, double latitude_deg, nt_sun_position* out) {
   if (!nd || !out) return NT_ERR_INTERNAL;
   if (!(latitude_deg >= -90.0 && latitude_deg <= 90.0)) return NT_ERR_RANGE;
 
@@ -309,7 +566,12 @@ nt_err nt_sun_position_for_date(const nt_natural_date* nd, double latitude_deg,
   return NT_OK;
 }
 
-nt_err nt_moon_position_for_date(const nt_natural_date* nd, double latitude_deg, nt_moon_position* out) {
+nt_err nt_sun_position_for_date(const nt_natural_date* nd, double latitude_deg, nt_sun_position* out) {
+  NT_CAPTURED(NT_CALL_SUN_POSITION, nd ? nd->unix_time : 0, nd ? nd->longitude : 0.0, latitude_deg,
+              sun_position_for_date(nd, latitude_deg, out));
+}
+
+static nt_err moon_position_for_date(const nt_natural_date* nd, double latitude_deg, nt_moon_position* out) {
   if (!nd || !out) return NT_ERR_INTERNAL;
   if (!(latitude_deg >= -90.0 && latitude_deg <= 90.0)) return NT_ERR_RANGE;
 
@@ -330,54 +592,90 @@ nt_err nt_moon_position_for_date(const nt_natural_date* nd, double latitude_deg,
   return NT_OK;
 }
 
-nt_err nt_moon_events_for_date(const nt_natural_date* nd, double latitude_deg, nt_moon_events* out) {
+nt_err nt_moon_position_for_date(const nt_natural_date* nd, double latitude_deg, nt_moon_position* out) {
+  NT_CAPTURED(NT_CALL_MOON_POSITION, nd ? nd->unix_time : 0, nd ? nd->longitude : 0.0, latitude_deg,
+              moon_position_for_date(nd, latitude_deg, out));
+}
+
+nt_err nt_internal_moon_search_begin(const nt_natural_date* nd, double latitude_deg, nt_moon_search* out) {
   if (!nd || !out) return NT_ERR_INTERNAL;
   if (!(latitude_deg >= -90.0 && latitude_deg <= 90.0)) return NT_ERR_RANGE;
 
-  astro_observer_t obs = Astronomy_MakeObserver(latitude_deg, nd->longitude, 0.0);
-  astro_time_t nadir_time = astro_time_from_unix_ms(nd->nadir);
-
-  astro_search_result_t moonrise = Astronomy_SearchRiseSetEx(BODY_MOON, obs, DIRECTION_RISE, nadir_time, 1.0, 0.0);
-  astro_search_result_t moonset  = Astronomy_SearchRiseSetEx(BODY_MOON, obs, DIRECTION_SET,  nadir_time, 1.0, 0.0);
-  astro_hour_angle_t transit = Astronomy_SearchHourAngleEx(BODY_MOON, obs, 0.0, nadir_time, +1);
+  nt_sky_window win;
+  nt_err err = nt_internal_sky_window(&win, NT_SKY_MOON, latitude_deg, nd->longitude, ut_days_from_unix_ms(nd->nadir), 1.0);
+  if (err != NT_OK) return err;
+  double dmin, dmax;
+  declination_range(&win, MOON_DEC_SLACK, &dmin, &dmax);
+  out->regime = classify_threshold(latitude_deg, dmin, dmax, MOON_HORIZON_LO, MOON_HORIZON_HI, MOON_PARALLAX_MAX);
+  nt_sky_crossing q[2];  // rise, set
+  for (int j = 0; j < 2; ++j) {
+    q[j].target_deg = rise_set_altitude();
+    q[j].direction = (j == 0) ? +1 : -1;
+    q[j].disc = 1;
+    q[j].limit_days = 1.0;
+  }
+  nt_internal_sky_search_begin(&out->search, &win, q, (out->regime == NT_POLAR_NONE) ? 2 : 0);
+  return NT_OK;
+}
 
-  // Convert found times to degrees within natural day, else 0
-  double to_deg_val = 0.0;
-  if (moonrise.status == ASTRO_SUCCESS) {
-    astro_utc_t u = Astronomy_UtcFromTime(moonrise.time);
-    int64_t ms = to_unix_ms_utc(u.year, u.month, u.day, u.hour, u.minute, (int)floor(u.second), (int)round((u.second - floor(u.second)) * 1000.0));
-    nt_get_time_of_event(nd, ms, &to_deg_val);
-    out->moonrise_deg = to_deg_val;
-  } else {
-    out->moonrise_deg = 0.0;
+// Rise/set degrees and the regime of a finished search.
+void nt_internal_moon_search_events(const nt_natural_date* nd, const nt_moon_search* s, nt_moon_events* out) {
+  const nt_sky_crossing* q = s->search.q;
+  int32_t regime = s->regime;
+  int rise = s->search.count > 0 && q[0].found, set = s->search.count > 1 && q[1].found;
+  if (regime == NT_POLAR_NONE && !rise && !set) {
+    regime = regime_from_altitude(&s->search.w, 0.5 * (MOON_HORIZON_LO + MOON_HORIZON_HI));
   }
-  if (moonset.status == ASTRO_SUCCESS) {
-    astro_utc_t u = Astronomy_UtcFromTime(moonset.time);
-    int64_t ms = to_unix_ms_utc(u.year, u.month, u.day, u.hour, u.minute, (int)floor(u.second), (int)round((u.second - floor(u.second)) * 1000.0));
-    nt_get_time_of_event(nd, ms, &to_deg_val);
-    out->moonset_deg = to_deg_val;
-  } else {
-    out->moonset_deg = 0.0;
+  // Convert found times to degrees within natural day, else 0
+  out->moonrise_deg = 0.0;
+  out->moonset_deg = 0.0;
+  if (rise) nt_get_time_of_event(nd, unix_ms_from_ut_days(q[0].ut), &out->moonrise_deg);
+  if (set) nt_get_time_of_event(nd, unix_ms_from_ut_days(q[1].ut), &out->moonset_deg);
+  out->horizon_regime = regime;
+}
+
+double nt_internal_moon_transit_altitude(const nt_natural_date* nd, double latitude_deg) {
+  astro_observer_t obs = Astronomy_MakeObserver(latitude_deg, nd->longitude, 0.0);
+  astro_hour_angle_t transit = Astronomy_SearchHourAngleEx(BODY_MOON, obs, 0.0, astro_time_from_unix_ms(nd->nadir), +1);
+  return (transit.status == ASTRO_SUCCESS) ? transit.hor.altitude : 0.0;
+}
+
+int nt_internal_cached_moon_events(const nt_natural_date* nd, double latitude_deg, nt_moon_events* out) {
+  if (nt_internal_snapshot_moon_events(nd->nadir, latitude_deg, nd->longitude, out)) return 1;
+  if (nt_internal_shm_moon_events(nd->nadir, latitude_deg, nd->longitude, out)) {
+    nt_internal_record_moon_events(nd->nadir, latitude_deg, nd->longitude, out);
+    return 1;
   }
-  out->highest_altitude = (transit.status == ASTRO_SUCCESS) ? transit.hor.altitude : 0.0;
-  return NT_OK;
+  return 0;
 }
 
-nt_err nt_mustaches_range(const nt_natural_date* nd, double latitude_deg, nt_mustaches* out) {
+void nt_internal_store_moon_events(const nt_natural_date* nd, double latitude_deg, const nt_moon_events* v) {
+  nt_internal_publish_moon_events(nd->nadir, latitude_deg, nd->longitude, v);
+  nt_internal_record_moon_events(nd->nadir, latitude_deg, nd->longitude, v);
+}
+
+static nt_err moon_events_for_date(const nt_natural_date* nd, double latitude_deg, nt_moon_events* out) {
   if (!nd || !out) return NT_ERR_INTERNAL;
   if (!(latitude_deg >= -90.0 && latitude_deg <= 90.0)) return NT_ERR_RANGE;
+  if (nt_internal_cached_moon_events(nd, latitude_deg, out)) return NT_OK;
+
+  nt_moon_search s;
+  nt_err err = nt_internal_moon_search_begin(nd, latitude_deg, &s);
+  if (err != NT_OK) return err;
+  nt_internal_sky_search_run(&s.search, NULL);
+  nt_internal_moon_search_events(nd, &s, out);
+  out->highest_altitude = nt_internal_moon_transit_altitude(nd, latitude_deg);
+  nt_internal_store_moon_events(nd, latitude_deg, out);
+  return NT_OK;
+}
 
-  int current_year = utc_year_from_unix_ms(nd->unix_time);
-
-  // Cache by (year, latitude)
-  if (g_moustaches_cache.valid &&
-      g_moustaches_cache.year == current_year &&
-      g_moustaches_cache.latitude == latitude_deg) {
-    *out = g_moustaches_cache.value;
-    return NT_OK;
-  }
+nt_err nt_moon_events_for_date(const nt_natural_date* nd, double latitude_deg, nt_moon_events* out) {
+  NT_CAPTURED(NT_CALL_MOON_EVENTS, nd ? nd->unix_time : 0, nd ? nd->longitude : 0.0, latitude_deg,
+              moon_events_for_date(nd, latitude_deg, out));
+}
 
-  astro_seasons_t seasons = seasons_for_year(current_year);
+static nt_err compute_mustaches(int year, double latitude_deg, nt_mustaches* out) {
+  astro_seasons_t seasons = seasons_for_year(year);
   if (seasons.status != ASTRO_SUCCESS) return NT_ERR_INTERNAL;
 
   // Build NaturalDate at exact solstice instants at longitude 0 (as in JS), then compute sun events at given latitude.
@@ -409,6 +707,32 @@ nt_err nt_mustaches_range(const nt_natural_date* nd, double latitude_deg, nt_mus
   out->summer_sunrise_deg = sse.sunrise_deg;
   out->summer_sunset_deg = sse.sunset_deg;
   out->average_angle_deg = avg;
+  return NT_OK;
+}
+
+static nt_err mustaches_range(const nt_natural_date* nd, double latitude_deg, nt_mustaches* out) {
+  if (!nd || !out) return NT_ERR_INTERNAL;
+  if (!(latitude_deg >= -90.0 && latitude_deg <= 90.0)) return NT_ERR_RANGE;
+
+  int current_year = utc_year_from_unix_ms(nd->unix_time);
+
+  // Cache by (year, latitude)
+  if (g_moustaches_cache.valid &&
+      g_moustaches_cache.year == current_year &&
+      g_moustaches_cache.latitude == latitude_deg) {
+    g_cache_stats.mustaches_hits++;
+    *out = g_moustaches_cache.value;
+    return NT_OK;
+  }
+  g_cache_stats.mustaches_misses++;
+  if (!nt_internal_snapshot_mustaches(current_year, latitude_deg, out)) {
+    if (!nt_internal_shm_mustaches(current_year, latitude_deg, out)) {
+      nt_err err = compute_mustaches(current_year, latitude_deg, out);
+      if (err != NT_OK) return err;
+      nt_internal_publish_mustaches(current_year, latitude_deg, out);
+    }
+    nt_internal_record_mustaches(current_year, latitude_deg, out);
+  }
 
   // Store cache
   g_moustaches_cache.valid = 1;
@@ -418,6 +742,145 @@ nt_err nt_mustaches_range(const nt_natural_date* nd, double latitude_deg, nt_mus
   return NT_OK;
 }
 
+nt_err nt_mustaches_range(const nt_natural_date* nd, double latitude_deg, nt_mustaches* out) {
+  NT_CAPTURED(NT_CALL_MUSTACHES, nd ? nd->unix_time : 0, nd ? nd->longitude : 0.0, latitude_deg,
+              mustaches_range(nd, latitude_deg, out));
+}
+
+// Appends every quarter in [start_ms, end_ms) to the parallel arrays; returns the
+// number found (may exceed capacity, extra events are counted but not stored).
+static int search_moon_quarters(int64_t start_ms, int64_t end_ms, int32_t *quarter, int64_t *unix_ms, int capacity, nt_err *err) {
+  int count = 0;
+  astro_moon_quarter_t mq = Astronomy_SearchMoonQuarter(astro_time_from_unix_ms(start_ms));
+  while (mq.status == ASTRO_SUCCESS) {
+    int64_t ms = unix_ms_from_astro_time(mq.time);
+    if (ms >= end_ms) return count;
+    if (count < capacity) {
+      quarter[count] = mq.quarter;
+      unix_ms[count] = ms;
+    }
+    count++;
+    mq = Astronomy_NextMoonQuarter(mq);
+  }
+  *err = NT_ERR_INTERNAL;
+  return count;
+}
+
+static const moon_quarters_cache_t *moon_quarters_for_year(const nt_natural_date* nd, nt_err *err) {
+  if (g_moon_quarters_cache.valid && g_moon_quarters_cache.year == nd->year) {
+    return &g_moon_quarters_cache;
+  }
+  // Year starts at other longitudes differ by at most one day; quarters are at most
+  // ~8.3 days apart, and illumination interpolation needs two quarters outside the year.
+  int64_t pad = 18 * MS_PER_DAY;
+  int64_t start = nd->year_start - pad;
+  int64_t end = nd->year_start + (int64_t)nd->year_duration * MS_PER_DAY + pad;
+  *err = NT_OK;
+  g_moon_quarters_cache.valid = 0;
+  int n = search_moon_quarters(start, end, g_moon_quarters_cache.quarter, g_moon_quarters_cache.unix_ms, MOON_QUARTERS_CACHE_CAP, err);
+  if (*err != NT_OK || n > MOON_QUARTERS_CACHE_CAP) { *err = NT_ERR_INTERNAL; return NULL; }
+  g_moon_quarters_cache.valid = 1;
+  g_moon_quarters_cache.year = nd->year;
+  g_moon_quarters_cache.count = n;
+  return &g_moon_quarters_cache;
+}
+
+static nt_err fill_moon_quarter(int32_t quarter, int64_t unix_ms, double longitude_deg, nt_moon_quarter *out) {
+  nt_natural_date at;
+  if (nt_make_natural_date(unix_ms, longitude_deg, &at) != NT_OK) return NT_ERR_INTERNAL;
+  out->quarter = quarter;
+  out->day_of_year = at.day_of_year;
+  out->unix_time = unix_ms;
+  out->time_deg = at.time_deg;
+  return NT_OK;
+}
+
+static nt_err moon_quarters_in_year(const nt_natural_date* nd, nt_moon_quarter* out, size_t capacity, size_t* out_count) {
+  if (!nd || !out_count || (!out && capacity > 0)) return NT_ERR_INTERNAL;
+  nt_err err = NT_OK;
+  const moon_quarters_cache_t *c = moon_quarters_for_year(nd, &err);
+  if (!c) return err;
+
+  int64_t year_end = nd->year_start + (int64_t)nd->year_duration * MS_PER_DAY;
+  size_t n = 0;
+  for (int i = 0; i < c->count; ++i) {
+    if (c->unix_ms[i] < nd->year_start || c->unix_ms[i] >= year_end) continue;
+    if (n < capacity) {
+      // Inside the year: natural fields follow directly from the year start.
+      int64_t since = c->unix_ms[i] - nd->year_start;
+      int64_t nadir = nd->year_start + (since / MS_PER_DAY) * MS_PER_DAY;
+      out[n].quarter = c->quarter[i];
+      out[n].day_of_year = (int32_t)(since / MS_PER_DAY) + 1;
+      out[n].unix_time = c->unix_ms[i];
+      out[n].time_deg = ((double)(c->unix_ms[i] - nadir)) * 360.0 / (double)MS_PER_DAY;
+    }
+    n++;
+  }
+  *out_count = n;
+  return (n > capacity) ? NT_ERR_RANGE : NT_OK;
+}
+
+nt_err nt_moon_quarters_for_year(const nt_natural_date* nd, nt_moon_quarter* out, size_t capacity, size_t* out_count) {
+  NT_CAPTURED(NT_CALL_MOON_QUARTERS_FOR_YEAR, nd ? nd->unix_time : 0, nd ? nd->longitude : 0.0, 0.0,
+              moon_quarters_in_year(nd, out, capacity, out_count));
+}
+
+nt_err nt_moon_quarters_range(int64_t start_ms_utc, int64_t end_ms_utc, double longitude_deg,
+                              nt_moon_quarter* out, size_t capacity, size_t* out_count) {
+  if (!out_count || (!out && capacity > 0)) return NT_ERR_INTERNAL;
+  if (!(longitude_deg >= -180.0 && longitude_deg <= 180.0)) return NT_ERR_RANGE;
+  if (start_ms_utc <= 0 || end_ms_utc < start_ms_utc) return NT_ERR_TIME;
+
+  size_t n = 0;
+  astro_moon_quarter_t mq = Astronomy_SearchMoonQuarter(astro_time_from_unix_ms(start_ms_utc));
+  while (1) {
+    if (mq.status != ASTRO_SUCCESS) return NT_ERR_INTERNAL;
+    int64_t ms = unix_ms_from_astro_time(mq.time);
+    if (ms >= end_ms_utc) break;
+    if (n < capacity && fill_moon_quarter(mq.quarter, ms, longitude_deg, &out[n]) != NT_OK) return NT_ERR_INTERNAL;
+    n++;
+    mq = Astronomy_NextMoonQuarter(mq);
+  }
+  *out_count = n;
+  return (n > capacity) ? NT_ERR_RANGE : NT_OK;
+}
+
+static nt_err moon_illumination_for_year(const nt_natural_date* nd, double* out_fraction, size_t capacity, size_t* out_count) {
+  if (!nd || !out_count || (!out_fraction && capacity > 0)) return NT_ERR_INTERNAL;
+  nt_err err = NT_OK;
+  const moon_quarters_cache_t *c = moon_quarters_for_year(nd, &err);
+  if (!c) return err;
+
+  size_t days = (size_t)nd->year_duration;
+  int i = 1;
+  for (size_t d = 0; d < days && d < capacity; ++d) {
+    int64_t t = nd->year_start + (int64_t)d * MS_PER_DAY + MS_PER_DAY / 2;
+    while (i + 3 < c->count && c->unix_ms[i + 1] <= t) i++;
+    if (c->unix_ms[i] > t || c->unix_ms[i + 1] < t) return NT_ERR_INTERNAL;
+    // Elongation advances 90° per quarter: cubic Lagrange fit of elongation(time)
+    // through the two quarters bracketing t and their outer neighbours.
+    double elong = 0.0;
+    for (int j = -1; j <= 2; ++j) {
+      double w = 1.0;
+      for (int k = -1; k <= 2; ++k) {
+        if (k == j) continue;
+        w *= (double)(t - c->unix_ms[i + k]) / (double)(c->unix_ms[i + j] - c->unix_ms[i + k]);
+      }
+      elong += w * 90.0 * (c->quarter[i] + j);
+    }
+    // The variation term (0.658° sin 2D) vanishes at every quarter, so the fit cannot see it; add it back.
+    elong += 0.6583 * sin(2.0 * elong * DEG2RAD);
+    out_fraction[d] = (1.0 - cos(elong * DEG2RAD)) / 2.0;
+  }
+  *out_count = days;
+  return (days > capacity) ? NT_ERR_RANGE : NT_OK;
+}
+
+nt_err nt_moon_illumination_for_year(const nt_natural_date* nd, double* out_fraction, size_t capacity, size_t* out_count) {
+  NT_CAPTURED(NT_CALL_MOON_ILLUMINATION_FOR_YEAR, nd ? nd->unix_time : 0, nd ? nd->longitude : 0.0, 0.0,
+              moon_illumination_for_year(nd, out_fraction, capacity, out_count));
+}
+
 
 // -------------------------
 // Formatting helpers (C API)
@@ -432,10 +895,21 @@ static void safe_snprintf(char* buffer, size_t buffer_size, const char* fmt, ...
   buffer[buffer_size - 1] = '\0';
 }
 
+// Same text as snprintf("%d") without the format parser (hot in bulk formatting).
+static int int_to_dec(char* out, int value) {
+  char rev[16];
+  int n = 0, len = 0;
+  unsigned int u = (value < 0) ? 0u - (unsigned int)value : (unsigned int)value;
+  do { rev[n++] = (char)('0' + u % 10u); u /= 10u; } while (u > 0u);
+  if (value < 0) out[len++] = '-';
+  while (n > 0) out[len++] = rev[--n];
+  out[len] = '\0';
+  return len;
+}
+
 static void pad_left_int(char* out, size_t out_size, int value, int width) {
   char tmp[64];
-  snprintf(tmp, sizeof(tmp), "%d", value);
-  int len = (int)strlen(tmp);
+  int len = int_to_dec(tmp, value);
   if (len >= width) {
     safe_snprintf(out, out_size, "%s", tmp);
     return;
@@ -500,10 +974,8 @@ nt_err nt_format_time_string(const nt_natural_date* nd, int decimals, double rou
     return NT_OK;
   }
   // fraction padded to 'decimals' digits
-  char fracFmt[16];
-  snprintf(fracFmt, sizeof(fracFmt), "%%0%dd", decimals);
   char fracBuf[16];
-  snprintf(fracBuf, sizeof(fracBuf), fracFmt, frac);
+  pad_left_int(fracBuf, sizeof(fracBuf), frac, decimals);
   safe_snprintf(buffer, buffer_size, "%s°%s", intBuf, fracBuf);
   return NT_OK;
 }
@@ -565,6 +1037,31 @@ nt_err nt_format_string(const nt_natural_date* nd, int time_decimals, double tim
   return NT_OK;
 }
 
+static nt_err time_split_fixed(const nt_natural_date* nd, int decimals, int unit_rounding,
+                               int32_t* out_integer, int32_t* out_fraction, int32_t* out_scale) {
+  if (!nd || !out_integer || !out_fraction || !out_scale) return NT_ERR_RANGE;
+  if (decimals < 0) decimals = 0;
+  if (decimals > 6) decimals = 6;
+  int64_t ms_of_day = (nd->unix_time - nd->nadir) % MS_PER_DAY;  // days outside the date wrap
+  if (ms_of_day < 0) ms_of_day += MS_PER_DAY;
+  int32_t scale = 1;
+  for (int i = 0; i < decimals; ++i) scale *= 10;
+  int64_t total = nt_fixed_time_total(ms_of_day, decimals, unit_rounding);
+  if (total >= (int64_t)360 * scale) total -= (int64_t)360 * scale;
+  *out_integer = (int32_t)(total / scale);
+  *out_fraction = (int32_t)(total % scale);
+  *out_scale = scale;
+  return NT_OK;
+}
+
+nt_err nt_time_split_fixed(const nt_natural_date* nd,
+                           int decimals,
+                           int32_t* out_integer,
+                           int32_t* out_fraction,
+                           int32_t* out_scale) {
+  return time_split_fixed(nd, decimals, 1, out_integer, out_fraction, out_scale);
+}
+
 nt_err nt_time_split_scaled(const nt_natural_date* nd,
                              int decimals,
                              double rounding,
@@ -574,6 +1071,16 @@ nt_err nt_time_split_scaled(const nt_natural_date* nd,
   if (!nd || !out_integer || !out_fraction || !out_scale) return NT_ERR_RANGE;
   if (decimals < 0) decimals = 0;
   if (decimals > 6) decimals = 6;
+#if defined(NT_FIXED_POINT)
+  // Integer-only mode: the default rounding (one unit of the last decimal) or none
+  // comes from the ms-of-day; other increments and times outside the date fall
+  // through to the double path.
+  static const double unit_increment[7] = {1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001};
+  int64_t ms_of_day = nd->unix_time - nd->nadir;
+  if ((rounding <= 0.0 || rounding == unit_increment[decimals]) && ms_of_day >= 0 && ms_of_day < MS_PER_DAY) {
+    return time_split_fixed(nd, decimals, rounding > 0.0, out_integer, out_fraction, out_scale);
+  }
+#endif
   double t = nd->time_deg;
   if (rounding > 0) {
     t = round_to_increment(t, rounding);
@@ -0,0 +1,485 @@
+#include "natural_time_async.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#define NT_ASYNC_EVENTFD 1
+#endif
+
+static const int64_t MS_PER_DAY = 86400000LL;
+
+#define TABLE_BUCKETS 256 // power of two; chains stay short for UI-sized bursts
+
+typedef struct waiter_t {
+  uint64_t handle;
+  void* user_data;
+  struct job_t* job;
+  struct waiter_t* next;   // job's waiters, in submission order
+  struct waiter_t* hnext;  // handle table chain
+} waiter_t;
+
+// Coalescing key: day-level for events/mustaches, exact bounds for ranges.
+typedef struct {
+  int kind;
+  int64_t k;
+  int64_t end;
+  double lon;
+  double lat;
+} job_key_t;
+
+typedef struct job_t {
+  job_key_t key;
+  nt_async_request req;    // first submitter's request (same key => same result)
+  int priority;
+  uint64_t seq;
+  size_t heap_index;
+  int running;
+  waiter_t* waiters;
+  waiter_t* waiters_tail;
+  struct job_t* knext;     // key table chain
+} job_t;
+
+struct nt_async_queue {
+  pthread_mutex_t mu;
+  pthread_cond_t work_cv;
+  int stop;
+
+  pthread_t* threads;
+  int nthreads;
+
+  nt_async_callback callback;
+  void* callback_ctx;
+
+  job_t** heap;
+  size_t heap_len, heap_cap;
+  job_t* keys[TABLE_BUCKETS];
+  waiter_t* handles[TABLE_BUCKETS];
+  uint64_t next_handle;
+  uint64_t next_seq;
+
+  nt_async_completion* done;  // ring buffer
+  size_t done_head, done_len, done_cap;
+  size_t done_reserved;       // completions still owed to waiters; the ring always has room for them
+  int wake_rd, wake_wr;       // same fd with eventfd
+
+  nt_async_stats stats;
+};
+
+// -------------------------
+// Tables
+// -------------------------
+
+static size_t key_bucket(const job_key_t* k) {
+  uint64_t a, b;
+  memcpy(&a, &k->lon, sizeof(a));
+  memcpy(&b, &k->lat, sizeof(b));
+  uint64_t h = (uint64_t)k->kind * 0x9E3779B97F4A7C15ULL ^ (uint64_t)k->k;
+  h = (h ^ (h >> 31)) * 0xBF58476D1CE4E5B9ULL ^ (uint64_t)k->end ^ a;
+  h = (h ^ (h >> 29)) * 0x94D049BB133111EBULL ^ b;
+  return (size_t)((h ^ (h >> 32)) & (TABLE_BUCKETS - 1));
+}
+
+static int key_equal(const job_key_t* x, const job_key_t* y) {
+  return x->kind == y->kind && x->k == y->k && x->end == y->end && x->lon == y->lon && x->lat == y->lat;
+}
+
+static void key_remove(nt_async_queue* q, job_t* j) {
+  job_t** p = &q->keys[key_bucket(&j->key)];
+  while (*p && *p != j) p = &(*p)->knext;
+  if (*p) *p = j->knext;
+}
+
+static waiter_t** handle_slot(nt_async_queue* q, uint64_t handle) {
+  waiter_t** p = &q->handles[handle & (TABLE_BUCKETS - 1)];
+  while (*p && (*p)->handle != handle) p = &(*p)->hnext;
+  return p;
+}
+
+// -------------------------
+// Priority heap (max priority, then FIFO)
+// -------------------------
+
+static int job_before(const job_t* a, const job_t* b) {
+  if (a->priority != b->priority) return a->priority > b->priority;
+  return a->seq < b->seq;
+}
+
+static void heap_set(nt_async_queue* q, size_t i, job_t* j) {
+  q->heap[i] = j;
+  j->heap_index = i;
+}
+
+static void sift_up(nt_async_queue* q, size_t i) {
+  job_t* j = q->heap[i];
+  while (i > 0) {
+    size_t parent = (i - 1) / 2;
+    if (!job_before(j, q->heap[parent])) break;
+    heap_set(q, i, q->heap[parent]);
+    i = parent;
+  }
+  heap_set(q, i, j);
+}
+
+static void sift_down(nt_async_queue* q, size_t i) {
+  job_t* j = q->heap[i];
+  for (;;) {
+    size_t c = 2 * i + 1;
+    if (c >= q->heap_len) break;
+    if (c + 1 < q->heap_len && job_before(q->heap[c + 1], q->heap[c])) c++;
+    if (!job_before(q->heap[c], j)) break;
+    heap_set(q, i, q->heap[c]);
+    i = c;
+  }
+  heap_set(q, i, j);
+}
+
+static int heap_push(nt_async_queue* q, job_t* j) {
+  if (q->heap_len == q->heap_cap) {
+    size_t cap = q->heap_cap ? q->heap_cap * 2 : 64;
+    job_t** h = (job_t**)realloc(q->heap, cap * sizeof(job_t*));
+    if (!h) return 0;
+    q->heap = h;
+    q->heap_cap = cap;
+  }
+  q->heap[q->heap_len] = j;
+  sift_up(q, q->heap_len++);
+  return 1;
+}
+
+static void heap_remove(nt_async_queue* q, size_t i) {
+  q->heap_len--;
+  if (i == q->heap_len) return;
+  job_t* moved = q->heap[q->heap_len];
+  heap_set(q, i, moved);
+  sift_down(q, i);
+  sift_up(q, moved->heap_index);
+}
+
+// -------------------------
+// Completions
+// -------------------------
+
+static void wake_set(nt_async_queue* q) {
+#if defined(NT_ASYNC_EVENTFD)
+  uint64_t one = 1;
+  ssize_t w = write(q->wake_wr, &one, sizeof(one));
+#else
+  const char one = 1;
+  ssize_t w = write(q->wake_wr, &one, 1);
+#endif
+  (void)w;
+}
+
+static void wake_clear(nt_async_queue* q) {
+  char tmp[64];
+  while (read(q->wake_rd, tmp, sizeof(tmp)) > 0) {}
+}
+
+// Grows the ring to hold `need` completions. Submit reserves the slot of each
+// new waiter here, so a finished job never has to allocate to be delivered.
+static int done_reserve(nt_async_queue* q, size_t need) {
+  if (need <= q->done_cap) return 1;
+  size_t cap = q->done_cap ? q->done_cap * 2 : 64;
+  while (cap < need) cap *= 2;
+  nt_async_completion* d = (nt_async_completion*)malloc(cap * sizeof(nt_async_completion));
+  if (!d) return 0;
+  for (size_t i = 0; i < q->done_len; ++i) d[i] = q->done[(q->done_head + i) % q->done_cap];
+  free(q->done);
+  q->done = d;
+  q->done_head = 0;
+  q->done_cap = cap;
+  return 1;
+}
+
+// Uses a slot reserved by nt_async_submit.
+static void done_push(nt_async_queue* q, const nt_async_completion* c) {
+  q->done_reserved--;
+  q->done[(q->done_head + q->done_len) % q->done_cap] = *c;
+  if (q->done_len++ == 0) wake_set(q);
+}
+
+// -------------------------
+// Workers
+// -------------------------
+
+static void evaluate(const nt_async_request* r, nt_async_completion* out) {
+  nt_natural_date nd;
+  memset(&out->u, 0, sizeof(out->u));
+  if (r->kind == NT_ASYNC_MOON_QUARTERS_RANGE) {
+    size_t n = 0;
+    out->status = nt_moon_quarters_range(r->unix_ms, r->end_ms, r->longitude, out->u.quarters.q, NT_MOON_QUARTERS_MAX, &n);
+    out->u.quarters.count = n;
+    return;
+  }
+  out->status = nt_make_natural_date(r->unix_ms, r->longitude, &nd);
+  if (out->status != NT_OK) return;
+  switch (r->kind) {
+    case NT_ASYNC_SUN_EVENTS: out->status = nt_sun_events_for_date(&nd, r->latitude, &out->u.sun); break;
+    case NT_ASYNC_MOON_EVENTS: out->status = nt_moon_events_for_date(&nd, r->latitude, &out->u.moon_events); break;
+    case NT_ASYNC_MUSTACHES: out->status = nt_mustaches_range(&nd, r->latitude, &out->u.mustaches); break;
+    default: out->status = NT_ERR_INTERNAL; break;
+  }
+}
+
+static void* worker_main(void* arg) {
+  nt_async_queue* q = (nt_async_queue*)arg;
+  nt_async_completion result;
+  pthread_mutex_lock(&q->mu);
+  for (;;) {
+    while (q->heap_len == 0 && !q->stop) pthread_cond_wait(&q->work_cv, &q->mu);
+    if (q->stop) break;
+    job_t* j = q->heap[0];
+    heap_remove(q, 0);
+    j->running = 1;
+    pthread_mutex_unlock(&q->mu);
+
+    evaluate(&j->req, &result);
+    result.kind = j->req.kind;
+
+    pthread_mutex_lock(&q->mu);
+    q->stats.computed++;
+    key_remove(q, j);
+    for (waiter_t* w = j->waiters; w; w = w->next) {
+      waiter_t** slot = handle_slot(q, w->handle);
+      if (*slot) *slot = w->hnext;
+    }
+    waiter_t* waiters = j->waiters;
+    free(j);
+    if (!q->callback) {
+      for (waiter_t* w = waiters; w; w = w->next) {
+        result.handle = w->handle;
+        result.user_data = w->user_data;
+        done_push(q, &result);
+      }
+    }
+    pthread_mutex_unlock(&q->mu);
+
+    // 💡 Callbacks run unlocked so they may submit or cancel.
+    while (waiters) {
+      waiter_t* next = waiters->next;
+      if (q->callback) {
+        result.handle = waiters->handle;
+        result.user_data = waiters->user_data;
+        q->callback(&result, q->callback_ctx);
+      }
+      free(waiters);
+      waiters = next;
+    }
+    pthread_mutex_lock(&q->mu);
+  }
+  pthread_mutex_unlock(&q->mu);
+  return NULL;
+}
+
+// -------------------------
+// Public API
+// -------------------------
+
+nt_async_queue* nt_async_create(int workers, nt_async_callback callback, void* callback_ctx) {
+  if (workers <= 0) workers = 1;
+  nt_async_queue* q = (nt_async_queue*)calloc(1, sizeof(nt_async_queue));
+  if (!q) return NULL;
+  q->callback = callback;
+  q->callback_ctx = callback_ctx;
+#if defined(NT_ASYNC_EVENTFD)
+  q->wake_rd = q->wake_wr = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (q->wake_rd < 0) { free(q); return NULL; }
+#else
+  int fds[2];
+  if (pipe(fds) != 0) { free(q); return NULL; }
+  for (int i = 0; i < 2; ++i) {
+    fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL, 0) | O_NONBLOCK);
+    fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+  }
+  q->wake_rd = fds[0];
+  q->wake_wr = fds[1];
+#endif
+  pthread_mutex_init(&q->mu, NULL);
+  pthread_cond_init(&q->work_cv, NULL);
+  q->threads = (pthread_t*)calloc((size_t)workers, sizeof(pthread_t));
+  if (!q->threads) {
+    nt_async_destroy(q);
+    return NULL;
+  }
+  for (int i = 0; i < workers; ++i) {
+    if (pthread_create(&q->threads[i], NULL, worker_main, q) != 0) break;
+    q->nthreads++;
+  }
+  if (q->nthreads == 0) {
+    nt_async_destroy(q);
+    return NULL;
+  }
+  return q;
+}
+
+void nt_async_destroy(nt_async_queue* q) {
+  if (!q) return;
+  pthread_mutex_lock(&q->mu);
+  q->stop = 1;
+  pthread_cond_broadcast(&q->work_cv);
+  pthread_mutex_unlock(&q->mu);
+  for (int i = 0; i < q->nthreads; ++i) pthread_join(q->threads[i], NULL);
+
+  for (size_t i = 0; i < q->heap_len; ++i) {
+    waiter_t* w = q->heap[i]->waiters;
+    while (w) {
+      waiter_t* next = w->next;
+      free(w);
+      w = next;
+    }
+    free(q->heap[i]);
+  }
+  close(q->wake_rd);
+  if (q->wake_wr != q->wake_rd) close(q->wake_wr);
+  pthread_cond_destroy(&q->work_cv);
+  pthread_mutex_destroy(&q->mu);
+  free(q->threads);
+  free(q->heap);
+  free(q->done);
+  free(q);
+}
+
+nt_err nt_async_submit(nt_async_queue* q, const nt_async_request* req, void* user_data, uint64_t* out_handle) {
+  if (!q || !req || !out_handle) return NT_ERR_INTERNAL;
+  if (!(req->longitude >= -180.0 && req->longitude <= 180.0)) return NT_ERR_RANGE;
+
+  job_key_t key = {(int)req->kind, 0, 0, req->longitude, 0.0};
+  switch (req->kind) {
+    case NT_ASYNC_SUN_EVENTS:
+    case NT_ASYNC_MOON_EVENTS: {
+      if (!(req->latitude >= -90.0 && req->latitude <= 90.0)) return NT_ERR_RANGE;
+      nt_natural_date nd;
+      nt_err e = nt_make_natural_date(req->unix_ms, req->longitude, &nd);
+      if (e != NT_OK) return e;
+      key.k = nd.nadir;
+      key.lat = req->latitude;
+      break;
+    }
+    case NT_ASYNC_MUSTACHES:
+      // Mustaches depend on the UTC year and latitude only; a UTC day never spans two years.
+      if (!(req->latitude >= -90.0 && req->latitude <= 90.0)) return NT_ERR_RANGE;
+      if (req->unix_ms <= 0) return NT_ERR_RANGE;
+      key.k = req->unix_ms / MS_PER_DAY;
+      key.lon = 0.0;
+      key.lat = req->latitude;
+      break;
+    case NT_ASYNC_MOON_QUARTERS_RANGE:
+      if (req->end_ms <= req->unix_ms) return NT_ERR_RANGE;
+      key.k = req->unix_ms;
+      key.end = req->end_ms;
+      break;
+    default:
+      return NT_ERR_RANGE;
+  }
+
+  waiter_t* w = (waiter_t*)calloc(1, sizeof(waiter_t));
+  if (!w) return NT_ERR_INTERNAL;
+  w->user_data = user_data;
+
+  pthread_mutex_lock(&q->mu);
+  if (!q->callback && !done_reserve(q, q->done_len + q->done_reserved + 1)) {
+    pthread_mutex_unlock(&q->mu);
+    free(w);
+    return NT_ERR_INTERNAL;
+  }
+  w->handle = ++q->next_handle;
+  job_t* j = q->keys[key_bucket(&key)];
+  while (j && !key_equal(&j->key, &key)) j = j->knext;
+  if (j) {
+    q->stats.coalesced++;
+    if (!j->running && req->priority > j->priority) {
+      j->priority = req->priority;
+      sift_up(q, j->heap_index);
+    }
+  } else {
+    j = (job_t*)calloc(1, sizeof(job_t));
+    if (j) {
+      j->key = key;
+      j->req = *req;
+      j->priority = req->priority;
+      j->seq = q->next_seq++;
+    }
+    if (!j || !heap_push(q, j)) {
+      pthread_mutex_unlock(&q->mu);
+      free(j);
+      free(w);
+      return NT_ERR_INTERNAL;
+    }
+    size_t b = key_bucket(&key);
+    j->knext = q->keys[b];
+    q->keys[b] = j;
+    pthread_cond_signal(&q->work_cv);
+  }
+  w->job = j;
+  if (j->waiters_tail) j->waiters_tail->next = w; else j->waiters = w;
+  j->waiters_tail = w;
+  waiter_t** slot = &q->handles[w->handle & (TABLE_BUCKETS - 1)];
+  w->hnext = *slot;
+  *slot = w;
+  if (!q->callback) q->done_reserved++;
+  q->stats.submitted++;
+  *out_handle = w->handle;
+  pthread_mutex_unlock(&q->mu);
+  return NT_OK;
+}
+
+nt_err nt_async_cancel(nt_async_queue* q, uint64_t handle) {
+  if (!q) return NT_ERR_INTERNAL;
+  pthread_mutex_lock(&q->mu);
+  waiter_t** slot = handle_slot(q, handle);
+  waiter_t* w = *slot;
+  if (!w || w->job->running) {
+    pthread_mutex_unlock(&q->mu);
+    return NT_ERR_RANGE;
+  }
+  *slot = w->hnext;
+  job_t* j = w->job;
+  waiter_t** p = &j->waiters;
+  waiter_t* prev = NULL;
+  while (*p != w) {
+    prev = *p;
+    p = &(*p)->next;
+  }
+  *p = w->next;
+  if (j->waiters_tail == w) j->waiters_tail = prev;
+  free(w);
+  if (!q->callback) q->done_reserved--;
+  if (!j->waiters) {
+    heap_remove(q, j->heap_index);
+    key_remove(q, j);
+    free(j);
+  }
+  q->stats.cancelled++;
+  pthread_mutex_unlock(&q->mu);
+  return NT_OK;
+}
+
+size_t nt_async_poll(nt_async_queue* q, nt_async_completion* out, size_t capacity) {
+  if (!q || !out) return 0;
+  pthread_mutex_lock(&q->mu);
+  size_t n = 0;
+  while (n < capacity && q->done_len > 0) {
+    out[n++] = q->done[q->done_head];
+    q->done_head = (q->done_head + 1) % q->done_cap;
+    q->done_len--;
+  }
+  if (q->done_len == 0) wake_clear(q);
+  pthread_mutex_unlock(&q->mu);
+  return n;
+}
+
+int nt_async_wait_fd(const nt_async_queue* q) {
+  return q ? q->wake_rd : -1;
+}
+
+void nt_async_get_stats(nt_async_queue* q, nt_async_stats* out) {
+  if (!q || !out) return;
+  pthread_mutex_lock(&q->mu);
+  *out = q->stats;
+  out->pending = q->heap_len;
+  pthread_mutex_unlock(&q->mu);
+}
@@ -0,0 +1,154 @@
+#include "natural_time_buckets.h"
+#include <stdlib.h>
+
+static const int64_t MS_PER_DAY = 86400000LL;
+
+struct nt_bucket_table {
+  nt_bucket_unit unit;
+  size_t count;
+  int64_t* bounds;    // count + 1 boundaries, strictly increasing
+  int32_t* year;
+  int32_t* ordinal;
+};
+
+static int push_bucket(nt_bucket_table* t, size_t* cap, int64_t start, int32_t year, int32_t ordinal) {
+  if (t->count + 2 > *cap) {
+    size_t c = *cap ? *cap * 2 : 512;
+    int64_t* b = (int64_t*)realloc(t->bounds, c * sizeof(int64_t));
+    if (b) t->bounds = b;
+    int32_t* y = (int32_t*)realloc(t->year, c * sizeof(int32_t));
+    if (y) t->year = y;
+    int32_t* o = (int32_t*)realloc(t->ordinal, c * sizeof(int32_t));
+    if (o) t->ordinal = o;
+    if (!b || !y || !o) return 0;
+    *cap = c;
+  }
+  t->bounds[t->count] = start;
+  t->year[t->count] = year;
+  t->ordinal[t->count] = ordinal;
+  t->count++;
+  return 1;
+}
+
+nt_bucket_table* nt_bucket_table_create(int64_t start_ms, int64_t end_ms, double longitude_deg,
+                                        nt_bucket_unit unit, nt_err* err) {
+  nt_err e = NT_OK;
+  nt_bucket_table* t = NULL;
+  nt_natural_date nd;
+  if (end_ms <= start_ms || unit < NT_BUCKET_DAY || unit > NT_BUCKET_YEAR) e = NT_ERR_RANGE;
+  if (e == NT_OK) e = nt_make_natural_date(start_ms, longitude_deg, &nd);
+  if (e == NT_OK) {
+    t = (nt_bucket_table*)calloc(1, sizeof(nt_bucket_table));
+    if (!t) e = NT_ERR_INTERNAL;
+  }
+  if (e != NT_OK) {
+    if (err) *err = e;
+    return NULL;
+  }
+  t->unit = unit;
+
+  // 💡 One year-start lookup per natural year; days, weeks and moons are fixed
+  // offsets from it (the last week/moon of the year is cut at the year end).
+  static const int64_t step_days[4] = {1, 7, 28, 0};
+  size_t cap = 0;
+  for (;;) {
+    int64_t year_end = nd.year_start + (int64_t)nd.year_duration * MS_PER_DAY;
+    int64_t step = step_days[unit] ? step_days[unit] * MS_PER_DAY : year_end - nd.year_start;
+    int32_t ordinal = 1;
+    for (int64_t b = nd.year_start; b < year_end; b += step, ++ordinal) {
+      if (b + step <= start_ms && b + step < year_end) continue;  // before the range
+      if (b >= end_ms) break;
+      if (!push_bucket(t, &cap, b, nd.year, ordinal)) {
+        e = NT_ERR_INTERNAL;
+        break;
+      }
+    }
+    if (e != NT_OK || year_end >= end_ms) {
+      if (e == NT_OK) t->bounds[t->count] = (t->bounds[t->count - 1] + step < year_end) ? t->bounds[t->count - 1] + step : year_end;
+      break;
+    }
+    e = nt_make_natural_date(year_end, longitude_deg, &nd);
+    if (e != NT_OK) break;
+  }
+  if (e != NT_OK) {
+    nt_bucket_table_destroy(t);
+    if (err) *err = e;
+    return NULL;
+  }
+  if (err) *err = NT_OK;
+  return t;
+}
+
+void nt_bucket_table_destroy(nt_bucket_table* t) {
+  if (!t) return;
+  free(t->bounds);
+  free(t->year);
+  free(t->ordinal);
+  free(t);
+}
+
+size_t nt_bucket_table_size(const nt_bucket_table* t) {
+  return t ? t->count : 0;
+}
+
+nt_err nt_bucket_get(const nt_bucket_table* t, size_t id, nt_bucket* out) {
+  if (!t || !out) return NT_ERR_INTERNAL;
+  if (id >= t->count) return NT_ERR_RANGE;
+  out->start_ms = t->bounds[id];
+  out->end_ms = t->bounds[id + 1];
+  out->year = t->year[id];
+  out->ordinal = t->ordinal[id];
+  return NT_OK;
+}
+
+// Largest id with bounds[id] <= ts, or NT_BUCKET_NONE.
+static int32_t bucket_search(const nt_bucket_table* t, int64_t ts) {
+  const int64_t* b = t->bounds;
+  if (ts < b[0] || ts >= b[t->count]) return NT_BUCKET_NONE;
+  if (t->unit == NT_BUCKET_DAY) {
+    // Days are exactly MS_PER_DAY apart across year boundaries too.
+    return (int32_t)((ts - b[0]) / MS_PER_DAY);
+  }
+  size_t lo = 0, hi = t->count;  // b[lo] <= ts < b[hi]
+  while (hi - lo > 1) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (b[mid] <= ts) lo = mid; else hi = mid;
+  }
+  return (int32_t)lo;
+}
+
+// Cursor step: the previous bucket or the next one cover sorted streams.
+static int32_t bucket_next(const nt_bucket_table* t, int32_t hint, int64_t ts) {
+  const int64_t* b = t->bounds;
+  if (hint >= 0) {
+    if (ts >= b[hint] && ts < b[hint + 1]) return hint;
+    if ((size_t)hint + 1 < t->count && ts >= b[hint + 1] && ts < b[hint + 2]) return hint + 1;
+  }
+  return bucket_search(t, ts);
+}
+
+void nt_bucket_assign(const nt_bucket_table* t, const int64_t* unix_ms, size_t count, int32_t* out_ids) {
+  if (!t || !unix_ms || !out_ids) return;
+  int32_t id = NT_BUCKET_NONE;
+  for (size_t i = 0; i < count; ++i) {
+    id = bucket_next(t, id, unix_ms[i]);
+    out_ids[i] = id;
+  }
+}
+
+size_t nt_bucket_aggregate(const nt_bucket_table* t, const int64_t* unix_ms, const double* values, size_t count,
+                           uint64_t* counts, double* sums) {
+  if (!t || !unix_ms || !counts) return 0;
+  size_t outside = 0;
+  int32_t id = NT_BUCKET_NONE;
+  for (size_t i = 0; i < count; ++i) {
+    id = bucket_next(t, id, unix_ms[i]);
+    if (id == NT_BUCKET_NONE) {
+      outside++;
+      continue;
+    }
+    counts[id]++;
+    if (values && sums) sums[id] += values[i];
+  }
+  return outside;
+}
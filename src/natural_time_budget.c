@@ -0,0 +1,280 @@
+#include "natural_time_budget.h"
+#include "natural_time_internal.h"
+#include <math.h>
+#include <string.h>
+#include "astronomy.h"  // vendor/astronomy include path wired from CMake
+
+#define TOKEN_SUN 0x4e544253u   // "NTBS"
+#define TOKEN_MOON 0x4e54424du  // "NTBM"
+#define UNKNOWN_DEG 360.0
+#define UNKNOWN_ALTITUDE_DEG 180.0
+
+static const double MS_PER_DAY = 86400000.0;
+static const double J2000_UNIX_MS = 946728000000.0;
+static const double GRID_STEP_DAYS = 1.0 / 24.0;
+
+// STAGE_BEGIN: the window and regimes are not set up yet (nt_internal_*_search_begin).
+enum { STAGE_BEGIN = 0, STAGE_SEARCH, STAGE_TRANSIT, STAGE_DONE };
+
+typedef struct {
+  uint32_t kind;
+  uint32_t stage;
+  nt_natural_date nd;
+  double latitude;
+  union {
+    nt_sun_search sun;
+    nt_moon_search moon;
+  } search;  // from STAGE_SEARCH
+  union {
+    nt_sun_events sun;
+    nt_moon_events moon;
+  } result;  // STAGE_DONE
+} token_t;
+
+_Static_assert(sizeof(token_t) <= sizeof(nt_continuation), "NT_CONTINUATION_BYTES too small");
+_Static_assert(NT_BUDGET_MIN_EVALUATIONS >= NT_SKY_BEGIN_EVALUATIONS &&
+                   NT_BUDGET_MIN_EVALUATIONS >= NT_SKY_FALLBACK_EVALUATIONS,
+               "indivisible steps fit the smallest budget");
+
+static token_t* token_of(nt_continuation* c) {
+  return (token_t*)(void*)c->opaque;
+}
+
+static nt_err start_budget(const nt_budget* in, nt_sky_budget* out) {
+  memset(out, 0, sizeof(*out));
+  if (!in) return NT_OK;
+  if (in->max_evaluations > 0 && in->max_evaluations < NT_BUDGET_MIN_EVALUATIONS) return NT_ERR_RANGE;
+  out->max_evaluations = in->max_evaluations;
+  if (in->max_microseconds > 0) out->deadline_s = nt_internal_clock_s() + in->max_microseconds * 1e-6;
+  return NT_OK;
+}
+
+// Indivisible steps (regime fallbacks, the transit search) run only when they fit.
+static int budget_allows(nt_sky_budget* b, uint64_t cost) {
+  if (b->max_evaluations > 0 && b->evaluations + cost > b->max_evaluations) return 0;
+  if (b->deadline_s > 0.0 && nt_internal_clock_s() >= b->deadline_s) return 0;
+  b->evaluations += cost;
+  return 1;
+}
+
+// Error of an event reported at `ut` +- bound_days in natural-day degrees:
+// instants outside [nadir, nadir + 1 day] read as 0°, so a range across either
+// end is unbounded.
+static double event_error_deg(const nt_natural_date* nd, double ut, double bound_days) {
+  if (bound_days <= 0.0) return 0.0;
+  double lo = J2000_UNIX_MS + (ut - bound_days) * MS_PER_DAY, hi = J2000_UNIX_MS + (ut + bound_days) * MS_PER_DAY;
+  double start = (double)nd->nadir, end = start + MS_PER_DAY;
+  if (hi < start || lo > end) return 0.0;
+  if (lo < start || hi >= end) return UNKNOWN_DEG;
+  return fmin(bound_days * 360.0, UNKNOWN_DEG);
+}
+
+static int64_t unix_ms_of(double ut) {
+  return (int64_t)llround(J2000_UNIX_MS + ut * MS_PER_DAY);
+}
+
+// -------------------------
+// Sun
+// -------------------------
+
+static void sun_estimate(const token_t* t, nt_sun_events_bounded* out) {
+  out->approximate = 1;
+  if (t->stage == STAGE_BEGIN) {
+    for (int i = 0; i < NT_SUN_EVENT_COUNT; ++i) out->error_deg[i] = UNKNOWN_DEG;
+    return;
+  }
+  const nt_sun_search* s = &t->search.sun;
+  nt_sun_event_times times;
+  for (int k = 0; k < NT_SUN_THRESHOLD_COUNT; ++k) times.regime[k] = s->regime[k];
+  for (int i = 0; i < NT_SUN_EVENT_COUNT; ++i) {
+    int found = 0;
+    double ut = 0.0, bound = 0.0;
+    times.found[i] = 0;
+    times.unix_ms[i] = 0;
+    out->error_deg[i] = 0.0;  // ruled out by the regime
+    if (s->query_of[i] < 0) continue;
+    if (!nt_internal_sky_search_estimate(&s->search, (size_t)s->query_of[i], &found, &ut, &bound)) {
+      out->error_deg[i] = UNKNOWN_DEG;
+      continue;
+    }
+    if (!found) continue;
+    times.found[i] = 1;
+    times.unix_ms[i] = unix_ms_of(ut);
+    out->error_deg[i] = event_error_deg(&t->nd, ut, bound);
+  }
+  nt_internal_sun_events_from_times(&t->nd, t->latitude, &times, &out->value);
+}
+
+static void sun_exact(const token_t* t, nt_sun_events_bounded* out) {
+  out->value = t->result.sun;
+  out->approximate = 0;
+  memset(out->error_deg, 0, sizeof(out->error_deg));
+}
+
+static nt_err sun_resume(token_t* t, nt_sky_budget* b, nt_sun_events_bounded* out) {
+  memset(out, 0, sizeof(*out));
+  if (t->stage == STAGE_BEGIN && budget_allows(b, NT_SKY_BEGIN_EVALUATIONS)) {
+    nt_err err = nt_internal_sun_search_begin(&t->nd, t->latitude, &t->search.sun);
+    if (err != NT_OK) return err;
+    t->stage = STAGE_SEARCH;
+  }
+  if (t->stage == STAGE_SEARCH && nt_internal_sky_search_run(&t->search.sun.search, b)) {
+    // Thresholds with no crossing fall back to one altitude sample each.
+    const nt_sun_search* s = &t->search.sun;
+    uint64_t fallbacks = 0;
+    for (int k = 0; k < NT_SUN_THRESHOLD_COUNT; ++k) {
+      int any = 0;
+      for (int j = 0; j < 2; ++j) {
+        int q = s->query_of[2 * k + j];
+        any |= (q >= 0 && s->search.q[q].found);
+      }
+      fallbacks += (s->regime[k] == NT_POLAR_NONE && !any);
+    }
+    if (budget_allows(b, fallbacks)) {
+      nt_sun_event_times times;
+      nt_internal_sun_search_times(s, &times);
+      nt_internal_sun_events_from_times(&t->nd, t->latitude, &times, &t->result.sun);
+      nt_internal_store_sun_events(&t->nd, t->latitude, &t->result.sun, 1);
+      t->stage = STAGE_DONE;
+    }
+  }
+  if (t->stage == STAGE_DONE) sun_exact(t, out);
+  else sun_estimate(t, out);
+  out->evaluations = (uint32_t)b->evaluations;
+  return NT_OK;
+}
+
+nt_err nt_sun_events_resume(nt_continuation* token, const nt_budget* budget, nt_sun_events_bounded* out) {
+  if (!token || !out) return NT_ERR_INTERNAL;
+  token_t* t = token_of(token);
+  if (t->kind != TOKEN_SUN || t->stage > STAGE_DONE) return NT_ERR_RANGE;
+  nt_sky_budget b;
+  nt_err err = start_budget(budget, &b);
+  if (err != NT_OK) return err;
+  return sun_resume(t, &b, out);
+}
+
+nt_err nt_sun_events_for_date_bounded(const nt_natural_date* nd, double latitude_deg, const nt_budget* budget,
+                                      nt_continuation* token, nt_sun_events_bounded* out) {
+  if (!nd || !token || !out) return NT_ERR_INTERNAL;
+  if (!(latitude_deg >= -90.0 && latitude_deg <= 90.0)) return NT_ERR_RANGE;
+  nt_sky_budget b;
+  nt_err err = start_budget(budget, &b);
+  if (err != NT_OK) return err;
+  token_t* t = token_of(token);
+  t->kind = TOKEN_SUN;
+  t->nd = *nd;
+  t->latitude = latitude_deg;
+  t->stage = nt_internal_cached_sun_events(nd, latitude_deg, &t->result.sun) ? STAGE_DONE : STAGE_BEGIN;
+  err = sun_resume(t, &b, out);
+  if (err != NT_OK) t->kind = 0;
+  return err;
+}
+
+// -------------------------
+// Moon
+// -------------------------
+
+// The peak lies within half a grid step of the highest sample, so the maximum
+// altitude rate bounds the difference (💡 a curvature bound fails near the
+// zenith, where the altitude curve is almost a cusp).
+static void moon_peak(const token_t* t, double* altitude, double* error) {
+  const nt_sky_search* s = &t->search.moon.search;
+  double alt = 0.0;
+  int inside = nt_internal_sky_search_peak(s, &alt);
+  *altitude = 0.0;
+  *error = UNKNOWN_ALTITUDE_DEG;
+  if (inside < 0) return;
+  *altitude = alt + Astronomy_Refraction(REFRACTION_NORMAL, alt);
+  if (inside) *error = nt_internal_max_altitude_slope(&s->w) * GRID_STEP_DAYS / 2.0;
+}
+
+static void moon_estimate(const token_t* t, nt_moon_events_bounded* out) {
+  out->approximate = 1;
+  if (t->stage == STAGE_BEGIN) {
+    out->moonrise_error_deg = UNKNOWN_DEG;
+    out->moonset_error_deg = UNKNOWN_DEG;
+    out->highest_altitude_error_deg = UNKNOWN_ALTITUDE_DEG;
+    return;
+  }
+  const nt_moon_search* s = &t->search.moon;
+  double* deg[2] = {&out->value.moonrise_deg, &out->value.moonset_deg};
+  double* err[2] = {&out->moonrise_error_deg, &out->moonset_error_deg};
+  if (t->stage == STAGE_TRANSIT) {
+    out->value = t->result.moon;  // all but the transit are final
+  } else {
+    out->value.horizon_regime = s->regime;
+    for (int j = 0; j < 2; ++j) {
+      int found = 0;
+      double ut = 0.0, bound = 0.0;
+      *deg[j] = 0.0;
+      *err[j] = 0.0;
+      if ((size_t)j >= s->search.count) continue;
+      if (!nt_internal_sky_search_estimate(&s->search, (size_t)j, &found, &ut, &bound)) {
+        *err[j] = UNKNOWN_DEG;
+        continue;
+      }
+      if (!found) continue;
+      nt_get_time_of_event(&t->nd, unix_ms_of(ut), deg[j]);
+      *err[j] = event_error_deg(&t->nd, ut, bound);
+    }
+  }
+  moon_peak(t, &out->value.highest_altitude, &out->highest_altitude_error_deg);
+}
+
+static nt_err moon_resume(token_t* t, nt_sky_budget* b, nt_moon_events_bounded* out) {
+  memset(out, 0, sizeof(*out));
+  nt_moon_search* s = &t->search.moon;
+  if (t->stage == STAGE_BEGIN && budget_allows(b, NT_SKY_BEGIN_EVALUATIONS)) {
+    nt_err err = nt_internal_moon_search_begin(&t->nd, t->latitude, s);
+    if (err != NT_OK) return err;
+    t->stage = STAGE_SEARCH;
+  }
+  if (t->stage == STAGE_SEARCH && nt_internal_sky_search_run(&s->search, b)) {
+    int crossed = (s->search.count > 0) && (s->search.q[0].found || s->search.q[1].found);
+    if (budget_allows(b, (s->regime == NT_POLAR_NONE && !crossed) ? 1 : 0)) {
+      nt_internal_moon_search_events(&t->nd, s, &t->result.moon);
+      t->stage = STAGE_TRANSIT;
+    }
+  }
+  if (t->stage == STAGE_TRANSIT && budget_allows(b, NT_BUDGET_TRANSIT_EVALUATIONS)) {
+    t->result.moon.highest_altitude = nt_internal_moon_transit_altitude(&t->nd, t->latitude);
+    nt_internal_store_moon_events(&t->nd, t->latitude, &t->result.moon);
+    t->stage = STAGE_DONE;
+  }
+  if (t->stage == STAGE_DONE) {
+    out->value = t->result.moon;
+    out->approximate = 0;
+  } else {
+    moon_estimate(t, out);
+  }
+  out->evaluations = (uint32_t)b->evaluations;
+  return NT_OK;
+}
+
+nt_err nt_moon_events_resume(nt_continuation* token, const nt_budget* budget, nt_moon_events_bounded* out) {
+  if (!token || !out) return NT_ERR_INTERNAL;
+  token_t* t = token_of(token);
+  if (t->kind != TOKEN_MOON || t->stage > STAGE_DONE) return NT_ERR_RANGE;
+  nt_sky_budget b;
+  nt_err err = start_budget(budget, &b);
+  if (err != NT_OK) return err;
+  return moon_resume(t, &b, out);
+}
+
+nt_err nt_moon_events_for_date_bounded(const nt_natural_date* nd, double latitude_deg, const nt_budget* budget,
+                                       nt_continuation* token, nt_moon_events_bounded* out) {
+  if (!nd || !token || !out) return NT_ERR_INTERNAL;
+  if (!(latitude_deg >= -90.0 && latitude_deg <= 90.0)) return NT_ERR_RANGE;
+  nt_sky_budget b;
+  nt_err err = start_budget(budget, &b);
+  if (err != NT_OK) return err;
+  token_t* t = token_of(token);
+  t->kind = TOKEN_MOON;
+  t->nd = *nd;
+  t->latitude = latitude_deg;
+  t->stage = nt_internal_cached_moon_events(nd, latitude_deg, &t->result.moon) ? STAGE_DONE : STAGE_BEGIN;
+  err = moon_resume(t, &b, out);
+  if (err != NT_OK) t->kind = 0;
+  return err;
+}
@@ -0,0 +1,261 @@
+#include "natural_time_capture.h"
+#include "natural_time_internal.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// File: header, then `capacity` records; call n (from 0) lives in record
+// n % capacity and `next` counts the calls claimed so far.
+typedef struct {
+  char magic[8];
+  uint32_t format;
+  uint32_t record_size;
+  uint32_t capacity;
+  uint32_t pad;
+  uint64_t next;
+} capture_header_t;
+
+static const char MAGIC[8] = {'N', 'T', 'C', 'A', 'P', '\0', '\0', '\0'};
+
+_Static_assert(sizeof(nt_capture_record) == 32, "capture records are 32 bytes");
+_Static_assert(sizeof(capture_header_t) % 8 == 0, "records stay 8-byte aligned");
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+// 💡 Other processes may read the mapped file, so `next` must be a real
+// lock-free atomic rather than a mutex-backed emulation.
+_Static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "capture needs lock-free 64-bit atomics");
+
+// The header as mapped by a running capture: the file layout, with `next` an
+// atomic object so writers never touch it through a cast.
+typedef struct {
+  char magic[8];
+  uint32_t format;
+  uint32_t record_size;
+  uint32_t capacity;
+  uint32_t pad;
+  _Atomic uint64_t next;
+} capture_map_t;
+
+_Static_assert(sizeof(capture_map_t) == sizeof(capture_header_t), "mapped header matches the file header");
+_Static_assert(offsetof(capture_map_t, next) == offsetof(capture_header_t, next), "mapped header matches the file header");
+
+enum { CAPTURE_IDLE = 0, CAPTURE_BUSY, CAPTURE_ACTIVE };
+
+static _Atomic int g_state;
+static _Atomic uint32_t g_writers;  // calls between the state check and their store
+static _Atomic uint32_t g_threads;
+static capture_map_t* g_map;
+static size_t g_map_size;
+
+static NT_THREAD_LOCAL int t_depth;
+static NT_THREAD_LOCAL int t_tagged;
+static NT_THREAD_LOCAL uint8_t t_tag;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint8_t cache_bits(const nt_cache_stats* a, const nt_cache_stats* b) {
+  uint8_t bits = 0;
+  if (b->seasons_hits > a->seasons_hits) bits |= NT_CACHE_HIT_SEASONS;
+  if (b->sun_events_hits > a->sun_events_hits) bits |= NT_CACHE_HIT_SUN_EVENTS;
+  if (b->mustaches_hits > a->mustaches_hits) bits |= NT_CACHE_HIT_MUSTACHES;
+  if (b->seasons_misses > a->seasons_misses) bits |= NT_CACHE_HIT_SEASONS << 4;
+  if (b->sun_events_misses > a->sun_events_misses) bits |= NT_CACHE_HIT_SUN_EVENTS << 4;
+  if (b->mustaches_misses > a->mustaches_misses) bits |= NT_CACHE_HIT_MUSTACHES << 4;
+  return bits;
+}
+
+int nt_internal_capture_begin(nt_capture_call* c) {
+  if (atomic_load_explicit(&g_state, memory_order_relaxed) != CAPTURE_ACTIVE || t_depth) return 0;
+  t_depth = 1;
+  nt_cache_counters(&c->caches);
+  c->start_ns = now_ns();
+  return 1;
+}
+
+void nt_internal_capture_end(const nt_capture_call* c, int call, int64_t unix_ms, double longitude_deg,
+                             double latitude_deg, nt_err status) {
+  uint64_t ns = now_ns() - c->start_ns;
+  t_depth = 0;
+  nt_cache_stats after;
+  nt_cache_counters(&after);
+  if (!t_tagged) {
+    t_tag = (uint8_t)atomic_fetch_add_explicit(&g_threads, 1, memory_order_relaxed);
+    t_tagged = 1;
+  }
+  nt_capture_record r;
+  memset(&r, 0, sizeof(r));
+  r.unix_ms = unix_ms;
+  r.longitude = longitude_deg;
+  r.latitude = latitude_deg;
+  r.latency_ns = (ns > UINT32_MAX) ? UINT32_MAX : (uint32_t)ns;
+  r.thread = t_tag;
+  r.call = (uint8_t)call;
+  r.status = (int8_t)status;
+  r.caches = cache_bits(&c->caches, &after);
+
+  // 💡 Announce the write before re-checking the state, so nt_capture_stop
+  // (which clears the state before waiting for writers) never unmaps under it.
+  atomic_fetch_add(&g_writers, 1);
+  if (atomic_load(&g_state) == CAPTURE_ACTIVE) {
+    capture_map_t* h = g_map;
+    uint64_t n = atomic_fetch_add_explicit(&h->next, 1, memory_order_relaxed);
+    nt_capture_record* records = (nt_capture_record*)(void*)(h + 1);
+    records[n % h->capacity] = r;
+  }
+  atomic_fetch_sub_explicit(&g_writers, 1, memory_order_release);
+}
+
+nt_err nt_capture_start(const char* path, uint32_t capacity) {
+  if (!path) return NT_ERR_INTERNAL;
+  if (capacity == 0 || capacity > NT_CAPTURE_MAX_RECORDS) return NT_ERR_RANGE;
+  int idle = CAPTURE_IDLE;
+  if (!atomic_compare_exchange_strong(&g_state, &idle, CAPTURE_BUSY)) return NT_ERR_RANGE;
+
+  size_t size = sizeof(capture_header_t) + (size_t)capacity * sizeof(nt_capture_record);
+  int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  void* map = MAP_FAILED;
+  if (fd >= 0 && ftruncate(fd, (off_t)size) == 0) {
+    map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  if (fd >= 0) close(fd);
+  if (map == MAP_FAILED) {
+    atomic_store(&g_state, CAPTURE_IDLE);
+    return NT_ERR_INTERNAL;
+  }
+  capture_map_t* h = (capture_map_t*)map;  // zero-filled by ftruncate
+  memcpy(h->magic, MAGIC, sizeof(MAGIC));
+  h->format = NT_CAPTURE_FORMAT;
+  h->record_size = sizeof(nt_capture_record);
+  h->capacity = capacity;
+  atomic_init(&h->next, 0);
+  g_map = h;
+  g_map_size = size;
+  atomic_store(&g_state, CAPTURE_ACTIVE);
+  return NT_OK;
+}
+
+void nt_capture_stop(void) {
+  int active = CAPTURE_ACTIVE;
+  if (!atomic_compare_exchange_strong(&g_state, &active, CAPTURE_BUSY)) return;
+  while (atomic_load(&g_writers) != 0) sched_yield();
+  munmap(g_map, g_map_size);
+  g_map = NULL;
+  g_map_size = 0;
+  atomic_store(&g_state, CAPTURE_IDLE);
+}
+
+int nt_capture_active(void) {
+  return atomic_load_explicit(&g_state, memory_order_relaxed) == CAPTURE_ACTIVE;
+}
+
+#else  // _WIN32
+
+int nt_internal_capture_begin(nt_capture_call* c) {
+  (void)c;
+  return 0;
+}
+
+void nt_internal_capture_end(const nt_capture_call* c, int call, int64_t unix_ms, double longitude_deg,
+                             double latitude_deg, nt_err status) {
+  (void)c; (void)call; (void)unix_ms; (void)longitude_deg; (void)latitude_deg; (void)status;
+}
+
+nt_err nt_capture_start(const char* path, uint32_t capacity) {
+  (void)path; (void)capacity;
+  return NT_ERR_INTERNAL;
+}
+
+void nt_capture_stop(void) {}
+
+int nt_capture_active(void) {
+  return 0;
+}
+
+#endif
+
+// -------------------------
+// Reading and writing files
+// -------------------------
+
+nt_err nt_capture_load(const char* path, nt_capture_record** out, size_t* out_count, uint64_t* out_dropped) {
+  if (!path || !out || !out_count || !out_dropped) return NT_ERR_INTERNAL;
+  *out = NULL;
+  *out_count = 0;
+  *out_dropped = 0;
+  FILE* f = fopen(path, "rb");
+  if (!f) return NT_ERR_INTERNAL;
+  capture_header_t h;
+  if (fread(&h, sizeof(h), 1, f) != 1 || memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      h.format != NT_CAPTURE_FORMAT || h.record_size != sizeof(nt_capture_record) || h.capacity == 0 ||
+      h.capacity > NT_CAPTURE_MAX_RECORDS) {
+    fclose(f);
+    return NT_ERR_RANGE;
+  }
+  nt_capture_record* ring = (nt_capture_record*)malloc((size_t)h.capacity * sizeof(nt_capture_record));
+  if (!ring) {
+    fclose(f);
+    return NT_ERR_INTERNAL;
+  }
+  size_t got = fread(ring, sizeof(nt_capture_record), h.capacity, f);
+  fclose(f);
+  if (got != h.capacity) {
+    free(ring);
+    return NT_ERR_RANGE;
+  }
+
+  // Oldest first: once the ring has wrapped it starts at next % capacity.
+  uint64_t filled = (h.next < h.capacity) ? h.next : h.capacity;
+  size_t first = (h.next > h.capacity) ? (size_t)(h.next % h.capacity) : 0;
+  nt_capture_record* records = (nt_capture_record*)malloc((filled ? filled : 1) * sizeof(nt_capture_record));
+  if (!records) {
+    free(ring);
+    return NT_ERR_INTERNAL;
+  }
+  size_t n = 0;
+  for (uint64_t i = 0; i < filled; ++i) {
+    const nt_capture_record* r = &ring[(first + i) % h.capacity];
+    if (r->call == 0 || r->call >= NT_CALL_KINDS) continue;
+    records[n++] = *r;
+  }
+  free(ring);
+  *out = records;
+  *out_count = n;
+  *out_dropped = h.next - filled;
+  return NT_OK;
+}
+
+void nt_capture_free(nt_capture_record* records) {
+  free(records);
+}
+
+nt_err nt_capture_save(const char* path, const nt_capture_record* records, size_t count) {
+  if (!path || (!records && count > 0)) return NT_ERR_INTERNAL;
+  if (count > NT_CAPTURE_MAX_RECORDS) return NT_ERR_RANGE;
+  capture_header_t h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, MAGIC, sizeof(MAGIC));
+  h.format = NT_CAPTURE_FORMAT;
+  h.record_size = sizeof(nt_capture_record);
+  h.capacity = count ? (uint32_t)count : 1;
+  h.next = count;
+  FILE* f = fopen(path, "wb");
+  if (!f) return NT_ERR_INTERNAL;
+  nt_capture_record empty;
+  memset(&empty, 0, sizeof(empty));
+  int ok = fwrite(&h, sizeof(h), 1, f) == 1 && (count == 0 ? fwrite(&empty, sizeof(empty), 1, f) == 1
+                                                             : fwrite(records, sizeof(*records), count, f) == count);
+  if (fclose(f) != 0) ok = 0;
+  return ok ? NT_OK : NT_ERR_INTERNAL;
+}
@@ -0,0 +1,326 @@
+// Natural Time — internal helpers shared between library translation units.
+// Not installed; signatures may change without notice.
+#ifndef NATURAL_TIME_INTERNAL_H
+#define NATURAL_TIME_INTERNAL_H
+
+#include "natural_time.h"
+
+// 💡 Caches are per thread so concurrent callers (ntc workers) never share state.
+#if defined(_MSC_VER)
+#define NT_THREAD_LOCAL __declspec(thread)
+#else
+#define NT_THREAD_LOCAL _Thread_local
+#endif
+
+// Sun event order used by the raw searches, matching nt_sun_events fields.
+enum {
+  NT_SUN_RISE = 0,
+  NT_SUN_SET,
+  NT_SUN_NIGHT_START,
+  NT_SUN_NIGHT_END,
+  NT_SUN_MORNING_GOLDEN,
+  NT_SUN_EVENING_GOLDEN,
+  NT_SUN_EVENT_COUNT
+};
+
+// Thresholds: event i belongs to threshold i / 2 (rise/set, night, golden).
+enum {
+  NT_SUN_HORIZON = 0,
+  NT_SUN_NIGHT,
+  NT_SUN_GOLDEN,
+  NT_SUN_THRESHOLD_COUNT
+};
+
+// Raw search results behind nt_sun_events_for_date: found[i] = 0 when the
+// search for event i failed (no crossing in the window) or was skipped because
+// regime[i / 2] rules the crossing out.
+typedef struct {
+  int found[NT_SUN_EVENT_COUNT];
+  int64_t unix_ms[NT_SUN_EVENT_COUNT];
+  int32_t regime[NT_SUN_THRESHOLD_COUNT];  // nt_polar_regime
+} nt_sun_event_times;
+
+nt_err nt_internal_sun_event_times(const nt_natural_date* nd, double latitude_deg, nt_sun_event_times* out);
+
+// Degrees within nd's natural day, with the seasonal defaults for failed searches;
+// copies the regimes.
+void nt_internal_sun_events_from_times(const nt_natural_date* nd, double latitude_deg,
+                                       const nt_sun_event_times* times, nt_sun_events* out);
+
+// -------------------------
+// Batched ephemeris (natural_time_series.c)
+// -------------------------
+// The vendor's Sun (VSOP87 Earth terms) and Moon (CalcMoon) series evaluated for
+// NT_SERIES_LANES instants at once, plus the observer geometry and the rise/set
+// style searches built on them.
+
+#define NT_SERIES_LANES 4
+#define NT_SKY_MAX_DAYS 2.0  // longest window nt_internal_sky_window accepts
+
+enum { NT_SKY_SUN = 0, NT_SKY_MOON };
+
+// sin/cos of `n` angles (radians); vectorizable polynomial, |x| < 1e6.
+void nt_internal_sincos(const double* x, double* s, double* c, size_t n);
+
+// Observer and frame data for one body over [ut0, ut0 + days] (UT days since
+// J2000). Precession/nutation, TT-UT and GAST-ERA are interpolated linearly
+// between the window ends; the Earth rotation angle is exact per instant.
+typedef struct {
+  int body;
+  double ut0, days;
+  double latitude, longitude;
+  double sin_lat, cos_lat;
+  double obs_xy_au, obs_z_au;  // observer distance from the axis / equator plane
+  double tt_offset[2];         // TT - UT at the window ends (days)
+  double st_offset[2];         // GAST - ERA at the window ends (degrees)
+  double rot[2][3][3];         // series frame -> true equator of date at the window ends
+} nt_sky_window;
+
+typedef struct {
+  double altitude_deg;  // topocentric center altitude, no refraction
+  double distance_au;   // topocentric
+  double ra_deg;        // geocentric, true equator of date, [0, 360)
+  double dec_deg;
+} nt_sky_sample;
+
+nt_err nt_internal_sky_window(nt_sky_window* w, int body, double latitude_deg, double longitude_deg,
+                              double ut0, double days);
+void nt_internal_sky_eval(const nt_sky_window* w, const double* ut, size_t n, nt_sky_sample* out);
+// Instants this thread has passed to nt_internal_sky_eval so far.
+uint64_t nt_internal_sky_eval_count(void);
+// Instants a search's begin step evaluates (its declination range).
+#define NT_SKY_BEGIN_EVALUATIONS 3
+// Charged for a query that falls back to the vendor search (see nt_sky_query_state).
+#define NT_SKY_FALLBACK_EVALUATIONS 4
+
+// First crossing of each query's altitude after the window start, with the
+// semantics of Astronomy_SearchAltitude / Astronomy_SearchRiseSetEx (same
+// slope-bound pruning of hidden rise/set pairs, roots past `limit_days` fail).
+// All queries share one probe grid and their refinement steps are evaluated
+// together.
+typedef struct {
+  double target_deg;   // altitude of the center, or of the top of the disc when `disc`
+  int direction;       // +1 rising through the target, -1 setting
+  int disc;            // rise/set: the top of the disc (target: the vendor's sea-level rise/set altitude)
+  double limit_days;   // <= window days
+  int found;           // out
+  double ut;           // out: UT days since J2000
+} nt_sky_crossing;
+
+void nt_internal_sky_crossings(const nt_sky_window* w, nt_sky_crossing* q, size_t count);
+
+// The same search as a resumable state machine, for callers with a budget.
+// Partial evaluations stop between batches; a finished search leaves the
+// results of nt_internal_sky_crossings in `q`.
+#define NT_SKY_QUERY_MAX 8
+#ifndef NT_SKY_CAND_MAX
+#define NT_SKY_CAND_MAX 32   // pending split intervals per query (tests build smaller queues)
+#endif
+#define NT_SKY_GRID_MAX 50   // NT_SKY_MAX_DAYS of hourly probes
+
+typedef struct {
+  double t1, t2, a1, a2;
+} nt_sky_bracket;
+
+typedef struct {
+  int done;
+  int have;            // `best` holds the leftmost rising bracket so far
+  nt_sky_bracket best;
+  int ncand;
+  nt_sky_bracket cand[NT_SKY_CAND_MAX];
+  int side;            // Illinois: endpoint replaced on the previous step (-1 t1, +1 t2)
+  int steps;
+  // A split interval found the queue full: the query is answered by the vendor
+  // search instead (1 pending, 2 done). Real ephemerides queue at most a few.
+  int overflow;
+} nt_sky_query_state;
+
+typedef struct {
+  nt_sky_window w;
+  size_t count;
+  nt_sky_crossing q[NT_SKY_QUERY_MAX];
+  double max_slope;
+  int phase;
+  int ngrid, grid_done;
+  double grid_ut[NT_SKY_GRID_MAX];
+  nt_sky_sample grid[NT_SKY_GRID_MAX];
+  nt_sky_query_state st[NT_SKY_QUERY_MAX];
+} nt_sky_search;
+
+typedef struct {
+  uint64_t max_evaluations;  // instants; 0 = no cap
+  double deadline_s;         // nt_internal_clock_s() value; 0 = none
+  uint64_t evaluations;      // spent so far
+} nt_sky_budget;
+
+double nt_internal_clock_s(void);
+double nt_internal_max_altitude_slope(const nt_sky_window* w);
+// At most NT_SKY_QUERY_MAX queries.
+void nt_internal_sky_search_begin(nt_sky_search* s, const nt_sky_window* w, const nt_sky_crossing* q, size_t count);
+// 1 once finished; `b` NULL runs to completion.
+int nt_internal_sky_search_run(nt_sky_search* s, nt_sky_budget* b);
+int nt_internal_sky_search_done(const nt_sky_search* s);
+// Best guess for query k so far: found/ut within +-bound_days of the crossing
+// the finished search returns. 0 when it is not yet known whether it crosses.
+int nt_internal_sky_search_estimate(const nt_sky_search* s, size_t k, int* found, double* ut, double* bound_days);
+// Highest grid altitude (topocentric, no refraction): 1 inside the grid,
+// 0 at an end, -1 before the grid is evaluated.
+int nt_internal_sky_search_peak(const nt_sky_search* s, double* altitude_deg);
+
+// -------------------------
+// Event searches in steps (natural_time.c)
+// -------------------------
+// nt_sun_events_for_date / nt_moon_events_for_date split at the search, so
+// natural_time_budget.c can run it under a budget; the cache helpers are the
+// lookup and store steps those functions wrap around it.
+
+typedef struct {
+  nt_sky_search search;
+  int32_t regime[NT_SUN_THRESHOLD_COUNT];  // before the searches
+  int query_of[NT_SUN_EVENT_COUNT];        // -1: ruled out by the regime
+} nt_sun_search;
+
+typedef struct {
+  nt_sky_search search;  // rise, set
+  int32_t regime;
+} nt_moon_search;
+
+nt_err nt_internal_sun_search_begin(const nt_natural_date* nd, double latitude_deg, nt_sun_search* out);
+// Times of a finished search (one more instant when a regime falls back to the altitude).
+void nt_internal_sun_search_times(const nt_sun_search* s, nt_sun_event_times* out);
+nt_err nt_internal_moon_search_begin(const nt_natural_date* nd, double latitude_deg, nt_moon_search* out);
+// Everything but highest_altitude, from a finished search.
+void nt_internal_moon_search_events(const nt_natural_date* nd, const nt_moon_search* s, nt_moon_events* out);
+// The vendor's transit search (Astronomy_SearchHourAngleEx), refracted.
+double nt_internal_moon_transit_altitude(const nt_natural_date* nd, double latitude_deg);
+
+// 1 when the thread cache, the loaded snapshot or the shared-memory cache has it.
+int nt_internal_cached_sun_events(const nt_natural_date* nd, double latitude_deg, nt_sun_events* out);
+int nt_internal_cached_moon_events(const nt_natural_date* nd, double latitude_deg, nt_moon_events* out);
+// Fills the thread cache; `computed` also publishes and records the result.
+void nt_internal_store_sun_events(const nt_natural_date* nd, double latitude_deg, const nt_sun_events* v, int computed);
+void nt_internal_store_moon_events(const nt_natural_date* nd, double latitude_deg, const nt_moon_events* v);
+
+// -------------------------
+// Cache records (natural_time_snapshot.c)
+// -------------------------
+// Fixed-layout results shared by the snapshot and shared-memory caches. Each
+// record starts with its key; keys are built in zeroed records with -0.0 folded
+// into +0.0, so equal keys compare equal byte for byte. No valid key has all
+// bits set (latitudes are never NaN, seasons are stored with status 0 and
+// mustaches with pad 0).
+
+enum { NT_CACHE_SEASONS = 0, NT_CACHE_SUN, NT_CACHE_MOON, NT_CACHE_MUSTACHES, NT_CACHE_TABLES };
+
+typedef struct {
+  int32_t year;
+  int32_t status;   // astro_status_t of Astronomy_Seasons
+  double ut[4];     // March equinox, June solstice, September equinox, December solstice
+} nt_seasons_record;
+
+typedef struct {
+  int64_t nadir;
+  double latitude;
+  double longitude;
+  nt_sun_events value;
+} nt_sun_record;
+
+typedef struct {
+  int64_t nadir;
+  double latitude;
+  double longitude;
+  nt_moon_events value;
+} nt_moon_record;
+
+typedef struct {
+  int32_t year;
+  int32_t pad;
+  double latitude;
+  nt_mustaches value;
+} nt_mustaches_record;
+
+extern const size_t nt_cache_record_size[NT_CACHE_TABLES];
+extern const size_t nt_cache_key_size[NT_CACHE_TABLES];
+
+void nt_internal_seasons_key(nt_seasons_record* r, int32_t year);
+void nt_internal_sun_key(nt_sun_record* r, int64_t nadir, double latitude_deg, double longitude_deg);
+void nt_internal_moon_key(nt_moon_record* r, int64_t nadir, double latitude_deg, double longitude_deg);
+void nt_internal_mustaches_key(nt_mustaches_record* r, int32_t year, double latitude_deg);
+
+// Build configuration that changes results: caches from another one are stale.
+#define NT_CONFIG_FIXED_POINT 0x1u
+#define NT_CONFIG_EPHEMERIS_CORE 0x2u
+#if defined(NT_FIXED_POINT) && defined(NT_EPHEMERIS_CORE)
+#define NT_BUILD_CONFIG (NT_CONFIG_FIXED_POINT | NT_CONFIG_EPHEMERIS_CORE)
+#elif defined(NT_FIXED_POINT)
+#define NT_BUILD_CONFIG NT_CONFIG_FIXED_POINT
+#elif defined(NT_EPHEMERIS_CORE)
+#define NT_BUILD_CONFIG NT_CONFIG_EPHEMERIS_CORE
+#else
+#define NT_BUILD_CONFIG 0u
+#endif
+
+// -------------------------
+// Cache snapshots (natural_time_snapshot.c)
+// -------------------------
+// Lookups in the loaded snapshot (1 on a hit) and recording of results computed
+// or served from the shared-memory cache or the snapshot.
+
+int nt_internal_snapshot_seasons(int32_t year, nt_seasons_record* out);
+int nt_internal_snapshot_sun_events(int64_t nadir, double latitude_deg, double longitude_deg, nt_sun_events* out);
+int nt_internal_snapshot_moon_events(int64_t nadir, double latitude_deg, double longitude_deg, nt_moon_events* out);
+int nt_internal_snapshot_mustaches(int32_t year, double latitude_deg, nt_mustaches* out);
+
+void nt_internal_record_seasons(const nt_seasons_record* r);
+void nt_internal_record_sun_events(int64_t nadir, double latitude_deg, double longitude_deg, const nt_sun_events* v);
+void nt_internal_record_moon_events(int64_t nadir, double latitude_deg, double longitude_deg, const nt_moon_events* v);
+void nt_internal_record_mustaches(int32_t year, double latitude_deg, const nt_mustaches* v);
+
+// -------------------------
+// Shared-memory cache (natural_time_shm.c)
+// -------------------------
+// Lookups in the attached segment (1 on a hit) and publication of freshly
+// computed results; both are no-ops when no segment is attached.
+
+int nt_internal_shm_seasons(int32_t year, nt_seasons_record* out);
+int nt_internal_shm_sun_events(int64_t nadir, double latitude_deg, double longitude_deg, nt_sun_events* out);
+int nt_internal_shm_moon_events(int64_t nadir, double latitude_deg, double longitude_deg, nt_moon_events* out);
+int nt_internal_shm_mustaches(int32_t year, double latitude_deg, nt_mustaches* out);
+
+void nt_internal_publish_seasons(const nt_seasons_record* r);
+void nt_internal_publish_sun_events(int64_t nadir, double latitude_deg, double longitude_deg, const nt_sun_events* v);
+void nt_internal_publish_moon_events(int64_t nadir, double latitude_deg, double longitude_deg, const nt_moon_events* v);
+void nt_internal_publish_mustaches(int32_t year, double latitude_deg, const nt_mustaches* v);
+
+#if defined(NT_SHM_TEST_HOOKS)
+// Marks a slot as being written by `pid`, as a writer that died mid-write
+// leaves it. Only in the library test_shm builds for itself.
+void nt_internal_shm_abandon_slot(int table, uint32_t index, int32_t pid);
+#endif
+
+// -------------------------
+// Workload capture (natural_time_capture.c)
+// -------------------------
+// Public entry points wrap their body in NT_CAPTURED: outside a capture that is
+// one relaxed load; inside, the outermost call is timed and recorded.
+
+typedef struct {
+  uint64_t start_ns;
+  nt_cache_stats caches;
+} nt_capture_call;
+
+// 1 when the call is recorded; nt_internal_capture_end must follow.
+int nt_internal_capture_begin(nt_capture_call* c);
+void nt_internal_capture_end(const nt_capture_call* c, int call, int64_t unix_ms, double longitude_deg,
+                             double latitude_deg, nt_err status);
+
+#define NT_CAPTURED(call, unix_ms, longitude_deg, latitude_deg, body) \
+  do {                                                                 \
+    nt_capture_call capture_;                                          \
+    if (!nt_internal_capture_begin(&capture_)) return (body);          \
+    nt_err captured_ = (body);                                         \
+    nt_internal_capture_end(&capture_, (call), (unix_ms), (longitude_deg), (latitude_deg), captured_); \
+    return captured_;                                                  \
+  } while (0)
+
+#endif // NATURAL_TIME_INTERNAL_H
@@ -0,0 +1,340 @@
+#include "natural_time_pack.h"
+#include <math.h>
+#include <string.h>
+
+static const int64_t MS_PER_DAY = 86400000LL;
+static const int64_t END_OF_ARTIFICIAL_TIME = 1356091200000LL;
+static const int64_t NEW_YEAR_NOON_PHASE = 43200000LL; // year starts at longitude 180 are 12:00 UTC
+
+#define PACK_VALID (1u << 31)
+#define PACK_LEAP (1u << 30)
+#define PACK_YEAR_SHIFT 18
+#define PACK_YEAR_MASK 0xFFFu
+#define PACK_DOY_MASK 0x1FFu
+
+#define BLOCK_MAGIC 0x3142544Eu // "NTB1"
+
+static int64_t floor_mod_i64(int64_t a, int64_t b) {
+  int64_t r = a % b;
+  return (r < 0) ? r + b : r;
+}
+
+static uint32_t pack_bits(int32_t year, int32_t day_of_year, int32_t duration) {
+  return PACK_VALID | ((duration == 366) ? PACK_LEAP : 0u) |
+         ((uint32_t)(year - NT_PACKED_YEAR_MIN) << PACK_YEAR_SHIFT) | (uint32_t)day_of_year;
+}
+
+nt_err nt_pack_dates(const nt_natural_date* in, nt_packed_date* out, size_t count) {
+  if ((!in || !out) && count > 0) return NT_ERR_INTERNAL;
+  nt_err err = NT_OK;
+  for (size_t i = 0; i < count; ++i) {
+    const nt_natural_date* nd = &in[i];
+    if (nd->year < NT_PACKED_YEAR_MIN || nd->year > NT_PACKED_YEAR_MAX || nd->day_of_year < 1 ||
+        nd->day_of_year > nd->year_duration || (nd->year_duration != 365 && nd->year_duration != 366)) {
+      memset(&out[i], 0, sizeof(out[i]));
+      err = NT_ERR_RANGE;
+      continue;
+    }
+    out[i].unix_ms = nd->unix_time;
+    out[i].longitude_udeg = (int32_t)llround(nd->longitude * 1e6);
+    out[i].bits = pack_bits(nd->year, nd->day_of_year, nd->year_duration);
+  }
+  return err;
+}
+
+nt_err nt_pack_unix_ms(const int64_t* unix_ms, size_t count, int32_t longitude_udeg, nt_packed_date* out) {
+  if ((!unix_ms || !out) && count > 0) return NT_ERR_INTERNAL;
+  if (longitude_udeg < -180000000 || longitude_udeg > 180000000) return NT_ERR_RANGE;
+  nt_err err = NT_OK;
+  // Current natural year segment [year_start, year_start + duration days).
+  int have = 0;
+  int64_t year_start = 0, year_end = 0;
+  int32_t year = 0, duration = 0;
+  for (size_t i = 0; i < count; ++i) {
+    int64_t t = unix_ms[i];
+    if (!have || t < year_start || t >= year_end) {
+      nt_natural_date nd;
+      nt_err e = nt_make_natural_date_fixed(t, longitude_udeg, &nd);
+      if (e != NT_OK || nd.year < NT_PACKED_YEAR_MIN || nd.year > NT_PACKED_YEAR_MAX) {
+        memset(&out[i], 0, sizeof(out[i]));
+        if (err == NT_OK) err = (e != NT_OK) ? e : NT_ERR_RANGE;
+        continue;
+      }
+      have = 1;
+      year_start = nd.year_start;
+      year_end = nd.year_start + (int64_t)nd.year_duration * MS_PER_DAY;
+      year = nd.year;
+      duration = nd.year_duration;
+    }
+    out[i].unix_ms = t;
+    out[i].longitude_udeg = longitude_udeg;
+    out[i].bits = pack_bits(year, (int32_t)((t - year_start) / MS_PER_DAY) + 1, duration);
+  }
+  return err;
+}
+
+nt_err nt_unpack_dates(const nt_packed_date* in, nt_natural_date* out, size_t count) {
+  if ((!in || !out) && count > 0) return NT_ERR_INTERNAL;
+  nt_err err = NT_OK;
+  for (size_t i = 0; i < count; ++i) {
+    const nt_packed_date* p = &in[i];
+    nt_natural_date* nd = &out[i];
+    if (!(p->bits & PACK_VALID) || p->longitude_udeg < -180000000 || p->longitude_udeg > 180000000) {
+      memset(nd, 0, sizeof(*nd));
+      err = NT_ERR_RANGE;
+      continue;
+    }
+    // Same integer shift as nt_make_natural_date_fixed: (180° - lon) days/360, rounded.
+    int64_t x25 = (180000000LL - (int64_t)p->longitude_udeg) * 6LL;
+    int64_t phase = NEW_YEAR_NOON_PHASE + (x25 + 12) / 25;
+    int64_t whole_days = (int64_t)(p->bits & PACK_DOY_MASK) - 1;
+    int64_t nadir = p->unix_ms - floor_mod_i64(p->unix_ms - phase, MS_PER_DAY);
+    int64_t eat_local = END_OF_ARTIFICIAL_TIME + x25 / 25;
+
+    nd->year = (int32_t)((p->bits >> PACK_YEAR_SHIFT) & PACK_YEAR_MASK) + NT_PACKED_YEAR_MIN;
+    nd->moon = (int32_t)(whole_days / 28) + 1;
+    nd->week = (int32_t)(whole_days / 7) + 1;
+    nd->week_of_moon = (int32_t)((whole_days / 7) % 4) + 1;
+    nd->unix_time = p->unix_ms;
+    nd->longitude = (double)p->longitude_udeg / 1e6;
+    int64_t rel = p->unix_ms - eat_local;
+    nd->day = (int32_t)(rel / MS_PER_DAY - ((rel % MS_PER_DAY) < 0 ? 1 : 0));
+    nd->day_of_year = (int32_t)whole_days + 1;
+    nd->day_of_moon = (int32_t)(whole_days % 28) + 1;
+    nd->day_of_week = (int32_t)(whole_days % 7) + 1;
+    nd->is_rainbow_day = (nd->day_of_year > 13 * 28) ? 1 : 0;
+    nd->time_deg = ((double)(p->unix_ms - nadir)) * 360.0 / (double)MS_PER_DAY;
+    if (nd->time_deg >= 360.0) nd->time_deg = 0.0;
+    nd->year_start = nadir - whole_days * MS_PER_DAY;
+    nd->year_duration = (p->bits & PACK_LEAP) ? 366 : 365;
+    nd->nadir = nadir;
+  }
+  return err;
+}
+
+// -------------------------
+// Columnar blocks
+// -------------------------
+//
+// Header (little-endian, NT_BLOCK_HEADER_SIZE bytes):
+//   u32 magic, u32 count, i64 ts_base, i64 delta_min, i32 lon_base,
+//   u32 runs, u8 ts_bits, u8 lon_bits, u16 flags (0), u32 payload_size
+// Payload: ts words, lon words (u64, ceil((count-1) * bits / 64) each), then
+// `runs` × (u32 bits, u32 length).
+
+static void store_u32(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; ++i) p[i] = (uint8_t)(v >> (8 * i)); }
+static void store_u64(uint8_t* p, uint64_t v) { for (int i = 0; i < 8; ++i) p[i] = (uint8_t)(v >> (8 * i)); }
+static uint32_t load_u32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static uint64_t load_u64(const uint8_t* p) { return (uint64_t)load_u32(p) | ((uint64_t)load_u32(p + 4) << 32); }
+
+static int bit_width(uint64_t v) {
+  int w = 0;
+  while (v) {
+    w++;
+    v >>= 1;
+  }
+  return w;
+}
+
+static size_t packed_words(size_t n, int width) { return (n * (size_t)width + 63) / 64; }
+
+static uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static int64_t unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+// Writes n values of `width` bits (values already masked) as little-endian u64 words.
+static uint8_t* put_packed(uint8_t* p, size_t n, int width, uint64_t (*value)(const nt_packed_date*, size_t, const void*),
+                           const nt_packed_date* in, const void* ctx) {
+  if (width == 0) return p;
+  uint64_t acc = 0;
+  int used = 0;
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t v = value(in, i + 1, ctx);
+    acc |= v << used;
+    if (used + width >= 64) {
+      store_u64(p, acc);
+      p += 8;
+      int spill = used + width - 64;
+      acc = (spill > 0) ? v >> (width - spill) : 0;
+      used = spill;
+    } else {
+      used += width;
+    }
+  }
+  if (used > 0) {
+    store_u64(p, acc);
+    p += 8;
+  }
+  return p;
+}
+
+static uint64_t ts_value(const nt_packed_date* in, size_t i, const void* ctx) {
+  int64_t delta_min = *(const int64_t*)ctx;
+  return (uint64_t)in[i].unix_ms - (uint64_t)in[i - 1].unix_ms - (uint64_t)delta_min;
+}
+
+static uint64_t lon_value(const nt_packed_date* in, size_t i, const void* ctx) {
+  (void)ctx;
+  return zigzag((int64_t)in[i].longitude_udeg - (int64_t)in[i - 1].longitude_udeg);
+}
+
+// Unpacks value i (width 1..64) from little-endian u64 words.
+static uint64_t get_packed(const uint8_t* words, size_t i, int width) {
+  size_t pos = i * (size_t)width;
+  size_t w = pos >> 6;
+  int off = (int)(pos & 63);
+  uint64_t v = load_u64(words + 8 * w) >> off;
+  if (off + width > 64) v |= load_u64(words + 8 * (w + 1)) << (64 - off);
+  return (width == 64) ? v : v & ((1ULL << width) - 1);
+}
+
+size_t nt_block_bound(size_t count) {
+  // Two bit-packed columns of at most 64 bits per value, plus one run per record.
+  return NT_BLOCK_HEADER_SIZE + 2 * (packed_words(count, 64) * 8) + count * 8;
+}
+
+nt_err nt_block_write(const nt_packed_date* in, size_t count, uint8_t* out, size_t capacity, size_t* out_size) {
+  if (!out || !out_size || (!in && count > 0)) return NT_ERR_INTERNAL;
+  if (count > UINT32_MAX) return NT_ERR_RANGE;
+  int64_t delta_min = 0;
+  uint64_t ts_max = 0, lon_max = 0;
+  size_t runs = (count > 0) ? 1 : 0;
+  for (size_t i = 1; i < count; ++i) {
+    int64_t d = (int64_t)((uint64_t)in[i].unix_ms - (uint64_t)in[i - 1].unix_ms);
+    if (i == 1 || d < delta_min) delta_min = d;
+    if (in[i].bits != in[i - 1].bits) runs++;
+  }
+  for (size_t i = 1; i < count; ++i) {
+    uint64_t t = ts_value(in, i, &delta_min);
+    uint64_t l = lon_value(in, i, NULL);
+    if (t > ts_max) ts_max = t;
+    if (l > lon_max) lon_max = l;
+  }
+  int ts_bits = bit_width(ts_max), lon_bits = bit_width(lon_max);
+  size_t n = (count > 0) ? count - 1 : 0;
+  size_t payload = (packed_words(n, ts_bits) + packed_words(n, lon_bits)) * 8 + runs * 8;
+  if (NT_BLOCK_HEADER_SIZE + payload > capacity) return NT_ERR_RANGE;
+
+  store_u32(out, BLOCK_MAGIC);
+  store_u32(out + 4, (uint32_t)count);
+  store_u64(out + 8, count ? (uint64_t)in[0].unix_ms : 0);
+  store_u64(out + 16, (uint64_t)delta_min);
+  store_u32(out + 24, count ? (uint32_t)in[0].longitude_udeg : 0);
+  store_u32(out + 28, (uint32_t)runs);
+  out[32] = (uint8_t)ts_bits;
+  out[33] = (uint8_t)lon_bits;
+  out[34] = out[35] = 0;
+  store_u32(out + 36, (uint32_t)payload);
+
+  uint8_t* p = out + NT_BLOCK_HEADER_SIZE;
+  p = put_packed(p, n, ts_bits, ts_value, in, &delta_min);
+  p = put_packed(p, n, lon_bits, lon_value, in, NULL);
+  for (size_t i = 0; i < count;) {
+    size_t j = i + 1;
+    while (j < count && in[j].bits == in[i].bits) j++;
+    store_u32(p, in[i].bits);
+    store_u32(p + 4, (uint32_t)(j - i));
+    p += 8;
+    i = j;
+  }
+  *out_size = (size_t)(p - out);
+  return NT_OK;
+}
+
+typedef struct {
+  size_t count;
+  int64_t ts_base, delta_min;
+  int32_t lon_base;
+  size_t runs;
+  int ts_bits, lon_bits;
+  const uint8_t* ts_words;
+  const uint8_t* lon_words;
+  const uint8_t* run_data;
+} block_view_t;
+
+static nt_err block_open(const uint8_t* block, size_t size, block_view_t* v) {
+  if (!block || size < NT_BLOCK_HEADER_SIZE || load_u32(block) != BLOCK_MAGIC) return NT_ERR_RANGE;
+  v->count = load_u32(block + 4);
+  v->ts_base = (int64_t)load_u64(block + 8);
+  v->delta_min = (int64_t)load_u64(block + 16);
+  v->lon_base = (int32_t)load_u32(block + 24);
+  v->runs = load_u32(block + 28);
+  v->ts_bits = block[32];
+  v->lon_bits = block[33];
+  size_t payload = load_u32(block + 36);
+  size_t n = (v->count > 0) ? v->count - 1 : 0;
+  if (v->ts_bits > 64 || v->lon_bits > 64 || v->runs > v->count || (v->count > 0 && v->runs == 0)) return NT_ERR_RANGE;
+  size_t ts_len = packed_words(n, v->ts_bits) * 8, lon_len = packed_words(n, v->lon_bits) * 8;
+  if (payload != ts_len + lon_len + v->runs * 8 || NT_BLOCK_HEADER_SIZE + payload > size) return NT_ERR_RANGE;
+  v->ts_words = block + NT_BLOCK_HEADER_SIZE;
+  v->lon_words = v->ts_words + ts_len;
+  v->run_data = v->lon_words + lon_len;
+  return NT_OK;
+}
+
+nt_err nt_block_count(const uint8_t* block, size_t size, size_t* out_count) {
+  if (!out_count) return NT_ERR_INTERNAL;
+  block_view_t v;
+  nt_err e = block_open(block, size, &v);
+  if (e == NT_OK) *out_count = v.count;
+  return e;
+}
+
+static void decode_unix_ms(const block_view_t* v, int64_t* out, size_t stride_bytes) {
+  if (v->count == 0) return;
+  uint64_t t = (uint64_t)v->ts_base;
+  uint8_t* p = (uint8_t*)out;
+  *(int64_t*)p = (int64_t)t;
+  if (v->ts_bits == 0) {
+    // Constant spacing: no payload to read.
+    for (size_t i = 1; i < v->count; ++i) {
+      t += (uint64_t)v->delta_min;
+      *(int64_t*)(p + i * stride_bytes) = (int64_t)t;
+    }
+    return;
+  }
+  for (size_t i = 1; i < v->count; ++i) {
+    t += get_packed(v->ts_words, i - 1, v->ts_bits) + (uint64_t)v->delta_min;
+    *(int64_t*)(p + i * stride_bytes) = (int64_t)t;
+  }
+}
+
+nt_err nt_block_read_unix_ms(const uint8_t* block, size_t size, int64_t* out, size_t capacity, size_t* out_count) {
+  if (!out || !out_count) return NT_ERR_INTERNAL;
+  block_view_t v;
+  nt_err e = block_open(block, size, &v);
+  if (e != NT_OK) return e;
+  *out_count = v.count;
+  if (v.count > capacity) return NT_ERR_RANGE;
+  decode_unix_ms(&v, out, sizeof(int64_t));
+  return NT_OK;
+}
+
+nt_err nt_block_read(const uint8_t* block, size_t size, nt_packed_date* out, size_t capacity, size_t* out_count) {
+  if (!out || !out_count) return NT_ERR_INTERNAL;
+  block_view_t v;
+  nt_err e = block_open(block, size, &v);
+  if (e != NT_OK) return e;
+  *out_count = v.count;
+  if (v.count > capacity) return NT_ERR_RANGE;
+  if (v.count == 0) return NT_OK;
+
+  decode_unix_ms(&v, &out[0].unix_ms, sizeof(nt_packed_date));
+
+  int64_t lon = v.lon_base;
+  out[0].longitude_udeg = (int32_t)lon;
+  for (size_t i = 1; i < v.count; ++i) {
+    if (v.lon_bits) lon += unzigzag(get_packed(v.lon_words, i - 1, v.lon_bits));
+    out[i].longitude_udeg = (int32_t)lon;
+  }
+
+  size_t i = 0;
+  for (size_t r = 0; r < v.runs; ++r) {
+    uint32_t bits = load_u32(v.run_data + 8 * r);
+    size_t len = load_u32(v.run_data + 8 * r + 4);
+    if (len > v.count - i) return NT_ERR_RANGE;
+    for (size_t k = 0; k < len; ++k) out[i++].bits = bits;
+  }
+  return (i == v.count) ? NT_OK : NT_ERR_RANGE;
+}
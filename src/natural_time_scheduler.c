@@ -0,0 +1,396 @@
+#include "natural_time_scheduler.h"
+#include "natural_time_internal.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const int64_t MS_PER_DAY = 86400000LL;
+
+#define DAY_EVENTS_MAX 16
+#define LOCATION_DAY_SLOTS 3
+#define SEARCH_HORIZON_DAYS 400 // every kind recurs within a natural year, even at the poles
+
+static const uint32_t SUN_KINDS = NT_EVENT_SUNRISE | NT_EVENT_SUNSET | NT_EVENT_NIGHT_START |
+                                  NT_EVENT_NIGHT_END | NT_EVENT_MORNING_GOLDEN | NT_EVENT_EVENING_GOLDEN;
+static const uint32_t MOON_KINDS = NT_EVENT_NEW_MOON | NT_EVENT_FIRST_QUARTER | NT_EVENT_FULL_MOON | NT_EVENT_LAST_QUARTER;
+static const uint32_t ALL_KINDS = (NT_EVENT_LAST_QUARTER << 1) - 1;
+
+typedef struct {
+  uint32_t kind;
+  int64_t event_ms;
+  double deg;
+} day_event_t;
+
+// One evaluated natural day of a location cell, events sorted by (event_ms, kind).
+typedef struct {
+  int valid;
+  int64_t nadir;
+  int count;
+  day_event_t ev[DAY_EVENTS_MAX];
+} day_slot_t;
+
+typedef struct {
+  int32_t qlat;
+  int32_t qlon;
+  double latitude;        // cell centre used for every subscriber in the cell
+  double longitude;
+  uint32_t kinds;         // union of subscriber kinds; days are evaluated for all of them
+  int next_slot;
+  day_slot_t days[LOCATION_DAY_SLOTS];
+} location_t;
+
+typedef struct {
+  int active;
+  uint32_t generation;    // bumped on unsubscribe so stale heap entries are skipped
+  size_t location;
+  uint32_t kinds;
+  int64_t offset_ms;
+  void* user_data;
+} subscription_t;
+
+typedef struct {
+  int64_t fire;
+  uint32_t id;
+  uint32_t kind;
+  uint32_t generation;
+  int64_t event_ms;
+  double deg;
+} heap_entry_t;
+
+struct nt_scheduler {
+  nt_clock_fn clock;
+  void* clock_ctx;
+  double cell_deg;
+
+  subscription_t* subs;
+  size_t subs_len, subs_cap, active;
+  uint32_t* free_ids;
+  size_t free_len, free_cap;
+
+  location_t* locs;
+  size_t locs_len, locs_cap;
+  size_t* loc_table;      // open addressing, stores index + 1 (0 = empty)
+  size_t loc_table_cap;
+
+  heap_entry_t* heap;
+  size_t heap_len, heap_cap;
+
+  uint64_t days_computed;
+};
+
+static int64_t system_clock_ms(void* ctx) {
+  (void)ctx;
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (int64_t)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000L;
+}
+
+static int grow(void** buf, size_t* cap, size_t need, size_t elem) {
+  if (need <= *cap) return 1;
+  size_t n = *cap ? *cap * 2 : 16;
+  while (n < need) n *= 2;
+  void* p = realloc(*buf, n * elem);
+  if (!p) return 0;
+  *buf = p;
+  *cap = n;
+  return 1;
+}
+
+// -------------------------
+// Min-heap on (fire, id, kind)
+// -------------------------
+
+static int heap_less(const heap_entry_t* a, const heap_entry_t* b) {
+  if (a->fire != b->fire) return a->fire < b->fire;
+  if (a->id != b->id) return a->id < b->id;
+  return a->kind < b->kind;
+}
+
+static int heap_push(nt_scheduler* s, heap_entry_t e) {
+  if (!grow((void**)&s->heap, &s->heap_cap, s->heap_len + 1, sizeof(heap_entry_t))) return 0;
+  size_t i = s->heap_len++;
+  while (i > 0) {
+    size_t parent = (i - 1) / 2;
+    if (!heap_less(&e, &s->heap[parent])) break;
+    s->heap[i] = s->heap[parent];
+    i = parent;
+  }
+  s->heap[i] = e;
+  return 1;
+}
+
+static heap_entry_t heap_pop(nt_scheduler* s) {
+  heap_entry_t top = s->heap[0];
+  heap_entry_t last = s->heap[--s->heap_len];
+  size_t i = 0;
+  for (;;) {
+    size_t child = 2 * i + 1;
+    if (child >= s->heap_len) break;
+    if (child + 1 < s->heap_len && heap_less(&s->heap[child + 1], &s->heap[child])) child++;
+    if (!heap_less(&s->heap[child], &last)) break;
+    s->heap[i] = s->heap[child];
+    i = child;
+  }
+  if (s->heap_len > 0) s->heap[i] = last;
+  return top;
+}
+
+// -------------------------
+// Location cells
+// -------------------------
+
+static size_t cell_hash(int32_t qlat, int32_t qlon) {
+  uint64_t h = ((uint64_t)(uint32_t)qlat << 32) | (uint32_t)qlon;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return (size_t)h;
+}
+
+static int rehash_locations(nt_scheduler* s, size_t cap) {
+  size_t* table = (size_t*)calloc(cap, sizeof(size_t));
+  if (!table) return 0;
+  for (size_t i = 0; i < s->locs_len; ++i) {
+    size_t slot = cell_hash(s->locs[i].qlat, s->locs[i].qlon) & (cap - 1);
+    while (table[slot]) slot = (slot + 1) & (cap - 1);
+    table[slot] = i + 1;
+  }
+  free(s->loc_table);
+  s->loc_table = table;
+  s->loc_table_cap = cap;
+  return 1;
+}
+
+static int find_or_add_location(nt_scheduler* s, double latitude, double longitude, uint32_t kinds, size_t* out) {
+  int32_t qlat = (int32_t)llround(latitude / s->cell_deg);
+  int32_t qlon = (int32_t)llround(longitude / s->cell_deg);
+  if (s->loc_table_cap == 0 || 2 * (s->locs_len + 1) > s->loc_table_cap) {
+    if (!rehash_locations(s, s->loc_table_cap ? s->loc_table_cap * 2 : 64)) return 0;
+  }
+  size_t slot = cell_hash(qlat, qlon) & (s->loc_table_cap - 1);
+  while (s->loc_table[slot]) {
+    location_t* loc = &s->locs[s->loc_table[slot] - 1];
+    if (loc->qlat == qlat && loc->qlon == qlon) {
+      if ((loc->kinds | kinds) != loc->kinds) {
+        // New kinds for this cell: evaluated days no longer list everything.
+        loc->kinds |= kinds;
+        for (int d = 0; d < LOCATION_DAY_SLOTS; ++d) loc->days[d].valid = 0;
+      }
+      *out = s->loc_table[slot] - 1;
+      return 1;
+    }
+    slot = (slot + 1) & (s->loc_table_cap - 1);
+  }
+  if (!grow((void**)&s->locs, &s->locs_cap, s->locs_len + 1, sizeof(location_t))) return 0;
+  location_t* loc = &s->locs[s->locs_len];
+  memset(loc, 0, sizeof(*loc));
+  loc->qlat = qlat;
+  loc->qlon = qlon;
+  loc->latitude = fmin(90.0, fmax(-90.0, qlat * s->cell_deg));
+  loc->longitude = fmin(180.0, fmax(-180.0, qlon * s->cell_deg));
+  loc->kinds = kinds;
+  s->loc_table[slot] = s->locs_len + 1;
+  *out = s->locs_len++;
+  return 1;
+}
+
+static void add_day_event(day_slot_t* day, uint32_t kind, double deg) {
+  if (day->count >= DAY_EVENTS_MAX) return;
+  int64_t ms = day->nadir + llround(deg * (double)MS_PER_DAY / 360.0);
+  int i = day->count++;
+  // Insertion sort: a day holds a dozen events at most.
+  while (i > 0 && (day->ev[i - 1].event_ms > ms || (day->ev[i - 1].event_ms == ms && day->ev[i - 1].kind > kind))) {
+    day->ev[i] = day->ev[i - 1];
+    i--;
+  }
+  day->ev[i].kind = kind;
+  day->ev[i].event_ms = ms;
+  day->ev[i].deg = deg;
+}
+
+// Sun events come from the raw searches: only crossings found inside the
+// natural day are scheduled. nt_sun_events would hold seasonal defaults for the
+// others (a polar regime, or a crossing past either edge of the day).
+static void add_sun_events(day_slot_t* day, uint32_t kinds, const nt_sun_event_times* t) {
+  static const uint32_t KIND[NT_SUN_EVENT_COUNT] = {NT_EVENT_SUNRISE,    NT_EVENT_SUNSET,          NT_EVENT_NIGHT_START,
+                                                    NT_EVENT_NIGHT_END, NT_EVENT_MORNING_GOLDEN, NT_EVENT_EVENING_GOLDEN};
+  for (int i = 0; i < NT_SUN_EVENT_COUNT; ++i) {
+    int64_t ms = t->unix_ms[i] - day->nadir;
+    if (!(kinds & KIND[i]) || !t->found[i] || ms < 0 || ms >= MS_PER_DAY) continue;
+    add_day_event(day, KIND[i], (double)ms * 360.0 / (double)MS_PER_DAY);
+  }
+}
+
+static const day_slot_t* location_day(nt_scheduler* s, location_t* loc, int64_t nadir) {
+  for (int d = 0; d < LOCATION_DAY_SLOTS; ++d) {
+    if (loc->days[d].valid && loc->days[d].nadir == nadir) return &loc->days[d];
+  }
+  day_slot_t* day = &loc->days[loc->next_slot];
+  loc->next_slot = (loc->next_slot + 1) % LOCATION_DAY_SLOTS;
+  memset(day, 0, sizeof(*day));
+
+  nt_natural_date nd;
+  if (nt_make_natural_date(nadir, loc->longitude, &nd) != NT_OK) return NULL;
+  day->nadir = nd.nadir;
+  s->days_computed++;
+
+  if (loc->kinds & NT_EVENT_NADIR) add_day_event(day, NT_EVENT_NADIR, 0.0);
+  if ((loc->kinds & NT_EVENT_RAINBOW_DAY) && nd.is_rainbow_day) add_day_event(day, NT_EVENT_RAINBOW_DAY, 0.0);
+
+  if (loc->kinds & SUN_KINDS) {
+    nt_sun_event_times times;
+    if (nt_internal_sun_event_times(&nd, loc->latitude, &times) != NT_OK) return NULL;
+    add_sun_events(day, loc->kinds, &times);
+  }
+
+  if (loc->kinds & MOON_KINDS) {
+    // Per-year quarter table is cached by the core library and shared by all cells.
+    nt_moon_quarter q[NT_MOON_QUARTERS_MAX];
+    size_t n = 0;
+    if (nt_moon_quarters_for_year(&nd, q, NT_MOON_QUARTERS_MAX, &n) != NT_OK) return NULL;
+    for (size_t i = 0; i < n; ++i) {
+      if (q[i].day_of_year != nd.day_of_year) continue;
+      uint32_t kind = (uint32_t)NT_EVENT_NEW_MOON << q[i].quarter;
+      if (loc->kinds & kind) add_day_event(day, kind, q[i].time_deg);
+    }
+  }
+
+  day->valid = 1;
+  return day;
+}
+
+// First event of the subscription strictly after (after_ms, after_kind), pushed on the heap.
+static int schedule_next(nt_scheduler* s, uint32_t id, int64_t after_ms, uint32_t after_kind) {
+  subscription_t* sub = &s->subs[id - 1];
+  location_t* loc = &s->locs[sub->location];
+  nt_natural_date nd;
+  if (nt_make_natural_date(after_ms > 0 ? after_ms : 1, loc->longitude, &nd) != NT_OK) return 0;
+  int64_t nadir = nd.nadir;
+  for (int d = 0; d < SEARCH_HORIZON_DAYS; ++d, nadir += MS_PER_DAY) {
+    const day_slot_t* day = location_day(s, loc, nadir);
+    if (!day) return 0;
+    for (int i = 0; i < day->count; ++i) {
+      const day_event_t* e = &day->ev[i];
+      if (!(sub->kinds & e->kind)) continue;
+      if (e->event_ms < after_ms || (e->event_ms == after_ms && e->kind <= after_kind)) continue;
+      heap_entry_t h;
+      h.fire = e->event_ms - sub->offset_ms;
+      h.id = id;
+      h.kind = e->kind;
+      h.generation = sub->generation;
+      h.event_ms = e->event_ms;
+      h.deg = e->deg;
+      return heap_push(s, h);
+    }
+  }
+  return 1; // nothing within a year: leave the subscription idle
+}
+
+nt_scheduler* nt_scheduler_create(nt_clock_fn clock, void* clock_ctx, double cell_deg) {
+  nt_scheduler* s = (nt_scheduler*)calloc(1, sizeof(nt_scheduler));
+  if (!s) return NULL;
+  s->clock = clock ? clock : system_clock_ms;
+  s->clock_ctx = clock_ctx;
+  s->cell_deg = (cell_deg > 0.0) ? cell_deg : 0.01;
+  return s;
+}
+
+void nt_scheduler_destroy(nt_scheduler* s) {
+  if (!s) return;
+  free(s->subs);
+  free(s->free_ids);
+  free(s->locs);
+  free(s->loc_table);
+  free(s->heap);
+  free(s);
+}
+
+nt_err nt_scheduler_subscribe(nt_scheduler* s, const nt_subscription* sub, uint32_t* out_id) {
+  if (!s || !sub || !out_id) return NT_ERR_INTERNAL;
+  if (!(sub->latitude >= -90.0 && sub->latitude <= 90.0)) return NT_ERR_RANGE;
+  if (!(sub->longitude >= -180.0 && sub->longitude <= 180.0)) return NT_ERR_RANGE;
+  if (!(sub->offset_deg > -360.0 && sub->offset_deg < 360.0)) return NT_ERR_RANGE;
+  if (sub->kinds == 0 || (sub->kinds & ~ALL_KINDS)) return NT_ERR_RANGE;
+
+  size_t loc;
+  if (!find_or_add_location(s, sub->latitude, sub->longitude, sub->kinds, &loc)) return NT_ERR_INTERNAL;
+
+  uint32_t id;
+  if (s->free_len > 0) {
+    id = s->free_ids[--s->free_len];
+  } else {
+    if (!grow((void**)&s->subs, &s->subs_cap, s->subs_len + 1, sizeof(subscription_t))) return NT_ERR_INTERNAL;
+    s->subs[s->subs_len].generation = 0;
+    id = (uint32_t)++s->subs_len;
+  }
+  subscription_t* rec = &s->subs[id - 1];
+  rec->active = 1;
+  rec->location = loc;
+  rec->kinds = sub->kinds;
+  rec->offset_ms = llround(sub->offset_deg * (double)MS_PER_DAY / 360.0);
+  rec->user_data = sub->user_data;
+  s->active++;
+
+  // First event whose fire time is not in the past.
+  int64_t target = s->clock(s->clock_ctx) + rec->offset_ms;
+  if (!schedule_next(s, id, target - 1, UINT32_MAX)) {
+    nt_scheduler_unsubscribe(s, id);
+    return NT_ERR_INTERNAL;
+  }
+  *out_id = id;
+  return NT_OK;
+}
+
+nt_err nt_scheduler_unsubscribe(nt_scheduler* s, uint32_t id) {
+  if (!s || id == 0 || id > s->subs_len || !s->subs[id - 1].active) return NT_ERR_RANGE;
+  if (!grow((void**)&s->free_ids, &s->free_cap, s->free_len + 1, sizeof(uint32_t))) return NT_ERR_INTERNAL;
+  subscription_t* rec = &s->subs[id - 1];
+  rec->active = 0;
+  rec->generation++;
+  s->free_ids[s->free_len++] = id;
+  s->active--;
+  return NT_OK;
+}
+
+static int is_stale(const nt_scheduler* s, const heap_entry_t* e) {
+  const subscription_t* sub = &s->subs[e->id - 1];
+  return !sub->active || sub->generation != e->generation;
+}
+
+nt_err nt_scheduler_pop_due(nt_scheduler* s, nt_scheduled_event* out, size_t capacity, size_t* out_count) {
+  if (!s || (!out && capacity > 0) || !out_count) return NT_ERR_INTERNAL;
+  *out_count = 0;
+  int64_t now = s->clock(s->clock_ctx);
+  size_t n = 0;
+  while (n < capacity && s->heap_len > 0 && s->heap[0].fire <= now) {
+    heap_entry_t e = heap_pop(s);
+    if (is_stale(s, &e)) continue;
+    const subscription_t* sub = &s->subs[e.id - 1];
+    out[n].subscription_id = e.id;
+    out[n].kind = e.kind;
+    out[n].fire_time = e.fire;
+    out[n].event_time = e.event_ms;
+    out[n].event_deg = e.deg;
+    out[n].user_data = sub->user_data;
+    *out_count = ++n;
+    if (!schedule_next(s, e.id, e.event_ms, e.kind)) return NT_ERR_INTERNAL;
+  }
+  return NT_OK;
+}
+
+nt_err nt_scheduler_next_fire_time(nt_scheduler* s, int64_t* out_ms) {
+  if (!s || !out_ms) return NT_ERR_INTERNAL;
+  while (s->heap_len > 0 && is_stale(s, &s->heap[0])) heap_pop(s);
+  if (s->heap_len == 0) return NT_ERR_RANGE;
+  *out_ms = s->heap[0].fire;
+  return NT_OK;
+}
+
+void nt_scheduler_get_stats(const nt_scheduler* s, nt_scheduler_stats* out) {
+  if (!s || !out) return;
+  out->subscriptions = s->active;
+  out->locations = s->locs_len;
+  out->days_computed = s->days_computed;
+  out->pending = s->heap_len;
+}
@@ -0,0 +1,946 @@
+// Natural Time — batched ephemeris series.
+//
+// The Sun and Moon searches spend nearly all their time in two vendor series:
+// the VSOP87 Earth terms behind Astronomy_GeoVector(BODY_SUN) and the CalcMoon
+// trigonometric series behind Astronomy_GeoMoon, both evaluated one instant at a
+// time with scalar libm cos/sin. Here the same terms are evaluated for
+// NT_SERIES_LANES instants per call:
+//  - term tables are parallel arrays, and every kernel loops over lanes
+//    innermost without branches, so compilers emit packed SSE2/AVX/NEON code
+//    (💡 no intrinsics: the same source vectorizes on every CI target);
+//  - sin/cos are fdlibm's polynomial kernels after a Cody-Waite reduction,
+//    evaluated over whole argument arrays;
+//  - observer geometry reuses one precession/nutation frame per search window.
+// Parity with the vendor functions is checked by tests/unit/test_series.c.
+#include "natural_time_internal.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "astronomy.h"  // vendor/astronomy include path wired from CMake
+
+#define LANES NT_SERIES_LANES
+
+static const double PI2 = 6.283185307179586476925287;
+static const double ARC = 3600.0 * 180.0 / 3.14159265358979323846;  // arcseconds per radian
+static const double DAYS_PER_MILLENNIUM = 365250.0;
+static const double SECONDS_PER_DAY = 86400.0;
+
+// -------------------------
+// sin/cos
+// -------------------------
+
+// x = k*pi/2 + r, |r| <= pi/4; pi/2 split in 33-bit parts so k*PIO2_n is exact for |k| < 2^20.
+static const double TWO_OVER_PI = 6.36619772367581382433e-01;
+static const double PIO2_1 = 1.57079632673412561417e+00;
+static const double PIO2_2 = 6.07710050630396597660e-11;
+static const double PIO2_3 = 2.02226624871116645580e-21;
+static const double ROUND_MAGIC = 6755399441055744.0;  // 1.5 * 2^52: adding it rounds to an integer
+
+static const double S1 = -1.66666666666666324348e-01, S2 = 8.33333333332248946124e-03,
+                    S3 = -1.98412698298579493134e-04, S4 = 2.75573137070700676789e-06,
+                    S5 = -2.50507602534068634195e-08, S6 = 1.58969099521155010221e-10;
+static const double C1 = 4.16666666666666019037e-02, C2 = -1.38888888888741095749e-03,
+                    C3 = 2.48015872894767294178e-05, C4 = -2.75573143513906633035e-07,
+                    C5 = 2.08757232129817482790e-09, C6 = -1.13596475577881948265e-11;
+
+void nt_internal_sincos(const double* x, double* s, double* c, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    double kd = x[i] * TWO_OVER_PI + ROUND_MAGIC;
+    uint64_t bits;
+    memcpy(&bits, &kd, sizeof(bits));  // low bits hold k (two's complement modulo 4)
+    kd -= ROUND_MAGIC;
+    double r = ((x[i] - kd * PIO2_1) - kd * PIO2_2) - kd * PIO2_3;
+    double z = r * r;
+    double sr = r + r * z * (S1 + z * (S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)))));
+    double cr = 1.0 - 0.5 * z + z * z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+    unsigned q = (unsigned)(bits & 3u);
+    double sv = (q & 1u) ? cr : sr;
+    double cv = (q & 1u) ? sr : cr;
+    s[i] = (q & 2u) ? -sv : sv;
+    c[i] = ((q + 1u) & 2u) ? -cv : cv;
+  }
+}
+
+// -------------------------
+// Sun: VSOP87 Earth terms
+// -------------------------
+// Same 51 terms as the vendor's vsop_{lon,lat,rad}_Earth tables, flattened into
+// parallel arrays; group g multiplies t^EARTH_POWER[g] into coordinate EARTH_COORD[g].
+
+#define EARTH_TERMS 51
+#define EARTH_GROUPS 7
+static const int EARTH_GROUP_END[EARTH_GROUPS] = {28, 31, 32, 34, 48, 50, 51};
+static const int EARTH_COORD[EARTH_GROUPS] = {0, 0, 0, 1, 2, 2, 2};  // lon, lat, rad
+static const int EARTH_POWER[EARTH_GROUPS] = {0, 1, 2, 1, 0, 1, 2};
+
+static const double EARTH_AMPLITUDE[EARTH_TERMS] = {
+  1.75347045673, 0.03341656453, 0.00034894275, 0.00003417572,
+  0.00003497056, 0.00003135899, 0.00002676218, 0.00002342691,
+  0.00001273165, 0.00001324294, 0.00000901854, 0.00001199167,
+  0.00000857223, 0.00000779786, 0.00000990250, 0.00000753141,
+  0.00000505267, 0.00000492392, 0.00000356672, 0.00000284125,
+  0.00000242879, 0.00000317087, 0.00000271112, 0.00000206217,
+  0.00000205478, 0.00000202318, 0.00000126225, 0.00000155516,
+  6283.07584999140, 0.00206058863, 0.00004303419, 0.00008721859,
+  0.00227777722, 0.00003805678, 1.00013988784, 0.01670699632,
+  0.00013956024, 0.00003083720, 0.00001628463, 0.00001575572,
+  0.00000924799, 0.00000542439, 0.00000472110, 0.00000085831,
+  0.00000057056, 0.00000055736, 0.00000174844, 0.00000243181,
+  0.00103018607, 0.00001721238, 0.00004359385,
+};
+
+static const double EARTH_PHASE[EARTH_TERMS] = {
+  0.00000000000, 4.66925680415, 4.62610242189, 2.82886579754,
+  2.74411783405, 3.62767041756, 4.41808345438, 6.13516214446,
+  2.03709657878, 0.74246341673, 2.04505446477, 1.10962946234,
+  3.50849152283, 1.17882681962, 5.23268072088, 2.53339052847,
+  4.58292599973, 4.20505711826, 2.91954114478, 1.89869240932,
+  0.34481445893, 5.84901948512, 0.31486255375, 4.80646631478,
+  1.86953770281, 2.45767790232, 1.08295459501, 0.83306084617,
+  0.00000000000, 2.67823455808, 2.63512233481, 1.07253635559,
+  3.41376620530, 3.37063423795, 0.00000000000, 3.09846350258,
+  3.05524609456, 5.19846674381, 1.17387558054, 2.84685214877,
+  5.45292236722, 4.56409151453, 3.66100022149, 1.27079125277,
+  2.01374292245, 5.24159799170, 3.01193636733, 4.27349530790,
+  1.10748968172, 1.06442300386, 5.78455133808,
+};
+
+static const double EARTH_FREQUENCY[EARTH_TERMS] = {
+  0.00000000000, 6283.07584999140, 12566.15169998280, 3.52311834900,
+  5753.38488489680, 77713.77146812050, 7860.41939243920, 3930.20969621960,
+  529.69096509460, 11506.76976979360, 26.29831979980, 1577.34354244780,
+  398.14900340820, 5223.69391980220, 5884.92684658320, 5507.55323866740,
+  18849.22754997420, 775.52261132400, 0.06731030280, 796.29800681640,
+  5486.77784317500, 11790.62908865880, 10977.07880469900, 2544.31441988340,
+  5573.14280143310, 6069.77675455340, 20.77539549240, 213.29909543800,
+  0.00000000000, 6283.07584999140, 12566.15169998280, 6283.07584999140,
+  6283.07584999140, 12566.15169998280, 0.00000000000, 6283.07584999140,
+  12566.15169998280, 77713.77146812050, 5753.38488489680, 7860.41939243920,
+  11506.76976979360, 3930.20969621960, 5884.92684658320, 161000.68573767410,
+  83996.84731811189, 71430.69561812909, 18849.22754997420, 11790.62908865880,
+  6283.07584999140, 12566.15169998280, 6283.07584999140,
+};
+
+// VSOP87 ecliptic -> EQJ (the vendor's VsopRotate).
+static const double VSOP_TO_EQJ[3][3] = {
+  {1.0, 0.000000440360, -0.000000190919},
+  {-0.000000479966, 0.917482137087, -0.397776982902},
+  {0.0, 0.397776982902, 0.917482137087},
+};
+
+// Geocentric Sun in the VSOP87 ecliptic frame (AU): minus the heliocentric
+// Earth backdated by the light time, as Astronomy_GeoVector(BODY_SUN, ABERRATION).
+// 💡 The vendor iterates full evaluations at t - lt; the series derivative
+// (free from the same sin/cos) moves the result there to ~1e-10 rad instead.
+static void sun_lanes(const double tt[LANES], double out[3][LANES]) {
+  double t[LANES];
+  double arg[EARTH_TERMS * LANES], s[EARTH_TERMS * LANES], c[EARTH_TERMS * LANES];
+  double sum[EARTH_GROUPS][LANES] = {{0}}, rate[EARTH_GROUPS][LANES] = {{0}};
+  for (int j = 0; j < LANES; ++j) t[j] = tt[j] / DAYS_PER_MILLENNIUM;
+  for (int i = 0; i < EARTH_TERMS; ++i) {
+    for (int j = 0; j < LANES; ++j) arg[i * LANES + j] = EARTH_PHASE[i] + t[j] * EARTH_FREQUENCY[i];
+  }
+  nt_internal_sincos(arg, s, c, EARTH_TERMS * LANES);
+  for (int g = 0, i = 0; g < EARTH_GROUPS; ++g) {
+    for (; i < EARTH_GROUP_END[g]; ++i) {
+      double a = EARTH_AMPLITUDE[i], af = EARTH_AMPLITUDE[i] * EARTH_FREQUENCY[i];
+      for (int j = 0; j < LANES; ++j) {
+        sum[g][j] += a * c[i * LANES + j];
+        rate[g][j] -= af * s[i * LANES + j];
+      }
+    }
+  }
+
+  // Spherical coordinates and their rates (per millennium), backdated.
+  double sph[3][LANES] = {{0}}, dsph[3][LANES] = {{0}};
+  for (int g = 0; g < EARTH_GROUPS; ++g) {
+    int k = EARTH_COORD[g], p = EARTH_POWER[g];
+    for (int j = 0; j < LANES; ++j) {
+      double tp = (p == 0) ? 1.0 : (p == 1) ? t[j] : t[j] * t[j];
+      double dtp = (p == 0) ? 0.0 : (p == 1) ? 1.0 : 2.0 * t[j];
+      sph[k][j] += tp * sum[g][j];
+      dsph[k][j] += dtp * sum[g][j] + tp * rate[g][j];
+    }
+  }
+  double ang[2 * LANES], sa[2 * LANES], ca[2 * LANES], rad[LANES];
+  for (int j = 0; j < LANES; ++j) {
+    double lt = sph[2][j] / C_AUDAY / DAYS_PER_MILLENNIUM;
+    ang[j] = sph[0][j] - lt * dsph[0][j];
+    ang[LANES + j] = sph[1][j] - lt * dsph[1][j];
+    rad[j] = sph[2][j] - lt * dsph[2][j];
+  }
+  nt_internal_sincos(ang, sa, ca, 2 * LANES);
+  for (int j = 0; j < LANES; ++j) {
+    double rc = rad[j] * ca[LANES + j];
+    out[0][j] = -rc * ca[j];
+    out[1][j] = -rc * sa[j];
+    out[2][j] = -rad[j] * sa[LANES + j];
+  }
+}
+
+// -------------------------
+// Moon: CalcMoon
+// -------------------------
+// The vendor's CalcMoon (Montenbruck & Pfleger's Improved Lunar Ephemeris):
+// the same coefficients, with CO/SI power tables and the term sums per lane.
+
+typedef struct {
+  double coeff[4];  // arcseconds: longitude (DLAM), S (DS), gamma (GAM1C), parallax (SINPI)
+  int8_t arg[4];    // multiples of l, l', F, D
+} moon_term_t;
+
+static const moon_term_t MOON_TERMS[] = {
+  {{    13.9020,     14.0600,  -0.0010,    0.2607}, { 0,  0,  0,  4}},
+  {{     0.4030,     -4.0100,   0.3940,    0.0023}, { 0,  0,  0,  3}},
+  {{  2369.9120,   2373.3600,   0.6010,   28.2333}, { 0,  0,  0,  2}},
+  {{  -125.1540,   -112.7900,  -0.7250,   -0.9781}, { 0,  0,  0,  1}},
+  {{     1.9790,      6.9800,  -0.4450,    0.0433}, { 1,  0,  0,  4}},
+  {{   191.9530,    192.7200,   0.0290,    3.0861}, { 1,  0,  0,  2}},
+  {{    -8.4660,    -13.5100,   0.4550,   -0.1093}, { 1,  0,  0,  1}},
+  {{ 22639.5000,  22609.0700,   0.0790,  186.5398}, { 1,  0,  0,  0}},
+  {{    18.6090,      3.5900,  -0.0940,    0.0118}, { 1,  0,  0, -1}},
+  {{ -4586.4650,  -4578.1300,  -0.0770,   34.3117}, { 1,  0,  0, -2}},
+  {{     3.2150,      5.4400,   0.1920,   -0.0386}, { 1,  0,  0, -3}},
+  {{   -38.4280,    -38.6400,   0.0010,    0.6008}, { 1,  0,  0, -4}},
+  {{    -0.3930,     -1.4300,  -0.0920,    0.0086}, { 1,  0,  0, -6}},
+  {{    -0.2890,     -1.5900,   0.1230,   -0.0053}, { 0,  1,  0,  4}},
+  {{   -24.4200,    -25.1000,   0.0400,   -0.3000}, { 0,  1,  0,  2}},
+  {{    18.0230,     17.9300,   0.0070,    0.1494}, { 0,  1,  0,  1}},
+  {{  -668.1460,   -126.9800,  -1.3020,   -0.3997}, { 0,  1,  0,  0}},
+  {{     0.5600,      0.3200,  -0.0010,   -0.0037}, { 0,  1,  0, -1}},
+  {{  -165.1450,   -165.0600,   0.0540,    1.9178}, { 0,  1,  0, -2}},
+  {{    -1.8770,     -6.4600,  -0.4160,    0.0339}, { 0,  1,  0, -4}},
+  {{     0.2130,      1.0200,  -0.0740,    0.0054}, { 2,  0,  0,  4}},
+  {{    14.3870,     14.7800,  -0.0170,    0.2833}, { 2,  0,  0,  2}},
+  {{    -0.5860,     -1.2000,   0.0540,   -0.0100}, { 2,  0,  0,  1}},
+  {{   769.0160,    767.9600,   0.1070,   10.1657}, { 2,  0,  0,  0}},
+  {{     1.7500,      2.0100,  -0.0180,    0.0155}, { 2,  0,  0, -1}},
+  {{  -211.6560,   -152.5300,   5.6790,   -0.3039}, { 2,  0,  0, -2}},
+  {{     1.2250,      0.9100,  -0.0300,   -0.0088}, { 2,  0,  0, -3}},
+  {{   -30.7730,    -34.0700,  -0.3080,    0.3722}, { 2,  0,  0, -4}},
+  {{    -0.5700,     -1.4000,  -0.0740,    0.0109}, { 2,  0,  0, -6}},
+  {{    -2.9210,    -11.7500,   0.7870,   -0.0484}, { 1,  1,  0,  2}},
+  {{     1.2670,      1.5200,  -0.0220,    0.0164}, { 1,  1,  0,  1}},
+  {{  -109.6730,   -115.1800,   0.4610,   -0.9490}, { 1,  1,  0,  0}},
+  {{  -205.9620,   -182.3600,   2.0560,    1.4437}, { 1,  1,  0, -2}},
+  {{     0.2330,      0.3600,   0.0120,   -0.0025}, { 1,  1,  0, -3}},
+  {{    -4.3910,     -9.6600,  -0.4710,    0.0673}, { 1,  1,  0, -4}},
+  {{     0.2830,      1.5300,  -0.1110,    0.0060}, { 1, -1,  0,  4}},
+  {{    14.5770,     31.7000,  -1.5400,    0.2302}, { 1, -1,  0,  2}},
+  {{   147.6870,    138.7600,   0.6790,    1.1528}, { 1, -1,  0,  0}},
+  {{    -1.0890,      0.5500,   0.0210,    0.0000}, { 1, -1,  0, -1}},
+  {{    28.4750,     23.5900,  -0.4430,   -0.2257}, { 1, -1,  0, -2}},
+  {{    -0.2760,     -0.3800,  -0.0060,   -0.0036}, { 1, -1,  0, -3}},
+  {{     0.6360,      2.2700,   0.1460,   -0.0102}, { 1, -1,  0, -4}},
+  {{    -0.1890,     -1.6800,   0.1310,   -0.0028}, { 0,  2,  0,  2}},
+  {{    -7.4860,     -0.6600,  -0.0370,   -0.0086}, { 0,  2,  0,  0}},
+  {{    -8.0960,    -16.3500,  -0.7400,    0.0918}, { 0,  2,  0, -2}},
+  {{    -5.7410,     -0.0400,   0.0000,   -0.0009}, { 0,  0,  2,  2}},
+  {{     0.2550,      0.0000,   0.0000,    0.0000}, { 0,  0,  2,  1}},
+  {{  -411.6080,     -0.2000,   0.0000,   -0.0124}, { 0,  0,  2,  0}},
+  {{     0.5840,      0.8400,   0.0000,    0.0071}, { 0,  0,  2, -1}},
+  {{   -55.1730,    -52.1400,   0.0000,   -0.1052}, { 0,  0,  2, -2}},
+  {{     0.2540,      0.2500,   0.0000,   -0.0017}, { 0,  0,  2, -3}},
+  {{     0.0250,     -1.6700,   0.0000,    0.0031}, { 0,  0,  2, -4}},
+  {{     1.0600,      2.9600,  -0.1660,    0.0243}, { 3,  0,  0,  2}},
+  {{    36.1240,     50.6400,  -1.3000,    0.6215}, { 3,  0,  0,  0}},
+  {{   -13.1930,    -16.4000,   0.2580,   -0.1187}, { 3,  0,  0, -2}},
+  {{    -1.1870,     -0.7400,   0.0420,    0.0074}, { 3,  0,  0, -4}},
+  {{    -0.2930,     -0.3100,  -0.0020,    0.0046}, { 3,  0,  0, -6}},
+  {{    -0.2900,     -1.4500,   0.1160,   -0.0051}, { 2,  1,  0,  2}},
+  {{    -7.6490,    -10.5600,   0.2590,   -0.1038}, { 2,  1,  0,  0}},
+  {{    -8.6270,     -7.5900,   0.0780,   -0.0192}, { 2,  1,  0, -2}},
+  {{    -2.7400,     -2.5400,   0.0220,    0.0324}, { 2,  1,  0, -4}},
+  {{     1.1810,      3.3200,  -0.2120,    0.0213}, { 2, -1,  0,  2}},
+  {{     9.7030,     11.6700,  -0.1510,    0.1268}, { 2, -1,  0,  0}},
+  {{    -0.3520,     -0.3700,   0.0010,   -0.0028}, { 2, -1,  0, -1}},
+  {{    -2.4940,     -1.1700,  -0.0030,   -0.0017}, { 2, -1,  0, -2}},
+  {{     0.3600,      0.2000,  -0.0120,   -0.0043}, { 2, -1,  0, -4}},
+  {{    -1.1670,     -1.2500,   0.0080,   -0.0106}, { 1,  2,  0,  0}},
+  {{    -7.4120,     -6.1200,   0.1170,    0.0484}, { 1,  2,  0, -2}},
+  {{    -0.3110,     -0.6500,  -0.0320,    0.0044}, { 1,  2,  0, -4}},
+  {{     0.7570,      1.8200,  -0.1050,    0.0112}, { 1, -2,  0,  2}},
+  {{     2.5800,      2.3200,   0.0270,    0.0196}, { 1, -2,  0,  0}},
+  {{     2.5330,      2.4000,  -0.0140,   -0.0212}, { 1, -2,  0, -2}},
+  {{    -0.3440,     -0.5700,  -0.0250,    0.0036}, { 0,  3,  0, -2}},
+  {{    -0.9920,     -0.0200,   0.0000,    0.0000}, { 1,  0,  2,  2}},
+  {{   -45.0990,     -0.0200,   0.0000,   -0.0010}, { 1,  0,  2,  0}},
+  {{    -0.1790,     -9.5200,   0.0000,   -0.0833}, { 1,  0,  2, -2}},
+  {{    -0.3010,     -0.3300,   0.0000,    0.0014}, { 1,  0,  2, -4}},
+  {{    -6.3820,     -3.3700,   0.0000,   -0.0481}, { 1,  0, -2,  2}},
+  {{    39.5280,     85.1300,   0.0000,   -0.7136}, { 1,  0, -2,  0}},
+  {{     9.3660,      0.7100,   0.0000,   -0.0112}, { 1,  0, -2, -2}},
+  {{     0.2020,      0.0200,   0.0000,    0.0000}, { 1,  0, -2, -4}},
+  {{     0.4150,      0.1000,   0.0000,    0.0013}, { 0,  1,  2,  0}},
+  {{    -2.1520,     -2.2600,   0.0000,   -0.0066}, { 0,  1,  2, -2}},
+  {{    -1.4400,     -1.3000,   0.0000,    0.0014}, { 0,  1, -2,  2}},
+  {{     0.3840,     -0.0400,   0.0000,    0.0000}, { 0,  1, -2, -2}},
+  {{     1.9380,      3.6000,  -0.1450,    0.0401}, { 4,  0,  0,  0}},
+  {{    -0.9520,     -1.5800,   0.0520,   -0.0130}, { 4,  0,  0, -2}},
+  {{    -0.5510,     -0.9400,   0.0320,   -0.0097}, { 3,  1,  0,  0}},
+  {{    -0.4820,     -0.5700,   0.0050,   -0.0045}, { 3,  1,  0, -2}},
+  {{     0.6810,      0.9600,  -0.0260,    0.0115}, { 3, -1,  0,  0}},
+  {{    -0.2970,     -0.2700,   0.0020,   -0.0009}, { 2,  2,  0, -2}},
+  {{     0.2540,      0.2100,  -0.0030,    0.0000}, { 2, -2,  0, -2}},
+  {{    -0.2500,     -0.2200,   0.0040,    0.0014}, { 1,  3,  0, -2}},
+  {{    -3.9960,      0.0000,   0.0000,    0.0004}, { 2,  0,  2,  0}},
+  {{     0.5570,     -0.7500,   0.0000,   -0.0090}, { 2,  0,  2, -2}},
+  {{    -0.4590,     -0.3800,   0.0000,   -0.0053}, { 2,  0, -2,  2}},
+  {{    -1.2980,      0.7400,   0.0000,    0.0004}, { 2,  0, -2,  0}},
+  {{     0.5380,      1.1400,   0.0000,   -0.0141}, { 2,  0, -2, -2}},
+  {{     0.2630,      0.0200,   0.0000,    0.0000}, { 1,  1,  2,  0}},
+  {{     0.4260,      0.0700,   0.0000,   -0.0006}, { 1,  1, -2, -2}},
+  {{    -0.3040,      0.0300,   0.0000,    0.0003}, { 1, -1,  2,  0}},
+  {{    -0.3720,     -0.1900,   0.0000,   -0.0027}, { 1, -1, -2,  2}},
+  {{     0.4180,      0.0000,   0.0000,    0.0000}, { 0,  0,  4,  0}},
+  {{    -0.3300,     -0.0400,   0.0000,    0.0000}, { 3,  0,  2,  0}},
+};
+#define MOON_TERM_COUNT (sizeof(MOON_TERMS) / sizeof(MOON_TERMS[0]))
+
+// SolarN: latitude terms N.
+static const moon_term_t MOON_N_TERMS[] = {
+  {{-526.069, 0, 0, 0}, { 0,  0, 1, -2}},
+  {{  -3.352, 0, 0, 0}, { 0,  0, 1, -4}},
+  {{ +44.297, 0, 0, 0}, {+1,  0, 1, -2}},
+  {{  -6.000, 0, 0, 0}, {+1,  0, 1, -4}},
+  {{ +20.599, 0, 0, 0}, {-1,  0, 1,  0}},
+  {{ -30.598, 0, 0, 0}, {-1,  0, 1, -2}},
+  {{ -24.649, 0, 0, 0}, {-2,  0, 1,  0}},
+  {{  -2.000, 0, 0, 0}, {-2,  0, 1, -2}},
+  {{ -22.571, 0, 0, 0}, { 0, +1, 1, -2}},
+  {{ +10.985, 0, 0, 0}, { 0, -1, 1, -2}},
+};
+#define MOON_N_COUNT (sizeof(MOON_N_TERMS) / sizeof(MOON_N_TERMS[0]))
+
+// Sines of phase + rate*T revolutions: LongPeriodic S1..S7, the three DGAM
+// terms, then Planetary (with its longitude coefficients).
+#define MOON_SINES 21
+static const double MOON_SINE_PHASE[MOON_SINES] = {
+  0.19833, 0.27869, 0.16827, 0.34734, 0.10498, 0.42681, 0.14943,
+  0.59734, 0.35498, 0.39943,
+  0.7736, 0.0466, 0.5785, 0.4591, 0.3130, 0.1480, 0.5918, 0.5784, 0.2275, 0.2965, 0.3132,
+};
+static const double MOON_SINE_RATE[MOON_SINES] = {
+  0.05611, 0.04508, -0.36903, -5.37261, -5.37899, -0.41855, -5.37511,
+  -5.37261, -5.37899, -5.37511,
+  -62.5512, -125.1025, -25.1042, 1335.8075, -91.5680, 1331.2898, 1056.5859, 1322.8595, -5.7374, 2.6929, 6.3368,
+};
+#define MOON_PLANETARY_FIRST 10
+static const double MOON_PLANETARY_COEFF[MOON_SINES - MOON_PLANETARY_FIRST] = {
+  0.82, 0.31, 0.35, 0.66, 0.64, 1.14, 0.21, 0.44, 0.24, 0.28, 0.33,
+};
+
+// Multiples -6..6 of the four fundamental arguments, times their FAC factors.
+typedef struct {
+  double co[4][13][LANES];
+  double si[4][13][LANES];
+} moon_powers_t;
+
+static double frac(double x) {
+  return x - floor(x);
+}
+
+// Sums of a term table into (x, y) per lane: the product of the four powers.
+static void moon_term_xy(const moon_powers_t* pw, const moon_term_t* term, double x[LANES], double y[LANES]) {
+  const double *c0 = pw->co[0][term->arg[0] + 6], *s0 = pw->si[0][term->arg[0] + 6];
+  const double *c1 = pw->co[1][term->arg[1] + 6], *s1 = pw->si[1][term->arg[1] + 6];
+  const double *c2 = pw->co[2][term->arg[2] + 6], *s2 = pw->si[2][term->arg[2] + 6];
+  const double *c3 = pw->co[3][term->arg[3] + 6], *s3 = pw->si[3][term->arg[3] + 6];
+  for (int j = 0; j < LANES; ++j) {
+    // Powers 0 are exactly (1, 0), so multiplying them in matches the vendor's skip.
+    double xa = c0[j] * c1[j] - s0[j] * s1[j];
+    double ya = s0[j] * c1[j] + c0[j] * s1[j];
+    double xb = xa * c2[j] - ya * s2[j];
+    double yb = ya * c2[j] + xa * s2[j];
+    x[j] = xb * c3[j] - yb * s3[j];
+    y[j] = yb * c3[j] + xb * s3[j];
+  }
+}
+
+// Geocentric Moon, mean ecliptic and equinox of date (AU).
+static void moon_lanes(const double tt[LANES], double out[3][LANES]) {
+  double T[LANES];
+  for (int j = 0; j < LANES; ++j) T[j] = tt[j] / 36525.0;
+
+  double arg[MOON_SINES * LANES], s[MOON_SINES * LANES], c[MOON_SINES * LANES];
+  for (int i = 0; i < MOON_SINES; ++i) {
+    for (int j = 0; j < LANES; ++j) arg[i * LANES + j] = PI2 * (MOON_SINE_PHASE[i] + MOON_SINE_RATE[i] * T[j]);
+  }
+  nt_internal_sincos(arg, s, c, MOON_SINES * LANES);
+#define SINE(i, j) s[(i) * LANES + (j)]
+
+  // LongPeriodic and the mean arguments (Init).
+  double dgam[LANES], L0[LANES], F[LANES], fund[4 * LANES], fac[4][LANES];
+  for (int j = 0; j < LANES; ++j) {
+    double t = T[j], t2 = t * t;
+    double S1v = SINE(0, j), S2v = SINE(1, j), S3v = SINE(2, j), S4v = SINE(3, j);
+    double S5v = SINE(4, j), S6v = SINE(5, j), S7v = SINE(6, j);
+    double dl0 = 0.84 * S1v + 0.31 * S2v + 14.27 * S3v + 7.26 * S4v + 0.28 * S5v + 0.24 * S6v;
+    double dl = 2.94 * S1v + 0.31 * S2v + 14.27 * S3v + 9.34 * S4v + 1.12 * S5v + 0.83 * S6v;
+    double dls = -6.40 * S1v - 1.89 * S6v;
+    double df = 0.21 * S1v + 0.31 * S2v + 14.27 * S3v - 88.70 * S4v - 15.30 * S5v + 0.24 * S6v - 1.86 * S7v;
+    double dd = dl0 - dls;
+    dgam[j] = -3332E-9 * SINE(7, j) - 539E-9 * SINE(8, j) - 64E-9 * SINE(9, j);
+    L0[j] = PI2 * frac(0.60643382 + 1336.85522467 * t - 0.00000313 * t2) + dl0 / ARC;
+    fund[0 * LANES + j] = PI2 * frac(0.37489701 + 1325.55240982 * t + 0.00002565 * t2) + dl / ARC;
+    fund[1 * LANES + j] = PI2 * frac(0.99312619 + 99.99735956 * t - 0.00000044 * t2) + dls / ARC;
+    F[j] = PI2 * frac(0.25909118 + 1342.22782980 * t - 0.00000892 * t2) + df / ARC;
+    fund[2 * LANES + j] = F[j];
+    fund[3 * LANES + j] = PI2 * frac(0.82736186 + 1236.85308708 * t - 0.00000397 * t2) + dd / ARC;
+    fac[0][j] = 1.000002208;
+    fac[1][j] = 0.997504612 - 0.002495388 * t;
+    fac[2][j] = 1.000002708 + 139.978 * dgam[j];
+    fac[3][j] = 1.0;
+  }
+  double fs[4 * LANES], fc[4 * LANES];
+  nt_internal_sincos(fund, fs, fc, 4 * LANES);
+
+  moon_powers_t pw;
+  for (int k = 0; k < 4; ++k) {
+    for (int j = 0; j < LANES; ++j) {
+      pw.co[k][6][j] = 1.0;
+      pw.si[k][6][j] = 0.0;
+      pw.co[k][7][j] = fc[k * LANES + j] * fac[k][j];
+      pw.si[k][7][j] = fs[k * LANES + j] * fac[k][j];
+    }
+    for (int p = 2; p <= 6; ++p) {
+      for (int j = 0; j < LANES; ++j) {
+        double c1 = pw.co[k][5 + p][j], s1 = pw.si[k][5 + p][j];
+        pw.co[k][6 + p][j] = c1 * pw.co[k][7][j] - s1 * pw.si[k][7][j];
+        pw.si[k][6 + p][j] = s1 * pw.co[k][7][j] + c1 * pw.si[k][7][j];
+      }
+    }
+    for (int p = 1; p <= 6; ++p) {
+      for (int j = 0; j < LANES; ++j) {
+        pw.co[k][6 - p][j] = pw.co[k][6 + p][j];
+        pw.si[k][6 - p][j] = -pw.si[k][6 + p][j];
+      }
+    }
+  }
+
+  // AddSol, SolarN, Planetary.
+  double dlam[LANES] = {0}, ds[LANES] = {0}, gam1c[LANES] = {0}, sinpi[LANES], n[LANES] = {0};
+  double x[LANES], y[LANES];
+  for (int j = 0; j < LANES; ++j) sinpi[j] = 3422.7000;
+  for (size_t i = 0; i < MOON_TERM_COUNT; ++i) {
+    const moon_term_t* term = &MOON_TERMS[i];
+    moon_term_xy(&pw, term, x, y);
+    for (int j = 0; j < LANES; ++j) {
+      dlam[j] += term->coeff[0] * y[j];
+      ds[j] += term->coeff[1] * y[j];
+      gam1c[j] += term->coeff[2] * x[j];
+      sinpi[j] += term->coeff[3] * x[j];
+    }
+  }
+  for (size_t i = 0; i < MOON_N_COUNT; ++i) {
+    moon_term_xy(&pw, &MOON_N_TERMS[i], x, y);
+    for (int j = 0; j < LANES; ++j) n[j] += MOON_N_TERMS[i].coeff[0] * y[j];
+  }
+  for (int i = MOON_PLANETARY_FIRST; i < MOON_SINES; ++i) {
+    for (int j = 0; j < LANES; ++j) dlam[j] += MOON_PLANETARY_COEFF[i - MOON_PLANETARY_FIRST] * SINE(i, j);
+  }
+#undef SINE
+
+  double sarg[LANES], ss[LANES], sc[LANES];
+  for (int j = 0; j < LANES; ++j) sarg[j] = F[j] + ds[j] / ARC;
+  nt_internal_sincos(sarg, ss, sc, LANES);
+  double ang[2 * LANES], sa[2 * LANES], ca[2 * LANES], dist[LANES];
+  for (int j = 0; j < LANES; ++j) {
+    double sin3 = ss[j] * (3.0 - 4.0 * ss[j] * ss[j]);
+    double lat_seconds = (1.000002708 + 139.978 * dgam[j]) * (18518.511 + 1.189 + gam1c[j]) * ss[j] - 6.24 * sin3 + n[j];
+    ang[j] = L0[j] + dlam[j] / ARC;
+    ang[LANES + j] = lat_seconds * (DEG2RAD / 3600.0);
+    dist[j] = (ARC * EARTH_EQUATORIAL_RADIUS_KM / KM_PER_AU) / (0.999953253 * sinpi[j]);
+  }
+  nt_internal_sincos(ang, sa, ca, 2 * LANES);
+  for (int j = 0; j < LANES; ++j) {
+    double rc = dist[j] * ca[LANES + j];
+    out[0][j] = rc * ca[j];
+    out[1][j] = rc * sa[j];
+    out[2][j] = dist[j] * sa[LANES + j];
+  }
+}
+
+// -------------------------
+// Observer geometry
+// -------------------------
+
+static double earth_rotation_angle(double ut) {
+  double theta = frac(0.7790572732640 + 0.00273781191135448 * ut + frac(ut));
+  return 360.0 * theta;
+}
+
+static double mean_obliquity_deg(double tt) {
+  double t = tt / 36525.0;
+  double asec = ((((-0.0000000434 * t - 0.000000576) * t + 0.00200340) * t - 0.0001831) * t - 46.836769) * t + 84381.406;
+  return asec / 3600.0;
+}
+
+// Mean ecliptic of date -> true equator of date: the vendor's ecl2equ_vec
+// (mean obliquity) followed by its nutation matrix.
+static void moon_frame(const astro_time_t* t, double m[3][3]) {
+  double oblm = mean_obliquity_deg(t->tt) * DEG2RAD;
+  double oblt = oblm + t->eps / 3600.0 * DEG2RAD;
+  double psi = t->psi / 3600.0 * DEG2RAD;
+  double cobm = cos(oblm), sobm = sin(oblm), cobt = cos(oblt), sobt = sin(oblt);
+  double cpsi = cos(psi), spsi = sin(psi);
+  const double nut[3][3] = {
+    {cpsi, -spsi * cobm, -spsi * sobm},
+    {spsi * cobt, cpsi * cobm * cobt + sobm * sobt, cpsi * sobm * cobt - cobm * sobt},
+    {spsi * sobt, cpsi * cobm * sobt - sobm * cobt, cpsi * sobm * sobt + cobm * cobt},
+  };
+  const double ecl[3][3] = {{1.0, 0.0, 0.0}, {0.0, cobm, -sobm}, {0.0, sobm, cobm}};
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) m[i][j] = nut[i][0] * ecl[0][j] + nut[i][1] * ecl[1][j] + nut[i][2] * ecl[2][j];
+  }
+}
+
+nt_err nt_internal_sky_window(nt_sky_window* w, int body, double latitude_deg, double longitude_deg,
+                              double ut0, double days) {
+  if (!w || (body != NT_SKY_SUN && body != NT_SKY_MOON)) return NT_ERR_INTERNAL;
+  if (!(days > 0.0 && days <= NT_SKY_MAX_DAYS) || !(latitude_deg >= -90.0 && latitude_deg <= 90.0)) return NT_ERR_RANGE;
+  w->body = body;
+  w->ut0 = ut0;
+  w->days = days;
+  w->latitude = latitude_deg;
+  w->longitude = longitude_deg;
+
+  // The vendor's terra() at sea level.
+  double phi = latitude_deg * DEG2RAD;
+  w->sin_lat = sin(phi);
+  w->cos_lat = cos(phi);
+  double cc = 1.0 / hypot(w->cos_lat, w->sin_lat * EARTH_FLATTENING);
+  double sc = cc * (EARTH_FLATTENING * EARTH_FLATTENING);
+  w->obs_xy_au = EARTH_EQUATORIAL_RADIUS_KM * cc * w->cos_lat / KM_PER_AU;
+  w->obs_z_au = EARTH_EQUATORIAL_RADIUS_KM * sc * w->sin_lat / KM_PER_AU;
+
+  for (int e = 0; e < 2; ++e) {
+    astro_time_t t = Astronomy_TimeFromDays(ut0 + days * e);
+    astro_rotation_t r = Astronomy_Rotation_EQJ_EQD(&t);  // also caches the nutation angles in t
+    if (r.status != ASTRO_SUCCESS) return NT_ERR_INTERNAL;
+    w->tt_offset[e] = t.tt - t.ut;
+    double st = remainder(Astronomy_SiderealTime(&t) * 15.0 - earth_rotation_angle(t.ut), 360.0);
+    w->st_offset[e] = st;
+    if (body == NT_SKY_SUN) {
+      // EQJ -> EQD after VSOP87 -> EQJ; the vendor's rot[i][j] maps component i into j.
+      for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+          w->rot[e][i][j] = r.rot[0][i] * VSOP_TO_EQJ[0][j] + r.rot[1][i] * VSOP_TO_EQJ[1][j] + r.rot[2][i] * VSOP_TO_EQJ[2][j];
+        }
+      }
+    } else {
+      moon_frame(&t, w->rot[e]);
+    }
+  }
+  return NT_OK;
+}
+
+static void sky_lanes(const nt_sky_window* w, const double ut[LANES], nt_sky_sample out[LANES]) {
+  double tt[LANES], f[LANES], v[3][LANES];
+  for (int j = 0; j < LANES; ++j) {
+    f[j] = (ut[j] - w->ut0) / w->days;
+    tt[j] = ut[j] + w->tt_offset[0] + f[j] * (w->tt_offset[1] - w->tt_offset[0]);
+  }
+  if (w->body == NT_SKY_SUN) {
+    sun_lanes(tt, v);
+  } else {
+    moon_lanes(tt, v);
+  }
+
+  double theta[LANES], st[LANES], ct[LANES];
+  for (int j = 0; j < LANES; ++j) {
+    double gast = earth_rotation_angle(ut[j]) + w->st_offset[0] + f[j] * (w->st_offset[1] - w->st_offset[0]);
+    theta[j] = (gast + w->longitude) * DEG2RAD;
+  }
+  nt_internal_sincos(theta, st, ct, LANES);
+
+  for (int j = 0; j < LANES; ++j) {
+    double g[3];
+    for (int i = 0; i < 3; ++i) {
+      double r0 = w->rot[0][i][0] * v[0][j] + w->rot[0][i][1] * v[1][j] + w->rot[0][i][2] * v[2][j];
+      double r1 = w->rot[1][i][0] * v[0][j] + w->rot[1][i][1] * v[1][j] + w->rot[1][i][2] * v[2][j];
+      g[i] = r0 + f[j] * (r1 - r0);
+    }
+    double topo[3] = {g[0] - w->obs_xy_au * ct[j], g[1] - w->obs_xy_au * st[j], g[2] - w->obs_z_au};
+    double dist = sqrt(topo[0] * topo[0] + topo[1] * topo[1] + topo[2] * topo[2]);
+    double up = (topo[0] * ct[j] + topo[1] * st[j]) * w->cos_lat + topo[2] * w->sin_lat;
+    double gdist = sqrt(g[0] * g[0] + g[1] * g[1] + g[2] * g[2]);
+    double ra = atan2(g[1], g[0]) * RAD2DEG;
+    out[j].altitude_deg = asin(fmax(-1.0, fmin(1.0, up / dist))) * RAD2DEG;
+    out[j].distance_au = dist;
+    out[j].ra_deg = (ra < 0.0) ? ra + 360.0 : ra;
+    out[j].dec_deg = asin(g[2] / gdist) * RAD2DEG;
+  }
+}
+
+static NT_THREAD_LOCAL uint64_t t_sky_evaluations;
+
+uint64_t nt_internal_sky_eval_count(void) {
+  return t_sky_evaluations;
+}
+
+void nt_internal_sky_eval(const nt_sky_window* w, const double* ut, size_t n, nt_sky_sample* out) {
+  t_sky_evaluations += n;
+  for (size_t i = 0; i < n; i += LANES) {
+    double lane_ut[LANES];
+    nt_sky_sample lane_out[LANES];
+    size_t m = (n - i < LANES) ? n - i : LANES;
+    for (size_t j = 0; j < LANES; ++j) lane_ut[j] = ut[i + (j < m ? j : m - 1)];  // pad with the last instant
+    sky_lanes(w, lane_ut, lane_out);
+    memcpy(&out[i], lane_out, m * sizeof(nt_sky_sample));
+  }
+}
+
+// -------------------------
+// Batched altitude searches
+// -------------------------
+// 💡 One grid of GRID_STEP_DAYS probes serves every query of a window. Between
+// probes the vendor's pruning applies unchanged: an interval whose ends lie on
+// the same side of the target is split only while the altitude could reach the
+// target and come back at the body's maximum altitude rate, down to 1 s. Splits
+// and root refinements of all queries are evaluated level by level in one
+// nt_internal_sky_eval call, and each query keeps its leftmost rising bracket,
+// so the crossing found is the one the vendor's depth-first search returns.
+
+#define GRID_PER_DAY 24
+#define GRID_STEP_DAYS (1.0 / GRID_PER_DAY)
+#define GRID_MAX NT_SKY_GRID_MAX
+#define CAND_MAX NT_SKY_CAND_MAX
+#define QUERY_MAX NT_SKY_QUERY_MAX
+#define ROOT_TOL_DAYS 1e-8   // ~1 ms (the vendor stops at 0.1 s)
+#define ROOT_MAX_STEPS 60
+#define BUDGET_BATCH 8       // instants per evaluation when a clock budget is set
+
+_Static_assert(GRID_MAX >= 2 * GRID_PER_DAY + 2, "grid covers NT_SKY_MAX_DAYS");
+
+typedef nt_sky_bracket bracket_t;
+typedef nt_sky_query_state query_state_t;
+
+enum { BRACKET_NONE = 0, BRACKET_RISE, BRACKET_SPLIT };
+enum { PHASE_GRID = 0, PHASE_SPLIT, PHASE_REFINE, PHASE_FALLBACK, PHASE_DONE };
+
+// The vendor's MaxAltitudeSlope (degrees/day).
+double nt_internal_max_altitude_slope(const nt_sky_window* w) {
+  double deriv_ra = (w->body == NT_SKY_MOON) ? 4.5 : 0.8;
+  double deriv_dec = (w->body == NT_SKY_MOON) ? 8.2 : 0.5;
+  return fabs((360.0 / 0.9972695717592592 - deriv_ra) * w->cos_lat) + fabs(deriv_dec * w->sin_lat);
+}
+
+// The vendor's FindAscent test for one interval.
+static int classify(const bracket_t* b, double max_slope) {
+  if (b->a1 < 0.0 && b->a2 >= 0.0) return BRACKET_RISE;
+  if (b->a1 >= 0.0 && b->a2 < 0.0) return BRACKET_NONE;
+  double dt = (b->t2 - b->t1) / 2;
+  if (dt * SECONDS_PER_DAY < 1.0) return BRACKET_NONE;
+  double da = fmin(fabs(b->a1), fabs(b->a2));
+  return (da > max_slope * (dt / 2)) ? BRACKET_NONE : BRACKET_SPLIT;
+}
+
+static double query_value(const nt_sky_window* w, const nt_sky_crossing* q, const nt_sky_sample* s) {
+  double alt = s->altitude_deg;
+  if (q->disc) {
+    double radius_au = ((w->body == NT_SKY_MOON) ? MOON_EQUATORIAL_RADIUS_KM : SUN_RADIUS_KM) / KM_PER_AU;
+    alt += RAD2DEG * asin(radius_au / s->distance_au);
+  }
+  return q->direction * (alt - q->target_deg);
+}
+
+// Classifies `b` for a query: records a rising bracket (dropping every later
+// candidate) or queues a split (flagging the query for the vendor search when
+// the queue is full). Returns 0 once the query is resolved left of `b`.
+static int offer(query_state_t* st, const bracket_t* b, double max_slope) {
+  switch (classify(b, max_slope)) {
+    case BRACKET_RISE:
+      st->have = 1;
+      st->best = *b;
+      return 0;
+    case BRACKET_SPLIT:
+      if (st->ncand < CAND_MAX) st->cand[st->ncand++] = *b;
+      else st->overflow = 1;
+      return 1;
+    default:
+      return 1;
+  }
+}
+
+double nt_internal_clock_s(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Instants the next evaluation may cover (0: the budget is spent).
+static size_t budget_take(const nt_sky_budget* b, size_t wanted) {
+  if (!b) return wanted;
+  if (b->deadline_s > 0.0) {
+    if (nt_internal_clock_s() >= b->deadline_s) return 0;
+    if (wanted > BUDGET_BATCH) wanted = BUDGET_BATCH;
+  }
+  if (b->max_evaluations > 0) {
+    uint64_t left = (b->evaluations < b->max_evaluations) ? b->max_evaluations - b->evaluations : 0;
+    if (wanted > left) wanted = (size_t)left;
+  }
+  return wanted;
+}
+
+static void eval(const nt_sky_window* w, const double* ut, size_t n, nt_sky_sample* out, nt_sky_budget* b) {
+  nt_internal_sky_eval(w, ut, n, out);
+  if (b) b->evaluations += n;
+}
+
+void nt_internal_sky_search_begin(nt_sky_search* s, const nt_sky_window* w, const nt_sky_crossing* q, size_t count) {
+  memset(s, 0, sizeof(*s));
+  s->w = *w;
+  s->count = count > QUERY_MAX ? QUERY_MAX : count;
+  s->max_slope = nt_internal_max_altitude_slope(w);
+  double limit = 0.0;
+  for (size_t k = 0; k < s->count; ++k) {
+    s->q[k] = q[k];
+    s->q[k].found = 0;
+    s->q[k].ut = 0.0;
+    if (q[k].limit_days > limit) limit = q[k].limit_days;
+  }
+  if (limit > w->days) limit = w->days;
+  s->ngrid = (int)ceil(limit / GRID_STEP_DAYS - 1e-9) + 1;
+  if (s->ngrid > GRID_MAX) s->ngrid = GRID_MAX;
+  for (int i = 0; i < s->ngrid; ++i) s->grid_ut[i] = w->ut0 + fmin(i * GRID_STEP_DAYS, limit);
+  s->phase = (s->count == 0) ? PHASE_DONE : PHASE_GRID;
+}
+
+// Shared probe grid, then every query's scan of it.
+static int run_grid(nt_sky_search* s, nt_sky_budget* b) {
+  while (s->grid_done < s->ngrid) {
+    size_t n = budget_take(b, (size_t)(s->ngrid - s->grid_done));
+    if (n == 0) return 0;
+    eval(&s->w, s->grid_ut + s->grid_done, n, s->grid + s->grid_done, b);
+    s->grid_done += (int)n;
+  }
+  for (size_t k = 0; k < s->count; ++k) {
+    double end = s->w.ut0 + fmin(s->q[k].limit_days, s->w.days);
+    double prev = query_value(&s->w, &s->q[k], &s->grid[0]);
+    for (int i = 1; i < s->ngrid && s->grid_ut[i - 1] < end; ++i) {
+      double a2 = query_value(&s->w, &s->q[k], &s->grid[i]);
+      bracket_t br = {s->grid_ut[i - 1], s->grid_ut[i], prev, a2};
+      prev = a2;
+      if (!offer(&s->st[k], &br, s->max_slope)) break;
+    }
+    if (s->st[k].overflow) s->st[k].ncand = 0;  // the vendor search answers it
+  }
+  return 1;
+}
+
+// Splits pending intervals level by level, all queries in one batch. A partial
+// batch splits the leftmost candidates and keeps the rest queued behind their
+// halves, so the order (and the leftmost-bracket rule) is unchanged.
+static int run_split(nt_sky_search* s, nt_sky_budget* b) {
+  double probe_ut[QUERY_MAX * CAND_MAX];
+  nt_sky_sample probe[QUERY_MAX * CAND_MAX];
+  for (;;) {
+    size_t total = 0;
+    for (size_t k = 0; k < s->count; ++k) total += (size_t)s->st[k].ncand;
+    if (total == 0) return 1;
+    size_t np = budget_take(b, total);
+    if (np == 0) return 0;
+    size_t taken[QUERY_MAX];
+    size_t p = 0;
+    for (size_t k = 0; k < s->count; ++k) {
+      taken[k] = 0;
+      for (int c = 0; c < s->st[k].ncand && p < np; ++c, ++taken[k]) {
+        probe_ut[p++] = 0.5 * (s->st[k].cand[c].t1 + s->st[k].cand[c].t2);
+      }
+    }
+    eval(&s->w, probe_ut, np, probe, b);
+    p = 0;
+    for (size_t k = 0; k < s->count; ++k) {
+      query_state_t* st = &s->st[k];
+      bracket_t pending[CAND_MAX];
+      int npending = st->ncand;
+      memcpy(pending, st->cand, (size_t)npending * sizeof(bracket_t));
+      st->ncand = 0;
+      int open = 1;
+      for (int c = 0; c < npending; ++c) {
+        if (!open) {
+          p += ((size_t)c < taken[k]);
+          continue;
+        }
+        if ((size_t)c >= taken[k]) {
+          if (st->ncand < CAND_MAX) st->cand[st->ncand++] = pending[c];
+          else st->overflow = 1;
+          continue;
+        }
+        double am = query_value(&s->w, &s->q[k], &probe[p]);
+        double tm = probe_ut[p++];
+        bracket_t left = {pending[c].t1, tm, pending[c].a1, am};
+        bracket_t right = {tm, pending[c].t2, am, pending[c].a2};
+        open = offer(st, &left, s->max_slope) && offer(st, &right, s->max_slope);
+      }
+      if (st->overflow) st->ncand = 0;
+    }
+  }
+}
+
+// Illinois false position on every rising bracket together.
+static int run_refine(nt_sky_search* s, nt_sky_budget* b) {
+  double probe_ut[QUERY_MAX];
+  nt_sky_sample probe[QUERY_MAX];
+  for (;;) {
+    size_t np = 0;
+    size_t owner[QUERY_MAX];
+    for (size_t k = 0; k < s->count; ++k) {
+      query_state_t* st = &s->st[k];
+      bracket_t* br = &st->best;
+      if (st->done) continue;
+      if (br->t2 - br->t1 < ROOT_TOL_DAYS || st->steps >= ROOT_MAX_STEPS) {
+        st->done = 1;
+        continue;
+      }
+      double t = br->t1 + (br->t2 - br->t1) * (-br->a1) / (br->a2 - br->a1);
+      if (!(t > br->t1 && t < br->t2)) t = 0.5 * (br->t1 + br->t2);
+      owner[np] = k;
+      probe_ut[np++] = t;
+    }
+    if (np == 0) return 1;
+    np = budget_take(b, np);
+    if (np == 0) return 0;
+    eval(&s->w, probe_ut, np, probe, b);
+    for (size_t p = 0; p < np; ++p) {
+      query_state_t* st = &s->st[owner[p]];
+      bracket_t* br = &st->best;
+      double a = query_value(&s->w, &s->q[owner[p]], &probe[p]);
+      double t = probe_ut[p];
+      st->steps++;
+      if (a == 0.0) {
+        br->t1 = br->t2 = t;
+        st->done = 1;
+      } else if (a < 0.0) {
+        br->t1 = t;
+        br->a1 = a;
+        if (st->side == -1) br->a2 *= 0.5;  // same side twice: Illinois halving
+        st->side = -1;
+      } else {
+        br->t2 = t;
+        br->a2 = a;
+        if (st->side == +1) br->a1 *= 0.5;
+        st->side = +1;
+      }
+      if (fabs(a) < 1e-9) st->done = 1;  // degrees: well under the time tolerance
+    }
+  }
+}
+
+// The vendor search for a query whose split queue overflowed.
+static void vendor_search(const nt_sky_window* w, nt_sky_crossing* q) {
+  astro_body_t body = (w->body == NT_SKY_MOON) ? BODY_MOON : BODY_SUN;
+  astro_observer_t obs = Astronomy_MakeObserver(w->latitude, w->longitude, 0.0);
+  astro_time_t start = Astronomy_TimeFromDays(w->ut0);
+  astro_direction_t dir = (q->direction > 0) ? DIRECTION_RISE : DIRECTION_SET;
+  double limit = fmin(q->limit_days, w->days);
+  astro_search_result_t r = q->disc ? Astronomy_SearchRiseSetEx(body, obs, dir, start, limit, 0.0)
+                                    : Astronomy_SearchAltitude(body, obs, dir, start, limit, q->target_deg);
+  q->found = (r.status == ASTRO_SUCCESS);
+  q->ut = q->found ? r.time.ut : 0.0;
+}
+
+static int run_fallback(nt_sky_search* s, nt_sky_budget* b) {
+  for (size_t k = 0; k < s->count; ++k) {
+    if (s->st[k].overflow != 1) continue;
+    if (budget_take(b, NT_SKY_FALLBACK_EVALUATIONS) < NT_SKY_FALLBACK_EVALUATIONS) return 0;
+    if (b) b->evaluations += NT_SKY_FALLBACK_EVALUATIONS;
+    vendor_search(&s->w, &s->q[k]);
+    s->st[k].overflow = 2;
+  }
+  return 1;
+}
+
+static double bracket_root(const bracket_t* b) {
+  double root = (b->a2 - b->a1 != 0.0) ? b->t1 + (b->t2 - b->t1) * (-b->a1) / (b->a2 - b->a1) : b->t1;
+  if (!(root >= b->t1 && root <= b->t2)) root = 0.5 * (b->t1 + b->t2);
+  return root;
+}
+
+int nt_internal_sky_search_run(nt_sky_search* s, nt_sky_budget* b) {
+  if (s->phase == PHASE_GRID) {
+    if (!run_grid(s, b)) return 0;
+    s->phase = PHASE_SPLIT;
+  }
+  if (s->phase == PHASE_SPLIT) {
+    if (!run_split(s, b)) return 0;
+    for (size_t k = 0; k < s->count; ++k) s->st[k].done = !s->st[k].have || s->st[k].overflow;
+    s->phase = PHASE_REFINE;
+  }
+  if (s->phase == PHASE_REFINE) {
+    if (!run_refine(s, b)) return 0;
+    for (size_t k = 0; k < s->count; ++k) {
+      if (!s->st[k].have || s->st[k].overflow) continue;
+      double root = bracket_root(&s->st[k].best);
+      if (root > s->w.ut0 + s->q[k].limit_days) continue;
+      s->q[k].found = 1;
+      s->q[k].ut = root;
+    }
+    s->phase = PHASE_FALLBACK;
+  }
+  if (s->phase == PHASE_FALLBACK) {
+    if (!run_fallback(s, b)) return 0;
+    s->phase = PHASE_DONE;
+  }
+  return 1;
+}
+
+int nt_internal_sky_search_done(const nt_sky_search* s) {
+  return s->phase == PHASE_DONE;
+}
+
+// Where the crossing can still be: the rising bracket kept so far and every
+// queued split interval (all of them left of it).
+int nt_internal_sky_search_estimate(const nt_sky_search* s, size_t k, int* found, double* ut, double* bound_days) {
+  *found = 0;
+  *ut = 0.0;
+  *bound_days = 0.0;
+  if (k >= s->count) return 0;
+  const nt_sky_crossing* q = &s->q[k];
+  if (s->phase == PHASE_DONE) {
+    *found = q->found;
+    *ut = q->ut;
+    *bound_days = q->found ? ROOT_TOL_DAYS : 0.0;
+    return 1;
+  }
+  const query_state_t* st = &s->st[k];
+  if (s->phase == PHASE_GRID || st->overflow || (st->ncand > 0 && !st->have)) return 0;  // may or may not cross
+  if (!st->have) return 1;                                                // no crossing anywhere
+  double root = bracket_root(&st->best);
+  double lo = st->best.t1, hi = st->best.t2;
+  for (int c = 0; c < st->ncand; ++c) lo = fmin(lo, st->cand[c].t1);
+  if (root > s->w.ut0 + q->limit_days) return (st->ncand == 0);  // only a queued interval could still hold one
+  *found = 1;
+  *ut = root;
+  *bound_days = fmax(root - lo, hi - root);
+  return 1;
+}
+
+// Highest probe altitude (topocentric, no refraction) and whether it is inside
+// the grid rather than at an end.
+int nt_internal_sky_search_peak(const nt_sky_search* s, double* altitude_deg) {
+  if (s->grid_done < s->ngrid || s->ngrid < 3) return -1;
+  int best = 0;
+  for (int i = 1; i < s->ngrid; ++i) {
+    if (s->grid[i].altitude_deg > s->grid[best].altitude_deg) best = i;
+  }
+  *altitude_deg = s->grid[best].altitude_deg;
+  return best > 0 && best < s->ngrid - 1;
+}
+
+void nt_internal_sky_crossings(const nt_sky_window* w, nt_sky_crossing* q, size_t count) {
+  if (!w || !q || count == 0) return;
+  if (count > QUERY_MAX) {
+    nt_internal_sky_crossings(w, q + QUERY_MAX, count - QUERY_MAX);
+    count = QUERY_MAX;
+  }
+  nt_sky_search s;
+  nt_internal_sky_search_begin(&s, w, q, count);
+  nt_internal_sky_search_run(&s, NULL);
+  for (size_t k = 0; k < count; ++k) {
+    q[k].found = s.q[k].found;
+    q[k].ut = s.q[k].ut;
+  }
+}
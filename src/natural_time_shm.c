@@ -0,0 +1,450 @@
+#include "natural_time_shm.h"
+#include "natural_time_internal.h"
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef NTC_VERSION
+#define NTC_VERSION "0"
+#endif
+
+#define READY_MARK 0x4e545348u   // "NTSH", stored last by the creator
+#define ATTACH_WAIT_MS 2000      // for a creator still initializing
+#define MAX_WORDS 16             // largest record, in 8-byte words
+#define READ_RETRIES 4
+
+// 💡 Slots live in memory shared between processes, so the seqlock word must be
+// a real lock-free atomic rather than a mutex-backed emulation.
+_Static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shared-memory cache needs lock-free 64-bit atomics");
+
+_Static_assert(sizeof(nt_seasons_record) <= MAX_WORDS * 8 && sizeof(nt_sun_record) <= MAX_WORDS * 8 &&
+               sizeof(nt_moon_record) <= MAX_WORDS * 8 && sizeof(nt_mustaches_record) <= MAX_WORDS * 8,
+               "cache records fit a slot");
+
+enum { T_COUNT = NT_CACHE_TABLES };
+
+typedef struct {
+  char magic[8];
+  uint32_t format;
+  uint32_t header_size;
+  char version[16];
+  uint32_t config;
+  uint32_t words[T_COUNT];   // record words per slot, after the state word
+  uint32_t slots[T_COUNT];   // power of two
+  uint64_t offset[T_COUNT];  // from the start of the segment, 8-byte aligned
+  uint64_t total_size;
+  _Atomic uint32_t ready;
+  uint32_t pad;
+} shm_header_t;
+
+static const char MAGIC[8] = {'N', 'T', 'S', 'H', 'M', '\0', '\0', '\0'};
+
+// Slot state word: low 32 bits a sequence number, high 32 bits the pid of the
+// writer while it is odd. 0 = never written, even = published, odd = being
+// written (or abandoned by a writer that died).
+#define STATE_SEQ(s) ((uint32_t)(s))
+#define STATE_OWNER(s) ((int32_t)(uint32_t)((s) >> 32))
+#define STATE(owner, seq) (((uint64_t)(uint32_t)(owner) << 32) | (uint32_t)(seq))
+
+static shm_header_t* g_shm;
+static size_t g_shm_size;
+static _Atomic uint64_t g_hits, g_misses, g_publishes, g_evictions, g_contended, g_reclaimed;
+
+static void count(_Atomic uint64_t* c) {
+  atomic_fetch_add_explicit(c, 1, memory_order_relaxed);
+}
+
+static size_t record_words(int table) {
+  return (nt_cache_record_size[table] + 7) / 8;
+}
+
+static _Atomic uint64_t* slot_at(int table, uint64_t index) {
+  uint64_t stride = 1 + g_shm->words[table];
+  index &= g_shm->slots[table] - 1;
+  return (_Atomic uint64_t*)((char*)g_shm + g_shm->offset[table]) + index * stride;
+}
+
+static uint64_t key_hash(int table, const void* rec) {
+  const uint8_t* b = (const uint8_t*)rec;
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < nt_cache_key_size[table]; ++i) h = (h ^ b[i]) * 0x100000001b3ULL;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  return h ^ (h >> 33);
+}
+
+// -------------------------
+// Slots
+// -------------------------
+
+enum { SLOT_EMPTY = 0, SLOT_READ, SLOT_BUSY };
+
+// Seqlock read: copies the record when the state word is the same even value
+// before and after.
+static int slot_read(int table, _Atomic uint64_t* slot, uint64_t* words) {
+  size_t n = g_shm->words[table];
+  for (int attempt = 0; attempt < READ_RETRIES; ++attempt) {
+    uint64_t s1 = atomic_load_explicit(&slot[0], memory_order_acquire);
+    if (s1 == 0) return SLOT_EMPTY;
+    if (STATE_SEQ(s1) & 1u) return SLOT_BUSY;
+    for (size_t i = 0; i < n; ++i) words[i] = atomic_load_explicit(&slot[1 + i], memory_order_relaxed);
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&slot[0], memory_order_relaxed) == s1) return SLOT_READ;
+  }
+  return SLOT_BUSY;
+}
+
+static int owner_alive(int32_t pid) {
+  return pid > 0 && (kill((pid_t)pid, 0) == 0 || errno == EPERM);
+}
+
+// Claims the slot (one CAS, no waiting), writes the record and publishes it.
+// An odd state whose owner is gone is taken over: the record is rewritten in
+// full before the slot becomes readable again.
+static int slot_write(int table, _Atomic uint64_t* slot, const uint64_t* words) {
+  uint64_t s = atomic_load_explicit(&slot[0], memory_order_acquire);
+  uint32_t seq = STATE_SEQ(s);
+  int32_t self = (int32_t)getpid();
+  int reclaim = (seq & 1u) != 0;
+  if (reclaim && owner_alive(STATE_OWNER(s))) return 0;
+  uint32_t claimed = reclaim ? seq + 2 : seq + 1;  // odd either way
+  if (!atomic_compare_exchange_strong_explicit(&slot[0], &s, STATE(self, claimed), memory_order_acquire,
+                                               memory_order_relaxed)) {
+    return 0;
+  }
+  atomic_thread_fence(memory_order_release);  // the odd state is visible before any word changes
+  for (size_t i = 0; i < g_shm->words[table]; ++i) atomic_store_explicit(&slot[1 + i], words[i], memory_order_relaxed);
+  uint32_t published = claimed + 1;
+  if (published == 0) published = 2;  // 0 means never written
+  atomic_store_explicit(&slot[0], STATE(0, published), memory_order_release);
+  if (reclaim) count(&g_reclaimed);
+  return 1;
+}
+
+// -------------------------
+// Tables
+// -------------------------
+
+// `rec` has its key filled in; the whole record is copied back on a hit.
+static int lookup(int table, void* rec) {
+  if (!g_shm) return 0;
+  uint64_t words[MAX_WORDS];
+  uint64_t h = key_hash(table, rec);
+  for (uint32_t p = 0; p < NT_SHM_PROBES && p < g_shm->slots[table]; ++p) {
+    int r = slot_read(table, slot_at(table, h + p), words);
+    if (r == SLOT_EMPTY) break;  // slots are never emptied, so the key is not further along
+    if (r == SLOT_BUSY) {
+      count(&g_contended);
+      continue;
+    }
+    if (memcmp(words, rec, nt_cache_key_size[table]) == 0) {
+      memcpy(rec, words, nt_cache_record_size[table]);
+      count(&g_hits);
+      return 1;
+    }
+  }
+  count(&g_misses);
+  return 0;
+}
+
+// First empty slot in the probe window, else the key's home slot. A slot that
+// already holds the key, or one being written, ends the publish.
+static void publish(int table, const void* rec) {
+  if (!g_shm) return;
+  uint64_t words[MAX_WORDS], existing[MAX_WORDS];
+  memset(words, 0, sizeof(words));
+  memcpy(words, rec, nt_cache_record_size[table]);
+  uint64_t h = key_hash(table, rec);
+  _Atomic uint64_t* target = NULL;
+  for (uint32_t p = 0; p < NT_SHM_PROBES && p < g_shm->slots[table]; ++p) {
+    _Atomic uint64_t* slot = slot_at(table, h + p);
+    int r = slot_read(table, slot, existing);
+    if (r == SLOT_EMPTY) {
+      target = slot;
+      break;
+    }
+    if (r == SLOT_BUSY) {
+      // Possibly abandoned: slot_write reclaims it if its owner is gone.
+      if (slot_write(table, slot, words)) count(&g_publishes);
+      else count(&g_contended);
+      return;
+    }
+    if (memcmp(existing, rec, nt_cache_key_size[table]) == 0) return;
+  }
+  int evict = (target == NULL);
+  if (evict) target = slot_at(table, h);
+  if (!slot_write(table, target, words)) {
+    count(&g_contended);
+    return;
+  }
+  count(&g_publishes);
+  if (evict) count(&g_evictions);
+}
+
+// -------------------------
+// Segment
+// -------------------------
+
+static void layout(shm_header_t* h, uint32_t slots) {
+  memset(h, 0, sizeof(*h));
+  memcpy(h->magic, MAGIC, sizeof(MAGIC));
+  h->format = NT_SHM_FORMAT;
+  h->header_size = (uint32_t)sizeof(*h);
+  strncpy(h->version, NTC_VERSION, sizeof(h->version));
+  h->config = NT_BUILD_CONFIG;
+  uint64_t off = (sizeof(*h) + 63) & ~(uint64_t)63;
+  for (int t = 0; t < T_COUNT; ++t) {
+    h->words[t] = (uint32_t)record_words(t);
+    h->slots[t] = slots;
+    h->offset[t] = off;
+    off += (uint64_t)slots * (1 + h->words[t]) * 8;
+    off = (off + 63) & ~(uint64_t)63;
+  }
+  h->total_size = off;
+}
+
+static int compatible(const shm_header_t* h, size_t mapped) {
+  shm_header_t expect;
+  layout(&expect, h->slots[0]);
+  if (memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 || h->format != NT_SHM_FORMAT ||
+      h->header_size != sizeof(*h) || memcmp(h->version, expect.version, sizeof(expect.version)) != 0 ||
+      h->config != NT_BUILD_CONFIG || h->total_size > mapped) {
+    return 0;
+  }
+  uint32_t slots = h->slots[0];
+  if (slots == 0 || slots > NT_SHM_MAX_SLOTS || (slots & (slots - 1)) != 0) return 0;
+  for (int t = 0; t < T_COUNT; ++t) {
+    if (h->words[t] != expect.words[t] || h->slots[t] != slots || h->offset[t] != expect.offset[t]) return 0;
+  }
+  return h->total_size == expect.total_size;
+}
+
+static void sleep_ms(long ms) {
+  struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+  nanosleep(&ts, NULL);
+}
+
+static uint32_t round_slots(uint32_t slots) {
+  if (slots > NT_SHM_MAX_SLOTS) slots = NT_SHM_MAX_SLOTS;
+  uint32_t n = NT_SHM_PROBES;
+  while (n < slots) n <<= 1;
+  return n;
+}
+
+// Creator: size, lay out and only then mark ready (a creator that dies before
+// that leaves a segment every attach refuses; nt_shm_unlink clears it).
+static nt_err create_segment(int fd, uint32_t slots, shm_header_t** out, size_t* out_size) {
+  shm_header_t h;
+  layout(&h, round_slots(slots));
+  if (ftruncate(fd, (off_t)h.total_size) != 0) return NT_ERR_INTERNAL;
+  void* map = mmap(NULL, (size_t)h.total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) return NT_ERR_INTERNAL;
+  shm_header_t* hdr = (shm_header_t*)map;  // pages arrive zeroed: every slot is empty
+  memcpy(hdr, &h, offsetof(shm_header_t, ready));
+  atomic_store_explicit(&hdr->ready, READY_MARK, memory_order_release);
+  *out = hdr;
+  *out_size = (size_t)h.total_size;
+  return NT_OK;
+}
+
+static nt_err open_segment(int fd, shm_header_t** out, size_t* out_size) {
+  struct stat st;
+  for (long waited = 0;; waited += 1) {
+    if (fstat(fd, &st) != 0) return NT_ERR_INTERNAL;
+    if ((size_t)st.st_size >= sizeof(shm_header_t)) {
+      void* map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (map == MAP_FAILED) return NT_ERR_INTERNAL;
+      shm_header_t* hdr = (shm_header_t*)map;
+      if (atomic_load_explicit(&hdr->ready, memory_order_acquire) == READY_MARK) {
+        if (!compatible(hdr, (size_t)st.st_size)) {
+          munmap(map, (size_t)st.st_size);
+          return NT_ERR_RANGE;
+        }
+        *out = hdr;
+        *out_size = (size_t)st.st_size;
+        return NT_OK;
+      }
+      munmap(map, (size_t)st.st_size);
+    }
+    if (waited >= ATTACH_WAIT_MS) return NT_ERR_RANGE;
+    sleep_ms(1);
+  }
+}
+
+nt_err nt_shm_attach(const char* name, uint32_t slots) {
+  if (!name) return NT_ERR_INTERNAL;
+  if (name[0] != '/' || name[1] == '\0' || strchr(name + 1, '/')) return NT_ERR_RANGE;
+  shm_header_t* hdr = NULL;
+  size_t size = 0;
+  nt_err err;
+  int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd >= 0) {
+    err = create_segment(fd, slots, &hdr, &size);
+    if (err != NT_OK) shm_unlink(name);
+  } else if (errno == EEXIST && (fd = shm_open(name, O_RDWR, 0)) >= 0) {
+    err = open_segment(fd, &hdr, &size);
+  } else {
+    return NT_ERR_INTERNAL;
+  }
+  close(fd);
+  if (err != NT_OK) return err;
+  nt_shm_detach();
+  g_shm = hdr;
+  g_shm_size = size;
+  return NT_OK;
+}
+
+void nt_shm_detach(void) {
+  if (g_shm) munmap(g_shm, g_shm_size);
+  g_shm = NULL;
+  g_shm_size = 0;
+  _Atomic uint64_t* counters[] = {&g_hits, &g_misses, &g_publishes, &g_evictions, &g_contended, &g_reclaimed};
+  for (size_t i = 0; i < sizeof counters / sizeof counters[0]; ++i) atomic_store(counters[i], 0);
+}
+
+nt_err nt_shm_unlink(const char* name) {
+  if (!name) return NT_ERR_INTERNAL;
+  if (shm_unlink(name) != 0) return errno == ENOENT ? NT_ERR_RANGE : NT_ERR_INTERNAL;
+  return NT_OK;
+}
+
+void nt_shm_counters(nt_shm_stats* out) {
+  if (!out) return;
+  out->hits = atomic_load(&g_hits);
+  out->misses = atomic_load(&g_misses);
+  out->publishes = atomic_load(&g_publishes);
+  out->evictions = atomic_load(&g_evictions);
+  out->contended = atomic_load(&g_contended);
+  out->reclaimed = atomic_load(&g_reclaimed);
+}
+
+uint32_t nt_shm_slots(void) {
+  return g_shm ? g_shm->slots[0] : 0;
+}
+
+#if defined(NT_SHM_TEST_HOOKS)
+void nt_internal_shm_abandon_slot(int table, uint32_t index, int32_t pid) {
+  if (!g_shm || table < 0 || table >= T_COUNT) return;
+  _Atomic uint64_t* slot = slot_at(table, index);
+  uint64_t s = atomic_load(&slot[0]);
+  atomic_store(&slot[0], STATE(pid, STATE_SEQ(s) | 1u));
+}
+#endif
+
+#else  // _WIN32
+
+static int lookup(int table, void* rec) {
+  (void)table;
+  (void)rec;
+  return 0;
+}
+
+static void publish(int table, const void* rec) {
+  (void)table;
+  (void)rec;
+}
+
+nt_err nt_shm_attach(const char* name, uint32_t slots) {
+  (void)name;
+  (void)slots;
+  return NT_ERR_INTERNAL;
+}
+
+void nt_shm_detach(void) {}
+
+nt_err nt_shm_unlink(const char* name) {
+  (void)name;
+  return NT_ERR_INTERNAL;
+}
+
+void nt_shm_counters(nt_shm_stats* out) {
+  if (out) memset(out, 0, sizeof(*out));
+}
+
+uint32_t nt_shm_slots(void) {
+  return 0;
+}
+
+#if defined(NT_SHM_TEST_HOOKS)
+void nt_internal_shm_abandon_slot(int table, uint32_t index, int32_t pid) {
+  (void)table;
+  (void)index;
+  (void)pid;
+}
+#endif
+
+#endif
+
+// -------------------------
+// Library hooks
+// -------------------------
+
+int nt_internal_shm_seasons(int32_t year, nt_seasons_record* out) {
+  nt_seasons_record r;
+  nt_internal_seasons_key(&r, year);
+  if (!lookup(NT_CACHE_SEASONS, &r)) return 0;
+  *out = r;
+  return 1;
+}
+
+int nt_internal_shm_sun_events(int64_t nadir, double latitude_deg, double longitude_deg, nt_sun_events* out) {
+  nt_sun_record r;
+  nt_internal_sun_key(&r, nadir, latitude_deg, longitude_deg);
+  if (!lookup(NT_CACHE_SUN, &r)) return 0;
+  *out = r.value;
+  return 1;
+}
+
+int nt_internal_shm_moon_events(int64_t nadir, double latitude_deg, double longitude_deg, nt_moon_events* out) {
+  nt_moon_record r;
+  nt_internal_moon_key(&r, nadir, latitude_deg, longitude_deg);
+  if (!lookup(NT_CACHE_MOON, &r)) return 0;
+  *out = r.value;
+  return 1;
+}
+
+int nt_internal_shm_mustaches(int32_t year, double latitude_deg, nt_mustaches* out) {
+  nt_mustaches_record r;
+  nt_internal_mustaches_key(&r, year, latitude_deg);
+  if (!lookup(NT_CACHE_MUSTACHES, &r)) return 0;
+  *out = r.value;
+  return 1;
+}
+
+void nt_internal_publish_seasons(const nt_seasons_record* rec) {
+  if (rec->status != 0) return;
+  nt_seasons_record r;
+  nt_internal_seasons_key(&r, rec->year);
+  memcpy(r.ut, rec->ut, sizeof(r.ut));
+  publish(NT_CACHE_SEASONS, &r);
+}
+
+void nt_internal_publish_sun_events(int64_t nadir, double latitude_deg, double longitude_deg, const nt_sun_events* v) {
+  nt_sun_record r;
+  nt_internal_sun_key(&r, nadir, latitude_deg, longitude_deg);
+  r.value = *v;
+  publish(NT_CACHE_SUN, &r);
+}
+
+void nt_internal_publish_moon_events(int64_t nadir, double latitude_deg, double longitude_deg, const nt_moon_events* v) {
+  nt_moon_record r;
+  nt_internal_moon_key(&r, nadir, latitude_deg, longitude_deg);
+  r.value = *v;
+  publish(NT_CACHE_MOON, &r);
+}
+
+void nt_internal_publish_mustaches(int32_t year, double latitude_deg, const nt_mustaches* v) {
+  nt_mustaches_record r;
+  nt_internal_mustaches_key(&r, year, latitude_deg);
+  r.value = *v;
+  publish(NT_CACHE_MUSTACHES, &r);
+}
@@ -0,0 +1,445 @@
+#include "natural_time_snapshot.h"
+#include "natural_time_internal.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifndef NTC_VERSION
+#define NTC_VERSION "0"
+#endif
+
+#define BYTE_ORDER_MARK 0x01020304u
+
+enum { T_SEASONS = NT_CACHE_SEASONS, T_SUN = NT_CACHE_SUN, T_MOON = NT_CACHE_MOON, T_MUSTACHES = NT_CACHE_MUSTACHES,
+       T_COUNT = NT_CACHE_TABLES };
+
+const size_t nt_cache_record_size[NT_CACHE_TABLES] = {sizeof(nt_seasons_record), sizeof(nt_sun_record),
+                                                      sizeof(nt_moon_record), sizeof(nt_mustaches_record)};
+const size_t nt_cache_key_size[NT_CACHE_TABLES] = {offsetof(nt_seasons_record, ut), offsetof(nt_sun_record, value),
+                                                   offsetof(nt_moon_record, value), offsetof(nt_mustaches_record, value)};
+#define RECORD_SIZE nt_cache_record_size
+#define KEY_SIZE nt_cache_key_size
+
+// Native layout, written and read with memcpy / in place.
+typedef struct {
+  char magic[8];
+  uint32_t format;
+  uint32_t header_size;
+  char version[16];
+  uint32_t config;
+  uint32_t byte_order;
+  uint32_t record_size[T_COUNT];
+  uint32_t capacity[T_COUNT];  // slots: 0 or a power of two
+  uint32_t count[T_COUNT];
+  uint64_t offset[T_COUNT];    // from the start of the blob, 8-byte aligned
+  uint64_t total_size;
+  uint64_t header_check;       // hash of every byte above
+} snapshot_header_t;
+
+static const char MAGIC[8] = {'N', 'T', 'S', 'N', 'A', 'P', '\0', '\0'};
+
+// -------------------------
+// Recording (per thread)
+// -------------------------
+
+typedef struct {
+  uint8_t* data;
+  uint32_t count;
+  uint32_t capacity;
+} record_list_t;
+
+static NT_THREAD_LOCAL int g_recording;
+static NT_THREAD_LOCAL nt_snapshot_counts g_hits;
+static NT_THREAD_LOCAL record_list_t g_recorded[T_COUNT];
+
+static void record(int table, const void* rec) {
+  if (!g_recording) return;
+  record_list_t* l = &g_recorded[table];
+  if (l->count >= NT_SNAPSHOT_MAX_ENTRIES) return;
+  if (l->count == l->capacity) {
+    uint32_t cap = l->capacity ? 2 * l->capacity : 64;
+    uint8_t* grown = (uint8_t*)realloc(l->data, (size_t)cap * RECORD_SIZE[table]);
+    if (!grown) return;
+    l->data = grown;
+    l->capacity = cap;
+  }
+  memcpy(l->data + (size_t)l->count * RECORD_SIZE[table], rec, RECORD_SIZE[table]);
+  l->count++;
+}
+
+void nt_snapshot_discard(void) {
+  for (int t = 0; t < T_COUNT; ++t) {
+    free(g_recorded[t].data);
+    memset(&g_recorded[t], 0, sizeof(g_recorded[t]));
+  }
+}
+
+void nt_snapshot_record(int enabled) {
+  if (enabled) nt_snapshot_discard();
+  g_recording = enabled ? 1 : 0;
+}
+
+void nt_snapshot_recorded(nt_snapshot_counts* out) {
+  if (!out) return;
+  out->seasons = g_recorded[T_SEASONS].count;
+  out->sun_events = g_recorded[T_SUN].count;
+  out->moon_events = g_recorded[T_MOON].count;
+  out->mustaches = g_recorded[T_MUSTACHES].count;
+}
+
+// -------------------------
+// Tables
+// -------------------------
+
+static uint64_t fnv1a(const void* p, size_t n, uint64_t h) {
+  const uint8_t* b = (const uint8_t*)p;
+  for (size_t i = 0; i < n; ++i) h = (h ^ b[i]) * 0x100000001b3ULL;
+  return h;
+}
+
+static uint64_t key_hash(int table, const void* rec) {
+  uint64_t h = fnv1a(rec, KEY_SIZE[table], 0xcbf29ce484222325ULL);
+  h ^= h >> 33;  // the low bits pick the slot
+  h *= 0xff51afd7ed558ccdULL;
+  return h ^ (h >> 33);
+}
+
+static int slot_empty(int table, const uint8_t* slot) {
+  for (size_t i = 0; i < KEY_SIZE[table]; ++i) {
+    if (slot[i] != 0xFF) return 0;
+  }
+  return 1;
+}
+
+// Linear probing; NULL when the key is absent. `insert` claims the empty slot.
+static uint8_t* probe(int table, uint8_t* base, uint32_t capacity, const void* rec, int insert) {
+  if (capacity == 0) return NULL;
+  uint64_t i = key_hash(table, rec);
+  for (uint32_t n = 0; n < capacity; ++n, ++i) {
+    uint8_t* slot = base + (size_t)(i & (capacity - 1)) * RECORD_SIZE[table];
+    if (slot_empty(table, slot)) {
+      if (!insert) return NULL;
+      memcpy(slot, rec, RECORD_SIZE[table]);
+      return slot;
+    }
+    if (memcmp(slot, rec, KEY_SIZE[table]) == 0) return insert ? NULL : slot;
+  }
+  return NULL;
+}
+
+static uint32_t table_capacity(uint32_t count) {
+  if (count == 0) return 0;
+  uint32_t cap = 1;
+  while (cap < 2 * count) cap <<= 1;  // load factor <= 1/2
+  return cap;
+}
+
+// -------------------------
+// Writing
+// -------------------------
+
+static void plan(snapshot_header_t* h) {
+  memset(h, 0, sizeof(*h));
+  memcpy(h->magic, MAGIC, sizeof(MAGIC));
+  h->format = NT_SNAPSHOT_FORMAT;
+  h->header_size = (uint32_t)sizeof(*h);
+  strncpy(h->version, NTC_VERSION, sizeof(h->version));
+  h->config = NT_BUILD_CONFIG;
+  h->byte_order = BYTE_ORDER_MARK;
+  uint64_t off = sizeof(*h);
+  for (int t = 0; t < T_COUNT; ++t) {
+    h->record_size[t] = (uint32_t)RECORD_SIZE[t];
+    h->capacity[t] = table_capacity(g_recorded[t].count);
+    h->offset[t] = off;
+    off += (uint64_t)h->capacity[t] * RECORD_SIZE[t];
+    off = (off + 7) & ~(uint64_t)7;
+  }
+  h->total_size = off;
+}
+
+size_t nt_snapshot_bound(void) {
+  snapshot_header_t h;
+  plan(&h);
+  return (size_t)h.total_size;
+}
+
+nt_err nt_snapshot_write(uint8_t* out, size_t capacity, size_t* out_size) {
+  if (!out || !out_size) return NT_ERR_INTERNAL;
+  snapshot_header_t h;
+  plan(&h);
+  if (h.total_size > capacity) return NT_ERR_RANGE;
+  memset(out, 0, (size_t)h.total_size);
+  for (int t = 0; t < T_COUNT; ++t) {
+    uint8_t* base = out + h.offset[t];
+    memset(base, 0xFF, (size_t)h.capacity[t] * RECORD_SIZE[t]);
+    const record_list_t* l = &g_recorded[t];
+    for (uint32_t i = 0; i < l->count; ++i) {
+      if (probe(t, base, h.capacity[t], l->data + (size_t)i * RECORD_SIZE[t], 1)) h.count[t]++;  // duplicates skipped
+    }
+  }
+  h.header_check = fnv1a(&h, offsetof(snapshot_header_t, header_check), 0xcbf29ce484222325ULL);
+  memcpy(out, &h, sizeof(h));
+  *out_size = (size_t)h.total_size;
+  return NT_OK;
+}
+
+nt_err nt_snapshot_save(const char* path) {
+  if (!path) return NT_ERR_INTERNAL;
+  size_t size = nt_snapshot_bound(), written = 0;
+  uint8_t* buf = (uint8_t*)malloc(size);
+  if (!buf) return NT_ERR_INTERNAL;
+  nt_err err = nt_snapshot_write(buf, size, &written);
+  if (err == NT_OK) {
+    // Write beside the target and rename, so a reader never maps a half-written file.
+    size_t n = strlen(path);
+    char* tmp = (char*)malloc(n + 5);
+    FILE* f = NULL;
+    if (tmp) {
+      memcpy(tmp, path, n);
+      memcpy(tmp + n, ".tmp", 5);
+      f = fopen(tmp, "wb");
+    }
+    int ok = f && fwrite(buf, 1, written, f) == written;
+    if (f && fclose(f) != 0) ok = 0;
+#if defined(_WIN32)
+    if (ok) remove(path);
+#endif
+    if (ok && rename(tmp, path) != 0) ok = 0;
+    if (!ok && tmp) remove(tmp);
+    if (!ok) err = NT_ERR_INTERNAL;
+    free(tmp);
+  }
+  free(buf);
+  return err;
+}
+
+// -------------------------
+// Loading (process-wide, read-only)
+// -------------------------
+
+enum { OWNED_NONE = 0, OWNED_MALLOC, OWNED_MMAP };
+
+static const uint8_t* g_blob;
+static size_t g_blob_size;
+static int g_owned;
+static snapshot_header_t g_header;
+
+static nt_err validate(const uint8_t* blob, size_t size, snapshot_header_t* h) {
+  if (!blob || size < sizeof(*h) || ((uintptr_t)blob & 7u) != 0) return NT_ERR_RANGE;
+  memcpy(h, blob, sizeof(*h));
+  char version[sizeof(h->version)];
+  memset(version, 0, sizeof(version));
+  strncpy(version, NTC_VERSION, sizeof(version));
+  if (memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 || h->format != NT_SNAPSHOT_FORMAT ||
+      h->header_size != sizeof(*h) || memcmp(h->version, version, sizeof(version)) != 0 ||
+      h->config != NT_BUILD_CONFIG || h->byte_order != BYTE_ORDER_MARK || h->total_size > size ||
+      h->header_check != fnv1a(h, offsetof(snapshot_header_t, header_check), 0xcbf29ce484222325ULL)) {
+    return NT_ERR_RANGE;
+  }
+  for (int t = 0; t < T_COUNT; ++t) {
+    uint32_t cap = h->capacity[t];
+    if (h->record_size[t] != RECORD_SIZE[t] || (cap & (cap - 1)) != 0 || h->count[t] > cap ||
+        (h->offset[t] & 7u) != 0 || h->offset[t] < sizeof(*h) || h->offset[t] > h->total_size ||
+        (uint64_t)cap * RECORD_SIZE[t] > h->total_size - h->offset[t]) {
+      return NT_ERR_RANGE;
+    }
+  }
+  return NT_OK;
+}
+
+static void release(void) {
+#if !defined(_WIN32)
+  if (g_owned == OWNED_MMAP) munmap((void*)g_blob, g_blob_size);
+#endif
+  if (g_owned == OWNED_MALLOC) free((void*)g_blob);
+  g_blob = NULL;
+  g_blob_size = 0;
+  g_owned = OWNED_NONE;
+  memset(&g_header, 0, sizeof(g_header));
+}
+
+static nt_err install(const uint8_t* blob, size_t size, int owned) {
+  snapshot_header_t h;
+  nt_err err = validate(blob, size, &h);
+  if (err != NT_OK) return err;
+  release();
+  g_blob = blob;
+  g_blob_size = size;
+  g_owned = owned;
+  g_header = h;
+  return NT_OK;
+}
+
+nt_err nt_snapshot_load(const uint8_t* blob, size_t size) {
+  return install(blob, size, OWNED_NONE);
+}
+
+nt_err nt_snapshot_load_file(const char* path) {
+  if (!path) return NT_ERR_INTERNAL;
+#if !defined(_WIN32)
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return NT_ERR_INTERNAL;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return NT_ERR_RANGE;
+  }
+  size_t size = (size_t)st.st_size;
+  void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) return NT_ERR_INTERNAL;
+  nt_err err = install((const uint8_t*)map, size, OWNED_MMAP);
+  if (err != NT_OK) munmap(map, size);
+  return err;
+#else
+  FILE* f = fopen(path, "rb");
+  if (!f) return NT_ERR_INTERNAL;
+  long len = (fseek(f, 0, SEEK_END) == 0) ? ftell(f) : -1;
+  uint8_t* buf = (len > 0 && fseek(f, 0, SEEK_SET) == 0) ? (uint8_t*)malloc((size_t)len) : NULL;
+  int ok = buf && fread(buf, 1, (size_t)len, f) == (size_t)len;
+  fclose(f);
+  if (!ok) {
+    free(buf);
+    return len > 0 ? NT_ERR_INTERNAL : NT_ERR_RANGE;
+  }
+  nt_err err = install(buf, (size_t)len, OWNED_MALLOC);
+  if (err != NT_OK) free(buf);
+  return err;
+#endif
+}
+
+void nt_snapshot_unload(void) {
+  release();
+}
+
+void nt_snapshot_loaded(nt_snapshot_counts* out) {
+  if (!out) return;
+  out->seasons = g_header.count[T_SEASONS];
+  out->sun_events = g_header.count[T_SUN];
+  out->moon_events = g_header.count[T_MOON];
+  out->mustaches = g_header.count[T_MUSTACHES];
+}
+
+void nt_snapshot_hits(nt_snapshot_counts* out) {
+  if (out) *out = g_hits;
+}
+
+// Snapshot lookup of a record whose key is filled in; copies the whole record.
+static int lookup(int table, void* rec) {
+  if (!g_blob) return 0;
+  const uint8_t* hit = probe(table, (uint8_t*)g_blob + g_header.offset[table], g_header.capacity[table], rec, 0);
+  if (!hit) return 0;
+  memcpy(rec, hit, RECORD_SIZE[table]);
+  record(table, rec);
+  switch (table) {
+    case T_SEASONS: g_hits.seasons++; break;
+    case T_SUN: g_hits.sun_events++; break;
+    case T_MOON: g_hits.moon_events++; break;
+    default: g_hits.mustaches++; break;
+  }
+  return 1;
+}
+
+// -------------------------
+// Keys
+// -------------------------
+
+void nt_internal_seasons_key(nt_seasons_record* r, int32_t year) {
+  memset(r, 0, sizeof(*r));
+  r->year = year;
+}
+
+void nt_internal_sun_key(nt_sun_record* r, int64_t nadir, double latitude_deg, double longitude_deg) {
+  memset(r, 0, sizeof(*r));
+  r->nadir = nadir;
+  r->latitude = latitude_deg + 0.0;
+  r->longitude = longitude_deg + 0.0;
+}
+
+void nt_internal_moon_key(nt_moon_record* r, int64_t nadir, double latitude_deg, double longitude_deg) {
+  memset(r, 0, sizeof(*r));
+  r->nadir = nadir;
+  r->latitude = latitude_deg + 0.0;
+  r->longitude = longitude_deg + 0.0;
+}
+
+void nt_internal_mustaches_key(nt_mustaches_record* r, int32_t year, double latitude_deg) {
+  memset(r, 0, sizeof(*r));
+  r->year = year;
+  r->latitude = latitude_deg + 0.0;
+}
+
+// -------------------------
+// Library hooks
+// -------------------------
+
+int nt_internal_snapshot_seasons(int32_t year, nt_seasons_record* out) {
+  nt_seasons_record r;
+  nt_internal_seasons_key(&r, year);
+  if (!lookup(T_SEASONS, &r)) return 0;
+  *out = r;
+  return 1;
+}
+
+int nt_internal_snapshot_sun_events(int64_t nadir, double latitude_deg, double longitude_deg, nt_sun_events* out) {
+  nt_sun_record r;
+  nt_internal_sun_key(&r, nadir, latitude_deg, longitude_deg);
+  if (!lookup(T_SUN, &r)) return 0;
+  *out = r.value;
+  return 1;
+}
+
+int nt_internal_snapshot_moon_events(int64_t nadir, double latitude_deg, double longitude_deg, nt_moon_events* out) {
+  nt_moon_record r;
+  nt_internal_moon_key(&r, nadir, latitude_deg, longitude_deg);
+  if (!lookup(T_MOON, &r)) return 0;
+  *out = r.value;
+  return 1;
+}
+
+int nt_internal_snapshot_mustaches(int32_t year, double latitude_deg, nt_mustaches* out) {
+  nt_mustaches_record r;
+  nt_internal_mustaches_key(&r, year, latitude_deg);
+  if (!lookup(T_MUSTACHES, &r)) return 0;
+  *out = r.value;
+  return 1;
+}
+
+void nt_internal_record_seasons(const nt_seasons_record* rec) {
+  if (!g_recording || rec->status != 0) return;
+  nt_seasons_record r;
+  nt_internal_seasons_key(&r, rec->year);
+  memcpy(r.ut, rec->ut, sizeof(r.ut));
+  record(T_SEASONS, &r);
+}
+
+void nt_internal_record_sun_events(int64_t nadir, double latitude_deg, double longitude_deg, const nt_sun_events* v) {
+  if (!g_recording) return;
+  nt_sun_record r;
+  nt_internal_sun_key(&r, nadir, latitude_deg, longitude_deg);
+  r.value = *v;
+  record(T_SUN, &r);
+}
+
+void nt_internal_record_moon_events(int64_t nadir, double latitude_deg, double longitude_deg, const nt_moon_events* v) {
+  if (!g_recording) return;
+  nt_moon_record r;
+  nt_internal_moon_key(&r, nadir, latitude_deg, longitude_deg);
+  r.value = *v;
+  record(T_MOON, &r);
+}
+
+void nt_internal_record_mustaches(int32_t year, double latitude_deg, const nt_mustaches* v) {
+  if (!g_recording) return;
+  nt_mustaches_record r;
+  nt_internal_mustaches_key(&r, year, latitude_deg);
+  r.value = *v;
+  record(T_MUSTACHES, &r);
+}
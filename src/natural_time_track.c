@@ -0,0 +1,226 @@
+#include "natural_time_track.h"
+#include "natural_time_internal.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "astronomy.h"  // vendor/astronomy include path wired from CMake
+
+static const int64_t MS_PER_DAY = 86400000LL;
+static const int64_t MS_PER_HOUR = 3600000LL;
+static const int64_t J2000_UNIX_MS = 946728000000LL;  // 2000-01-01T12:00:00Z
+static const double SIDEREAL_DEG_PER_MS = 360.98564736629 / 86400000.0;
+static const double SUN_PARALLAX_DEG = 0.002443;       // horizontal parallax at 1 AU
+static const double EARTH_RADIUS_KM = 6371.0;
+
+#define DEFAULT_MAX_DISTANCE_KM 25.0
+#define NEWTON_MAX_STEPS 6
+#define EDGE_GUARD_MS (30LL * 60000LL)   // refined events this close to a day edge re-anchor
+#define MAX_SHIFT_MS (3LL * MS_PER_HOUR) // refinement farther than this re-anchors
+#define POLAR_MARGIN_DEG 0.1             // model slack of the "no crossing" test (plus declination drift)
+#define NODE_SLOTS 64                    // hourly nodes, direct-mapped (covers the 2-day search windows)
+
+// Nominal thresholds of the searches in nt_sun_events_for_date (rise/set includes
+// refraction and the solar radius), used only for the "no crossing" margin test.
+static const double EVENT_ALTITUDE[NT_SUN_EVENT_COUNT] = {-0.8333, -0.8333, -12.0, -12.0, 6.0, 6.0};
+
+// Apparent sun position at an hour boundary (equator of date) and sidereal time.
+typedef struct {
+  int valid;
+  int64_t hour;
+  double ra_deg;
+  double dec_deg;
+  double gast_deg;
+} eph_node_t;
+
+typedef struct {
+  int valid;
+  double latitude, longitude;
+  int64_t unix_ms;
+  int64_t nadir;
+  nt_sun_event_times times;
+  double target_sin_alt[NT_SUN_EVENT_COUNT];  // model altitude at the searched instants
+} anchor_t;
+
+struct nt_track {
+  double max_distance_km;
+  int64_t max_interval_ms;
+  eph_node_t nodes[NODE_SLOTS];
+  anchor_t anchor;
+  nt_track_stats stats;
+};
+
+// -------------------------
+// Ephemeris model
+// -------------------------
+
+static void eval_node(nt_track* t, eph_node_t* n, int64_t hour) {
+  astro_time_t at = Astronomy_TimeFromDays((double)(hour * MS_PER_HOUR - J2000_UNIX_MS) / (double)MS_PER_DAY);
+  astro_vector_t eqj = Astronomy_GeoVector(BODY_SUN, at, ABERRATION);
+  astro_rotation_t rot = Astronomy_Rotation_EQJ_EQD(&at);
+  astro_equatorial_t eq = Astronomy_EquatorFromVector(Astronomy_RotateVector(rot, eqj));
+  n->valid = 1;
+  n->hour = hour;
+  n->ra_deg = eq.ra * 15.0;
+  n->dec_deg = eq.dec;
+  n->gast_deg = Astronomy_SiderealTime(&at) * 15.0;
+  t->stats.ephemeris_nodes++;
+}
+
+static const eph_node_t* node_at(nt_track* t, int64_t hour) {
+  eph_node_t* n = &t->nodes[(uint64_t)hour % NODE_SLOTS];
+  if (!n->valid || n->hour != hour) eval_node(t, n, hour);
+  return n;
+}
+
+// Sun declination and hour angle at (unix_ms, longitude), linear between hourly nodes.
+static void sun_hour_angle(nt_track* t, int64_t unix_ms, double longitude, double* dec_deg, double* ha_deg,
+                           double* dec_rate_deg_per_day) {
+  int64_t hour = unix_ms / MS_PER_HOUR - ((unix_ms % MS_PER_HOUR) < 0 ? 1 : 0);
+  const eph_node_t* a = node_at(t, hour);
+  const eph_node_t* b = node_at(t, hour + 1);
+  double f = (double)(unix_ms - hour * MS_PER_HOUR) / (double)MS_PER_HOUR;
+  double dra = b->ra_deg - a->ra_deg;
+  if (dra < -180.0) dra += 360.0;
+  if (dra > 180.0) dra -= 360.0;
+  double ra = a->ra_deg + f * dra;
+  double gast = a->gast_deg + (double)(unix_ms - hour * MS_PER_HOUR) * SIDEREAL_DEG_PER_MS;
+  *dec_deg = a->dec_deg + f * (b->dec_deg - a->dec_deg);
+  *ha_deg = gast + longitude - ra;
+  if (dec_rate_deg_per_day) *dec_rate_deg_per_day = (b->dec_deg - a->dec_deg) * 24.0;
+}
+
+static double sin_altitude(double lat, double dec, double ha) {
+  return sin(lat * DEG2RAD) * sin(dec * DEG2RAD) + cos(lat * DEG2RAD) * cos(dec * DEG2RAD) * cos(ha * DEG2RAD);
+}
+
+// Refines an event instant for a new observer: solves sin(alt) = target near `guess`.
+static int refine_event(nt_track* t, int64_t guess, double lat, double lon, double target, int64_t* out_ms) {
+  double tm = (double)guess;
+  for (int i = 0; i < NEWTON_MAX_STEPS; ++i) {
+    double dec, ha;
+    sun_hour_angle(t, (int64_t)llround(tm), lon, &dec, &ha, NULL);
+    double g = sin_altitude(lat, dec, ha) - target;
+    double slope = -cos(lat * DEG2RAD) * cos(dec * DEG2RAD) * sin(ha * DEG2RAD) * SIDEREAL_DEG_PER_MS * DEG2RAD;
+    if (fabs(slope) < 0.05 * SIDEREAL_DEG_PER_MS * DEG2RAD) return 0;  // grazing crossing
+    double step = g / slope;
+    tm -= step;
+    if (!isfinite(tm) || fabs(tm - (double)guess) > (double)MAX_SHIFT_MS) return 0;
+    if (fabs(step) < 0.5) {
+      *out_ms = (int64_t)llround(tm);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static double distance_km(double lat1, double lon1, double lat2, double lon2) {
+  double dlat = (lat2 - lat1) * DEG2RAD, dlon = (lon2 - lon1) * DEG2RAD;
+  double h = sin(dlat / 2) * sin(dlat / 2) + cos(lat1 * DEG2RAD) * cos(lat2 * DEG2RAD) * sin(dlon / 2) * sin(dlon / 2);
+  return 2.0 * EARTH_RADIUS_KM * asin(sqrt(h < 1.0 ? h : 1.0));
+}
+
+// -------------------------
+// Anchors
+// -------------------------
+
+static nt_err set_anchor(nt_track* t, const nt_natural_date* nd, double lat) {
+  anchor_t* a = &t->anchor;
+  nt_err err = nt_internal_sun_event_times(nd, lat, &a->times);
+  if (err != NT_OK) return err;
+  a->valid = 1;
+  a->latitude = lat;
+  a->longitude = nd->longitude;
+  a->unix_ms = nd->unix_time;
+  a->nadir = nd->nadir;
+  for (int i = 0; i < NT_SUN_EVENT_COUNT; ++i) {
+    if (!a->times.found[i]) continue;
+    double dec, ha;
+    sun_hour_angle(t, a->times.unix_ms[i], a->longitude, &dec, &ha, NULL);
+    a->target_sin_alt[i] = sin_altitude(lat, dec, ha);
+  }
+  t->stats.anchors++;
+  return NT_OK;
+}
+
+// Event instants for a fix from the anchor; 0 when the anchor must be rebuilt.
+static int times_from_anchor(nt_track* t, const nt_natural_date* nd, double lat, nt_sun_event_times* out) {
+  const anchor_t* a = &t->anchor;
+  double dec, ha, dec_rate;
+  sun_hour_angle(t, nd->unix_time, nd->longitude, &dec, &ha, &dec_rate);
+  double alt_max = 90.0 - fabs(lat - dec);
+  double alt_min = fabs(lat + dec) - 90.0;
+  double margin = POLAR_MARGIN_DEG + 2.0 * fabs(dec_rate);  // searches look up to 2 days ahead
+  for (int k = 0; k < NT_SUN_THRESHOLD_COUNT; ++k) out->regime[k] = a->times.regime[k];
+  for (int i = 0; i < NT_SUN_EVENT_COUNT; ++i) {
+    out->found[i] = a->times.found[i];
+    out->unix_ms[i] = 0;
+    if (!a->times.found[i]) {
+      // Still no crossing only if the sun stays clear of the threshold all day here.
+      double thr = EVENT_ALTITUDE[i];
+      if (!(alt_min - thr > margin || thr - alt_max > margin)) return 0;
+      continue;
+    }
+    int64_t ms;
+    if (!refine_event(t, a->times.unix_ms[i], lat, nd->longitude, a->target_sin_alt[i], &ms)) return 0;
+    // The search from this fix's nadir must find the same occurrence.
+    if (ms - nd->nadir < EDGE_GUARD_MS || ms - nd->nadir > MS_PER_DAY - EDGE_GUARD_MS) return 0;
+    out->unix_ms[i] = ms;
+  }
+  return 1;
+}
+
+// -------------------------
+// Public API
+// -------------------------
+
+nt_track* nt_track_create(const nt_track_options* options) {
+  nt_track* t = (nt_track*)calloc(1, sizeof(nt_track));
+  if (!t) return NULL;
+  t->max_distance_km = (options && options->max_distance_km > 0.0) ? options->max_distance_km : DEFAULT_MAX_DISTANCE_KM;
+  t->max_interval_ms = (options && options->max_interval_ms > 0) ? options->max_interval_ms : 0;
+  return t;
+}
+
+void nt_track_destroy(nt_track* t) {
+  free(t);
+}
+
+nt_err nt_track_process(nt_track* t, const nt_track_point* points, size_t count, nt_track_fix* out) {
+  if (!t || (count > 0 && (!points || !out))) return NT_ERR_INTERNAL;
+  for (size_t i = 0; i < count; ++i) {
+    const nt_track_point* p = &points[i];
+    nt_track_fix* f = &out[i];
+    if (!(p->latitude >= -90.0 && p->latitude <= 90.0)) return NT_ERR_RANGE;
+    nt_err err = nt_make_natural_date(p->unix_ms, p->longitude, &f->date);
+    if (err != NT_OK) return err;
+    t->stats.points++;
+
+    // Sun altitude from the interpolated model (topocentric parallax + normal refraction).
+    double dec, ha;
+    sun_hour_angle(t, p->unix_ms, p->longitude, &dec, &ha, NULL);
+    double s = sin_altitude(p->latitude, dec, ha);
+    double alt = asin(s < -1.0 ? -1.0 : (s > 1.0 ? 1.0 : s)) / DEG2RAD;
+    alt -= SUN_PARALLAX_DEG * cos(alt * DEG2RAD);
+    f->sun_altitude = alt + Astronomy_Refraction(REFRACTION_NORMAL, alt);
+
+    const anchor_t* a = &t->anchor;
+    nt_sun_event_times times;
+    int reuse = a->valid && llabs(f->date.nadir - a->nadir) < MS_PER_DAY / 2 &&
+                distance_km(a->latitude, a->longitude, p->latitude, p->longitude) <= t->max_distance_km &&
+                (t->max_interval_ms == 0 || llabs(p->unix_ms - a->unix_ms) <= t->max_interval_ms) &&
+                times_from_anchor(t, &f->date, p->latitude, &times);
+    f->anchored = !reuse;
+    if (!reuse) {
+      err = set_anchor(t, &f->date, p->latitude);
+      if (err != NT_OK) return err;
+      times = t->anchor.times;
+    }
+    nt_internal_sun_events_from_times(&f->date, p->latitude, &times, &f->sun);
+  }
+  return NT_OK;
+}
+
+void nt_track_get_stats(const nt_track* t, nt_track_stats* out) {
+  if (!t || !out) return;
+  *out = t->stats;
+}
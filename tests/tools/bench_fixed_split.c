@@ -0,0 +1,81 @@
+// Time-split benchmark: nt_time_split_fixed (integer split from the ms-of-day)
+// against nt_time_split_scaled with the same unit rounding (the double split,
+// unless the library is built with NT_FIXED_POINT). Both routes run over the
+// same ms values, ties of every decimal count included, and must agree.
+//   bench_fixed_split [splits per decimal count]
+// Prints ns per split for each route; timings are informational only.
+#include "natural_time.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static const double UNIT[7] = {1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001};
+static const int64_t TIE_PERIOD[7] = {240000, 24000, 2400, 240, 24, 12, 6};
+
+static double now_ns(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+int main(int argc, char** argv) {
+  long n = (argc > 1) ? atol(argv[1]) : 1000000;
+  if (n <= 0) return 2;
+  nt_natural_date nd;
+  if (nt_make_natural_date(1718928000000LL, 2.35, &nd) != NT_OK) return 1;
+
+  int64_t* ms = malloc((size_t)n * sizeof(*ms));
+  int32_t* fixed = malloc((size_t)n * 2 * sizeof(*fixed));
+  int32_t* scaled = malloc((size_t)n * 2 * sizeof(*scaled));
+  if (!ms || !fixed || !scaled) {
+    free(ms);
+    free(fixed);
+    free(scaled);
+    return 1;
+  }
+
+  int mismatches = 0;
+  double fixed_ns = 0.0, scaled_ns = 0.0;
+  uint64_t seed = 0x9E3779B97F4A7C15ULL;
+  for (int decimals = 0; decimals <= 6; ++decimals) {
+    // Every 16th value is an exact tie (ms * 10^d / 240000 ends in .5).
+    int64_t tie_period = TIE_PERIOD[decimals];
+    for (long i = 0; i < n; ++i) {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      int64_t r = (int64_t)((seed >> 11) % 86400000ULL);
+      ms[i] = (i % 16 == 0) ? (r / tie_period) * tie_period + tie_period / 2 : r;
+    }
+
+    int32_t fs, ss;
+    double t0 = now_ns();
+    for (long i = 0; i < n; ++i) {
+      nd.unix_time = nd.nadir + ms[i];
+      nt_time_split_fixed(&nd, decimals, &fixed[2 * i], &fixed[2 * i + 1], &fs);
+    }
+    double t1 = now_ns();
+    for (long i = 0; i < n; ++i) {
+      nd.unix_time = nd.nadir + ms[i];
+      nd.time_deg = (double)ms[i] * 360.0 / 86400000.0;
+      nt_time_split_scaled(&nd, decimals, UNIT[decimals], &scaled[2 * i], &scaled[2 * i + 1], &ss);
+    }
+    double t2 = now_ns();
+    fixed_ns += t1 - t0;
+    scaled_ns += t2 - t1;
+
+    for (long i = 0; i < 2 * n; ++i) mismatches += fixed[i] != scaled[i];
+    if (fs != ss) mismatches++;
+  }
+  free(ms);
+  free(fixed);
+  free(scaled);
+
+#if defined(NT_FIXED_POINT)
+  const char* scaled_route = "fixed";
+#else
+  const char* scaled_route = "double";
+#endif
+  printf("%ld splits per decimal count: nt_time_split_fixed %.1f ns/split, nt_time_split_scaled (%s) %.1f ns/split\n",
+         n, fixed_ns / (7.0 * (double)n), scaled_route, scaled_ns / (7.0 * (double)n));
+  printf("%d mismatches\n", mismatches);
+  return mismatches != 0;
+}
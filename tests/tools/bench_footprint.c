@@ -0,0 +1,130 @@
+// Footprint benchmark for natural_time vs natural_time_core. Built once per
+// variant; tests/tools/core_footprint.cmake drives both builds:
+//   bench_footprint dump <file>       sun/moon/mustache/season outputs over a grid
+//   bench_footprint compare <a> <b>   the two variants' dumps must agree
+//   bench_footprint startup <runs>    median wall time of fresh processes doing one sun query
+//   bench_footprint first-call        that query (the child process of `startup`)
+#include "natural_time.h"
+#include <math.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+
+#define MAX_RUNS 200
+#define MAX_ABS_DIFF 1e-9   // degrees; both variants run the same ephemeris code
+
+extern char** environ;
+
+static const double k_places[][2] = {{48.85, 2.35}, {-33.87, 151.21}, {64.15, -21.94}, {0.0, 0.0}, {78.22, 15.65}};
+
+static int query(int64_t unix_ms, double lat, double lon, FILE* out) {
+  nt_natural_date nd;
+  nt_sun_events se;
+  nt_sun_position sp;
+  nt_moon_events me;
+  nt_moon_position mp;
+  nt_mustaches mu;
+  if (nt_make_natural_date(unix_ms, lon, &nd) != NT_OK || nt_sun_events_for_date(&nd, lat, &se) != NT_OK ||
+      nt_sun_position_for_date(&nd, lat, &sp) != NT_OK || nt_moon_events_for_date(&nd, lat, &me) != NT_OK ||
+      nt_moon_position_for_date(&nd, lat, &mp) != NT_OK || nt_mustaches_range(&nd, lat, &mu) != NT_OK) {
+    return 0;
+  }
+  if (out) {
+    fprintf(out, "%lld %.17g %.17g %.17g %.17g %.17g %.17g %d %d %d\n", (long long)nd.year_start, se.sunrise_deg,
+            se.sunset_deg, se.night_start_deg, se.night_end_deg, se.morning_golden_deg, se.evening_golden_deg,
+            se.horizon_regime, se.night_regime, se.golden_regime);
+    fprintf(out, "%.17g %.17g %.17g %.17g %.17g %.17g %d\n", sp.altitude, sp.highest_altitude, mp.altitude,
+            mp.phase_deg, me.moonrise_deg, me.moonset_deg, me.horizon_regime);
+    fprintf(out, "%.17g %.17g %.17g %.17g %.17g\n", mu.winter_sunrise_deg, mu.winter_sunset_deg,
+            mu.summer_sunrise_deg, mu.summer_sunset_deg, mu.average_angle_deg);
+  }
+  return 1;
+}
+
+static int dump(const char* path) {
+  FILE* f = fopen(path, "w");
+  if (!f) return 1;
+  int ok = 1;
+  for (int d = 0; d < 40 && ok; ++d) {
+    int64_t t = 1704067200000LL + (int64_t)d * 9 * 86400000LL + (int64_t)d * 3600000LL;  // 2024, ~1 year
+    for (size_t p = 0; p < sizeof k_places / sizeof k_places[0] && ok; ++p) {
+      ok = query(t, k_places[p][0], k_places[p][1], f);
+    }
+  }
+  fclose(f);
+  return ok ? 0 : 1;
+}
+
+static int compare(const char* a_path, const char* b_path) {
+  FILE* a = fopen(a_path, "r");
+  FILE* b = fopen(b_path, "r");
+  int failures = 0;
+  size_t values = 0;
+  double worst = 0.0;
+  if (!a || !b) failures++;
+  while (!failures) {
+    double x, y;
+    int ra = fscanf(a, "%lf", &x), rb = fscanf(b, "%lf", &y);
+    if (ra != rb) failures++;
+    if (ra != 1 || rb != 1) break;
+    double diff = fabs(x - y);
+    if (!(diff <= MAX_ABS_DIFF) && !(isnan(x) && isnan(y))) {
+      fprintf(stderr, "value %zu: %.17g vs %.17g\n", values, x, y);
+      failures++;
+    }
+    if (diff > worst) worst = diff;
+    values++;
+  }
+  if (a) fclose(a);
+  if (b) fclose(b);
+  if (values == 0) failures++;
+  if (failures) return 1;
+  printf("parity ok: %zu values, max difference %.3g\n", values, worst);
+  return 0;
+}
+
+static double now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+static int cmp_double(const void* a, const void* b) {
+  double x = *(const double*)a, y = *(const double*)b;
+  return (x > y) - (x < y);
+}
+
+// Process creation, loading and one cold query per run.
+static int startup(const char* self, int runs) {
+  double ms[MAX_RUNS];
+  if (runs < 1) runs = 1;
+  if (runs > MAX_RUNS) runs = MAX_RUNS;
+  for (int i = 0; i < runs; ++i) {
+    char* argv[] = {(char*)self, "first-call", NULL};
+    pid_t pid;
+    int status;
+    double t0 = now_ms();
+    if (posix_spawn(&pid, self, NULL, NULL, argv, environ) != 0) return 1;
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) return 1;
+    ms[i] = now_ms() - t0;
+  }
+  qsort(ms, (size_t)runs, sizeof ms[0], cmp_double);
+  printf("startup: median %.3f ms, min %.3f ms over %d runs\n", ms[runs / 2], ms[0], runs);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc == 3 && strcmp(argv[1], "dump") == 0) return dump(argv[2]);
+  if (argc == 4 && strcmp(argv[1], "compare") == 0) return compare(argv[2], argv[3]);
+  if (argc == 3 && strcmp(argv[1], "startup") == 0) return startup(argv[0], atoi(argv[2]));
+  if (argc == 2 && strcmp(argv[1], "first-call") == 0) {
+    nt_natural_date nd;
+    nt_sun_events se;
+    return nt_make_natural_date(1718928000000LL, 2.35, &nd) == NT_OK && nt_sun_events_for_date(&nd, 48.85, &se) == NT_OK ? 0 : 1;
+  }
+  fprintf(stderr, "usage: %s dump <file> | compare <a> <b> | startup <runs> | first-call\n", argv[0]);
+  return 2;
+}
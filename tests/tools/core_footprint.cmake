@@ -0,0 +1,37 @@
+# Compares natural_time with natural_time_core: identical answers over a grid,
+# a smaller library (and executable when linked statically), and process
+# startup plus one cold sun query.
+# Invoked by ctest with -DFULL_EXE=<bench exe> -DCORE_EXE=<bench exe> -DFULL_LIB=<lib>
+# -DCORE_LIB=<lib> -DWORK=<scratch dir>; run `ctest -V -R core_footprint` for the numbers.
+file(MAKE_DIRECTORY ${WORK})
+foreach(variant FULL CORE)
+  execute_process(COMMAND ${${variant}_EXE} dump ${WORK}/${variant}.txt RESULT_VARIABLE rc)
+  if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "${variant} dump failed: ${rc}")
+  endif()
+endforeach()
+execute_process(COMMAND ${CORE_EXE} compare ${WORK}/FULL.txt ${WORK}/CORE.txt RESULT_VARIABLE rc OUTPUT_VARIABLE parity)
+if(NOT rc EQUAL 0)
+  message(FATAL_ERROR "natural_time_core answers differ from natural_time")
+endif()
+message(STATUS "${parity}")
+
+foreach(kind _LIB _EXE)
+  file(SIZE ${FULL${kind}} full_size)
+  file(SIZE ${CORE${kind}} core_size)
+  math(EXPR saved "100 - 100 * ${core_size} / ${full_size}")
+  get_filename_component(name ${CORE${kind}} NAME)
+  message(STATUS "${name}: ${core_size} bytes vs ${full_size} (${saved}% smaller)")
+  if(kind STREQUAL "_LIB" AND NOT core_size LESS full_size)
+    message(FATAL_ERROR "natural_time_core is not smaller than natural_time")
+  endif()
+endforeach()
+
+foreach(variant FULL CORE)
+  execute_process(COMMAND ${${variant}_EXE} startup 50 RESULT_VARIABLE rc OUTPUT_VARIABLE timing)
+  if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "${variant} startup run failed: ${rc}")
+  endif()
+  string(STRIP "${timing}" timing)
+  message(STATUS "${variant} ${timing}")
+endforeach()
@@ -0,0 +1,510 @@
+// ntaccuracy — accuracy-versus-speed profile of the fast paths.
+//
+//   ntaccuracy [--lat from:to:step] [--lon from:to:step]
+//              [--dates YYYY-MM-DD:YYYY-MM-DD:step_days]
+//              [--modes series,budget,track,illumination] [--budgets 4,16,48]
+//              [-o report.json]
+//
+// Sweeps a latitude/longitude/date grid and, for each mode, compares every
+// event with the full-precision answer: error histograms, mean and maximum,
+// the worst location, bound violations, and the time spent in the mode next
+// to the reference. Writes a JSON report (stdout by default) and exits with 1
+// when any mode exceeds its declared bound.
+//
+// Modes and their declared bounds:
+//   series        nt_sun_events_for_date / nt_moon_events_for_date crossing
+//                 instants (batched series) vs Astronomy_SearchRiseSetEx /
+//                 Astronomy_SearchAltitude from the same nadir: 1 s, and the
+//                 same events found
+//   budget_N      first nt_*_events_for_date_bounded estimate under an
+//                 N-evaluation budget vs the unbounded events: each event
+//                 within the error bound the call reports
+//   track         nt_track refinement 15 km and 2 h from its anchor vs
+//                 nt_sun_events_for_date / nt_sun_position_for_date: 0.001°
+//                 (natural_time_track.h; latitudes up to 70° only)
+//   illumination  nt_moon_illumination_for_year vs the ephemeris phase at
+//                 the day's 180°: 0.01 (natural_time.h)
+//
+// Built with the tests (it calls the library's internal search entry points)
+// against natural_time (ntaccuracy) and natural_time_core (ntaccuracy_core),
+// each compared with its own ephemeris.
+#include "natural_time.h"
+#include "natural_time_budget.h"
+#include "natural_time_internal.h"
+#include "natural_time_track.h"
+#include "astronomy.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef NT_ACCURACY_LIBRARY
+#define NT_ACCURACY_LIBRARY "natural_time"
+#endif
+
+#define MAX_MODES 16
+#define MAX_EVENTS 9
+#define MAX_BUDGETS 8
+#define EDGES 11  // histogram: below 1e-9, decades up to 10, then above
+
+static const int64_t MS_PER_DAY = 86400000LL;
+static const int64_t J2000_UNIX_MS = 946728000000LL;
+static const double SERIES_BOUND_S = 1.0;
+static const double TRACK_BOUND_DEG = 0.001;
+static const double TRACK_MAX_LATITUDE = 70.0;
+static const double ILLUMINATION_BOUND = 0.01;
+static const double BOUND_SLACK = 1e-6;
+
+typedef struct {
+  double from, to, step;
+} range_t;
+
+typedef struct {
+  double latitude, longitude;
+  int64_t unix_ms;
+} point_t;
+
+typedef struct {
+  const char* name;
+  const char* unit;
+  double bound;  // < 0: the bound each result reports
+  uint64_t count, violations, mismatches;
+  double sum, max, max_excess;
+  point_t worst;
+  uint64_t hist[EDGES + 1];
+} event_stats;
+
+typedef struct {
+  char name[32];
+  int nevents;
+  event_stats ev[MAX_EVENTS];
+  uint64_t samples;
+  uint64_t exact;  // budget: calls that finished within the budget
+  double time_s, reference_time_s;
+} mode_stats;
+
+typedef struct {
+  range_t lat, lon, days;  // days: from/to in days since 1970-01-01
+  int series, track, illumination;
+  uint32_t budgets[MAX_BUDGETS];
+  int nbudgets;
+  const char* output;
+} options_t;
+
+// -------------------------
+// Statistics
+// -------------------------
+
+static void add_event(mode_stats* m, const char* name, const char* unit, double bound) {
+  event_stats* e = &m->ev[m->nevents++];
+  memset(e, 0, sizeof(*e));
+  e->name = name;
+  e->unit = unit;
+  e->bound = bound;
+}
+
+static void record(event_stats* e, const point_t* p, double err, double bound) {
+  int b = 0;
+  while (b < EDGES && err >= pow(10.0, b - 9)) b++;
+  e->hist[b]++;
+  e->count++;
+  e->sum += err;
+  if (err > e->max || e->count == 1) {
+    e->max = err;
+    e->worst = *p;
+  }
+  double excess = err - bound;
+  if (excess > e->max_excess) e->max_excess = excess;
+  if (excess > BOUND_SLACK) e->violations++;
+}
+
+// Found by one side only: a violation whatever the bound.
+static void mismatch(event_stats* e, const point_t* p) {
+  e->mismatches++;
+  e->violations++;
+  if (e->mismatches == 1 && e->count == 0) e->worst = *p;
+}
+
+static double circular_diff(double a, double b) {
+  double d = fmod(fabs(a - b), 360.0);
+  return fmin(d, 360.0 - d);
+}
+
+// -------------------------
+// Modes
+// -------------------------
+
+static const char* const SUN_EVENTS[NT_SUN_EVENT_COUNT] = {"sunrise",     "sunset",         "night_start",
+                                                           "night_end",   "morning_golden", "evening_golden"};
+
+static double ut_of(int64_t unix_ms) {
+  return (double)(unix_ms - J2000_UNIX_MS) / (double)MS_PER_DAY;
+}
+
+// Same queries as nt_internal_sun_search_begin, through the vendor.
+static astro_search_result_t vendor_sun_event(int i, astro_observer_t obs, astro_time_t start) {
+  int k = i / 2, j = i % 2;
+  int rising = (k == NT_SUN_NIGHT) ? (j == 1) : (j == 0);
+  astro_direction_t dir = rising ? DIRECTION_RISE : DIRECTION_SET;
+  if (k == NT_SUN_HORIZON) return Astronomy_SearchRiseSetEx(BODY_SUN, obs, dir, start, 1.0, 0.0);
+  return Astronomy_SearchAltitude(BODY_SUN, obs, dir, start, 2.0, (k == NT_SUN_NIGHT) ? -12.0 : 6.0);
+}
+
+static nt_err run_series(mode_stats* m, const point_t* p, const nt_natural_date* nd) {
+  astro_observer_t obs = Astronomy_MakeObserver(p->latitude, p->longitude, 0.0);
+  astro_time_t start = Astronomy_TimeFromDays(ut_of(nd->nadir));
+
+  double t0 = nt_internal_clock_s();
+  nt_sun_event_times sun;
+  nt_err err = nt_internal_sun_event_times(nd, p->latitude, &sun);
+  nt_moon_search moon;
+  if (err == NT_OK) err = nt_internal_moon_search_begin(nd, p->latitude, &moon);
+  if (err != NT_OK) return err;
+  nt_internal_sky_search_run(&moon.search, NULL);
+  double t1 = nt_internal_clock_s();
+  astro_search_result_t ref[NT_SUN_EVENT_COUNT + 2];
+  for (int i = 0; i < NT_SUN_EVENT_COUNT; ++i) ref[i] = vendor_sun_event(i, obs, start);
+  ref[NT_SUN_EVENT_COUNT] = Astronomy_SearchRiseSetEx(BODY_MOON, obs, DIRECTION_RISE, start, 1.0, 0.0);
+  ref[NT_SUN_EVENT_COUNT + 1] = Astronomy_SearchRiseSetEx(BODY_MOON, obs, DIRECTION_SET, start, 1.0, 0.0);
+  double t2 = nt_internal_clock_s();
+  m->time_s += t1 - t0;
+  m->reference_time_s += t2 - t1;
+
+  for (int i = 0; i < NT_SUN_EVENT_COUNT + 2; ++i) {
+    int found = 0;
+    double ut = 0.0;
+    if (i < NT_SUN_EVENT_COUNT) {
+      found = sun.found[i];
+      ut = ut_of(sun.unix_ms[i]);
+    } else if (moon.search.count > 0) {  // else ruled out by the regime
+      const nt_sky_crossing* q = &moon.search.q[i - NT_SUN_EVENT_COUNT];
+      found = q->found;
+      ut = q->ut;
+    }
+    int want = ref[i].status == ASTRO_SUCCESS;
+    if (found != want) {
+      mismatch(&m->ev[i], p);
+    } else if (found) {
+      record(&m->ev[i], p, fabs(ut - ref[i].time.ut) * 86400.0, SERIES_BOUND_S);
+    }
+  }
+  m->samples++;
+  return NT_OK;
+}
+
+static nt_err run_budget(mode_stats* m, uint32_t evaluations, const point_t* p, const nt_natural_date* nd) {
+  static nt_continuation token;
+  nt_budget budget = {evaluations, 0};
+  nt_sun_events sun;
+  nt_moon_events moon;
+  nt_sun_events_bounded sb;
+  nt_moon_events_bounded mb;
+
+  nt_reset_caches();
+  double t0 = nt_internal_clock_s();
+  nt_err err = nt_sun_events_for_date(nd, p->latitude, &sun);
+  if (err == NT_OK) err = nt_moon_events_for_date(nd, p->latitude, &moon);
+  double t1 = nt_internal_clock_s();
+  if (err != NT_OK) return err;
+  nt_reset_caches();
+  double t2 = nt_internal_clock_s();
+  err = nt_sun_events_for_date_bounded(nd, p->latitude, &budget, &token, &sb);
+  if (err == NT_OK) err = nt_moon_events_for_date_bounded(nd, p->latitude, &budget, &token, &mb);
+  double t3 = nt_internal_clock_s();
+  if (err != NT_OK) return err;
+  m->reference_time_s += t1 - t0;
+  m->time_s += t3 - t2;
+
+  const double got[6] = {sb.value.sunrise_deg,     sb.value.sunset_deg,         sb.value.night_start_deg,
+                         sb.value.night_end_deg,   sb.value.morning_golden_deg, sb.value.evening_golden_deg};
+  const double want[6] = {sun.sunrise_deg,   sun.sunset_deg,         sun.night_start_deg,
+                          sun.night_end_deg, sun.morning_golden_deg, sun.evening_golden_deg};
+  for (int i = 0; i < 6; ++i) record(&m->ev[i], p, circular_diff(got[i], want[i]), sb.error_deg[i]);
+  record(&m->ev[6], p, circular_diff(mb.value.moonrise_deg, moon.moonrise_deg), mb.moonrise_error_deg);
+  record(&m->ev[7], p, circular_diff(mb.value.moonset_deg, moon.moonset_deg), mb.moonset_error_deg);
+  record(&m->ev[8], p, fabs(mb.value.highest_altitude - moon.highest_altitude), mb.highest_altitude_error_deg);
+  m->exact += !sb.approximate + !mb.approximate;
+  m->samples++;
+  return NT_OK;
+}
+
+static nt_err run_track(mode_stats* m, const point_t* p) {
+  if (fabs(p->latitude) > TRACK_MAX_LATITUDE) return NT_OK;
+  // Anchor 15 km west and 2 h earlier (same anchor while under 25 km).
+  nt_track_point pts[2] = {
+      {p->unix_ms - 2 * 3600000LL, p->latitude, p->longitude - 15.0 / (111.32 * cos(p->latitude * DEG2RAD))},
+      {p->unix_ms, p->latitude, p->longitude},
+  };
+  if (pts[0].longitude < -180.0) pts[0].longitude += 360.0;
+  nt_track_fix fix[2];
+  nt_track* t = nt_track_create(NULL);
+  if (!t) return NT_ERR_INTERNAL;
+  nt_reset_caches();
+  nt_err err = nt_track_process(t, pts, 1, fix);
+  double t0 = nt_internal_clock_s();
+  if (err == NT_OK) err = nt_track_process(t, pts + 1, 1, fix + 1);
+  double t1 = nt_internal_clock_s();
+  nt_track_destroy(t);
+  if (err != NT_OK) return err;
+
+  nt_natural_date nd;
+  nt_sun_events sun;
+  nt_sun_position pos;
+  nt_reset_caches();
+  double t2 = nt_internal_clock_s();
+  err = nt_make_natural_date(p->unix_ms, p->longitude, &nd);
+  if (err == NT_OK) err = nt_sun_events_for_date(&nd, p->latitude, &sun);
+  if (err == NT_OK) err = nt_sun_position_for_date(&nd, p->latitude, &pos);
+  double t3 = nt_internal_clock_s();
+  if (err != NT_OK) return err;
+  m->time_s += t1 - t0;
+  m->reference_time_s += t3 - t2;
+
+  const nt_sun_events* f = &fix[1].sun;
+  const double got[6] = {f->sunrise_deg,   f->sunset_deg,         f->night_start_deg,
+                         f->night_end_deg, f->morning_golden_deg, f->evening_golden_deg};
+  const double want[6] = {sun.sunrise_deg,   sun.sunset_deg,         sun.night_start_deg,
+                          sun.night_end_deg, sun.morning_golden_deg, sun.evening_golden_deg};
+  for (int i = 0; i < 6; ++i) record(&m->ev[i], p, circular_diff(got[i], want[i]), TRACK_BOUND_DEG);
+  if (pos.altitude > 0.0) record(&m->ev[6], p, fabs(fix[1].sun_altitude - pos.altitude), TRACK_BOUND_DEG);
+  m->samples++;
+  return NT_OK;
+}
+
+static nt_err run_illumination(mode_stats* m, const point_t* p, const nt_natural_date* nd) {
+  static double fraction[400];
+  size_t days = 0;
+  nt_natural_date mid;
+  nt_moon_position pos;
+  // Amortized over the sweep: the quarter search behind it is cached per year.
+  double t0 = nt_internal_clock_s();
+  nt_err err = nt_moon_illumination_for_year(nd, fraction, 400, &days);
+  double t1 = nt_internal_clock_s();
+  if (err == NT_OK) err = nt_make_natural_date(nd->nadir + MS_PER_DAY / 2, nd->longitude, &mid);
+  double t2 = nt_internal_clock_s();
+  if (err == NT_OK) err = nt_moon_position_for_date(&mid, 0.0, &pos);
+  double t3 = nt_internal_clock_s();
+  if (err != NT_OK) return err;
+  if (nd->day_of_year < 1 || (size_t)nd->day_of_year > days) return NT_ERR_INTERNAL;
+  m->time_s += t1 - t0;
+  m->reference_time_s += t3 - t2;
+  double want = (1.0 - cos(pos.phase_deg * DEG2RAD)) / 2.0;
+  record(&m->ev[0], p, fabs(fraction[nd->day_of_year - 1] - want), ILLUMINATION_BOUND);
+  m->samples++;
+  return NT_OK;
+}
+
+// -------------------------
+// Report
+// -------------------------
+
+static int64_t days_from_civil(int y, int m, int d) {
+  y -= m <= 2;
+  int64_t era = (y >= 0 ? y : y - 399) / 400;
+  int64_t yoe = y - era * 400;
+  int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+static void civil_from_days(int64_t z, int* y, int* m, int* d) {
+  z += 719468;
+  int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  int64_t doe = z - era * 146097;
+  int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  int64_t mp = (5 * doy + 2) / 153;
+  *d = (int)(doy - (153 * mp + 2) / 5 + 1);
+  *m = (int)(mp < 10 ? mp + 3 : mp - 9);
+  *y = (int)(yoe + era * 400 + (*m <= 2));
+}
+
+static void print_mode(FILE* f, const mode_stats* m, int last) {
+  uint64_t violations = 0;
+  for (int i = 0; i < m->nevents; ++i) violations += m->ev[i].violations;
+  fprintf(f, "    {\"mode\": \"%s\", \"samples\": %llu, \"time_s\": %.6f, \"reference_time_s\": %.6f, \"speedup\": %.3f,\n",
+          m->name, (unsigned long long)m->samples, m->time_s, m->reference_time_s,
+          m->time_s > 0.0 ? m->reference_time_s / m->time_s : 0.0);
+  if (strncmp(m->name, "budget_", 7) == 0) {
+    fprintf(f, "     \"exact_share\": %.4f,\n", m->samples ? (double)m->exact / (2.0 * (double)m->samples) : 0.0);
+  }
+  fprintf(f, "     \"violations\": %llu, \"pass\": %s,\n     \"events\": [\n", (unsigned long long)violations,
+          violations ? "false" : "true");
+  for (int i = 0; i < m->nevents; ++i) {
+    const event_stats* e = &m->ev[i];
+    int y, mo, d;
+    civil_from_days(e->worst.unix_ms / MS_PER_DAY, &y, &mo, &d);
+    fprintf(f, "       {\"event\": \"%s\", \"unit\": \"%s\", ", e->name, e->unit);
+    if (e->bound >= 0.0) fprintf(f, "\"declared_bound\": %.9g, ", e->bound);
+    else fprintf(f, "\"declared_bound\": \"reported\", \"max_excess\": %.9g, ", e->max_excess);
+    fprintf(f, "\"count\": %llu, \"mean\": %.9g, \"max\": %.9g, \"violations\": %llu, \"found_mismatches\": %llu,\n",
+            (unsigned long long)e->count, e->count ? e->sum / (double)e->count : 0.0, e->max,
+            (unsigned long long)e->violations, (unsigned long long)e->mismatches);
+    fprintf(f, "        \"worst\": {\"latitude\": %.6f, \"longitude\": %.6f, \"unix_ms\": %lld, \"date\": \"%04d-%02d-%02d\"},\n",
+            e->worst.latitude, e->worst.longitude, (long long)e->worst.unix_ms, y, mo, d);
+    fprintf(f, "        \"histogram\": {\"upper_edges\": [");
+    for (int b = 0; b < EDGES; ++b) fprintf(f, "%s%g", b ? ", " : "", pow(10.0, b - 9));
+    fprintf(f, "], \"counts\": [");
+    for (int b = 0; b <= EDGES; ++b) fprintf(f, "%s%llu", b ? ", " : "", (unsigned long long)e->hist[b]);
+    fprintf(f, "]}}%s\n", i + 1 < m->nevents ? "," : "");
+  }
+  fprintf(f, "     ]}%s\n", last ? "" : ",");
+}
+
+// -------------------------
+// Options
+// -------------------------
+
+static int parse_range(const char* s, range_t* r) {
+  return sscanf(s, "%lf:%lf:%lf", &r->from, &r->to, &r->step) == 3 && r->step > 0.0 && r->to >= r->from;
+}
+
+static int parse_dates(const char* s, range_t* r) {
+  int y0, m0, d0, y1, m1, d1;
+  if (sscanf(s, "%d-%d-%d:%d-%d-%d:%lf", &y0, &m0, &d0, &y1, &m1, &d1, &r->step) != 7 || !(r->step > 0.0)) return 0;
+  r->from = (double)days_from_civil(y0, m0, d0);
+  r->to = (double)days_from_civil(y1, m1, d1);
+  return r->to >= r->from && r->from > 0.0;
+}
+
+static int parse_modes(const char* s, options_t* o) {
+  o->series = o->track = o->illumination = 0;
+  int budget = 0;
+  char buf[128];
+  snprintf(buf, sizeof buf, "%s", s);
+  for (char* tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+    if (strcmp(tok, "series") == 0) o->series = 1;
+    else if (strcmp(tok, "budget") == 0) budget = 1;
+    else if (strcmp(tok, "track") == 0) o->track = 1;
+    else if (strcmp(tok, "illumination") == 0) o->illumination = 1;
+    else return 0;
+  }
+  if (!budget) o->nbudgets = 0;
+  return 1;
+}
+
+static int parse_budgets(const char* s, options_t* o) {
+  char buf[128];
+  snprintf(buf, sizeof buf, "%s", s);
+  o->nbudgets = 0;
+  for (char* tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+    long v = strtol(tok, NULL, 10);
+    if (o->nbudgets == MAX_BUDGETS || v < NT_BUDGET_MIN_EVALUATIONS) return 0;
+    o->budgets[o->nbudgets++] = (uint32_t)v;
+  }
+  return o->nbudgets > 0;
+}
+
+static void usage(void) {
+  fprintf(stderr,
+          "usage: ntaccuracy [--lat from:to:step] [--lon from:to:step] [--dates YYYY-MM-DD:YYYY-MM-DD:step_days]\n"
+          "                  [--modes series,budget,track,illumination] [--budgets 4,16,48] [-o report.json]\n");
+}
+
+int main(int argc, char** argv) {
+  options_t o = {{-75.0, 75.0, 25.0}, {-180.0, 150.0, 30.0}, {0.0, 0.0, 73.0}, 1, 1, 1, {4, 16, 48}, 3, NULL};
+  o.days.from = (double)days_from_civil(2020, 1, 1);
+  o.days.to = (double)days_from_civil(2030, 1, 1);
+  const char* budgets = NULL;
+  for (int i = 1; i < argc; ++i) {
+    int ok = i + 1 < argc;
+    if (ok && strcmp(argv[i], "--lat") == 0) ok = parse_range(argv[++i], &o.lat);
+    else if (ok && strcmp(argv[i], "--lon") == 0) ok = parse_range(argv[++i], &o.lon);
+    else if (ok && strcmp(argv[i], "--dates") == 0) ok = parse_dates(argv[++i], &o.days);
+    else if (ok && strcmp(argv[i], "--modes") == 0) ok = parse_modes(argv[++i], &o);
+    else if (ok && strcmp(argv[i], "--budgets") == 0) budgets = argv[++i];
+    else if (ok && strcmp(argv[i], "-o") == 0) o.output = argv[++i];
+    else ok = 0;
+    if (!ok) {
+      usage();
+      return 2;
+    }
+  }
+  if (budgets && o.nbudgets > 0 && !parse_budgets(budgets, &o)) {
+    usage();
+    return 2;
+  }
+  if (o.lat.from < -90.0 || o.lat.to > 90.0 || o.lon.from < -180.0 || o.lon.to > 180.0) {
+    usage();
+    return 2;
+  }
+
+  static mode_stats modes[MAX_MODES];
+  int nmodes = 0;
+  mode_stats *series = NULL, *budget[MAX_BUDGETS] = {NULL}, *track = NULL, *illumination = NULL;
+  if (o.series) {
+    series = &modes[nmodes++];
+    snprintf(series->name, sizeof series->name, "series");
+    for (int i = 0; i < NT_SUN_EVENT_COUNT; ++i) add_event(series, SUN_EVENTS[i], "s", SERIES_BOUND_S);
+    add_event(series, "moonrise", "s", SERIES_BOUND_S);
+    add_event(series, "moonset", "s", SERIES_BOUND_S);
+  }
+  for (int b = 0; b < o.nbudgets; ++b) {
+    budget[b] = &modes[nmodes++];
+    snprintf(budget[b]->name, sizeof budget[b]->name, "budget_%u", (unsigned)o.budgets[b]);
+    for (int i = 0; i < NT_SUN_EVENT_COUNT; ++i) add_event(budget[b], SUN_EVENTS[i], "deg", -1.0);
+    add_event(budget[b], "moonrise", "deg", -1.0);
+    add_event(budget[b], "moonset", "deg", -1.0);
+    add_event(budget[b], "moon_highest_altitude", "deg", -1.0);
+  }
+  if (o.track) {
+    track = &modes[nmodes++];
+    snprintf(track->name, sizeof track->name, "track");
+    for (int i = 0; i < NT_SUN_EVENT_COUNT; ++i) add_event(track, SUN_EVENTS[i], "deg", TRACK_BOUND_DEG);
+    add_event(track, "sun_altitude", "deg", TRACK_BOUND_DEG);
+  }
+  if (o.illumination) {
+    illumination = &modes[nmodes++];
+    snprintf(illumination->name, sizeof illumination->name, "illumination");
+    add_event(illumination, "illumination", "fraction", ILLUMINATION_BOUND);
+  }
+
+  // Noon UTC of each date, latitudes and longitudes from their lower ends.
+  uint64_t points = 0;
+  for (double lat = o.lat.from; lat <= o.lat.to + 1e-9; lat += o.lat.step) {
+    for (double lon = o.lon.from; lon <= o.lon.to + 1e-9; lon += o.lon.step) {
+      for (double day = o.days.from; day <= o.days.to + 1e-9; day += o.days.step) {
+        point_t p = {lat, lon, (int64_t)day * MS_PER_DAY + MS_PER_DAY / 2};
+        nt_natural_date nd;
+        nt_err err = nt_make_natural_date(p.unix_ms, lon, &nd);
+        if (err == NT_OK && series) err = run_series(series, &p, &nd);
+        for (int b = 0; err == NT_OK && b < o.nbudgets; ++b) err = run_budget(budget[b], o.budgets[b], &p, &nd);
+        if (err == NT_OK && track) err = run_track(track, &p);
+        if (err == NT_OK && illumination && lat == o.lat.from) err = run_illumination(illumination, &p, &nd);
+        if (err != NT_OK) {
+          fprintf(stderr, "ntaccuracy: error %d at lat %.4f lon %.4f unix_ms %lld\n", (int)err, lat, lon,
+                  (long long)p.unix_ms);
+          return 3;
+        }
+        points++;
+      }
+    }
+  }
+
+  FILE* f = o.output ? fopen(o.output, "w") : stdout;
+  if (!f) {
+    fprintf(stderr, "ntaccuracy: cannot write %s\n", o.output);
+    return 3;
+  }
+  int y0, m0, d0, y1, m1, d1;
+  civil_from_days((int64_t)o.days.from, &y0, &m0, &d0);
+  civil_from_days((int64_t)o.days.to, &y1, &m1, &d1);
+  uint64_t violations = 0;
+  for (int k = 0; k < nmodes; ++k) {
+    for (int i = 0; i < modes[k].nevents; ++i) violations += modes[k].ev[i].violations;
+  }
+  fprintf(f, "{\n  \"library\": \"%s\", \"version\": \"%s\",\n", NT_ACCURACY_LIBRARY, NTC_VERSION);
+  fprintf(f, "  \"grid\": {\"latitude\": [%g, %g, %g], \"longitude\": [%g, %g, %g], "
+             "\"dates\": [\"%04d-%02d-%02d\", \"%04d-%02d-%02d\", %g], \"points\": %llu},\n",
+          o.lat.from, o.lat.to, o.lat.step, o.lon.from, o.lon.to, o.lon.step, y0, m0, d0, y1, m1, d1, o.days.step,
+          (unsigned long long)points);
+  fprintf(f, "  \"pass\": %s,\n  \"modes\": [\n", violations ? "false" : "true");
+  for (int k = 0; k < nmodes; ++k) print_mode(f, &modes[k], k + 1 == nmodes);
+  fprintf(f, "  ]\n}\n");
+  if (o.output) fclose(f);
+  if (violations) {
+    fprintf(stderr, "ntaccuracy: %llu results outside their declared bound\n", (unsigned long long)violations);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,44 @@
+# Runs ntc on a small CSV and NDJSON sample, single- and multi-threaded.
+# Invoked by ctest with -DNTC=<path to ntc> -DWORK=<scratch dir>.
+file(MAKE_DIRECTORY ${WORK})
+set(csv "${WORK}/in.csv")
+file(WRITE ${csv} "id,unix_ms,lon,lat\n")
+foreach(i RANGE 0 2999)
+  math(EXPR t "1356091200000 + ${i} * 3600000")
+  math(EXPR lon "(${i} % 360) - 180")
+  file(APPEND ${csv} "${i},${t},${lon},48.85\n")
+endforeach()
+
+foreach(threads 1 4)
+  execute_process(COMMAND ${NTC} -t unix_ms -x lon -y lat --sun -j ${threads} -o ${WORK}/out_${threads}.csv ${csv}
+                  RESULT_VARIABLE rc)
+  if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "ntc -j ${threads} failed: ${rc}")
+  endif()
+endforeach()
+file(READ ${WORK}/out_1.csv single)
+file(READ ${WORK}/out_4.csv multi)
+if(NOT single STREQUAL multi)
+  message(FATAL_ERROR "multi-threaded output differs from single-threaded output")
+endif()
+string(FIND "${single}" "0,1356091200000,-180,48.85,0,14,53,365,1,1,1,0.000000,000)RAINBOW 000°00 NT-180.0" first)
+if(first EQUAL -1)
+  message(FATAL_ERROR "unexpected first row in:\n${single}")
+endif()
+string(REGEX MATCHALL "\n" lines "${single}")
+list(LENGTH lines nlines)
+if(NOT nlines EQUAL 3001)
+  message(FATAL_ERROR "expected 3001 lines, got ${nlines}")
+endif()
+
+# A whole timestamp written with a zero fraction is accepted; a fractional one is an error, not truncated.
+file(WRITE ${WORK}/in.ndjson "{\"unix_ms\":1356091200000,\"lon\":0}\n{\"unix_ms\":\"bad\"}\n"
+                             "{\"unix_ms\":1356091200000.000,\"lon\":0}\n{\"unix_ms\":1356091200000.5,\"lon\":0}\n")
+execute_process(COMMAND ${NTC} -x lon OUTPUT_VARIABLE nd INPUT_FILE ${WORK}/in.ndjson RESULT_VARIABLE rc)
+string(REGEX MATCHALL "\"nt_string\":\"000\\)RAINBOW 180°00 NTZ\"}" good "${nd}")
+string(REGEX MATCHALL "\"nt_error\":true}" bad "${nd}")
+list(LENGTH good ngood)
+list(LENGTH bad nbad)
+if(NOT rc EQUAL 0 OR NOT ngood EQUAL 2 OR NOT nbad EQUAL 2)
+  message(FATAL_ERROR "unexpected NDJSON output:\n${nd}")
+endif()
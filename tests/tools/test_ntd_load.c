@@ -0,0 +1,314 @@
+// Load generator for ntd: starts the daemon, drives it from several pipelining
+// client threads with mixed batches, checks sampled answers against the
+// library, then reads the daemon stats and stops it with SIGTERM.
+#include "ntd_wire.h"
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CLIENTS 4
+#define ROUNDS 40
+#define PIPELINE 8   // frames in flight per client
+#define BATCH 64
+
+static const char* g_socket;
+static const double k_places[5][2] = {{48.85, 2.35}, {-33.87, 151.21}, {64.15, -21.94}, {0.0, 0.0}, {78.22, 15.65}};
+
+typedef struct {
+  int index;
+  int failures;
+  uint64_t items;
+} client_arg;
+
+static uint64_t next_rand(uint64_t* s) {
+  *s = *s * 6364136223846793005ULL + 1442695040888963407ULL;
+  return *s >> 11;
+}
+
+static int same_result(int op, const ntd_query* q, const ntd_result* r) {
+  nt_natural_date nd;
+  nt_err e = nt_make_natural_date(q->unix_ms, q->longitude, &nd);
+  if (e == NT_OK && op != NTD_OP_DATE && !(q->latitude >= -90.0 && q->latitude <= 90.0)) e = NT_ERR_RANGE;
+  if (e != NT_OK) return r->status == e;
+  if (r->status != NT_OK) return 0;
+  switch (op) {
+    case NTD_OP_DATE:
+      return r->u.date.nadir == nd.nadir && r->u.date.time_deg == nd.time_deg && r->u.date.day_of_year == nd.day_of_year &&
+             r->u.date.year == nd.year && r->u.date.year_start == nd.year_start;
+    case NTD_OP_SUN_EVENTS: {
+      nt_sun_events se;
+      nt_sun_events_for_date(&nd, q->latitude, &se);
+      const nt_sun_events* g = &r->u.sun;
+      return se.sunrise_deg == g->sunrise_deg && se.sunset_deg == g->sunset_deg && se.night_start_deg == g->night_start_deg &&
+             se.night_end_deg == g->night_end_deg && se.morning_golden_deg == g->morning_golden_deg &&
+             se.evening_golden_deg == g->evening_golden_deg && se.horizon_regime == g->horizon_regime &&
+             se.night_regime == g->night_regime && se.golden_regime == g->golden_regime;
+    }
+    case NTD_OP_MOON_POSITION: {
+      nt_moon_position mp;
+      nt_moon_position_for_date(&nd, q->latitude, &mp);
+      return mp.altitude == r->u.moon_position.altitude && mp.phase_deg == r->u.moon_position.phase_deg;
+    }
+    case NTD_OP_MOON_EVENTS: {
+      nt_moon_events me;
+      nt_moon_events_for_date(&nd, q->latitude, &me);
+      const nt_moon_events* g = &r->u.moon_events;
+      return me.moonrise_deg == g->moonrise_deg && me.moonset_deg == g->moonset_deg &&
+             me.highest_altitude == g->highest_altitude && me.horizon_regime == g->horizon_regime;
+    }
+    case NTD_OP_MUSTACHES: {
+      nt_mustaches m;
+      nt_mustaches_range(&nd, q->latitude, &m);
+      return memcmp(&m, &r->u.mustaches, sizeof(m)) == 0;
+    }
+    default: return 0;
+  }
+}
+
+static int raw_connect(void) {
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, g_socket);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd >= 0 && connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+    close(fd);
+    fd = -1;
+  }
+  return fd;
+}
+
+// A frame of another protocol version gets an empty NT_ERR_RANGE response,
+// then the daemon hangs up.
+static int check_version_refused(void) {
+  int fd = raw_connect();
+  if (fd < 0) return 1;
+  unsigned char frame[NTD_HEADER_SIZE + NTD_QUERY_SIZE];
+  ntd_header h = {NTD_PROTOCOL_VERSION + 1, NTD_QUERY_SIZE, 7, NTD_OP_DATE, 1, 0};
+  ntd_query one = {1750000000000LL, 2.35, 48.85};
+  ntd_put_header(frame, &h);
+  ntd_put_query(frame + NTD_HEADER_SIZE, &one);
+  int failures = (write(fd, frame, sizeof(frame)) != (ssize_t)sizeof(frame));
+  unsigned char reply[NTD_HEADER_SIZE + 1];
+  size_t got = 0;
+  ssize_t r;
+  while ((r = read(fd, reply + got, sizeof(reply) - got)) > 0) got += (size_t)r;
+  ntd_get_header(reply, &h);
+  if (got != NTD_HEADER_SIZE || h.version != NTD_PROTOCOL_VERSION || h.id != 7 || h.status != NT_ERR_RANGE ||
+      h.payload_len != 0) {
+    failures++;
+  }
+  close(fd);
+  return failures;
+}
+
+// A client that writes far more than it reads: the daemon stops reading it once
+// NTD_MAX_PENDING_OUT bytes of responses are unsent, and resumes as they drain.
+#define SLOW_FRAMES 24
+typedef struct {
+  int fd;
+  int ok;
+} slow_writer_arg;
+
+static void* slow_writer_main(void* p) {
+  slow_writer_arg* a = (slow_writer_arg*)p;
+  size_t len = NTD_HEADER_SIZE + (size_t)NTD_MAX_BATCH * NTD_QUERY_SIZE;
+  unsigned char* frame = (unsigned char*)malloc(len);
+  if (!frame) return NULL;
+  for (uint32_t f = 0; f < SLOW_FRAMES; ++f) {
+    ntd_header h = {NTD_PROTOCOL_VERSION, NTD_MAX_BATCH * NTD_QUERY_SIZE, f + 1, NTD_OP_DATE, NTD_MAX_BATCH, 0};
+    ntd_put_header(frame, &h);
+    for (int i = 0; i < NTD_MAX_BATCH; ++i) {
+      ntd_query q = {1750000000000LL + (int64_t)f * 86400000LL + i * 1000LL, 2.35, 48.85};
+      ntd_put_query(frame + NTD_HEADER_SIZE + (size_t)i * NTD_QUERY_SIZE, &q);
+    }
+    for (size_t off = 0; off < len;) {
+      ssize_t w = send(a->fd, frame + off, len - off, MSG_NOSIGNAL);
+      if (w <= 0) { free(frame); return NULL; }
+      off += (size_t)w;
+    }
+  }
+  free(frame);
+  a->ok = 1;
+  return NULL;
+}
+
+static int read_exact(int fd, unsigned char* p, size_t n) {
+  while (n > 0) {
+    ssize_t r = read(fd, p, n);
+    if (r <= 0) return 0;
+    p += r;
+    n -= (size_t)r;
+  }
+  return 1;
+}
+
+static int check_slow_reader(void) {
+  slow_writer_arg a = {raw_connect(), 0};
+  if (a.fd < 0) return 1;
+  struct timeval tv = {10, 0};  // a stalled daemon fails the check instead of hanging it
+  setsockopt(a.fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  pthread_t th;
+  if (pthread_create(&th, NULL, slow_writer_main, &a) != 0) {
+    close(a.fd);
+    return 1;
+  }
+  usleep(300000);  // let the responses back up in the daemon
+  int failures = 0;
+  size_t rec = 8 + ntd_wire_record_size(NTD_OP_DATE);
+  unsigned char* body = (unsigned char*)malloc((size_t)NTD_MAX_BATCH * rec);
+  uint32_t seen = 0;  // responses come back in completion order
+  for (uint32_t f = 0; body && f < SLOW_FRAMES; ++f) {
+    unsigned char hb[NTD_HEADER_SIZE];
+    ntd_header h;
+    if (!read_exact(a.fd, hb, sizeof(hb))) { failures++; break; }
+    ntd_get_header(hb, &h);
+    if (h.id < 1 || h.id > SLOW_FRAMES || (seen & (1u << (h.id - 1))) || h.status != NT_OK ||
+        h.count != NTD_MAX_BATCH || h.payload_len != NTD_MAX_BATCH * rec || !read_exact(a.fd, body, h.payload_len)) {
+      failures++;
+      break;
+    }
+    seen |= 1u << (h.id - 1);
+  }
+  if (!body) failures++;
+  free(body);
+  shutdown(a.fd, SHUT_RDWR);
+  pthread_join(th, NULL);
+  close(a.fd);
+  if (!a.ok) failures++;
+  if (failures) fprintf(stderr, "slow reader: responses did not all arrive\n");
+  return failures;
+}
+
+static void* client_main(void* p) {
+  client_arg* a = (client_arg*)p;
+  ntd_client* c = ntd_client_connect(g_socket);
+  if (!c) { a->failures++; return NULL; }
+  uint64_t seed = 0x51ED270B27ULL + (uint64_t)a->index;
+  static ntd_query q[CLIENTS][PIPELINE][BATCH];
+  static int ops[CLIENTS][PIPELINE];
+  ntd_result* res = (ntd_result*)malloc(BATCH * sizeof(ntd_result));
+
+  for (int round = 0; round < ROUNDS; ++round) {
+    for (int f = 0; f < PIPELINE; ++f) {
+      int op = 1 + (int)(next_rand(&seed) % NTD_QUERY_OPS);
+      ops[a->index][f] = op;
+      for (int i = 0; i < BATCH; ++i) {
+        // 90 days x 5 places: repeated days exercise the shared cache.
+        const double* pl = k_places[next_rand(&seed) % 5];
+        ntd_query* x = &q[a->index][f][i];
+        x->unix_ms = 1750000000000LL + (int64_t)(next_rand(&seed) % 90) * 86400000LL + (int64_t)(next_rand(&seed) % 86400000ULL);
+        x->longitude = pl[1];
+        x->latitude = pl[0];
+        if (i == 7) x->latitude = 91.0;  // per-item error inside a batch
+      }
+      ntd_client_send(c, (uint32_t)(round * PIPELINE + f + 1), op, q[a->index][f], BATCH);
+    }
+    for (int f = 0; f < PIPELINE; ++f) {
+      uint32_t id;
+      size_t n;
+      if (ntd_client_recv(c, &id, res, BATCH, &n) != NT_OK || n != BATCH) { a->failures++; continue; }
+      int slot = (int)((id - 1) % PIPELINE);
+      if ((int)((id - 1) / PIPELINE) != round) { a->failures++; continue; }
+      a->items += n;
+      for (size_t i = 0; i < n; i += 13) {
+        if (!same_result(ops[a->index][slot], &q[a->index][slot][i], &res[i])) a->failures++;
+      }
+      if (res[7].status != NT_ERR_RANGE && ops[a->index][slot] != NTD_OP_DATE) a->failures++;
+    }
+  }
+  free(res);
+  ntd_client_close(c);
+  return NULL;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) { fprintf(stderr, "usage: test_ntd_load path/to/ntd\n"); return 1; }
+  char path[64];  // relative: under the directory ctest runs in
+  snprintf(path, sizeof(path), "ntd_test_%d.sock", (int)getpid());
+  g_socket = path;
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    execl(argv[1], argv[1], "-s", path, "-j", "4", (char*)NULL);
+    _exit(127);
+  }
+  ntd_client* c = NULL;
+  for (int i = 0; i < 500 && !c; ++i) {
+    c = ntd_client_connect(path);
+    if (!c) usleep(10000);
+  }
+  if (!c) { fprintf(stderr, "ntd did not start\n"); kill(pid, SIGKILL); return 2; }
+
+  int failures = 0;
+  // Unknown op: whole-frame error, connection stays usable.
+  ntd_query one = {1750000000000LL, 2.35, 48.85};
+  ntd_result r;
+  if (ntd_client_send(c, 99, 42, &one, 1) != NT_OK) failures++;
+  uint32_t id;
+  size_t n;
+  if (ntd_client_recv(c, &id, &r, 1, &n) != NT_ERR_RANGE || id != 99) failures++;
+  if (ntd_client_query(c, NTD_OP_DATE, &one, 1, &r) != NT_OK || !same_result(NTD_OP_DATE, &one, &r)) failures++;
+  failures += check_version_refused();
+
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  pthread_t th[CLIENTS];
+  client_arg args[CLIENTS];
+  int started = 0;
+  for (; started < CLIENTS; ++started) {
+    args[started] = (client_arg){started, 0, 0};
+    if (pthread_create(&th[started], NULL, client_main, &args[started]) != 0) {
+      fprintf(stderr, "cannot start client thread %d\n", started);
+      failures++;
+      break;
+    }
+  }
+  uint64_t items = 0;
+  for (int i = 0; i < started; ++i) {
+    pthread_join(th[i], NULL);
+    failures += args[i].failures;
+    items += args[i].items;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  double secs = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+  ntd_stats st;
+  if (ntd_client_stats(c, &st) != NT_OK) failures++;
+  uint64_t frames = 0, hits = 0, misses = 0;
+  for (int o = 0; o < NTD_QUERY_OPS; ++o) {
+    frames += st.ops[o].frames;
+    hits += st.ops[o].cache_hits;
+    misses += st.ops[o].cache_misses;
+    printf("op %d: %llu frames, p50 <= %llu us, p99 <= %llu us\n", o + 1, (unsigned long long)st.ops[o].frames,
+           (unsigned long long)ntd_latency_quantile_us(&st.ops[o], 0.5),
+           (unsigned long long)ntd_latency_quantile_us(&st.ops[o], 0.99));
+  }
+  if (frames != CLIENTS * ROUNDS * PIPELINE + 1) { fprintf(stderr, "frames %llu\n", (unsigned long long)frames); failures++; }
+  // Only 450 distinct (day, place) keys: nearly everything after warm-up is a hit.
+  if (hits < 4 * misses) { fprintf(stderr, "cache hits %llu misses %llu\n", (unsigned long long)hits, (unsigned long long)misses); failures++; }
+  failures += check_slow_reader();
+  ntd_client_close(c);
+
+  kill(pid, SIGTERM);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failures++;
+  if (access(path, F_OK) == 0) failures++;  // socket removed on shutdown
+
+  if (failures != 0) {
+    fprintf(stderr, "ntd load test failed: %d failures\n", failures);
+    return 3;
+  }
+  printf("ntd load ok (%llu items in %.2f s, cache hits %llu / misses %llu)\n", (unsigned long long)items, secs,
+         (unsigned long long)hits, (unsigned long long)misses);
+  return 0;
+}
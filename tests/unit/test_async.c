@@ -0,0 +1,130 @@
+#include "natural_time_async.h"
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+// Callback mode: the first completion blocks the only worker until the rest is queued,
+// which makes the priority/coalescing order deterministic.
+typedef struct {
+  pthread_mutex_t mu;
+  pthread_cond_t cv;
+  int entered, released;
+  int order[8];
+  nt_async_completion got[8];
+  int n;
+} recorder;
+
+static void on_complete(const nt_async_completion* c, void* ctx) {
+  recorder* r = (recorder*)ctx;
+  pthread_mutex_lock(&r->mu);
+  if (r->n < 8) {
+    r->order[r->n] = (int)(intptr_t)c->user_data;
+    r->got[r->n] = *c;
+  }
+  r->n++;
+  r->entered = 1;
+  pthread_cond_broadcast(&r->cv);
+  while (!r->released) pthread_cond_wait(&r->cv, &r->mu);
+  pthread_mutex_unlock(&r->mu);
+}
+
+// Field by field: the struct has tail padding.
+static int sun_equal(const nt_sun_events* a, const nt_sun_events* b) {
+  return a->sunrise_deg == b->sunrise_deg && a->sunset_deg == b->sunset_deg && a->night_start_deg == b->night_start_deg &&
+         a->night_end_deg == b->night_end_deg && a->morning_golden_deg == b->morning_golden_deg &&
+         a->evening_golden_deg == b->evening_golden_deg && a->horizon_regime == b->horizon_regime &&
+         a->night_regime == b->night_regime && a->golden_regime == b->golden_regime;
+}
+
+static int same_sun(const nt_sun_events* a, const nt_async_request* req) {
+  nt_natural_date nd;
+  nt_sun_events se;
+  nt_make_natural_date(req->unix_ms, req->longitude, &nd);
+  nt_sun_events_for_date(&nd, req->latitude, &se);
+  return sun_equal(a, &se);
+}
+
+int main(void) {
+  int failures = 0;
+  const int64_t day0 = 1750000000000LL;
+  recorder rec = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0, {0}, {{0}}, 0};
+  nt_async_queue* q = nt_async_create(1, on_complete, &rec);
+  if (!q) return 1;
+
+  nt_async_request range = {NT_ASYNC_MOON_QUARTERS_RANGE, day0, day0 + 60LL * 86400000LL, 2.35, 0.0, 100};
+  nt_async_request low = {NT_ASYNC_SUN_EVENTS, day0, 0, 2.35, 48.85, 0};
+  nt_async_request low_same_day = low;
+  low_same_day.unix_ms += 3600000LL;  // same natural day: coalesced with `low`
+  nt_async_request high = {NT_ASYNC_MOON_EVENTS, day0, 0, 2.35, 48.85, 5};
+  nt_async_request dropped = {NT_ASYNC_MUSTACHES, day0, 0, 0.0, 48.85, 1};
+  uint64_t h[5];
+  if (nt_async_submit(q, &range, (void*)1, &h[0]) != NT_OK) failures++;
+  pthread_mutex_lock(&rec.mu);
+  while (!rec.entered) pthread_cond_wait(&rec.cv, &rec.mu);
+  pthread_mutex_unlock(&rec.mu);
+
+  if (nt_async_submit(q, &low, (void*)2, &h[1]) != NT_OK) failures++;
+  if (nt_async_submit(q, &high, (void*)3, &h[2]) != NT_OK) failures++;
+  if (nt_async_submit(q, &low_same_day, (void*)4, &h[3]) != NT_OK) failures++;
+  if (nt_async_submit(q, &dropped, (void*)5, &h[4]) != NT_OK) failures++;
+  if (nt_async_cancel(q, h[4]) != NT_OK) failures++;
+  if (nt_async_cancel(q, h[4]) != NT_ERR_RANGE) failures++;
+  if (nt_async_cancel(q, h[0]) != NT_ERR_RANGE) failures++;  // already done
+  nt_async_request bad = low;
+  bad.latitude = 91.0;
+  uint64_t hb;
+  if (nt_async_submit(q, &bad, NULL, &hb) != NT_ERR_RANGE) failures++;
+
+  pthread_mutex_lock(&rec.mu);
+  rec.released = 1;
+  pthread_cond_broadcast(&rec.cv);
+  pthread_mutex_unlock(&rec.mu);
+
+  nt_async_stats st;
+  pthread_mutex_lock(&rec.mu);
+  while (rec.n < 4) pthread_cond_wait(&rec.cv, &rec.mu);
+  pthread_mutex_unlock(&rec.mu);
+  nt_async_destroy(q);
+
+  // Range first (already running), then high priority, then the coalesced pair in submission order.
+  const int expect[4] = {1, 3, 2, 4};
+  if (rec.n != 4) failures++;
+  for (int i = 0; i < 4 && i < rec.n; ++i) if (rec.order[i] != expect[i]) failures++;
+  if (rec.got[0].status != NT_OK || rec.got[0].u.quarters.count < 7 || rec.got[0].u.quarters.count > 9) failures++;
+  if (rec.got[2].status != NT_OK || !same_sun(&rec.got[2].u.sun, &low)) failures++;
+  if (!sun_equal(&rec.got[2].u.sun, &rec.got[3].u.sun)) failures++;
+  if (rec.got[2].handle != h[1] || rec.got[3].handle != h[3]) failures++;
+
+  // Poll mode: completions queue up and the wait fd signals them.
+  q = nt_async_create(2, NULL, NULL);
+  if (!q) return 1;
+  nt_async_request req[20];
+  for (int i = 0; i < 20; ++i) {
+    req[i] = (nt_async_request){NT_ASYNC_SUN_EVENTS, day0 + (int64_t)(i % 10) * 86400000LL, 0, -21.94, 64.15, i % 3};
+    uint64_t hh;
+    if (nt_async_submit(q, &req[i], &req[i], &hh) != NT_OK) failures++;
+  }
+  int received = 0;
+  struct pollfd pfd = {nt_async_wait_fd(q), POLLIN, 0};
+  while (received < 20 && poll(&pfd, 1, 5000) > 0) {
+    nt_async_completion c[8];
+    size_t n = nt_async_poll(q, c, 8);
+    for (size_t i = 0; i < n; ++i) {
+      const nt_async_request* r = (const nt_async_request*)c[i].user_data;
+      if (c[i].status != NT_OK || !same_sun(&c[i].u.sun, r)) failures++;
+    }
+    received += (int)n;
+  }
+  nt_async_get_stats(q, &st);
+  nt_async_destroy(q);
+  if (received != 20) failures++;
+  if (st.computed + st.coalesced != 20 || st.computed < 10) failures++;
+
+  if (failures != 0) {
+    fprintf(stderr, "async test failed: %d failures\n", failures);
+    return 3;
+  }
+  printf("async ok (poll mode: %llu computed, %llu coalesced)\n", (unsigned long long)st.computed, (unsigned long long)st.coalesced);
+  return 0;
+}
@@ -0,0 +1,121 @@
+#include "natural_time_buckets.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+  int64_t ts;
+  double value;
+} sample_t;
+
+static int by_time(const void* a, const void* b) {
+  int64_t x = ((const sample_t*)a)->ts, y = ((const sample_t*)b)->ts;
+  return (x > y) - (x < y);
+}
+
+int main(void) {
+  int failures = 0;
+  const int64_t start = 1700000000000LL;             // Nov 2023
+  const int64_t end = start + 800LL * 86400000LL;    // spans two natural new years
+  const double lon = -73.98;
+
+  enum { N = 50000 };
+  int64_t* ts = (int64_t*)malloc(N * sizeof(int64_t));
+  double* values = (double*)malloc(N * sizeof(double));
+  int32_t* ids = (int32_t*)malloc(N * sizeof(int32_t));
+  uint64_t seed = 0xD1B54A32D192ED03ULL;
+  for (int i = 0; i < N; ++i) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    ts[i] = start + (int64_t)((seed >> 11) % (uint64_t)(end - start));
+    values[i] = (double)(i % 7);
+  }
+
+  for (int unit = NT_BUCKET_DAY; unit <= NT_BUCKET_YEAR; ++unit) {
+    nt_err err;
+    nt_bucket_table* t = nt_bucket_table_create(start, end, lon, (nt_bucket_unit)unit, &err);
+    if (!t || err != NT_OK) return 1;
+    size_t n = nt_bucket_table_size(t);
+
+    // Buckets tile the range without gaps.
+    nt_bucket first, last, prev, cur;
+    nt_bucket_get(t, 0, &first);
+    nt_bucket_get(t, n - 1, &last);
+    if (first.start_ms > start || last.end_ms < end) failures++;
+    for (size_t i = 1; i < n; ++i) {
+      nt_bucket_get(t, i - 1, &prev);
+      nt_bucket_get(t, i, &cur);
+      if (prev.end_ms != cur.start_ms || cur.end_ms <= cur.start_ms) failures++;
+    }
+
+    // Unsorted assignment matches nt_make_natural_date on a sample.
+    nt_bucket_assign(t, ts, N, ids);
+    for (int i = 0; i < N; i += 50) {
+      nt_natural_date nd;
+      nt_bucket b;
+      nt_make_natural_date(ts[i], lon, &nd);
+      if (ids[i] == NT_BUCKET_NONE || nt_bucket_get(t, (size_t)ids[i], &b) != NT_OK) { failures++; continue; }
+      int32_t expect = (unit == NT_BUCKET_DAY) ? nd.day_of_year : (unit == NT_BUCKET_WEEK) ? nd.week : (unit == NT_BUCKET_MOON) ? nd.moon : 1;
+      if (b.year != nd.year || b.ordinal != expect || ts[i] < b.start_ms || ts[i] >= b.end_ms) {
+        if (failures < 5) fprintf(stderr, "unit %d: %lld -> year %d/%d ordinal %d/%d\n", unit, (long long)ts[i], b.year, nd.year, b.ordinal, expect);
+        failures++;
+      }
+      if (unit == NT_BUCKET_DAY && b.start_ms != nd.nadir) failures++;
+    }
+
+    // Unsorted aggregation matches the assigned ids; the same samples sorted and
+    // aggregated in two chunks give the same per-bucket counts and sums (the
+    // values are small integers, so the sums are exact in any order).
+    uint64_t* counts = (uint64_t*)calloc(n, sizeof(uint64_t));
+    double* sums = (double*)calloc(n, sizeof(double));
+    uint64_t* sorted_counts = (uint64_t*)calloc(n, sizeof(uint64_t));
+    double* sorted_sums = (double*)calloc(n, sizeof(double));
+    uint64_t* expect_counts = (uint64_t*)calloc(n, sizeof(uint64_t));
+    for (int i = 0; i < N; ++i) expect_counts[ids[i]]++;
+    if (nt_bucket_aggregate(t, ts, values, N, counts, sums) != 0) failures++;
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+      if (counts[i] != expect_counts[i]) failures++;
+      total += sums[i];
+    }
+    double expect_total = 0.0;
+    for (int i = 0; i < N; ++i) expect_total += values[i];
+    if (total != expect_total) failures++;
+
+    sample_t* samples = (sample_t*)malloc(N * sizeof(sample_t));
+    int64_t* sorted = (int64_t*)malloc(N * sizeof(int64_t));
+    double* sorted_values = (double*)malloc(N * sizeof(double));
+    for (int i = 0; i < N; ++i) samples[i] = (sample_t){ts[i], values[i]};
+    qsort(samples, N, sizeof(sample_t), by_time);
+    for (int i = 0; i < N; ++i) {
+      sorted[i] = samples[i].ts;
+      sorted_values[i] = samples[i].value;
+    }
+    size_t outside = nt_bucket_aggregate(t, sorted, sorted_values, N / 2, sorted_counts, sorted_sums);
+    outside += nt_bucket_aggregate(t, sorted + N / 2, sorted_values + N / 2, N - N / 2, sorted_counts, sorted_sums);
+    if (outside != 0) failures++;
+    for (size_t i = 0; i < n; ++i) {
+      if (sorted_counts[i] != counts[i] || sorted_sums[i] != sums[i]) failures++;
+    }
+
+    nt_bucket_assign(t, sorted, N, ids);
+    for (int i = 1; i < N; ++i) if (ids[i] < ids[i - 1]) failures++;
+    int32_t none;
+    int64_t before = first.start_ms - 1;
+    nt_bucket_assign(t, &before, 1, &none);
+    if (none != NT_BUCKET_NONE) failures++;
+
+    printf("unit %d: %zu buckets\n", unit, n);
+    free(counts); free(sums); free(sorted_counts); free(sorted_sums); free(expect_counts);
+    free(samples); free(sorted); free(sorted_values);
+    nt_bucket_table_destroy(t);
+  }
+  nt_err err;
+  if (nt_bucket_table_create(end, start, lon, NT_BUCKET_DAY, &err) != NULL || err != NT_ERR_RANGE) failures++;
+
+  free(ts); free(values); free(ids);
+  if (failures != 0) {
+    fprintf(stderr, "buckets test failed: %d failures\n", failures);
+    return 3;
+  }
+  printf("buckets ok\n");
+  return 0;
+}
@@ -0,0 +1,162 @@
+#include "natural_time.h"
+#include "natural_time_budget.h"
+#include "natural_time_internal.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// Bounded calls resumed until exact: every call stays within its evaluation
+// cap (counting the instants the series really evaluated), every estimate
+// within its error bound, and the final answer is the unbounded one exactly.
+
+static const double SLACK_DEG = 1e-6;
+
+static double circular_diff(double a, double b) {
+  double d = fmod(fabs(a - b), 360.0);
+  return fmin(d, 360.0 - d);
+}
+
+// Series instants evaluated since the last call.
+static uint64_t spent(uint64_t* mark) {
+  uint64_t now = nt_internal_sky_eval_count(), n = now - *mark;
+  *mark = now;
+  return n;
+}
+
+static int same_sun(const nt_sun_events* a, const nt_sun_events* b) {
+  return a->sunrise_deg == b->sunrise_deg && a->sunset_deg == b->sunset_deg && a->night_start_deg == b->night_start_deg &&
+         a->night_end_deg == b->night_end_deg && a->morning_golden_deg == b->morning_golden_deg &&
+         a->evening_golden_deg == b->evening_golden_deg && a->horizon_regime == b->horizon_regime &&
+         a->night_regime == b->night_regime && a->golden_regime == b->golden_regime;
+}
+
+static int same_moon(const nt_moon_events* a, const nt_moon_events* b) {
+  return a->moonrise_deg == b->moonrise_deg && a->moonset_deg == b->moonset_deg &&
+         a->highest_altitude == b->highest_altitude && a->horizon_regime == b->horizon_regime;
+}
+
+static int check_sun(const nt_natural_date* nd, double lat, const nt_budget* budget, int* calls) {
+  nt_sun_events exact;
+  nt_reset_caches();
+  if (nt_sun_events_for_date(nd, lat, &exact) != NT_OK) return 1;
+  nt_reset_caches();
+
+  static nt_continuation token;
+  nt_sun_events_bounded r;
+  int failures = 0;
+  uint64_t mark = nt_internal_sky_eval_count();
+  if (nt_sun_events_for_date_bounded(nd, lat, budget, &token, &r) != NT_OK) return 1;
+  for (*calls = 1;; ++*calls) {
+    uint64_t real = spent(&mark);
+    if (real != r.evaluations || (budget->max_evaluations && r.evaluations > budget->max_evaluations)) {
+      fprintf(stderr, "sun lat %.1f call %d: %llu evaluations, %u reported\n", lat, *calls, (unsigned long long)real,
+              (unsigned)r.evaluations);
+      failures++;
+    }
+    if (!r.approximate) break;
+    const double got[6] = {r.value.sunrise_deg, r.value.sunset_deg, r.value.night_start_deg,
+                           r.value.night_end_deg, r.value.morning_golden_deg, r.value.evening_golden_deg};
+    const double want[6] = {exact.sunrise_deg, exact.sunset_deg, exact.night_start_deg,
+                            exact.night_end_deg, exact.morning_golden_deg, exact.evening_golden_deg};
+    for (int i = 0; i < 6; ++i) {
+      if (circular_diff(got[i], want[i]) > r.error_deg[i] + SLACK_DEG) {
+        fprintf(stderr, "sun lat %.1f call %d event %d: %.6f vs %.6f (bound %.6f)\n", lat, *calls, i, got[i], want[i],
+                r.error_deg[i]);
+        failures++;
+      }
+    }
+    if (*calls > 1000 || nt_sun_events_resume(&token, budget, &r) != NT_OK) return failures + 1;
+  }
+  if (!same_sun(&r.value, &exact)) {
+    fprintf(stderr, "sun lat %.1f: bounded result differs\n", lat);
+    failures++;
+  }
+  // Finished: served from the thread cache, nothing spent.
+  if (nt_sun_events_for_date_bounded(nd, lat, budget, &token, &r) != NT_OK || r.approximate || r.evaluations != 0) failures++;
+  return failures;
+}
+
+static int check_moon(const nt_natural_date* nd, double lat, const nt_budget* budget, int* calls) {
+  nt_moon_events exact;
+  if (nt_moon_events_for_date(nd, lat, &exact) != NT_OK) return 1;
+
+  static nt_continuation token;
+  nt_moon_events_bounded r;
+  int failures = 0;
+  uint64_t mark = nt_internal_sky_eval_count();
+  if (nt_moon_events_for_date_bounded(nd, lat, budget, &token, &r) != NT_OK) return 1;
+  for (*calls = 1;; ++*calls) {
+    // The transit search is charged NT_BUDGET_TRANSIT_EVALUATIONS without using the series.
+    uint64_t real = spent(&mark);
+    if (real > r.evaluations || (budget->max_evaluations && r.evaluations > budget->max_evaluations)) {
+      fprintf(stderr, "moon lat %.1f call %d: %llu evaluations, %u reported\n", lat, *calls, (unsigned long long)real,
+              (unsigned)r.evaluations);
+      failures++;
+    }
+    if (!r.approximate) break;
+    if (circular_diff(r.value.moonrise_deg, exact.moonrise_deg) > r.moonrise_error_deg + SLACK_DEG ||
+        circular_diff(r.value.moonset_deg, exact.moonset_deg) > r.moonset_error_deg + SLACK_DEG ||
+        fabs(r.value.highest_altitude - exact.highest_altitude) > r.highest_altitude_error_deg + SLACK_DEG) {
+      fprintf(stderr, "moon lat %.1f call %d: %.4f/%.4f/%.4f vs %.4f/%.4f/%.4f (bounds %.4f/%.4f/%.4f)\n", lat, *calls,
+              r.value.moonrise_deg, r.value.moonset_deg, r.value.highest_altitude, exact.moonrise_deg,
+              exact.moonset_deg, exact.highest_altitude, r.moonrise_error_deg, r.moonset_error_deg,
+              r.highest_altitude_error_deg);
+      failures++;
+    }
+    if (*calls > 1000 || nt_moon_events_resume(&token, budget, &r) != NT_OK) return failures + 1;
+  }
+  if (!same_moon(&r.value, &exact)) {
+    fprintf(stderr, "moon lat %.1f: bounded result differs\n", lat);
+    failures++;
+  }
+  return failures;
+}
+
+int main(void) {
+  int failures = 0;
+  const double lats[] = {-70.0, -33.9, 0.0, 48.85, 64.1, 78.2};
+  const uint32_t caps[] = {NT_BUDGET_MIN_EVALUATIONS, 12, 40, 0};
+  int max_calls = 0;
+  for (int d = 0; d < 6; ++d) {
+    nt_natural_date nd;
+    int64_t t = 1704067200000LL + (int64_t)d * 67 * 86400000LL;  // 2024
+    for (size_t i = 0; i < sizeof lats / sizeof lats[0]; ++i) {
+      if (nt_make_natural_date(t, -150.0 + 55.0 * d, &nd) != NT_OK) return 3;
+      for (size_t c = 0; c < sizeof caps / sizeof caps[0]; ++c) {
+        nt_budget budget = {caps[c], 0};
+        int calls = 0;
+        failures += check_sun(&nd, lats[i], &budget, &calls);
+        if (caps[c] == 0 && calls != 1) failures++;  // no cap: one call
+        if (calls > max_calls) max_calls = calls;
+        failures += check_moon(&nd, lats[i], &budget, &calls);
+        if (caps[c] == 0 && calls != 1) failures++;
+      }
+      // Clock budget: progress on every call, same final answer.
+      nt_budget quick = {0, 20};
+      int calls = 0;
+      failures += check_sun(&nd, lats[i], &quick, &calls);
+      failures += check_moon(&nd, lats[i], &quick, &calls);
+    }
+  }
+
+  // Misuse.
+  nt_natural_date nd;
+  nt_continuation token;
+  nt_sun_events_bounded sr;
+  nt_moon_events_bounded mr;
+  memset(&token, 0, sizeof(token));
+  nt_budget tiny = {NT_BUDGET_MIN_EVALUATIONS - 1, 0};
+  if (nt_make_natural_date(1718928000000LL, 2.35, &nd) != NT_OK) return 3;
+  if (nt_sun_events_resume(&token, NULL, &sr) != NT_ERR_RANGE) failures++;
+  if (nt_sun_events_for_date_bounded(&nd, 48.85, &tiny, &token, &sr) != NT_ERR_RANGE) failures++;
+  if (nt_sun_events_for_date_bounded(&nd, 91.0, NULL, &token, &sr) != NT_ERR_RANGE) failures++;
+  if (nt_sun_events_for_date_bounded(&nd, 48.85, NULL, &token, &sr) != NT_OK) failures++;
+  if (nt_moon_events_resume(&token, NULL, &mr) != NT_ERR_RANGE) failures++;  // a sun token
+
+  if (failures != 0) {
+    fprintf(stderr, "budget test failed: %d failures\n", failures);
+    return 3;
+  }
+  printf("budget ok (up to %d calls per sun day at %u evaluations)\n", max_calls, (unsigned)NT_BUDGET_MIN_EVALUATIONS);
+  return 0;
+}
@@ -0,0 +1,126 @@
+#include "natural_time.h"
+#include "natural_time_capture.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// Captured calls come back in order with their arguments, status and cache
+// hits; nested calls are not recorded, the ring keeps the newest calls, and
+// nothing is recorded once stopped. Leaves a trace at argv[1] for ntreplay.
+
+static int workload(int days) {
+  int failures = 0;
+  for (int d = 0; d < days; ++d) {
+    nt_natural_date nd;
+    nt_sun_events se;
+    nt_moon_events me;
+    nt_mustaches mu;
+    double lat = (d % 3 == 0) ? 48.85 : -33.9;
+    if (nt_make_natural_date(1704067200000LL + (int64_t)(d / 2) * 86400000LL, 2.35, &nd) != NT_OK) failures++;
+    if (nt_sun_events_for_date(&nd, lat, &se) != NT_OK) failures++;
+    if (nt_moon_events_for_date(&nd, lat, &me) != NT_OK) failures++;
+    if (nt_mustaches_range(&nd, lat, &mu) != NT_OK) failures++;
+  }
+  return failures;
+}
+
+int main(int argc, char** argv) {
+  int failures = 0;
+  char path[96];
+  snprintf(path, sizeof path, "nt_test_capture_%ld.ntcap", (long)getpid());  // in the build directory
+
+  if (nt_capture_start(path, 0) != NT_ERR_RANGE || nt_capture_active()) failures++;
+  if (nt_capture_start(path, 64) != NT_OK || !nt_capture_active()) {
+    fprintf(stderr, "start failed\n");
+    return 3;
+  }
+  if (nt_capture_start(path, 64) != NT_ERR_RANGE) failures++;  // already running
+
+  nt_reset_caches();
+  nt_natural_date nd;
+  nt_sun_events se;
+  nt_mustaches mu;
+  nt_cache_stats before, after;
+  nt_cache_counters(&before);
+  if (nt_make_natural_date(1718928000000LL, 2.35, &nd) != NT_OK) failures++;
+  if (nt_sun_events_for_date(&nd, 48.85, &se) != NT_OK) failures++;
+  if (nt_sun_events_for_date(&nd, 48.85, &se) != NT_OK) failures++;
+  if (nt_sun_events_for_date(&nd, 91.0, &se) != NT_ERR_RANGE) failures++;
+  if (nt_mustaches_range(&nd, 48.85, &mu) != NT_OK) failures++;  // nested make/sun calls
+  nt_cache_counters(&after);
+  if (after.sun_events_hits - before.sun_events_hits < 1 || after.sun_events_misses - before.sun_events_misses < 3 ||
+      after.mustaches_misses - before.mustaches_misses != 1) {
+    failures++;
+  }
+  nt_capture_stop();
+  if (nt_capture_active()) failures++;
+  if (nt_sun_events_for_date(&nd, 48.85, &se) != NT_OK) failures++;  // not recorded
+  nt_capture_stop();
+
+  nt_capture_record* r = NULL;
+  size_t n = 0;
+  uint64_t dropped = 0;
+  if (nt_capture_load(path, &r, &n, &dropped) != NT_OK || n != 5 || dropped != 0) {
+    fprintf(stderr, "load: %zu records\n", n);
+    return 3;
+  }
+  const uint8_t calls[5] = {NT_CALL_MAKE_NATURAL_DATE, NT_CALL_SUN_EVENTS, NT_CALL_SUN_EVENTS, NT_CALL_SUN_EVENTS,
+                            NT_CALL_MUSTACHES};
+  const int8_t status[5] = {NT_OK, NT_OK, NT_OK, NT_ERR_RANGE, NT_OK};
+  for (size_t i = 0; i < n; ++i) {
+    if (r[i].call != calls[i] || r[i].status != status[i] || r[i].unix_ms != 1718928000000LL || r[i].longitude != 2.35 ||
+        r[i].thread != r[0].thread) {
+      fprintf(stderr, "record %zu: call %d status %d\n", i, r[i].call, r[i].status);
+      failures++;
+    }
+  }
+  if (r[1].latitude != 48.85 || r[1].caches != (NT_CACHE_HIT_SUN_EVENTS << 4) || r[2].caches != NT_CACHE_HIT_SUN_EVENTS ||
+      r[3].caches != 0 || !(r[4].caches & (NT_CACHE_HIT_MUSTACHES << 4)) || r[1].latency_ns == 0) {
+    failures++;
+  }
+  nt_capture_free(r);
+
+  // A small ring keeps the newest calls, oldest first.
+  if (nt_capture_start(path, 8) != NT_OK) failures++;
+  for (int i = 0; i < 20; ++i) {
+    if (nt_make_natural_date(1704067200000LL + (int64_t)i * 1000, 0.0, &nd) != NT_OK) failures++;
+  }
+  nt_capture_stop();
+  if (nt_capture_load(path, &r, &n, &dropped) != NT_OK || n != 8 || dropped != 12) failures++;
+  for (size_t i = 0; i < n; ++i) {
+    if (r[i].unix_ms != 1704067200000LL + (int64_t)(12 + i) * 1000) failures++;
+  }
+
+  // Save round trip; bad files are refused.
+  if (nt_capture_save(path, r, n) != NT_OK) failures++;
+  nt_capture_record* again = NULL;
+  size_t m = 0;
+  if (nt_capture_load(path, &again, &m, &dropped) != NT_OK || m != n || dropped != 0 ||
+      memcmp(again, r, n * sizeof(*r)) != 0) {
+    failures++;
+  }
+  nt_capture_free(again);
+  nt_capture_free(r);
+  FILE* f = fopen(path, "wb");
+  if (f) {
+    fputs("not a capture", f);
+    fclose(f);
+  }
+  if (nt_capture_load(path, &r, &n, &dropped) != NT_ERR_RANGE) failures++;
+  unlink(path);
+
+  // A realistic trace for the ntreplay smoke test.
+  if (argc > 1) {
+    if (nt_capture_start(argv[1], 4096) != NT_OK) failures++;
+    nt_reset_caches();
+    failures += workload(200);
+    nt_capture_stop();
+  }
+
+  if (failures != 0) {
+    fprintf(stderr, "capture test failed: %d failures\n", failures);
+    return 3;
+  }
+  printf("capture ok\n");
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include "natural_time.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// Constant dates fold at compile time.
+constexpr auto kEat = nt::make_natural_date(1356091200000LL, 0.0);
+static_assert(kEat.has_value());
+static_assert(kEat->year == 0 && kEat->moon == 14 && kEat->day_of_year == 365);
+static_assert(kEat->is_rainbow_day == 1 && kEat->day == -1);
+static_assert(kEat->year_start == 1324598400000LL && kEat->nadir == 1356048000000LL);
+static_assert(kEat->time_deg == 180.0);
+static_assert(nt::split_time<2>(*kEat).integer == 180 && nt::split_time<2>(*kEat).fraction == 0);
+static_assert(!nt::make_natural_date(0, 0.0).has_value());
+static_assert(!nt::make_natural_date(1356091200000LL, 181.0).has_value());
+
+static int check_same(const nt_natural_date& c, const nt_natural_date& x) {
+  return c.year == x.year && c.moon == x.moon && c.week == x.week && c.week_of_moon == x.week_of_moon &&
+         c.unix_time == x.unix_time && c.longitude == x.longitude && c.day == x.day &&
+         c.day_of_year == x.day_of_year && c.day_of_moon == x.day_of_moon && c.day_of_week == x.day_of_week &&
+         c.is_rainbow_day == x.is_rainbow_day && c.time_deg == x.time_deg && c.year_start == x.year_start &&
+         c.year_duration == x.year_duration && c.nadir == x.nadir;
+}
+
+int main() {
+  int failures = 0;
+  int checked = 0;
+
+  // Every solstice table entry against Astronomy_Seasons through the C library.
+  for (int y = nt::detail::solstice_table_first_year + 1; y < nt::detail::solstice_table_last_year; ++y) {
+    std::int64_t probe = nt::detail::new_year_noon_ms(y) + 3 * nt::ms_per_day;
+    nt_natural_date c{};
+    if (nt_make_natural_date(probe, 180.0, &c) != NT_OK || c.year_start != nt::detail::new_year_noon_ms(y)) {
+      std::fprintf(stderr, "solstice table mismatch for %d\n", y);
+      failures++;
+    }
+  }
+
+  // Pseudo-random timestamps/longitudes inside and outside the table range.
+  std::uint64_t seed = 0x9E3779B97F4A7C15ULL;
+  for (int i = 0; i < 20000; ++i) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    std::int64_t unix_ms = 1 + static_cast<std::int64_t>((seed >> 11) % 7400000000000ULL);
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    double lon = std::floor(static_cast<double>((seed >> 11) % 3600001ULL)) / 10000.0 - 180.0;
+
+    nt_natural_date c{};
+    if (nt_make_natural_date(unix_ms, lon, &c) != NT_OK) { failures++; continue; }
+    auto x = nt::make_natural_date(unix_ms, lon);
+    if (!x || !check_same(c, *x)) {
+      std::fprintf(stderr, "date mismatch at %lld lon=%.4f\n", static_cast<long long>(unix_ms), lon);
+      failures++;
+      continue;
+    }
+
+    char cbuf[96];
+    nt_format_string(&c, 2, 0.01, cbuf, sizeof(cbuf));
+    std::string xs = nt::to_string(*x);
+    if (xs != cbuf) {
+      std::fprintf(stderr, "format mismatch: C=%s C++=%s\n", cbuf, xs.c_str());
+      failures++;
+    }
+    nt_format_time_string(&c, 4, 0.0001, cbuf, sizeof(cbuf));
+    char tbuf[32];
+    auto r = nt::format_time<4>(std::span<char>(tbuf), *x);
+    if (r.ec != std::errc{} || std::string(tbuf, r.ptr) != cbuf) failures++;
+    for (int d = 0; d <= 6; ++d) {
+      std::int32_t fi = 0, ff = 0, fs = 0;
+      auto split = nt::split_time_fixed(*x, d);
+      if (nt_time_split_fixed(&c, d, &fi, &ff, &fs) != NT_OK || split.integer != fi || split.fraction != ff ||
+          split.scale != fs) {
+        failures++;
+      }
+    }
+    checked++;
+  }
+
+  // Undersized output spans report value_too_large instead of writing past the end.
+  char tiny[4];
+  if (nt::format_date(std::span<char>(tiny), *kEat).ec != std::errc::value_too_large) failures++;
+
+  if (failures != 0) {
+    std::fprintf(stderr, "C++ layer parity failed: %d failures out of %d checked\n", failures, checked);
+    return 1;
+  }
+  std::printf("cpp layer ok (%d cases)\n", checked);
+  return 0;
+}
@@ -0,0 +1,108 @@
+#include "natural_time.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const double UNIT[7] = {1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001};
+static const int64_t TIE_PERIOD[7] = {240000, 24000, 2400, 240, 24, 12, 6};  // ms * 10^d / 240000 ends in .5
+
+static int same_date(const nt_natural_date* a, const nt_natural_date* b) {
+  return a->unix_time == b->unix_time && a->year_start == b->year_start && a->year_duration == b->year_duration &&
+         a->year == b->year && a->moon == b->moon && a->week == b->week && a->week_of_moon == b->week_of_moon &&
+         a->day == b->day && a->day_of_year == b->day_of_year && a->day_of_moon == b->day_of_moon &&
+         a->day_of_week == b->day_of_week && a->is_rainbow_day == b->is_rainbow_day && a->time_deg == b->time_deg &&
+         a->longitude == b->longitude && a->nadir == b->nadir;
+}
+
+// The double split written out: llround(time_deg * scale), after rounding
+// time_deg to one unit of the last decimal when asked.
+static int64_t double_total(double time_deg, int decimals, int unit_rounding) {
+  double t = time_deg;
+  if (unit_rounding) t = floor(t / UNIT[decimals] + 0.5) * UNIT[decimals];
+  if (t >= 360.0) t = fmod(t, 360.0);
+  int64_t scale = llround(1.0 / UNIT[decimals]);
+  int64_t total = llround(t * (double)scale);
+  return (total >= 360 * scale) ? total - 360 * scale : total;
+}
+
+// Every split route agrees with the double split, ties included.
+static int check_splits(const nt_natural_date* d, const char* what) {
+  int failures = 0;
+  for (int decimals = 0; decimals <= 6; ++decimals) {
+    for (int unit_rounding = 0; unit_rounding <= 1; ++unit_rounding) {
+      int32_t di, df, ds, fi, ff, fs;
+      int64_t want = double_total(d->time_deg, decimals, unit_rounding);
+      nt_time_split_scaled(d, decimals, unit_rounding ? UNIT[decimals] : 0.0, &di, &df, &ds);
+      int bad = (int64_t)di * ds + df != want;
+      if (unit_rounding) {
+        bad |= nt_time_split_fixed(d, decimals, &fi, &ff, &fs) != NT_OK || fs != ds || (int64_t)fi * fs + ff != want;
+      }
+      if (bad) {
+        fprintf(stderr, "%s split mismatch ms=%lld decimals=%d rounding=%d: want %lld\n", what,
+                (long long)(d->unix_time - d->nadir), decimals, unit_rounding, (long long)want);
+        failures++;
+      }
+    }
+  }
+  return failures;
+}
+
+int main(void) {
+  int failures = 0;
+  uint64_t seed = 0x2545F4914F6CDD1DULL;
+  for (int i = 0; i < 20000; ++i) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    int64_t unix_ms = 1 + (int64_t)((seed >> 11) % 4102444800000ULL); // up to 2100
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    int32_t lon_udeg = (int32_t)((seed >> 11) % 360000001ULL) - 180000000;
+
+    nt_natural_date d, f;
+    if (nt_make_natural_date(unix_ms, (double)lon_udeg / 1e6, &d) != NT_OK) { failures++; continue; }
+    if (nt_make_natural_date_fixed(unix_ms, lon_udeg, &f) != NT_OK) { failures++; continue; }
+    if (!same_date(&d, &f)) {
+      fprintf(stderr, "date mismatch at %lld lon=%d udeg\n", (long long)unix_ms, lon_udeg);
+      failures++;
+      continue;
+    }
+    failures += check_splits(&f, "random");
+  }
+
+  // Exact ties of each decimal count, where a half-up integer split would differ.
+  nt_natural_date nd;
+  if (nt_make_natural_date(1718928000000LL, 2.35, &nd) != NT_OK) return 1;
+  int ties = 0;
+  for (int decimals = 0; decimals <= 6; ++decimals) {
+    int64_t step = TIE_PERIOD[decimals] * ((decimals < 3) ? 1 : 997);
+    for (int64_t ms = TIE_PERIOD[decimals] / 2; ms < 86400000LL; ms += step) {
+      nd.unix_time = nd.nadir + ms;
+      nd.time_deg = (double)ms * 360.0 / 86400000.0;
+      failures += check_splits(&nd, "tie");
+      ties++;
+    }
+  }
+
+  // Times outside the date are accepted and wrap into it.
+  int32_t wi, wf, ws, ii, iff, is;
+  nt_natural_date wrapped = nd;
+  nd.unix_time = nd.nadir + 1234567;
+  wrapped.unix_time = nd.unix_time + 86400000LL;
+  if (nt_time_split_fixed(&wrapped, 3, &wi, &wf, &ws) != NT_OK || nt_time_split_fixed(&nd, 3, &ii, &iff, &is) != NT_OK ||
+      wi != ii || wf != iff || ws != is) {
+    failures++;
+  }
+  wrapped.unix_time = nd.nadir - 1;
+  if (nt_time_split_fixed(&wrapped, 2, &wi, &wf, &ws) != NT_OK || wi != 0 || wf != 0) failures++;
+
+  // Longitudes that are not whole micro-degrees are kept as given.
+  nt_natural_date d;
+  if (nt_make_natural_date(1718928000000LL, 2.3500004, &d) != NT_OK || d.longitude != 2.3500004) failures++;
+  if (nt_make_natural_date_fixed(1356091200000LL, 180000001, &nd) != NT_ERR_RANGE) failures++;
+  if (nt_make_natural_date_fixed(0, 0, &nd) != NT_ERR_TIME) failures++;
+
+  if (failures != 0) {
+    fprintf(stderr, "fixed-point test failed: %d failures\n", failures);
+    return 1;
+  }
+  printf("fixed point ok (%d ties)\n", ties);
+  return 0;
+}
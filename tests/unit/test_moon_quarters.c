@@ -0,0 +1,64 @@
+#include "natural_time.h"
+#include <stdio.h>
+#include <math.h>
+
+#define PHASE_EPS 0.01       // degrees of elongation at a found quarter instant
+#define ILLUMINATION_EPS 0.01
+
+int main(void) {
+  int failures = 0;
+  nt_natural_date nd;
+  if (nt_make_natural_date(1735689600000LL, 2.35, &nd) != NT_OK) return 1; // 2025-01-01
+
+  nt_moon_quarter q[NT_MOON_QUARTERS_MAX];
+  size_t n = 0;
+  if (nt_moon_quarters_for_year(&nd, q, NT_MOON_QUARTERS_MAX, &n) != NT_OK) return 2;
+  if (n < 48 || n > 51) { fprintf(stderr, "unexpected quarter count %zu\n", n); return 3; }
+
+  for (size_t i = 0; i < n; ++i) {
+    if (i > 0 && (q[i].quarter != (q[i - 1].quarter + 1) % 4 || q[i].unix_time <= q[i - 1].unix_time)) failures++;
+    if (q[i].unix_time < nd.year_start || q[i].unix_time >= nd.year_start + (int64_t)nd.year_duration * 86400000LL) failures++;
+    nt_natural_date at;
+    nt_moon_position mp;
+    if (nt_make_natural_date(q[i].unix_time, nd.longitude, &at) != NT_OK) { failures++; continue; }
+    if (at.day_of_year != q[i].day_of_year || fabs(at.time_deg - q[i].time_deg) > 1e-9) failures++;
+    if (nt_moon_position_for_date(&at, 0.0, &mp) != NT_OK) { failures++; continue; }
+    double d = fabs(mp.phase_deg - 90.0 * q[i].quarter);
+    if (d > 180.0) d = 360.0 - d;
+    if (d > PHASE_EPS) { fprintf(stderr, "quarter %d off by %.6f deg\n", q[i].quarter, d); failures++; }
+  }
+
+  // Range search agrees with the cached per-year table.
+  nt_moon_quarter r[NT_MOON_QUARTERS_MAX];
+  size_t rn = 0;
+  int64_t year_end = nd.year_start + (int64_t)nd.year_duration * 86400000LL;
+  if (nt_moon_quarters_range(nd.year_start, year_end, nd.longitude, r, NT_MOON_QUARTERS_MAX, &rn) != NT_OK || rn != n) failures++;
+  for (size_t i = 0; i < rn && i < n; ++i) {
+    if (r[i].unix_time != q[i].unix_time || r[i].quarter != q[i].quarter || r[i].day_of_year != q[i].day_of_year) failures++;
+  }
+  size_t small = 0;
+  if (nt_moon_quarters_range(nd.year_start, year_end, nd.longitude, r, 4, &small) != NT_ERR_RANGE || small != n) failures++;
+
+  // Interpolated illumination against the ephemeris elongation at each day's 180°.
+  double frac[400];
+  size_t days = 0;
+  if (nt_moon_illumination_for_year(&nd, frac, 400, &days) != NT_OK || days != (size_t)nd.year_duration) return 4;
+  double max_err = 0.0;
+  for (size_t d = 0; d < days; ++d) {
+    nt_natural_date mid;
+    nt_moon_position mp;
+    int64_t t = nd.year_start + (int64_t)d * 86400000LL + 43200000LL;
+    if (nt_make_natural_date(t, nd.longitude, &mid) != NT_OK || nt_moon_position_for_date(&mid, 0.0, &mp) != NT_OK) { failures++; continue; }
+    double expect = (1.0 - cos(mp.phase_deg * 3.14159265358979323846 / 180.0)) / 2.0;
+    double e = fabs(frac[d] - expect);
+    if (e > max_err) max_err = e;
+  }
+  if (max_err > ILLUMINATION_EPS) { fprintf(stderr, "illumination max error %.6f\n", max_err); failures++; }
+
+  if (failures != 0) {
+    fprintf(stderr, "moon quarters test failed: %d failures\n", failures);
+    return 5;
+  }
+  printf("moon quarters ok (%zu quarters, illumination max Δ %.6f)\n", n, max_err);
+  return 0;
+}
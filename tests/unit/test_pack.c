@@ -0,0 +1,80 @@
+#include "natural_time_pack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int same_date(const nt_natural_date* a, const nt_natural_date* b) {
+  return a->year == b->year && a->moon == b->moon && a->week == b->week && a->week_of_moon == b->week_of_moon &&
+         a->unix_time == b->unix_time && a->longitude == b->longitude && a->day == b->day &&
+         a->day_of_year == b->day_of_year && a->day_of_moon == b->day_of_moon && a->day_of_week == b->day_of_week &&
+         a->is_rainbow_day == b->is_rainbow_day && a->time_deg == b->time_deg && a->year_start == b->year_start &&
+         a->year_duration == b->year_duration && a->nadir == b->nadir;
+}
+
+int main(void) {
+  int failures = 0;
+  if (sizeof(nt_packed_date) != 16) failures++;
+
+  // Random dates round-trip through the packed form, at micro-degree and at 4-decimal longitudes.
+  enum { N = 20000 };
+  nt_natural_date* nd = (nt_natural_date*)malloc(N * sizeof(nt_natural_date));
+  nt_natural_date* back = (nt_natural_date*)malloc(N * sizeof(nt_natural_date));
+  nt_packed_date* packed = (nt_packed_date*)malloc(N * sizeof(nt_packed_date));
+  uint64_t seed = 0x2545F4914F6CDD1DULL;
+  for (int i = 0; i < N; ++i) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    int64_t t = 1 + (int64_t)((seed >> 11) % 7400000000000ULL);
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    int32_t udeg = (int32_t)((seed >> 11) % 360000001ULL) - 180000000;
+    if (i % 2) {
+      nt_make_natural_date_fixed(t, udeg, &nd[i]);
+    } else {
+      nt_make_natural_date(t, (double)(udeg / 100) / 10000.0, &nd[i]);
+    }
+  }
+  if (nt_pack_dates(nd, packed, N) != NT_OK) failures++;
+  if (nt_unpack_dates(packed, back, N) != NT_OK) failures++;
+  for (int i = 0; i < N; ++i) {
+    if (!same_date(&nd[i], &back[i])) {
+      if (failures < 5) fprintf(stderr, "round trip mismatch at %lld lon=%.6f\n", (long long)nd[i].unix_time, nd[i].longitude);
+      failures++;
+    }
+  }
+
+  // A sorted one-minute log over 400 days at one longitude.
+  enum { M = 400 * 1440 };
+  int64_t* ts = (int64_t*)malloc(M * sizeof(int64_t));
+  nt_packed_date* log = (nt_packed_date*)malloc(M * sizeof(nt_packed_date));
+  nt_packed_date* log_back = (nt_packed_date*)malloc(M * sizeof(nt_packed_date));
+  for (int i = 0; i < M; ++i) ts[i] = 1720000000000LL + (int64_t)i * 60000LL;
+  if (nt_pack_unix_ms(ts, M, 2350000, log) != NT_OK) failures++;
+  for (int i = 0; i < M; i += 997) {
+    nt_natural_date ref;
+    nt_packed_date p;
+    nt_make_natural_date_fixed(ts[i], 2350000, &ref);
+    nt_pack_dates(&ref, &p, 1);
+    if (memcmp(&p, &log[i], sizeof(p)) != 0) failures++;
+  }
+
+  size_t cap = nt_block_bound(M), size = 0, count = 0;
+  uint8_t* block = (uint8_t*)malloc(cap);
+  if (nt_block_write(log, M, block, cap, &size) != NT_OK) failures++;
+  if (size > 8 * 1024) { fprintf(stderr, "sorted log block is %zu bytes\n", size); failures++; }
+  if (nt_block_count(block, size, &count) != NT_OK || count != M) failures++;
+  if (nt_block_read(block, size, log_back, M, &count) != NT_OK || memcmp(log, log_back, M * sizeof(nt_packed_date)) != 0) failures++;
+  if (nt_block_read_unix_ms(block, size, ts, M, &count) != NT_OK || ts[M - 1] != log[M - 1].unix_ms) failures++;
+  if (nt_block_read(block, size - 1, log_back, M, &count) != NT_ERR_RANGE) failures++;  // truncated
+
+  // Unsorted timestamps and mixed longitudes still round-trip.
+  size_t rsize = 0;
+  if (nt_block_write(packed, N, block, cap, &rsize) != NT_OK) failures++;
+  if (nt_block_read(block, rsize, log_back, N, &count) != NT_OK || memcmp(packed, log_back, N * sizeof(nt_packed_date)) != 0) failures++;
+
+  free(nd); free(back); free(packed); free(ts); free(log); free(log_back); free(block);
+  if (failures != 0) {
+    fprintf(stderr, "pack test failed: %d failures\n", failures);
+    return 3;
+  }
+  printf("pack ok (sorted log: %d records in %zu bytes; random: %zu bytes)\n", M, size, rsize);
+  return 0;
+}
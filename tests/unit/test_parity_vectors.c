@@ -82,6 +82,7 @@ static int parse_bool_after(const char *buf, size_t start, const char *key, int
   return parse_int_after(buf, start, key, out);
 }
 
+// `out` needs room for any int fields (64 bytes), not just 4-digit years.
 static void format_iso8601(long long unix_ms, char *out, size_t out_size) {
   time_t secs = (time_t)(unix_ms / 1000LL);
   struct tm *gmt = gmtime(&secs);
@@ -93,8 +94,8 @@ static void format_iso8601(long long unix_ms, char *out, size_t out_size) {
 int main(void) {
   char *json = NULL; size_t len = 0;
   if (!read_file_into_buffer(VECTORS_PATH, &json, &len)) {
-    fprintf(stderr, "Failed to read %s\n", VECTORS_PATH);
-    return 1;
+    fprintf(stderr, "Failed to read %s (generate it from natural-time-js, see README)\n", VECTORS_PATH);
+    return 77;  // ctest: skipped
   }
 
   size_t cursor = 0;
@@ -213,7 +214,7 @@ int main(void) {
                 max_js_value[ei] = jvals[ei];
               }
               if (logged < MAX_MISMATCH_LOGS) {
-                char iso[32];
+                char iso[64];
                 format_iso8601(unix_ms, iso, sizeof(iso));
                 fprintf(stderr, "Mismatch %s at %s lon=%.2f lat=%.2f: C=%.6f JS=%.6f Δ=%.6f\n",
                         event_names[ei], iso, longitude, latitude, cvals[ei], jvals[ei], delta);
@@ -272,21 +273,22 @@ int main(void) {
     cursor = expect_pos + 8; // move forward inside this case; next search finds next case
   }
 
-  free(json);
   if (checked == 0) {
     fprintf(stderr, "No cases parsed from %s\n", VECTORS_PATH);
+    free(json);
     return 2;
   }
   if (failures != 0) {
     fprintf(stderr, "Parity test failed: %d failures out of %d checked\n", failures, checked);
     for (int ei = 0; ei < 6; ++ei) {
       if (mismatch_counts[ei] > 0) {
-        char iso[32];
+        char iso[64];
         format_iso8601(max_unix_ms[ei], iso, sizeof(iso));
         fprintf(stderr, "  worst %s: Δ=%.6f at %s lon=%.2f lat=%.2f (C=%.6f JS=%.6f), count=%lld\n",
                 event_names[ei], max_delta[ei], iso, max_lon[ei], max_lat[ei], max_c_value[ei], max_js_value[ei], mismatch_counts[ei]);
       }
     }
+    free(json);
     return 3;
   }
   // When parity is exact (no mismatches), still compute and print average epsilons (should be ~0)
@@ -345,6 +347,7 @@ int main(void) {
       sum_ws_rise/must_count, sum_ws_set/must_count, sum_ss_rise/must_count, sum_ss_set/must_count, sum_angle/must_count,
       max_ws_rise, max_ws_set, max_ss_rise, max_ss_set, max_angle, must_count);
   }
+  free(json);
   return 0;
 }
 
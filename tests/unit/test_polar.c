@@ -0,0 +1,60 @@
+#include "natural_time.h"
+#include <stdio.h>
+
+static int sun_at(int64_t unix_ms, double lon, double lat, nt_sun_events* se) {
+  nt_natural_date nd;
+  if (nt_make_natural_date(unix_ms, lon, &nd) != NT_OK) return 0;
+  return nt_sun_events_for_date(&nd, lat, se) == NT_OK;
+}
+
+int main(void) {
+  int failures = 0;
+  const int64_t june = 1718928000000LL;      // 2024-06-21
+  const int64_t december = 1734739200000LL;  // 2024-12-21
+  nt_sun_events se;
+
+  // Svalbard, midnight sun: every threshold stays below the sun, summer defaults.
+  if (!sun_at(june, 15.6, 78.2, &se)) failures++;
+  if (se.horizon_regime != NT_POLAR_ALWAYS_ABOVE || se.night_regime != NT_POLAR_ALWAYS_ABOVE ||
+      se.golden_regime != NT_POLAR_ALWAYS_ABOVE) failures++;
+  if (se.sunrise_deg != 0.0 || se.sunset_deg != 360.0 || se.morning_golden_deg != 0.0 || se.evening_golden_deg != 360.0) failures++;
+
+  // Svalbard, polar night: no sunrise or golden hour, but the noon sun still
+  // climbs above -12° so the night threshold is crossed.
+  if (!sun_at(december, 15.6, 78.2, &se)) failures++;
+  if (se.horizon_regime != NT_POLAR_ALWAYS_BELOW || se.golden_regime != NT_POLAR_ALWAYS_BELOW ||
+      se.night_regime != NT_POLAR_NONE) failures++;
+  if (se.sunrise_deg != 180.0 || se.sunset_deg != 180.0) failures++;
+
+  // Antarctic side of the same day: midnight sun again.
+  if (!sun_at(december, 0.0, -75.0, &se)) failures++;
+  if (se.horizon_regime != NT_POLAR_ALWAYS_ABOVE || se.sunrise_deg != 0.0 || se.sunset_deg != 360.0) failures++;
+
+  // Mid latitudes: everything crosses.
+  if (!sun_at(june, 2.35, 48.85, &se)) failures++;
+  if (se.horizon_regime != NT_POLAR_NONE || se.night_regime != NT_POLAR_NONE || se.golden_regime != NT_POLAR_NONE) failures++;
+
+  // Moon near the 2024-2025 major standstill at 80°N: circumpolar and never-rising
+  // days both occur within a month; neither has a moonrise or moonset.
+  int above = 0, below = 0;
+  for (int d = 0; d < 30; ++d) {
+    nt_natural_date nd;
+    nt_moon_events me;
+    if (nt_make_natural_date(1735689600000LL + (int64_t)d * 86400000LL, 10.0, &nd) != NT_OK ||
+        nt_moon_events_for_date(&nd, 80.0, &me) != NT_OK) {
+      failures++;
+      continue;
+    }
+    if (me.horizon_regime == NT_POLAR_ALWAYS_ABOVE) above++;
+    if (me.horizon_regime == NT_POLAR_ALWAYS_BELOW) below++;
+    if (me.horizon_regime != NT_POLAR_NONE && (me.moonrise_deg != 0.0 || me.moonset_deg != 0.0)) failures++;
+  }
+  if (above == 0 || below == 0) failures++;
+
+  if (failures != 0) {
+    fprintf(stderr, "polar test failed: %d failures\n", failures);
+    return 3;
+  }
+  printf("polar ok (moon above %d, below %d days)\n", above, below);
+  return 0;
+}
@@ -0,0 +1,120 @@
+#include "natural_time_scheduler.h"
+#include <stdio.h>
+#include <math.h>
+
+static int64_t fake_clock(void* ctx) { return *(const int64_t*)ctx; }
+
+int main(void) {
+  int failures = 0;
+  int64_t now = 1750000000000LL; // 2025-06-15
+  nt_scheduler* s = nt_scheduler_create(fake_clock, &now, 0.01);
+  if (!s) return 1;
+
+  // Two subscribers in the same Paris cell, one in Sydney, one watching moon quarters.
+  nt_subscription paris_a = {48.8566, 2.3522, NT_EVENT_SUNRISE | NT_EVENT_SUNSET, 10.0, (void*)1};
+  nt_subscription paris_b = {48.8590, 2.3540, NT_EVENT_SUNRISE | NT_EVENT_NADIR, 0.0, (void*)2};
+  nt_subscription sydney = {-33.8688, 151.2093, NT_EVENT_SUNSET, 0.0, (void*)3};
+  nt_subscription moon = {0.0, 0.0, NT_EVENT_NEW_MOON | NT_EVENT_FULL_MOON, 0.0, (void*)4};
+  // Svalbard under the midnight sun, the sun above +6° all day: nothing fires.
+  nt_subscription polar = {78.22, 15.65, NT_EVENT_SUNRISE | NT_EVENT_SUNSET | NT_EVENT_EVENING_GOLDEN, 0.0, (void*)5};
+  uint32_t ids[5];
+  if (nt_scheduler_subscribe(s, &paris_a, &ids[0]) != NT_OK) return 2;
+  if (nt_scheduler_subscribe(s, &paris_b, &ids[1]) != NT_OK) return 2;
+  if (nt_scheduler_subscribe(s, &sydney, &ids[2]) != NT_OK) return 2;
+  if (nt_scheduler_subscribe(s, &moon, &ids[3]) != NT_OK) return 2;
+  if (nt_scheduler_subscribe(s, &polar, &ids[4]) != NT_OK) return 2;
+  nt_subscription bad = {91.0, 0.0, NT_EVENT_SUNRISE, 0.0, NULL};
+  uint32_t bad_id;
+  if (nt_scheduler_subscribe(s, &bad, &bad_id) != NT_ERR_RANGE) failures++;
+
+  nt_scheduler_stats st;
+  nt_scheduler_get_stats(s, &st);
+  if (st.subscriptions != 5 || st.locations != 4) { fprintf(stderr, "expected 4 shared cells, got %zu\n", st.locations); failures++; }
+
+  // Step the fake clock through 40 days in 10-minute ticks.
+  int64_t last_fire = now;
+  int counts[5] = {0};
+  nt_scheduled_event ev[16];
+  for (int64_t end = now + 40LL * 86400000LL; now < end; now += 600000LL) {
+    size_t n = 0;
+    if (nt_scheduler_pop_due(s, ev, 16, &n) != NT_OK) failures++;
+    for (size_t i = 0; i < n; ++i) {
+      if (ev[i].fire_time < last_fire || ev[i].fire_time > now) failures++;
+      last_fire = ev[i].fire_time;
+      int who = (int)(intptr_t)ev[i].user_data - 1;
+      counts[who]++;
+
+      // Fire time honours the natural-degree offset.
+      double offset = (who == 0) ? 10.0 : 0.0;
+      if (ev[i].event_time - ev[i].fire_time != llround(offset * 86400000.0 / 360.0)) failures++;
+
+      if (ev[i].kind == NT_EVENT_SUNRISE || ev[i].kind == NT_EVENT_SUNSET) {
+        // Matches the core API evaluated at the cell centre.
+        const nt_subscription* sub = (who == 2) ? &sydney : &paris_a;
+        nt_natural_date nd;
+        nt_sun_events se;
+        nt_make_natural_date(ev[i].event_time, round(sub->longitude * 100.0) / 100.0, &nd);
+        nt_sun_events_for_date(&nd, round(sub->latitude * 100.0) / 100.0, &se);
+        double expect = (ev[i].kind == NT_EVENT_SUNRISE) ? se.sunrise_deg : se.sunset_deg;
+        if (fabs(expect - ev[i].event_deg) > 1e-9) failures++;
+      }
+    }
+  }
+  // ~40 sunrises + ~40 sunsets, ~40 sunrises + ~40 nadirs, ~40 sunsets, ~2-3 new/full moons.
+  if (counts[0] < 78 || counts[0] > 82) failures++;
+  if (counts[1] < 78 || counts[1] > 82) failures++;
+  if (counts[2] < 39 || counts[2] > 41) failures++;
+  if (counts[3] < 2 || counts[3] > 3) failures++;
+  if (counts[4] != 0) failures++;
+
+  // Days are evaluated once per cell, not once per subscriber (the moon cell also
+  // looks up to two weeks ahead for its next quarter, the Svalbard cell to its
+  // first golden hour in early August).
+  nt_scheduler_get_stats(s, &st);
+  if (st.days_computed > 200) { fprintf(stderr, "days computed %llu\n", (unsigned long long)st.days_computed); failures++; }
+
+  // Unsubscribed ids stop firing.
+  if (nt_scheduler_unsubscribe(s, ids[2]) != NT_OK) failures++;
+  for (int64_t end = now + 2LL * 86400000LL; now < end; now += 600000LL) {
+    size_t n = 0;
+    if (nt_scheduler_pop_due(s, ev, 16, &n) != NT_OK) failures++;
+    for (size_t i = 0; i < n; ++i) if (ev[i].subscription_id == ids[2]) failures++;
+  }
+  int64_t next;
+  if (nt_scheduler_next_fire_time(s, &next) != NT_OK || next <= now - 600000LL) failures++;
+
+  nt_scheduler_destroy(s);
+
+  // Mid-August in Svalbard: the sun dips below +6° again but not yet below the
+  // horizon, so only golden-hour ends fire, as the core API reports them.
+  int64_t august = 1754784000000LL;  // 2025-08-10
+  nt_scheduler* p = nt_scheduler_create(fake_clock, &august, 0.01);
+  uint32_t polar_id;
+  if (!p || nt_scheduler_subscribe(p, &polar, &polar_id) != NT_OK) return 2;
+  int golden = 0;
+  for (int64_t end = august + 10LL * 86400000LL; august < end; august += 600000LL) {
+    size_t n = 0;
+    if (nt_scheduler_pop_due(p, ev, 16, &n) != NT_OK) failures++;
+    for (size_t i = 0; i < n; ++i) {
+      nt_natural_date nd;
+      nt_sun_events se;
+      nt_make_natural_date(ev[i].event_time, 15.65, &nd);
+      nt_sun_events_for_date(&nd, 78.22, &se);
+      if (ev[i].kind != NT_EVENT_EVENING_GOLDEN || se.horizon_regime != NT_POLAR_ALWAYS_ABOVE ||
+          se.golden_regime != NT_POLAR_NONE || fabs(se.evening_golden_deg - ev[i].event_deg) > 1e-9) {
+        failures++;
+      }
+      golden++;
+    }
+  }
+  if (golden < 9 || golden > 11) { fprintf(stderr, "polar golden hours %d\n", golden); failures++; }
+  nt_scheduler_destroy(p);
+
+  if (failures != 0) {
+    fprintf(stderr, "scheduler test failed: %d failures (counts %d/%d/%d/%d/%d)\n", failures, counts[0], counts[1], counts[2],
+            counts[3], counts[4]);
+    return 3;
+  }
+  printf("scheduler ok (days computed %llu)\n", (unsigned long long)st.days_computed);
+  return 0;
+}
@@ -0,0 +1,144 @@
+#include "natural_time.h"
+#include "natural_time_internal.h"
+#include "astronomy.h"
+#include <math.h>
+#include <stdio.h>
+
+// Batched series vs the vendor's per-instant functions. Also built with a
+// one-entry split queue (NT_SKY_CAND_MAX=1), where queries overflow and must
+// still come out right through the vendor fallback.
+
+static const double MAX_DEG = 1e-3;         // altitude / ra / dec
+static const double MAX_SECONDS = 0.1;      // crossing instants (the vendor's own tolerance)
+static const double SECONDS_PER_DAY = 86400.0;
+
+static int g_overflows;
+
+static double wrap180(double d) {
+  return remainder(d, 360.0);
+}
+
+static int check_sincos(void) {
+  enum { N = 4001 };
+  static double x[N], s[N], c[N];
+  for (int i = 0; i < N; ++i) x[i] = (i - N / 2) * 0.3711;  // ±742 rad, every quadrant
+  nt_internal_sincos(x, s, c, N);
+  double worst = 0.0;
+  for (int i = 0; i < N; ++i) {
+    worst = fmax(worst, fabs(s[i] - sin(x[i])));
+    worst = fmax(worst, fabs(c[i] - cos(x[i])));
+  }
+  if (worst > 1e-14) {
+    fprintf(stderr, "sincos: max error %g\n", worst);
+    return 1;
+  }
+  return 0;
+}
+
+static int check_positions(int body, double lat, double lon, double ut0, double* worst) {
+  astro_body_t vb = body == NT_SKY_SUN ? BODY_SUN : BODY_MOON;
+  astro_observer_t obs = Astronomy_MakeObserver(lat, lon, 0.0);
+  nt_sky_window w;
+  if (nt_internal_sky_window(&w, body, lat, lon, ut0, NT_SKY_MAX_DAYS) != NT_OK) return 1;
+
+  enum { N = 13 };  // odd count exercises the padded tail
+  double ut[N];
+  nt_sky_sample out[N];
+  for (int i = 0; i < N; ++i) ut[i] = ut0 + NT_SKY_MAX_DAYS * i / (N - 1);
+  nt_internal_sky_eval(&w, ut, N, out);
+
+  int failures = 0;
+  for (int i = 0; i < N; ++i) {
+    astro_time_t t = Astronomy_TimeFromDays(ut[i]);
+    astro_equatorial_t topo = Astronomy_Equator(vb, &t, obs, EQUATOR_OF_DATE, ABERRATION);
+    astro_horizon_t hor = Astronomy_Horizon(&t, obs, topo.ra, topo.dec, REFRACTION_NONE);
+    astro_vector_t v = vb == BODY_SUN ? Astronomy_GeoVector(BODY_SUN, t, ABERRATION) : Astronomy_GeoMoon(t);
+    astro_equatorial_t geo = Astronomy_EquatorFromVector(Astronomy_RotateVector(Astronomy_Rotation_EQJ_EQD(&t), v));
+    double e = fabs(out[i].altitude_deg - hor.altitude);
+    e = fmax(e, fabs(wrap180(out[i].ra_deg - geo.ra * 15.0)) * cos(geo.dec * DEG2RAD));
+    e = fmax(e, fabs(out[i].dec_deg - geo.dec));
+    *worst = fmax(*worst, e);
+    if (e > MAX_DEG || fabs(out[i].distance_au - topo.dist) > 1e-6 * topo.dist) {
+      fprintf(stderr, "body %d lat %.1f ut %.4f: altitude %.6f vs %.6f, ra %.6f vs %.6f\n", body, lat, ut[i],
+              out[i].altitude_deg, hor.altitude, out[i].ra_deg, geo.ra * 15.0);
+      failures++;
+    }
+  }
+  return failures;
+}
+
+// One crossings call (rise, set, twilight) against the vendor searches.
+static int check_crossings(int body, double lat, double lon, double ut0, double* worst) {
+  astro_body_t vb = body == NT_SKY_SUN ? BODY_SUN : BODY_MOON;
+  astro_observer_t obs = Astronomy_MakeObserver(lat, lon, 0.0);
+  double limit = body == NT_SKY_SUN ? 2.0 : 1.0;
+  nt_sky_window w;
+  if (nt_internal_sky_window(&w, body, lat, lon, ut0, limit) != NT_OK) return 1;
+
+  double rise_alt = -(34.0 / 60.0);
+  nt_sky_crossing q[4] = {
+    {rise_alt, +1, 1, limit, 0, 0.0},
+    {rise_alt, -1, 1, limit, 0, 0.0},
+    {-12.0, +1, 0, limit, 0, 0.0},
+    {6.0, -1, 0, limit, 0, 0.0},
+  };
+  nt_sky_search s;
+  nt_internal_sky_search_begin(&s, &w, q, 4);
+  nt_internal_sky_search_run(&s, NULL);
+  for (int k = 0; k < 4; ++k) {
+    q[k] = s.q[k];
+    g_overflows += (s.st[k].overflow != 0);
+  }
+
+  astro_time_t start = Astronomy_TimeFromDays(ut0);
+  astro_search_result_t ref[4] = {
+    Astronomy_SearchRiseSetEx(vb, obs, DIRECTION_RISE, start, limit, 0.0),
+    Astronomy_SearchRiseSetEx(vb, obs, DIRECTION_SET, start, limit, 0.0),
+    Astronomy_SearchAltitude(vb, obs, DIRECTION_RISE, start, limit, -12.0),
+    Astronomy_SearchAltitude(vb, obs, DIRECTION_SET, start, limit, 6.0),
+  };
+
+  int failures = 0;
+  for (int k = 0; k < 4; ++k) {
+    int found = ref[k].status == ASTRO_SUCCESS;
+    if (found != q[k].found) {
+      fprintf(stderr, "body %d lat %.1f ut0 %.2f query %d: found %d vs %d\n", body, lat, ut0, k, q[k].found, found);
+      failures++;
+      continue;
+    }
+    if (!found) continue;
+    double dt = fabs(q[k].ut - ref[k].time.ut) * SECONDS_PER_DAY;
+    *worst = fmax(*worst, dt);
+    if (dt > MAX_SECONDS) {
+      fprintf(stderr, "body %d lat %.1f ut0 %.2f query %d: off by %.3f s\n", body, lat, ut0, k, dt);
+      failures++;
+    }
+  }
+  return failures;
+}
+
+int main(void) {
+  int failures = check_sincos();
+  double worst_deg = 0.0, worst_s = 0.0;
+  const double lats[] = {-78.0, -45.0, 0.0, 35.5, 51.5, 66.0, 78.2};
+  for (int body = NT_SKY_SUN; body <= NT_SKY_MOON; ++body) {
+    for (size_t i = 0; i < sizeof lats / sizeof lats[0]; ++i) {
+      for (int d = 0; d < 12; ++d) {
+        double ut0 = 8900.0 + 31.3 * d + 0.17 * (double)i;  // 2024-2025, all seasons and lunar phases
+        double lon = -170.0 + 29.0 * d;
+        failures += check_positions(body, lats[i], lon, ut0, &worst_deg);
+        failures += check_crossings(body, lats[i], lon, ut0, &worst_s);
+      }
+    }
+  }
+  if (failures != 0) {
+    fprintf(stderr, "series test failed: %d failures\n", failures);
+    return 3;
+  }
+  if (NT_SKY_CAND_MAX == 1 && g_overflows == 0) {
+    fprintf(stderr, "series test failed: no query overflowed its split queue\n");
+    return 3;
+  }
+  printf("series ok (max %.2g deg, %.2g s, %d vendor fallbacks)\n", worst_deg, worst_s, g_overflows);
+  return 0;
+}
@@ -0,0 +1,152 @@
+#include "natural_time.h"
+#include "natural_time_internal.h"
+#include "natural_time_shm.h"
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Forked workers hammer overlapping keys through one segment; every answer
+// must match the one computed without it exactly.
+
+enum { PLACES = 12, DAYS = 5, KEYS = PLACES * DAYS, WORKERS = 8, ROUNDS = 3 };
+
+typedef struct {
+  nt_sun_events se;
+  nt_moon_events me;
+  nt_mustaches mu;
+} answers_t;
+
+static answers_t g_reference[KEYS];
+
+static int same_sun(const nt_sun_events* a, const nt_sun_events* b) {
+  return a->sunrise_deg == b->sunrise_deg && a->sunset_deg == b->sunset_deg && a->night_start_deg == b->night_start_deg &&
+         a->night_end_deg == b->night_end_deg && a->morning_golden_deg == b->morning_golden_deg &&
+         a->evening_golden_deg == b->evening_golden_deg && a->horizon_regime == b->horizon_regime &&
+         a->night_regime == b->night_regime && a->golden_regime == b->golden_regime;
+}
+
+static int same_moon(const nt_moon_events* a, const nt_moon_events* b) {
+  return a->moonrise_deg == b->moonrise_deg && a->moonset_deg == b->moonset_deg &&
+         a->highest_altitude == b->highest_altitude && a->horizon_regime == b->horizon_regime;
+}
+
+static int same_mustaches(const nt_mustaches* a, const nt_mustaches* b) {
+  return a->winter_sunrise_deg == b->winter_sunrise_deg && a->winter_sunset_deg == b->winter_sunset_deg &&
+         a->summer_sunrise_deg == b->summer_sunrise_deg && a->summer_sunset_deg == b->summer_sunset_deg &&
+         a->average_angle_deg == b->average_angle_deg;
+}
+
+static int same_answers(const answers_t* a, const answers_t* b) {
+  return same_sun(&a->se, &b->se) && same_moon(&a->me, &b->me) && same_mustaches(&a->mu, &b->mu);
+}
+
+static int answer(int key, answers_t* a) {
+  int p = key % PLACES, d = key / PLACES;
+  double lat = -66.0 + 12.0 * p, lon = -165.0 + 30.0 * p;
+  int64_t t = 1704067200000LL + (int64_t)d * 73 * 86400000LL;  // 2024-2025
+  nt_natural_date nd;
+  return nt_make_natural_date(t, lon, &nd) == NT_OK && nt_sun_events_for_date(&nd, lat, &a->se) == NT_OK &&
+         nt_moon_events_for_date(&nd, lat, &a->me) == NT_OK && nt_mustaches_range(&nd, lat, &a->mu) == NT_OK;
+}
+
+// All keys from a worker-specific starting point, thread caches cleared so
+// every call goes to the segment.
+static int run_keys(int worker, int rounds) {
+  int failures = 0;
+  for (int r = 0; r < rounds; ++r) {
+    for (int i = 0; i < KEYS; ++i) {
+      int key = (i * 7 + worker * 5 + r) % KEYS;
+      answers_t a;
+      nt_reset_caches();
+      if (!answer(key, &a) || !same_answers(&a, &g_reference[key])) failures++;
+    }
+  }
+  return failures;
+}
+
+static int fork_workers(int rounds) {
+  pid_t pids[WORKERS];
+  int failures = 0;
+  for (int w = 0; w < WORKERS; ++w) {
+    pids[w] = fork();
+    if (pids[w] == 0) _exit(run_keys(w, rounds) == 0 ? 0 : 1);
+    if (pids[w] < 0) failures++;
+  }
+  for (int w = 0; w < WORKERS; ++w) {
+    int status;
+    if (pids[w] > 0 && (waitpid(pids[w], &status, 0) != pids[w] || !WIFEXITED(status) || WEXITSTATUS(status) != 0)) {
+      fprintf(stderr, "worker %d failed\n", w);
+      failures++;
+    }
+  }
+  return failures;
+}
+
+static int32_t dead_pid(void) {
+  pid_t pid = fork();
+  if (pid == 0) _exit(0);
+  waitpid(pid, NULL, 0);
+  return (int32_t)pid;
+}
+
+int main(void) {
+  int failures = 0;
+  for (int k = 0; k < KEYS; ++k) {
+    if (!answer(k, &g_reference[k])) failures++;
+  }
+
+  char name[64];
+  snprintf(name, sizeof name, "/nt_test_shm_%ld", (long)getpid());
+  if (nt_shm_attach("nt_no_slash", 64) != NT_ERR_RANGE) failures++;
+  nt_shm_unlink(name);
+
+  // Tiny tables: constant eviction and slot rewrites under concurrent readers.
+  if (nt_shm_attach(name, 1) != NT_OK || nt_shm_slots() != NT_SHM_PROBES) {
+    fprintf(stderr, "attach failed\n");
+    return 3;
+  }
+  failures += fork_workers(ROUNDS);
+  nt_shm_detach();
+  if (nt_shm_unlink(name) != NT_OK || nt_shm_unlink(name) != NT_ERR_RANGE) failures++;
+
+  // Roomy tables: what the workers computed, this process only reads.
+  if (nt_shm_attach(name, 4096) != NT_OK || nt_shm_slots() != 4096) failures++;
+  failures += fork_workers(1);
+  nt_shm_stats st;
+  failures += run_keys(0, 1);
+  nt_shm_counters(&st);
+  if (st.misses != 0 || st.hits < 3 * KEYS || st.publishes != 0) {  // plus seasons
+    fprintf(stderr, "shared: %llu hits, %llu misses\n", (unsigned long long)st.hits, (unsigned long long)st.misses);
+    failures++;
+  }
+
+  // A second attach sees the existing segment, whatever size it asks for.
+  if (nt_shm_attach(name, 64) != NT_OK || nt_shm_slots() != 4096) failures++;
+
+  // Writers that died mid-write: their slots are hidden, then reclaimed.
+  int32_t gone = dead_pid();
+  for (uint32_t i = 0; i < 4096; ++i) nt_internal_shm_abandon_slot(NT_CACHE_SUN, i, gone);
+  failures += run_keys(1, 1);
+  nt_shm_counters(&st);
+  if (st.reclaimed == 0 || st.contended == 0) failures++;
+  failures += run_keys(2, 1);
+  nt_shm_stats again;
+  nt_shm_counters(&again);
+  if (again.misses != st.misses) failures++;  // every sun key was republished
+
+  // A live writer's slot is left alone.
+  for (uint32_t i = 0; i < 4096; ++i) nt_internal_shm_abandon_slot(NT_CACHE_MOON, i, (int32_t)getpid());
+  failures += run_keys(3, 1);
+  nt_shm_counters(&st);
+  if (st.reclaimed != again.reclaimed || st.contended <= again.contended) failures++;
+
+  nt_shm_detach();
+  nt_shm_unlink(name);
+
+  if (failures != 0) {
+    fprintf(stderr, "shm test failed: %d failures\n", failures);
+    return 3;
+  }
+  printf("shm ok (%d workers)\n", WORKERS);
+  return 0;
+}
@@ -0,0 +1,167 @@
+#include "natural_time.h"
+#include "natural_time_snapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Record a workload, write/load it, and check the loaded answers are the
+// computed ones exactly (and that stale or damaged blobs are refused).
+
+typedef struct {
+  nt_sun_events se;
+  nt_moon_events me;
+  nt_mustaches mu;
+} answers_t;
+
+static const double k_places[][2] = {{48.85, 2.35}, {-33.87, 151.21}, {78.2, 15.6}, {-0.0, 0.0}};
+enum { PLACES = sizeof k_places / sizeof k_places[0], DAYS = 6 };
+
+static int same_sun(const nt_sun_events* a, const nt_sun_events* b) {
+  return a->sunrise_deg == b->sunrise_deg && a->sunset_deg == b->sunset_deg && a->night_start_deg == b->night_start_deg &&
+         a->night_end_deg == b->night_end_deg && a->morning_golden_deg == b->morning_golden_deg &&
+         a->evening_golden_deg == b->evening_golden_deg && a->horizon_regime == b->horizon_regime &&
+         a->night_regime == b->night_regime && a->golden_regime == b->golden_regime;
+}
+
+static int same_moon(const nt_moon_events* a, const nt_moon_events* b) {
+  return a->moonrise_deg == b->moonrise_deg && a->moonset_deg == b->moonset_deg &&
+         a->highest_altitude == b->highest_altitude && a->horizon_regime == b->horizon_regime;
+}
+
+static int same_mustaches(const nt_mustaches* a, const nt_mustaches* b) {
+  return a->winter_sunrise_deg == b->winter_sunrise_deg && a->winter_sunset_deg == b->winter_sunset_deg &&
+         a->summer_sunrise_deg == b->summer_sunrise_deg && a->summer_sunset_deg == b->summer_sunset_deg &&
+         a->average_angle_deg == b->average_angle_deg;
+}
+
+// Number of days/places whose answers differ.
+static int differences(const answers_t* a, const answers_t* b) {
+  int n = 0;
+  for (int i = 0; i < DAYS * PLACES; ++i) {
+    if (!same_sun(&a[i].se, &b[i].se) || !same_moon(&a[i].me, &b[i].me) || !same_mustaches(&a[i].mu, &b[i].mu)) n++;
+  }
+  return n;
+}
+
+static int run(answers_t* out) {
+  for (int d = 0; d < DAYS; ++d) {
+    int64_t t = 1704067200000LL + (int64_t)d * 61 * 86400000LL;  // 2024
+    for (int p = 0; p < PLACES; ++p) {
+      nt_natural_date nd;
+      answers_t* a = &out[d * PLACES + p];
+      if (nt_make_natural_date(t, k_places[p][1], &nd) != NT_OK || nt_sun_events_for_date(&nd, k_places[p][0], &a->se) != NT_OK ||
+          nt_moon_events_for_date(&nd, k_places[p][0], &a->me) != NT_OK ||
+          nt_mustaches_range(&nd, k_places[p][0], &a->mu) != NT_OK) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+static double now_ms(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+int main(int argc, char** argv) {
+  int failures = 0;
+  static answers_t computed[DAYS * PLACES], loaded[DAYS * PLACES];
+
+  nt_snapshot_record(1);
+  double t0 = now_ms();
+  if (!run(computed)) failures++;
+  double cold_ms = now_ms() - t0;
+  nt_snapshot_record(0);
+
+  nt_snapshot_counts rc;
+  nt_snapshot_recorded(&rc);
+  if (rc.sun_events == 0 || rc.moon_events != DAYS * PLACES || rc.mustaches == 0 || rc.seasons == 0) failures++;
+
+  size_t bound = nt_snapshot_bound(), size = 0;
+  uint64_t* storage = (uint64_t*)malloc(bound + 8);  // 8-byte aligned
+  uint8_t* blob = (uint8_t*)storage;
+  if (!blob || nt_snapshot_write(blob, bound, &size) != NT_OK || size == 0 || size > bound) {
+    fprintf(stderr, "write failed\n");
+    return 3;
+  }
+  size_t small = 0;
+  if (nt_snapshot_write(blob, 16, &small) != NT_ERR_RANGE) failures++;
+  nt_snapshot_discard();
+
+  // Served from the snapshot: identical answers, every moon query and some sun
+  // and mustache queries answered by a snapshot lookup.
+  if (nt_snapshot_load(blob, size) != NT_OK) failures++;
+  nt_snapshot_counts lc;
+  nt_snapshot_loaded(&lc);
+  if (lc.moon_events != DAYS * PLACES || lc.sun_events == 0 || lc.sun_events > rc.sun_events ||
+      lc.mustaches > rc.mustaches) failures++;
+  nt_reset_caches();
+  nt_snapshot_counts h0, h1;
+  nt_snapshot_hits(&h0);
+  t0 = now_ms();
+  if (!run(loaded)) failures++;
+  double warm_ms = now_ms() - t0;
+  nt_snapshot_hits(&h1);
+  if (differences(computed, loaded) != 0) {
+    fprintf(stderr, "loaded answers differ from computed ones\n");
+    failures++;
+  }
+  if (h1.moon_events - h0.moon_events != DAYS * PLACES || h1.sun_events == h0.sun_events ||
+      h1.mustaches == h0.mustaches) {
+    fprintf(stderr, "snapshot hits: sun %u moon %u mustaches %u\n", h1.sun_events - h0.sun_events,
+            h1.moon_events - h0.moon_events, h1.mustaches - h0.mustaches);
+    failures++;
+  }
+
+  // Damaged or stale blobs are refused and leave the loaded snapshot alone.
+  uint8_t* copy = (uint8_t*)malloc(size + 8);
+  memcpy(copy, blob, size);
+  copy[8] ^= 1;  // format
+  if (nt_snapshot_load(copy, size) != NT_ERR_RANGE) failures++;
+  memcpy(copy, blob, size);
+  copy[16] ^= 1;  // library version
+  if (nt_snapshot_load(copy, size) != NT_ERR_RANGE) failures++;
+  memcpy(copy, blob, size);
+  if (nt_snapshot_load(copy, size - 1) != NT_ERR_RANGE) failures++;      // truncated
+  if (nt_snapshot_load(copy + 1, size - 1) != NT_ERR_RANGE) failures++;  // misaligned
+  nt_snapshot_loaded(&lc);
+  if (lc.moon_events != DAYS * PLACES) failures++;
+  free(copy);
+
+  // Files: save, unload, load.
+  // Named after the executable: the natural_time and natural_time_core builds may run in parallel.
+  const char* self = (argc > 0) ? argv[0] : "test_snapshot";
+  for (const char* p = self; *p; ++p) {
+    if (*p == '/' || *p == '\\') self = p + 1;
+  }
+  char path[256];
+  snprintf(path, sizeof path, "nt_%s_%ld.bin", self, (long)time(NULL));
+  nt_snapshot_record(1);
+  nt_reset_caches();
+  if (!run(loaded)) failures++;  // snapshot hits are recorded too
+  if (nt_snapshot_save(path) != NT_OK) failures++;
+  nt_snapshot_record(0);
+  nt_snapshot_discard();
+  nt_snapshot_unload();
+  nt_snapshot_loaded(&lc);
+  if (lc.moon_events != 0) failures++;
+  if (nt_snapshot_load_file(path) != NT_OK) failures++;
+  nt_snapshot_loaded(&lc);
+  if (lc.moon_events != DAYS * PLACES) failures++;
+  nt_reset_caches();
+  memset(loaded, 0, sizeof(loaded));
+  if (!run(loaded) || differences(computed, loaded) != 0) failures++;
+  nt_snapshot_unload();
+  remove(path);
+  free(storage);
+
+  if (failures != 0) {
+    fprintf(stderr, "snapshot test failed: %d failures\n", failures);
+    return 3;
+  }
+  printf("snapshot ok (%zu bytes, cold %.2f ms, warm %.2f ms)\n", size, cold_ms, warm_ms);
+  return 0;
+}
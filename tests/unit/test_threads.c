@@ -0,0 +1,93 @@
+#include "natural_time.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+// Several threads query the library at once, each walking the same dates in
+// its own order so their per-thread caches hold different days. Every answer
+// must match the one computed before any thread started.
+
+enum { THREADS = 4, DATES = 96 };
+
+typedef struct {
+  nt_natural_date nd;
+  nt_sun_events se;
+  nt_mustaches mu;
+  char text[64];
+} answer_t;
+
+static const double k_places[][2] = {{48.85, 2.35}, {-33.87, 151.21}, {64.15, -21.94}, {78.22, 15.65}};
+static answer_t g_expected[DATES];
+
+static int64_t date_ms(int i) {
+  // Two years either side of new year, across places and times of day.
+  return 1703000000000LL + (int64_t)i * 15 * 86400000LL + (int64_t)(i % 7) * 3600000LL;
+}
+
+static int answer(int i, answer_t* out) {
+  const double* pl = k_places[i % 4];
+  memset(out, 0, sizeof(*out));
+  return nt_make_natural_date(date_ms(i), pl[1], &out->nd) == NT_OK &&
+         nt_sun_events_for_date(&out->nd, pl[0], &out->se) == NT_OK &&
+         nt_mustaches_range(&out->nd, pl[0], &out->mu) == NT_OK &&
+         nt_format_string(&out->nd, 2, 0.01, out->text, sizeof(out->text)) == NT_OK;
+}
+
+static int same_answer(const answer_t* a, const answer_t* b) {
+  const nt_natural_date *x = &a->nd, *y = &b->nd;
+  const nt_sun_events *s = &a->se, *t = &b->se;
+  return x->unix_time == y->unix_time && x->year_start == y->year_start && x->year_duration == y->year_duration &&
+         x->year == y->year && x->day_of_year == y->day_of_year && x->time_deg == y->time_deg && x->nadir == y->nadir &&
+         s->sunrise_deg == t->sunrise_deg && s->sunset_deg == t->sunset_deg && s->night_start_deg == t->night_start_deg &&
+         s->night_end_deg == t->night_end_deg && s->morning_golden_deg == t->morning_golden_deg &&
+         s->evening_golden_deg == t->evening_golden_deg && s->horizon_regime == t->horizon_regime &&
+         a->mu.winter_sunrise_deg == b->mu.winter_sunrise_deg && a->mu.summer_sunset_deg == b->mu.summer_sunset_deg &&
+         a->mu.average_angle_deg == b->mu.average_angle_deg && strcmp(a->text, b->text) == 0;
+}
+
+typedef struct {
+  int index;
+  int failures;
+} worker_arg;
+
+static void* worker_main(void* p) {
+  worker_arg* a = (worker_arg*)p;
+  for (int round = 0; round < 3; ++round) {
+    for (int k = 0; k < DATES; ++k) {
+      int i = (k * (2 * a->index + 1) + a->index * 13) % DATES;  // odd strides visit every date
+      answer_t got;
+      if (!answer(i, &got) || !same_answer(&got, &g_expected[i])) a->failures++;
+    }
+    nt_reset_caches();
+  }
+  return NULL;
+}
+
+int main(void) {
+  for (int i = 0; i < DATES; ++i) {
+    if (!answer(i, &g_expected[i])) return 2;
+  }
+  nt_reset_caches();
+
+  pthread_t th[THREADS];
+  worker_arg args[THREADS];
+  int started = 0, failures = 0;
+  for (; started < THREADS; ++started) {
+    args[started] = (worker_arg){started, 0};
+    if (pthread_create(&th[started], NULL, worker_main, &args[started]) != 0) {
+      failures++;
+      break;
+    }
+  }
+  for (int i = 0; i < started; ++i) {
+    pthread_join(th[i], NULL);
+    failures += args[i].failures;
+  }
+
+  if (failures != 0) {
+    fprintf(stderr, "threads test failed: %d failures\n", failures);
+    return 1;
+  }
+  printf("threads ok (%d threads x %d dates)\n", THREADS, DATES);
+  return 0;
+}
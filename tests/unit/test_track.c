@@ -0,0 +1,120 @@
+#include "natural_time_track.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Documented bound (natural_time_track.h).
+#define MAX_EVENT_ERR_DEG 0.001
+#define MAX_ALTITUDE_ERR_DEG 0.001
+
+static double circular_diff(double a, double b) {
+  double d = fabs(a - b);
+  while (d >= 360.0) d -= 360.0;
+  return d > 180.0 ? 360.0 - d : d;
+}
+
+// Straight line from (lat0, lon0) to (lat1, lon1), one fix every `step_ms`.
+static size_t make_track(nt_track_point* pts, size_t n, int64_t start, int64_t step_ms,
+                         double lat0, double lon0, double lat1, double lon1) {
+  for (size_t i = 0; i < n; ++i) {
+    double f = (double)i / (double)(n - 1);
+    pts[i].unix_ms = start + (int64_t)i * step_ms;
+    pts[i].latitude = lat0 + f * (lat1 - lat0);
+    pts[i].longitude = lon0 + f * (lon1 - lon0);
+  }
+  return n;
+}
+
+// `max_anchor_share`: at most 1 in that many fixes may run the full searches.
+static int check_track(const char* name, const nt_track_point* pts, size_t n, size_t sample_every, uint64_t max_anchor_share) {
+  int failures = 0;
+  nt_track_fix* fixes = (nt_track_fix*)malloc(n * sizeof(nt_track_fix));
+  nt_track* t = nt_track_create(NULL);
+  if (!t || !fixes) return 1;
+  // Two chunks: state carries over between calls.
+  if (nt_track_process(t, pts, n / 3, fixes) != NT_OK) failures++;
+  if (nt_track_process(t, pts + n / 3, n - n / 3, fixes + n / 3) != NT_OK) failures++;
+
+  double max_event = 0.0, max_alt = 0.0;
+  for (size_t i = 0; i < n; i += sample_every) {
+    nt_natural_date nd;
+    nt_sun_events ev;
+    nt_sun_position pos;
+    if (nt_make_natural_date(pts[i].unix_ms, pts[i].longitude, &nd) != NT_OK ||
+        nt_sun_events_for_date(&nd, pts[i].latitude, &ev) != NT_OK ||
+        nt_sun_position_for_date(&nd, pts[i].latitude, &pos) != NT_OK) {
+      failures++;
+      continue;
+    }
+    if (fixes[i].date.year != nd.year || fixes[i].date.day_of_year != nd.day_of_year || fixes[i].date.time_deg != nd.time_deg) failures++;
+    const double got[6] = {fixes[i].sun.sunrise_deg, fixes[i].sun.sunset_deg, fixes[i].sun.night_start_deg,
+                           fixes[i].sun.night_end_deg, fixes[i].sun.morning_golden_deg, fixes[i].sun.evening_golden_deg};
+    const double want[6] = {ev.sunrise_deg, ev.sunset_deg, ev.night_start_deg,
+                            ev.night_end_deg, ev.morning_golden_deg, ev.evening_golden_deg};
+    for (int k = 0; k < 6; ++k) {
+      double d = circular_diff(got[k], want[k]);
+      if (d > max_event) max_event = d;
+      if (d > MAX_EVENT_ERR_DEG && failures < 5) {
+        fprintf(stderr, "%s fix %zu event %d: %.5f vs %.5f (anchored %d)\n", name, i, k, got[k], want[k], fixes[i].anchored);
+      }
+      if (d > MAX_EVENT_ERR_DEG) failures++;
+    }
+    if (pos.altitude > 0.5) {
+      double d = fabs(fixes[i].sun_altitude - pos.altitude);
+      if (d > max_alt) max_alt = d;
+      if (d > MAX_ALTITUDE_ERR_DEG) failures++;
+    }
+  }
+
+  nt_track_stats st;
+  nt_track_get_stats(t, &st);
+  if (st.points != n || st.anchors == 0 || st.anchors * max_anchor_share > st.points) failures++;
+  printf("%s: %zu fixes, %llu anchors, %llu nodes, max event err %.5f deg, max altitude err %.5f deg\n", name, n,
+         (unsigned long long)st.anchors, (unsigned long long)st.ephemeris_nodes, max_event, max_alt);
+  nt_track_destroy(t);
+  free(fixes);
+  return failures;
+}
+
+int main(void) {
+  int failures = 0;
+  const int64_t MIN = 60000LL;
+  enum { N = 14400 };
+  nt_track_point* pts = (nt_track_point*)malloc(N * sizeof(nt_track_point));
+  if (!pts) return 1;
+
+  // Ship, Brest -> New York in 10 days, one fix per minute (June).
+  make_track(pts, N, 1718000000000LL, MIN, 48.4, -4.5, 40.7, -74.0);
+  failures += check_track("ship", pts, N, 7, 20);
+
+  // Flight, Paris -> New York in 8 h, one fix per 10 s (December).
+  make_track(pts, 2880, 1734400000000LL, 10000LL, 49.0, 2.5, 40.6, -73.8);
+  failures += check_track("flight", pts, 2880, 3, 5);
+
+  // Oslo -> Anchorage in December: the noon sun grazes the +6 deg golden hour
+  // threshold, so most fixes fall back to the full searches.
+  make_track(pts, 3240, 1734400000000LL, 10000LL, 59.9, 10.8, 61.2, -149.9);
+  failures += check_track("grazing flight", pts, 3240, 3, 1);
+
+  // Hike around Tromso during the polar day: rise/set and night take the library defaults.
+  make_track(pts, 2000, 1718400000000LL, 2 * MIN, 69.6, 18.9, 69.9, 20.1);
+  failures += check_track("polar hike", pts, 2000, 5, 20);
+
+  // Errors.
+  nt_track* t = nt_track_create(NULL);
+  nt_track_fix fix;
+  nt_track_point bad = {1718000000000LL, 91.0, 0.0};
+  if (nt_track_process(t, &bad, 1, &fix) != NT_ERR_RANGE) failures++;
+  bad.latitude = 0.0;
+  bad.unix_ms = 0;
+  if (nt_track_process(t, &bad, 1, &fix) == NT_OK) failures++;
+  nt_track_destroy(t);
+
+  free(pts);
+  if (failures != 0) {
+    fprintf(stderr, "track test failed: %d failures\n", failures);
+    return 3;
+  }
+  printf("track ok\n");
+  return 0;
+}
@@ -0,0 +1,634 @@
+// ntc — annotate CSV/NDJSON timestamp streams with natural dates.
+//
+//   ntc [options] [file...]        (stdin when no file is given)
+//
+// Each input record keeps its bytes and gains natural date fields (and
+// optionally sun/moon events). Input is read in large chunks split on line
+// boundaries; worker threads convert chunks in parallel and a writer thread
+// emits them in input order.
+#include "natural_time.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined(NTC_HAVE_PTHREADS)
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define NTC_CHUNK_SIZE (4u << 20)      // input bytes per chunk (split on '\n')
+#define NTC_OUT_BUFFER (1u << 20)      // stdio buffer for the output stream
+#define NTC_MAX_FIELD 64
+static const int64_t MS_PER_DAY = 86400000LL;
+
+typedef enum { FMT_AUTO, FMT_CSV, FMT_NDJSON } ntc_format;
+
+typedef struct {
+  ntc_format format;
+  const char *time_field;   // CSV: header name or 1-based index; NDJSON: key
+  const char *lon_field;
+  const char *lat_field;
+  int time_unit_s;          // timestamps in seconds instead of ms
+  double longitude;         // used when lon_field is NULL
+  double latitude;          // used when lat_field is NULL
+  int has_latitude;
+  int sun;
+  int moon;
+  int decimals;
+  int header;               // CSV has a header row
+  int threads;
+  const char *output;
+} ntc_options;
+
+// Column positions resolved per file (CSV) — copied into each chunk.
+typedef struct {
+  int time_col;
+  int lon_col;
+  int lat_col;
+} ntc_columns;
+
+typedef struct {
+  char *data;
+  size_t len, cap;
+} ntc_buf;
+
+static int buf_reserve(ntc_buf *b, size_t extra) {
+  if (b->len + extra <= b->cap) return 1;
+  size_t n = b->cap ? b->cap : 4096;
+  while (n < b->len + extra) n *= 2;
+  char *p = (char *)realloc(b->data, n);
+  if (!p) return 0;
+  b->data = p;
+  b->cap = n;
+  return 1;
+}
+
+static void buf_append(ntc_buf *b, const char *s, size_t n) {
+  if (!buf_reserve(b, n)) { fprintf(stderr, "ntc: out of memory\n"); exit(2); }
+  memcpy(b->data + b->len, s, n);
+  b->len += n;
+}
+
+// -------------------------
+// Record conversion
+// -------------------------
+
+// Per-worker memo: consecutive records in the same natural day at the same
+// longitude share every field except unix_time/time_deg (typical for logs).
+typedef struct {
+  int valid;
+  nt_natural_date nd;
+} ntc_memo;
+
+static nt_err natural_date_memo(ntc_memo *m, int64_t unix_ms, double lon, nt_natural_date *out) {
+  if (m->valid && m->nd.longitude == lon && unix_ms >= m->nd.nadir && unix_ms < m->nd.nadir + MS_PER_DAY && unix_ms > 0) {
+    *out = m->nd;
+    out->unix_time = unix_ms;
+    out->time_deg = ((double)(unix_ms - out->nadir)) * 360.0 / (double)MS_PER_DAY;
+    return NT_OK;
+  }
+  nt_err e = nt_make_natural_date(unix_ms, lon, out);
+  m->valid = (e == NT_OK);
+  if (m->valid) m->nd = *out;
+  return e;
+}
+
+static int parse_field_int64(const char *s, size_t n, int64_t *out) {
+  char tmp[NTC_MAX_FIELD];
+  while (n > 0 && (*s == '"' || *s == ' ')) { s++; n--; }
+  while (n > 0 && (s[n - 1] == '"' || s[n - 1] == ' ' || s[n - 1] == '\r')) n--;
+  if (n == 0 || n >= sizeof(tmp)) return 0;
+  memcpy(tmp, s, n);
+  tmp[n] = '\0';
+  char *end;
+  errno = 0;
+  long long v = strtoll(tmp, &end, 10);
+  if (errno || end == tmp) return 0;
+  // "123.000" is still a whole timestamp; any other fraction is an error, not truncated.
+  if (*end == '.') {
+    while (*++end == '0') {}
+  }
+  if (*end != '\0') return 0;
+  *out = (int64_t)v;
+  return 1;
+}
+
+static int parse_field_double(const char *s, size_t n, double *out) {
+  char tmp[NTC_MAX_FIELD];
+  while (n > 0 && (*s == '"' || *s == ' ')) { s++; n--; }
+  while (n > 0 && (s[n - 1] == '"' || s[n - 1] == ' ' || s[n - 1] == '\r')) n--;
+  if (n == 0 || n >= sizeof(tmp)) return 0;
+  memcpy(tmp, s, n);
+  tmp[n] = '\0';
+  char *end;
+  double v = strtod(tmp, &end);
+  if (end == tmp || *end != '\0') return 0;
+  *out = v;
+  return 1;
+}
+
+// Appends the natural fields, each preceded by ','; `json` selects "key":value output.
+static void append_fields(const ntc_options *o, ntc_buf *out, int json, int ok, const nt_natural_date *nd, double lat) {
+  char tmp[512];
+  int n;
+  if (!ok) {
+    if (json) {
+      buf_append(out, ",\"nt_error\":true", 16);
+    } else {
+      int fields = 9 + (o->sun ? 6 : 0) + (o->moon ? 4 : 0);
+      for (int i = 0; i < fields; ++i) buf_append(out, ",", 1);
+    }
+    return;
+  }
+  static const double unit_increment[7] = {1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001};
+  char str[96];
+  nt_format_string(nd, o->decimals, unit_increment[o->decimals], str, sizeof(str));
+  if (json) {
+    n = snprintf(tmp, sizeof(tmp),
+                 ",\"nt_year\":%d,\"nt_moon\":%d,\"nt_week\":%d,\"nt_day_of_year\":%d,\"nt_day_of_moon\":%d,"
+                 "\"nt_day_of_week\":%d,\"nt_rainbow\":%s,\"nt_time_deg\":%.6f,\"nt_string\":\"%s\"",
+                 nd->year, nd->moon, nd->week, nd->day_of_year, nd->day_of_moon, nd->day_of_week,
+                 nd->is_rainbow_day ? "true" : "false", nd->time_deg, str);
+  } else {
+    n = snprintf(tmp, sizeof(tmp), ",%d,%d,%d,%d,%d,%d,%d,%.6f,%s",
+                 nd->year, nd->moon, nd->week, nd->day_of_year, nd->day_of_moon, nd->day_of_week,
+                 nd->is_rainbow_day, nd->time_deg, str);
+  }
+  buf_append(out, tmp, (size_t)n);
+
+  if (o->sun) {
+    nt_sun_events se;
+    if (nt_sun_events_for_date(nd, lat, &se) == NT_OK) {
+      n = snprintf(tmp, sizeof(tmp),
+                   json ? ",\"nt_sunrise\":%.6f,\"nt_sunset\":%.6f,\"nt_night_start\":%.6f,\"nt_night_end\":%.6f,"
+                          "\"nt_morning_golden\":%.6f,\"nt_evening_golden\":%.6f"
+                        : ",%.6f,%.6f,%.6f,%.6f,%.6f,%.6f",
+                   se.sunrise_deg, se.sunset_deg, se.night_start_deg, se.night_end_deg, se.morning_golden_deg, se.evening_golden_deg);
+      buf_append(out, tmp, (size_t)n);
+    } else if (!json) {
+      buf_append(out, ",,,,,,", 6);
+    }
+  }
+  if (o->moon) {
+    nt_moon_position mp;
+    nt_moon_events me;
+    if (nt_moon_position_for_date(nd, lat, &mp) == NT_OK && nt_moon_events_for_date(nd, lat, &me) == NT_OK) {
+      n = snprintf(tmp, sizeof(tmp),
+                   json ? ",\"nt_moon_phase\":%.6f,\"nt_moon_altitude\":%.6f,\"nt_moonrise\":%.6f,\"nt_moonset\":%.6f"
+                        : ",%.6f,%.6f,%.6f,%.6f",
+                   mp.phase_deg, mp.altitude, me.moonrise_deg, me.moonset_deg);
+      buf_append(out, tmp, (size_t)n);
+    } else if (!json) {
+      buf_append(out, ",,,,", 4);
+    }
+  }
+}
+
+static void convert_csv_line(const ntc_options *o, const ntc_columns *c, ntc_memo *memo,
+                             const char *line, size_t len, ntc_buf *out) {
+  size_t body = len;
+  while (body > 0 && line[body - 1] == '\r') body--;
+  const char *fs[3] = {NULL, NULL, NULL};
+  size_t fl[3] = {0, 0, 0};
+  const int want[3] = {c->time_col, c->lon_col, c->lat_col};
+  int col = 0, quoted = 0;
+  size_t start = 0;
+  for (size_t i = 0; i <= body; ++i) {
+    if (i < body && line[i] == '"') quoted = !quoted;
+    if (i == body || (line[i] == ',' && !quoted)) {
+      for (int k = 0; k < 3; ++k) if (want[k] == col) { fs[k] = line + start; fl[k] = i - start; }
+      col++;
+      start = i + 1;
+    }
+  }
+
+  int64_t t;
+  double lon = o->longitude, lat = o->latitude;
+  int ok = fs[0] && parse_field_int64(fs[0], fl[0], &t);
+  if (ok && c->lon_col >= 0) ok = fs[1] && parse_field_double(fs[1], fl[1], &lon);
+  if (ok && c->lat_col >= 0) ok = fs[2] && parse_field_double(fs[2], fl[2], &lat);
+  nt_natural_date nd;
+  if (ok) ok = natural_date_memo(memo, o->time_unit_s ? t * 1000LL : t, lon, &nd) == NT_OK;
+  if (ok && (o->sun || o->moon)) ok = (lat >= -90.0 && lat <= 90.0);
+
+  buf_append(out, line, body);
+  append_fields(o, out, 0, ok, &nd, lat);
+  buf_append(out, "\n", 1);
+}
+
+// Finds `"key":` in a flat JSON object line and returns the raw value span.
+static int json_value(const char *line, size_t len, const char *key, const char **v, size_t *vn) {
+  size_t kl = strlen(key);
+  for (size_t i = 0; i + kl + 2 < len; ++i) {
+    if (line[i] != '"' || memcmp(line + i + 1, key, kl) != 0 || line[i + kl + 1] != '"') continue;
+    size_t j = i + kl + 2;
+    while (j < len && (line[j] == ' ' || line[j] == '\t')) j++;
+    if (j >= len || line[j] != ':') continue;
+    j++;
+    while (j < len && (line[j] == ' ' || line[j] == '\t')) j++;
+    size_t e = j;
+    if (e < len && line[e] == '"') {
+      e++;
+      while (e < len && line[e] != '"') e++;
+      if (e < len) e++;
+    } else {
+      while (e < len && line[e] != ',' && line[e] != '}' && line[e] != ' ') e++;
+    }
+    *v = line + j;
+    *vn = e - j;
+    return 1;
+  }
+  return 0;
+}
+
+static void convert_ndjson_line(const ntc_options *o, ntc_memo *memo, const char *line, size_t len, ntc_buf *out) {
+  size_t body = len;
+  while (body > 0 && (line[body - 1] == '\r' || line[body - 1] == ' ')) body--;
+  size_t close = body;
+  while (close > 0 && line[close - 1] != '}') close--;
+  if (close == 0) { // not an object: pass through untouched
+    buf_append(out, line, body);
+    buf_append(out, "\n", 1);
+    return;
+  }
+  close--;
+
+  const char *v;
+  size_t vn;
+  int64_t t;
+  double lon = o->longitude, lat = o->latitude;
+  int ok = json_value(line, close, o->time_field ? o->time_field : "unix_ms", &v, &vn) && parse_field_int64(v, vn, &t);
+  if (ok && o->lon_field) ok = json_value(line, close, o->lon_field, &v, &vn) && parse_field_double(v, vn, &lon);
+  if (ok && o->lat_field) ok = json_value(line, close, o->lat_field, &v, &vn) && parse_field_double(v, vn, &lat);
+  nt_natural_date nd;
+  if (ok) ok = natural_date_memo(memo, o->time_unit_s ? t * 1000LL : t, lon, &nd) == NT_OK;
+  if (ok && (o->sun || o->moon)) ok = (lat >= -90.0 && lat <= 90.0);
+
+  size_t prefix = close;
+  while (prefix > 0 && (line[prefix - 1] == ' ' || line[prefix - 1] == '\t')) prefix--;
+  buf_append(out, line, prefix);
+  if (prefix > 0 && line[prefix - 1] == '{') {
+    // Empty object: drop the leading comma of the first appended field.
+    ntc_buf tmp = {0};
+    append_fields(o, &tmp, 1, ok, &nd, lat);
+    if (tmp.len > 0) buf_append(out, tmp.data + 1, tmp.len - 1);
+    free(tmp.data);
+  } else {
+    append_fields(o, out, 1, ok, &nd, lat);
+  }
+  buf_append(out, line + close, body - close);
+  buf_append(out, "\n", 1);
+}
+
+typedef struct {
+  ntc_format format;
+  ntc_columns columns;
+  ntc_buf in;
+  ntc_buf out;
+} ntc_chunk;
+
+static void convert_chunk(const ntc_options *o, ntc_memo *memo, ntc_chunk *c) {
+  c->out.len = 0;
+  buf_reserve(&c->out, c->in.len + c->in.len / 2 + 256);
+  size_t start = 0;
+  for (size_t i = 0; i < c->in.len; ++i) {
+    if (c->in.data[i] != '\n') continue;
+    if (i > start) {
+      if (c->format == FMT_CSV) convert_csv_line(o, &c->columns, memo, c->in.data + start, i - start, &c->out);
+      else convert_ndjson_line(o, memo, c->in.data + start, i - start, &c->out);
+    }
+    start = i + 1;
+  }
+}
+
+// -------------------------
+// Ordered parallel pipeline
+// -------------------------
+
+typedef struct {
+  const ntc_options *opt;
+  FILE *out;
+  int nslots;
+  ntc_chunk *slots;
+  int *state;               // 0 = free, 1 = filled, 2 = converted
+  long long next_fill, next_convert, next_write;
+  int done;
+#if defined(NTC_HAVE_PTHREADS)
+  pthread_mutex_t mu;
+  pthread_cond_t cv;
+#endif
+} ntc_pipeline;
+
+#if defined(NTC_HAVE_PTHREADS)
+static void *worker_main(void *arg) {
+  ntc_pipeline *p = (ntc_pipeline *)arg;
+  ntc_memo memo = {0};
+  pthread_mutex_lock(&p->mu);
+  for (;;) {
+    while (!(p->next_convert < p->next_fill && p->state[p->next_convert % p->nslots] == 1) && !(p->done && p->next_convert >= p->next_fill)) {
+      pthread_cond_wait(&p->cv, &p->mu);
+    }
+    if (p->next_convert >= p->next_fill) break;
+    long long seq = p->next_convert++;
+    ntc_chunk *c = &p->slots[seq % p->nslots];
+    pthread_mutex_unlock(&p->mu);
+    convert_chunk(p->opt, &memo, c);
+    pthread_mutex_lock(&p->mu);
+    p->state[seq % p->nslots] = 2;
+    pthread_cond_broadcast(&p->cv);
+  }
+  pthread_mutex_unlock(&p->mu);
+  return NULL;
+}
+
+static void *writer_main(void *arg) {
+  ntc_pipeline *p = (ntc_pipeline *)arg;
+  pthread_mutex_lock(&p->mu);
+  for (;;) {
+    while (!(p->next_write < p->next_fill && p->state[p->next_write % p->nslots] == 2) && !(p->done && p->next_write >= p->next_fill)) {
+      pthread_cond_wait(&p->cv, &p->mu);
+    }
+    if (p->next_write >= p->next_fill) break;
+    ntc_chunk *c = &p->slots[p->next_write % p->nslots];
+    pthread_mutex_unlock(&p->mu);
+    fwrite(c->out.data, 1, c->out.len, p->out);
+    pthread_mutex_lock(&p->mu);
+    p->state[p->next_write % p->nslots] = 0;
+    p->next_write++;
+    pthread_cond_broadcast(&p->cv);
+  }
+  pthread_mutex_unlock(&p->mu);
+  return NULL;
+}
+#endif
+
+// Returns a free slot to fill (blocks while all slots are in flight).
+static ntc_chunk *pipeline_acquire(ntc_pipeline *p) {
+#if defined(NTC_HAVE_PTHREADS)
+  if (p->opt->threads > 1) {
+    pthread_mutex_lock(&p->mu);
+    while (p->state[p->next_fill % p->nslots] != 0) pthread_cond_wait(&p->cv, &p->mu);
+    pthread_mutex_unlock(&p->mu);
+  }
+#endif
+  return &p->slots[p->next_fill % p->nslots];
+}
+
+static void pipeline_submit(ntc_pipeline *p, ntc_memo *memo) {
+#if defined(NTC_HAVE_PTHREADS)
+  if (p->opt->threads > 1) {
+    pthread_mutex_lock(&p->mu);
+    p->state[p->next_fill % p->nslots] = 1;
+    p->next_fill++;
+    pthread_cond_broadcast(&p->cv);
+    pthread_mutex_unlock(&p->mu);
+    return;
+  }
+#endif
+  ntc_chunk *c = &p->slots[p->next_fill % p->nslots];
+  convert_chunk(p->opt, memo, c);
+  fwrite(c->out.data, 1, c->out.len, p->out);
+  p->next_fill++;
+}
+
+// -------------------------
+// Input handling
+// -------------------------
+
+static int resolve_column(const char *header, size_t len, const char *name, int fallback) {
+  if (!name) return fallback;
+  char *end;
+  long idx = strtol(name, &end, 10);
+  if (*end == '\0' && idx > 0) return (int)idx - 1;
+  int col = 0;
+  size_t start = 0, nl = strlen(name);
+  for (size_t i = 0; i <= len; ++i) {
+    if (i == len || header[i] == ',') {
+      const char *f = header + start;
+      size_t fl = i - start;
+      while (fl > 0 && (f[fl - 1] == '\r' || f[fl - 1] == ' ')) fl--;
+      if (fl >= 2 && f[0] == '"' && f[fl - 1] == '"') { f++; fl -= 2; }
+      if (fl == nl && memcmp(f, name, nl) == 0) return col;
+      col++;
+      start = i + 1;
+    }
+  }
+  return -2; // not found
+}
+
+static void write_csv_header(const ntc_options *o, FILE *out, const char *header, size_t len) {
+  while (len > 0 && header[len - 1] == '\r') len--;
+  fwrite(header, 1, len, out);
+  fputs(",nt_year,nt_moon,nt_week,nt_day_of_year,nt_day_of_moon,nt_day_of_week,nt_rainbow,nt_time_deg,nt_string", out);
+  if (o->sun) fputs(",nt_sunrise,nt_sunset,nt_night_start,nt_night_end,nt_morning_golden,nt_evening_golden", out);
+  if (o->moon) fputs(",nt_moon_phase,nt_moon_altitude,nt_moonrise,nt_moonset", out);
+  fputc('\n', out);
+}
+
+static int process_stream(ntc_pipeline *p, ntc_memo *memo, FILE *in, const char *name, int first_file) {
+  const ntc_options *o = p->opt;
+  ntc_format fmt = o->format;
+  ntc_columns cols = {0, o->lon_field ? -2 : -1, o->lat_field ? -2 : -1};
+  ntc_buf carry = {0};
+  int first_chunk = 1;
+
+  for (;;) {
+    ntc_chunk *c = pipeline_acquire(p);
+    c->in.len = 0;
+    if (carry.len) buf_append(&c->in, carry.data, carry.len);
+    carry.len = 0;
+    buf_reserve(&c->in, NTC_CHUNK_SIZE);
+    size_t got = fread(c->in.data + c->in.len, 1, NTC_CHUNK_SIZE, in);
+    c->in.len += got;
+    int eof = (got < NTC_CHUNK_SIZE);
+    if (eof && c->in.len > 0 && c->in.data[c->in.len - 1] != '\n') buf_append(&c->in, "\n", 1);
+    if (c->in.len == 0) break;
+
+    size_t begin = 0;
+    if (first_chunk) {
+      first_chunk = 0;
+      if (fmt == FMT_AUTO) {
+        size_t i = 0;
+        while (i < c->in.len && (c->in.data[i] == ' ' || c->in.data[i] == '\n' || c->in.data[i] == '\r')) i++;
+        fmt = (i < c->in.len && c->in.data[i] == '{') ? FMT_NDJSON : FMT_CSV;
+      }
+      if (fmt == FMT_CSV && o->header) {
+        const char *nl = memchr(c->in.data, '\n', c->in.len);
+        size_t hl = nl ? (size_t)(nl - c->in.data) : c->in.len;
+        cols.time_col = resolve_column(c->in.data, hl, o->time_field, 0);
+        cols.lon_col = resolve_column(c->in.data, hl, o->lon_field, -1);
+        cols.lat_col = resolve_column(c->in.data, hl, o->lat_field, -1);
+        if (cols.time_col < 0 || cols.lon_col == -2 || cols.lat_col == -2) {
+          fprintf(stderr, "ntc: %s: column not found in header\n", name);
+          free(carry.data);
+          return 0;
+        }
+        if (first_file) write_csv_header(o, p->out, c->in.data, hl);
+        begin = nl ? hl + 1 : c->in.len;
+      } else if (fmt == FMT_CSV) {
+        cols.time_col = resolve_column("", 0, o->time_field, 0);
+        cols.lon_col = resolve_column("", 0, o->lon_field, -1);
+        cols.lat_col = resolve_column("", 0, o->lat_field, -1);
+        if (cols.time_col < 0 || cols.lon_col == -2 || cols.lat_col == -2) {
+          fprintf(stderr, "ntc: %s: use 1-based column indexes with --no-header\n", name);
+          free(carry.data);
+          return 0;
+        }
+      }
+    }
+
+    // Keep the trailing partial line for the next chunk.
+    size_t end = c->in.len;
+    while (end > begin && c->in.data[end - 1] != '\n') end--;
+    if (end < c->in.len) buf_append(&carry, c->in.data + end, c->in.len - end);
+    if (begin > 0) memmove(c->in.data, c->in.data + begin, end - begin);
+    c->in.len = end - begin;
+    c->format = fmt;
+    c->columns = cols;
+    pipeline_submit(p, memo);
+    if (eof && carry.len == 0) break;
+  }
+  free(carry.data);
+  if (ferror(in)) {
+    fprintf(stderr, "ntc: %s: read error\n", name);
+    return 0;
+  }
+  return 1;
+}
+
+static void usage(void) {
+  fprintf(stderr,
+    "usage: ntc [options] [file...]\n"
+    "  -f, --format csv|ndjson   input format (default: detect from first byte)\n"
+    "  -t, --time FIELD          timestamp column name, 1-based index or JSON key (default: first column / \"unix_ms\")\n"
+    "      --seconds             timestamps are Unix seconds instead of ms\n"
+    "  -x, --lon FIELD           longitude column/key (default: --longitude)\n"
+    "  -y, --lat FIELD           latitude column/key (default: --latitude)\n"
+    "      --longitude DEG       fixed longitude (default 0)\n"
+    "      --latitude DEG        fixed latitude for --sun/--moon\n"
+    "      --sun                 append sun events\n"
+    "      --moon                append moon phase/altitude/rise/set\n"
+    "      --decimals N          time decimals in nt_string (0..6, default 2)\n"
+    "      --no-header           CSV input has no header row\n"
+    "  -j, --threads N           worker threads (default: online CPUs)\n"
+    "  -o, --output FILE         output file (default stdout)\n");
+}
+
+int main(int argc, char **argv) {
+  ntc_options o;
+  memset(&o, 0, sizeof(o));
+  o.format = FMT_AUTO;
+  o.decimals = 2;
+  o.header = 1;
+  o.threads = 1;
+#if defined(NTC_HAVE_PTHREADS) && defined(_SC_NPROCESSORS_ONLN)
+  long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+  if (ncpu > 1) o.threads = (int)ncpu;
+#endif
+
+  const char **files = (const char **)calloc((size_t)argc, sizeof(char *));
+  int nfiles = 0;
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+#define NTC_TAKE_ARG() do { if (!v) { usage(); return 1; } ++i; } while (0)
+    if (!strcmp(a, "-f") || !strcmp(a, "--format")) {
+      NTC_TAKE_ARG();
+      if (!strcmp(v, "csv")) o.format = FMT_CSV;
+      else if (!strcmp(v, "ndjson") || !strcmp(v, "jsonl")) o.format = FMT_NDJSON;
+      else { usage(); return 1; }
+    } else if (!strcmp(a, "-t") || !strcmp(a, "--time")) { NTC_TAKE_ARG(); o.time_field = v; }
+    else if (!strcmp(a, "-x") || !strcmp(a, "--lon")) { NTC_TAKE_ARG(); o.lon_field = v; }
+    else if (!strcmp(a, "-y") || !strcmp(a, "--lat")) { NTC_TAKE_ARG(); o.lat_field = v; o.has_latitude = 1; }
+    else if (!strcmp(a, "--longitude")) { NTC_TAKE_ARG(); o.longitude = atof(v); }
+    else if (!strcmp(a, "--latitude")) { NTC_TAKE_ARG(); o.latitude = atof(v); o.has_latitude = 1; }
+    else if (!strcmp(a, "--seconds")) o.time_unit_s = 1;
+    else if (!strcmp(a, "--sun")) o.sun = 1;
+    else if (!strcmp(a, "--moon")) o.moon = 1;
+    else if (!strcmp(a, "--decimals")) { NTC_TAKE_ARG(); o.decimals = atoi(v); }
+    else if (!strcmp(a, "--no-header")) o.header = 0;
+    else if (!strcmp(a, "-j") || !strcmp(a, "--threads")) { NTC_TAKE_ARG(); o.threads = atoi(v); }
+    else if (!strncmp(a, "-j", 2) && a[2] >= '0' && a[2] <= '9') o.threads = atoi(a + 2);
+    else if (!strcmp(a, "-o") || !strcmp(a, "--output")) { NTC_TAKE_ARG(); o.output = v; }
+    else if (!strcmp(a, "-h") || !strcmp(a, "--help")) { usage(); return 0; }
+    else if (a[0] == '-' && a[1] != '\0') { usage(); return 1; }
+    else files[nfiles++] = a;
+#undef NTC_TAKE_ARG
+  }
+  if (o.decimals < 0 || o.decimals > 6) o.decimals = 2;
+  if (o.threads < 1) o.threads = 1;
+  if ((o.sun || o.moon) && !o.has_latitude) {
+    fprintf(stderr, "ntc: --sun/--moon need --lat or --latitude\n");
+    return 1;
+  }
+
+  FILE *out = stdout;
+  if (o.output && !(out = fopen(o.output, "wb"))) {
+    fprintf(stderr, "ntc: cannot open %s\n", o.output);
+    return 1;
+  }
+  setvbuf(out, NULL, _IOFBF, NTC_OUT_BUFFER);
+
+  ntc_pipeline p;
+  memset(&p, 0, sizeof(p));
+  p.opt = &o;
+  p.out = out;
+  p.nslots = (o.threads > 1) ? 2 * o.threads + 1 : 1;
+  p.slots = (ntc_chunk *)calloc((size_t)p.nslots, sizeof(ntc_chunk));
+  p.state = (int *)calloc((size_t)p.nslots, sizeof(int));
+  ntc_memo memo = {0};
+
+  int ok = 1;
+#if defined(NTC_HAVE_PTHREADS)
+  pthread_t *workers = NULL;
+  pthread_t writer;
+  int started = 0, writer_started = 0;
+  if (o.threads > 1) {
+    pthread_mutex_init(&p.mu, NULL);
+    pthread_cond_init(&p.cv, NULL);
+    workers = (pthread_t *)calloc((size_t)o.threads, sizeof(pthread_t));
+    while (workers && started < o.threads && pthread_create(&workers[started], NULL, worker_main, &p) == 0) ++started;
+    writer_started = started == o.threads && pthread_create(&writer, NULL, writer_main, &p) == 0;
+    if (!writer_started) {
+      fprintf(stderr, "ntc: cannot start %d threads\n", o.threads + 1);
+      ok = 0;
+    }
+  }
+#endif
+
+  // An auto-detected format is per file; a CSV header is written once.
+  if (ok && nfiles == 0) {
+    ok = process_stream(&p, &memo, stdin, "<stdin>", 1);
+  } else {
+    for (int i = 0; i < nfiles && ok; ++i) {
+      FILE *in = fopen(files[i], "rb");
+      if (!in) { fprintf(stderr, "ntc: cannot open %s\n", files[i]); ok = 0; break; }
+      setvbuf(in, NULL, _IOFBF, NTC_OUT_BUFFER);
+      ok = process_stream(&p, &memo, in, files[i], i == 0);
+      fclose(in);
+    }
+  }
+
+#if defined(NTC_HAVE_PTHREADS)
+  if (o.threads > 1) {
+    pthread_mutex_lock(&p.mu);
+    p.done = 1;
+    pthread_cond_broadcast(&p.cv);
+    pthread_mutex_unlock(&p.mu);
+    for (int i = 0; i < started; ++i) pthread_join(workers[i], NULL);
+    if (writer_started) pthread_join(writer, NULL);
+    free(workers);
+    pthread_mutex_destroy(&p.mu);
+    pthread_cond_destroy(&p.cv);
+  }
+#endif
+
+  if (fflush(out) != 0) ok = 0;
+  if (out != stdout) fclose(out);
+  for (int i = 0; i < p.nslots; ++i) { free(p.slots[i].in.data); free(p.slots[i].out.data); }
+  free(p.slots);
+  free(p.state);
+  free(files);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,581 @@
+// ntd — Natural Time query daemon over a Unix domain socket.
+//
+//   ntd [-s socket] [-j workers] [--cache-slots N]
+//
+// One poll() event loop owns the sockets: it parses pipelined request frames
+// and hands them to a pool of worker threads, which answer from a shared
+// day-level result cache (sun events, moon events, mustaches) in front of the
+// library and post encoded responses back through a wake pipe. Latency from
+// frame receipt to response is recorded per op in log2 histograms
+// (NTD_OP_STATS). Local only: no network sockets are opened.
+#include "ntd_wire.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#define NTD_MAX_CONNS 1024
+#define NTD_MAX_INFLIGHT 64         // per connection; reading pauses above this (backpressure)
+#define NTD_MAX_PENDING_OUT (4u << 20)  // per connection; reading pauses while more output is unsent
+#define NTD_READ_SIZE (64u << 10)
+#define NTD_CACHE_SHARDS 64
+static const int64_t MS_PER_DAY = 86400000LL;
+
+// -------------------------
+// Shared result cache
+// -------------------------
+
+// Direct-mapped per shard. Keys are day-level: (op, nadir, longitude, latitude)
+// for sun/moon events, (op, UTC year, latitude) for mustaches.
+typedef struct {
+  int     valid;
+  int     op;
+  int64_t k;
+  double  lon, lat;
+  ntd_result value;
+} ntd_cache_entry;
+
+typedef struct {
+  pthread_mutex_t mu;
+  ntd_cache_entry* slots;
+} ntd_cache_shard;
+
+static ntd_cache_shard g_cache[NTD_CACHE_SHARDS];
+static size_t g_cache_slots = 1024;  // per shard
+
+static uint64_t cache_hash(int op, int64_t k, double lon, double lat) {
+  uint64_t a, b;
+  memcpy(&a, &lon, 8);
+  memcpy(&b, &lat, 8);
+  uint64_t h = (uint64_t)op * 0x9E3779B97F4A7C15ULL ^ (uint64_t)k;
+  h = (h ^ (h >> 31)) * 0xBF58476D1CE4E5B9ULL ^ a;
+  h = (h ^ (h >> 29)) * 0x94D049BB133111EBULL ^ b;
+  return (h ^ (h >> 32)) * 0x9E3779B97F4A7C15ULL;
+}
+
+static int cache_get(int op, int64_t k, double lon, double lat, ntd_result* out) {
+  uint64_t h = cache_hash(op, k, lon, lat);
+  ntd_cache_shard* s = &g_cache[h % NTD_CACHE_SHARDS];
+  const ntd_cache_entry* e = &s->slots[(h >> 8) % g_cache_slots];
+  int hit = 0;
+  pthread_mutex_lock(&s->mu);
+  if (e->valid && e->op == op && e->k == k && e->lon == lon && e->lat == lat) {
+    *out = e->value;
+    hit = 1;
+  }
+  pthread_mutex_unlock(&s->mu);
+  return hit;
+}
+
+static void cache_put(int op, int64_t k, double lon, double lat, const ntd_result* value) {
+  uint64_t h = cache_hash(op, k, lon, lat);
+  ntd_cache_shard* s = &g_cache[h % NTD_CACHE_SHARDS];
+  ntd_cache_entry* e = &s->slots[(h >> 8) % g_cache_slots];
+  pthread_mutex_lock(&s->mu);
+  e->valid = 1;
+  e->op = op;
+  e->k = k;
+  e->lon = lon;
+  e->lat = lat;
+  e->value = *value;
+  pthread_mutex_unlock(&s->mu);
+}
+
+// -------------------------
+// Stats
+// -------------------------
+
+typedef struct {
+  atomic_uint_fast64_t frames, items, hits, misses;
+  atomic_uint_fast64_t hist[NTD_HIST_BUCKETS];
+} ntd_counters;
+
+static ntd_counters g_stats[NTD_QUERY_OPS];
+
+static int64_t now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void record_latency(int op, int64_t us) {
+  int b = 0;
+  while (us > 1 && b < NTD_HIST_BUCKETS - 1) {
+    us >>= 1;
+    b++;
+  }
+  atomic_fetch_add(&g_stats[op - 1].hist[b], 1);
+}
+
+// -------------------------
+// Query evaluation
+// -------------------------
+
+static int64_t utc_year_of(int64_t unix_ms) {
+  // Civil-from-days (Howard Hinnant), floor division for pre-1970 instants.
+  int64_t z = (unix_ms >= 0 ? unix_ms / MS_PER_DAY : (unix_ms - MS_PER_DAY + 1) / MS_PER_DAY) + 719468;
+  int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  int64_t doe = z - era * 146097;
+  int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  int64_t mp = (5 * doy + 2) / 153;
+  return yoe + era * 400 + (mp >= 10 ? 1 : 0);
+}
+
+static void evaluate(int op, const ntd_query* q, ntd_result* r) {
+  nt_natural_date nd;
+  memset(r, 0, sizeof(*r));
+  r->status = nt_make_natural_date(q->unix_ms, q->longitude, &nd);
+  if (r->status != NT_OK) return;
+  if (op == NTD_OP_DATE) {
+    r->u.date = nd;
+    return;
+  }
+  if (op == NTD_OP_MOON_POSITION) {
+    r->status = nt_moon_position_for_date(&nd, q->latitude, &r->u.moon_position);
+    return;
+  }
+  if (!(q->latitude >= -90.0 && q->latitude <= 90.0)) {
+    r->status = NT_ERR_RANGE;
+    return;
+  }
+  // Mustaches only depend on the UTC year and latitude (solstices at longitude 0).
+  int64_t k = (op == NTD_OP_MUSTACHES) ? utc_year_of(q->unix_ms) : nd.nadir;
+  double lon = (op == NTD_OP_MUSTACHES) ? 0.0 : nd.longitude;
+  ntd_counters* st = &g_stats[op - 1];
+  if (cache_get(op, k, lon, q->latitude, r)) {
+    atomic_fetch_add(&st->hits, 1);
+    return;
+  }
+  atomic_fetch_add(&st->misses, 1);
+  switch (op) {
+    case NTD_OP_SUN_EVENTS: r->status = nt_sun_events_for_date(&nd, q->latitude, &r->u.sun); break;
+    case NTD_OP_MOON_EVENTS: r->status = nt_moon_events_for_date(&nd, q->latitude, &r->u.moon_events); break;
+    case NTD_OP_MUSTACHES: r->status = nt_mustaches_range(&nd, q->latitude, &r->u.mustaches); break;
+    default: r->status = NT_ERR_INTERNAL; break;
+  }
+  if (r->status == NT_OK) cache_put(op, k, lon, q->latitude, r);
+}
+
+// -------------------------
+// Job and completion queues
+// -------------------------
+
+typedef struct ntd_job {
+  struct ntd_job* next;
+  int conn;            // connection slot
+  uint32_t gen;        // slot generation (responses to closed connections are dropped)
+  uint32_t id;
+  int op;
+  int64_t t_recv_us;
+  size_t count;
+  unsigned char* out;  // encoded response (filled by the worker)
+  size_t out_len;
+  ntd_query queries[]; // count entries
+} ntd_job;
+
+typedef struct {
+  pthread_mutex_t mu;
+  pthread_cond_t cv;
+  ntd_job *head, *tail;
+  int stop;
+} ntd_job_queue;
+
+static ntd_job_queue g_jobs = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, NULL, 0};
+static pthread_mutex_t g_done_mu = PTHREAD_MUTEX_INITIALIZER;
+static ntd_job *g_done_head, *g_done_tail;
+static int g_wake[2] = {-1, -1};
+static volatile sig_atomic_t g_quit = 0;
+
+static void job_push(ntd_job_queue* q, ntd_job* j) {
+  j->next = NULL;
+  pthread_mutex_lock(&q->mu);
+  if (q->tail) q->tail->next = j; else q->head = j;
+  q->tail = j;
+  pthread_cond_signal(&q->cv);
+  pthread_mutex_unlock(&q->mu);
+}
+
+static void wake_loop(void) {
+  const char b = 1;
+  ssize_t w = write(g_wake[1], &b, 1);  // pipe full = loop already woken
+  (void)w;
+}
+
+static void encode_response(ntd_job* j, const ntd_result* res) {
+  size_t rs = ntd_wire_record_size(j->op);
+  j->out_len = NTD_HEADER_SIZE + j->count * (8 + rs);
+  j->out = (unsigned char*)malloc(j->out_len);
+  if (!j->out) {
+    j->out_len = 0;
+    return;
+  }
+  ntd_header h = {NTD_PROTOCOL_VERSION, (uint32_t)(j->count * (8 + rs)), j->id, (uint16_t)j->op, (uint16_t)j->count, NT_OK};
+  ntd_put_header(j->out, &h);
+  for (size_t i = 0; i < j->count; ++i) {
+    unsigned char* p = j->out + NTD_HEADER_SIZE + i * (8 + rs);
+    ntd_put_u32(p, (uint32_t)res[i].status);
+    ntd_put_u32(p + 4, 0);
+    if (res[i].status == NT_OK) ntd_put_record(p + 8, j->op, &res[i]); else memset(p + 8, 0, rs);
+  }
+}
+
+static void* worker_main(void* arg) {
+  (void)arg;
+  ntd_result* res = (ntd_result*)malloc(NTD_MAX_BATCH * sizeof(ntd_result));
+  if (!res) return NULL;
+  for (;;) {
+    pthread_mutex_lock(&g_jobs.mu);
+    while (!g_jobs.head && !g_jobs.stop) pthread_cond_wait(&g_jobs.cv, &g_jobs.mu);
+    ntd_job* j = g_jobs.head;
+    if (j) {
+      g_jobs.head = j->next;
+      if (!g_jobs.head) g_jobs.tail = NULL;
+    }
+    pthread_mutex_unlock(&g_jobs.mu);
+    if (!j) break;
+
+    for (size_t i = 0; i < j->count; ++i) evaluate(j->op, &j->queries[i], &res[i]);
+    encode_response(j, res);
+    ntd_counters* st = &g_stats[j->op - 1];
+    atomic_fetch_add(&st->frames, 1);
+    atomic_fetch_add(&st->items, j->count);
+    record_latency(j->op, now_us() - j->t_recv_us);
+
+    j->next = NULL;
+    pthread_mutex_lock(&g_done_mu);
+    if (g_done_tail) g_done_tail->next = j; else g_done_head = j;
+    g_done_tail = j;
+    pthread_mutex_unlock(&g_done_mu);
+    wake_loop();
+  }
+  free(res);
+  return NULL;
+}
+
+// -------------------------
+// Connections
+// -------------------------
+
+typedef struct {
+  int fd;              // -1 when free
+  uint32_t gen;
+  int inflight;
+  int closing;         // stop reading; close once in-flight jobs are answered and sent
+  unsigned char* in;
+  size_t in_len, in_cap;
+  unsigned char* out;
+  size_t out_off, out_len, out_cap;
+} ntd_conn;
+
+static ntd_conn g_conns[NTD_MAX_CONNS];
+
+// Backpressure: a client that stops reading its responses stops being read, so
+// neither the in-flight jobs nor the unsent output grow past their caps.
+static int conn_accepts_frames(const ntd_conn* c) {
+  return c->inflight < NTD_MAX_INFLIGHT && c->out_len - c->out_off <= NTD_MAX_PENDING_OUT;
+}
+
+static int out_append(ntd_conn* c, const unsigned char* p, size_t n) {
+  if (c->out_off > 0 && c->out_off == c->out_len) c->out_off = c->out_len = 0;
+  if (c->out_len + n > c->out_cap) {
+    size_t cap = c->out_cap ? c->out_cap : 4096;
+    while (cap < c->out_len + n) cap *= 2;
+    unsigned char* q = (unsigned char*)realloc(c->out, cap);
+    if (!q) return 0;
+    c->out = q;
+    c->out_cap = cap;
+  }
+  memcpy(c->out + c->out_len, p, n);
+  c->out_len += n;
+  return 1;
+}
+
+static void conn_close(ntd_conn* c) {
+  close(c->fd);
+  c->fd = -1;
+  c->gen++;
+  c->closing = 0;
+  c->in_len = c->out_len = c->out_off = 0;
+  // Buffers are kept for the next connection in this slot; in-flight jobs are dropped on completion.
+}
+
+// Replies return 0 when the output buffer cannot grow; the caller then closes
+// the connection, since the client would otherwise wait for the response forever.
+static int reply_status(ntd_conn* c, uint32_t id, int op, nt_err status) {
+  unsigned char hb[NTD_HEADER_SIZE];
+  ntd_header h = {NTD_PROTOCOL_VERSION, 0, id, (uint16_t)op, 0, status};
+  ntd_put_header(hb, &h);
+  return out_append(c, hb, sizeof(hb));
+}
+
+static int reply_stats(ntd_conn* c, uint32_t id) {
+  enum { WORDS = 4 + NTD_HIST_BUCKETS };
+  unsigned char buf[NTD_HEADER_SIZE + 8 + NTD_QUERY_OPS * WORDS * 8];
+  ntd_header h = {NTD_PROTOCOL_VERSION, (uint32_t)(sizeof(buf) - NTD_HEADER_SIZE), id, NTD_OP_STATS, 0, NT_OK};
+  ntd_put_header(buf, &h);
+  unsigned char* p = buf + NTD_HEADER_SIZE;
+  ntd_put_u32(p, NTD_QUERY_OPS);
+  ntd_put_u32(p + 4, NTD_HIST_BUCKETS);
+  p += 8;
+  for (int o = 0; o < NTD_QUERY_OPS; ++o) {
+    ntd_counters* s = &g_stats[o];
+    uint64_t head[4] = {atomic_load(&s->frames), atomic_load(&s->items), atomic_load(&s->hits), atomic_load(&s->misses)};
+    for (int k = 0; k < 4; ++k, p += 8) ntd_put_u64(p, head[k]);
+    for (int b = 0; b < NTD_HIST_BUCKETS; ++b, p += 8) ntd_put_u64(p, atomic_load(&s->hist[b]));
+  }
+  return out_append(c, buf, sizeof(buf));
+}
+
+// Parses every complete frame in the input buffer. Returns 0 when framing is
+// broken or a reply cannot be queued, and the connection must be closed.
+static int conn_parse(int slot) {
+  ntd_conn* c = &g_conns[slot];
+  if (c->closing) {
+    c->in_len = 0;
+    return 1;
+  }
+  size_t off = 0;
+  while (c->in_len - off >= NTD_HEADER_SIZE && conn_accepts_frames(c)) {
+    ntd_header h;
+    ntd_get_header(c->in + off, &h);
+    if (h.version != NTD_PROTOCOL_VERSION) {
+      // The rest of the stream uses a layout we do not know: refuse and hang up.
+      if (!reply_status(c, h.id, h.op, NT_ERR_RANGE)) return 0;
+      c->closing = 1;
+      c->in_len = 0;
+      return 1;
+    }
+    if (h.payload_len > NTD_MAX_BATCH * NTD_QUERY_SIZE) return 0;
+    if (c->in_len - off < NTD_HEADER_SIZE + h.payload_len) break;
+    const unsigned char* payload = c->in + off + NTD_HEADER_SIZE;
+    off += NTD_HEADER_SIZE + h.payload_len;
+
+    if (h.op == NTD_OP_STATS) {
+      if (!reply_stats(c, h.id)) return 0;
+      continue;
+    }
+    if (ntd_wire_record_size(h.op) == 0 || h.payload_len != (uint32_t)h.count * NTD_QUERY_SIZE) {
+      if (!reply_status(c, h.id, h.op, NT_ERR_RANGE)) return 0;
+      continue;
+    }
+    ntd_job* j = (ntd_job*)malloc(sizeof(ntd_job) + h.count * sizeof(ntd_query));
+    if (!j) {
+      if (!reply_status(c, h.id, h.op, NT_ERR_INTERNAL)) return 0;
+      continue;
+    }
+    j->conn = slot;
+    j->gen = c->gen;
+    j->id = h.id;
+    j->op = h.op;
+    j->count = h.count;
+    j->out = NULL;
+    j->out_len = 0;
+    j->t_recv_us = now_us();
+    for (size_t i = 0; i < h.count; ++i) ntd_get_query(payload + i * NTD_QUERY_SIZE, &j->queries[i]);
+    c->inflight++;
+    job_push(&g_jobs, j);
+  }
+  memmove(c->in, c->in + off, c->in_len - off);
+  c->in_len -= off;
+  return 1;
+}
+
+static int conn_read(int slot) {
+  ntd_conn* c = &g_conns[slot];
+  if (c->in_len + NTD_READ_SIZE > c->in_cap) {
+    size_t cap = c->in_len + NTD_READ_SIZE;
+    unsigned char* p = (unsigned char*)realloc(c->in, cap);
+    if (!p) return 0;
+    c->in = p;
+    c->in_cap = cap;
+  }
+  ssize_t r = read(c->fd, c->in + c->in_len, NTD_READ_SIZE);
+  if (r < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) return 1;
+  if (r <= 0) return 0;
+  c->in_len += (size_t)r;
+  return conn_parse(slot);
+}
+
+static int conn_flush(ntd_conn* c) {
+  while (c->out_off < c->out_len) {
+    ssize_t w = send(c->fd, c->out + c->out_off, c->out_len - c->out_off, MSG_NOSIGNAL);
+    if (w < 0 && errno == EINTR) continue;
+    if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 1;
+    if (w <= 0) return 0;
+    c->out_off += (size_t)w;
+  }
+  c->out_off = c->out_len = 0;
+  return 1;
+}
+
+static void drain_completions(void) {
+  char tmp[256];
+  while (read(g_wake[0], tmp, sizeof(tmp)) > 0) {}
+  pthread_mutex_lock(&g_done_mu);
+  ntd_job* j = g_done_head;
+  g_done_head = g_done_tail = NULL;
+  pthread_mutex_unlock(&g_done_mu);
+  while (j) {
+    ntd_job* next = j->next;
+    ntd_conn* c = &g_conns[j->conn];
+    if (c->fd >= 0 && c->gen == j->gen) {
+      c->inflight--;
+      // A response that cannot be queued becomes an error status; if even that fails, hang up.
+      int queued = j->out && out_append(c, j->out, j->out_len);
+      if (!queued) queued = reply_status(c, j->id, j->op, NT_ERR_INTERNAL);
+      // Frames held back by backpressure can now be dispatched.
+      if (!queued || !conn_parse(j->conn)) conn_close(c);
+    }
+    free(j->out);
+    free(j);
+    j = next;
+  }
+}
+
+static void on_signal(int sig) {
+  (void)sig;
+  g_quit = 1;
+  wake_loop();
+}
+
+static void set_nonblocking(int fd) {
+  int fl = fcntl(fd, F_GETFL, 0);
+  fcntl(fd, F_SETFL, fl | O_NONBLOCK);
+  fcntl(fd, F_SETFD, FD_CLOEXEC);
+}
+
+static void usage(void) {
+  fprintf(stderr,
+    "usage: ntd [options]\n"
+    "  -s, --socket PATH      Unix socket path (default " NTD_DEFAULT_SOCKET ")\n"
+    "  -j, --workers N        worker threads (default: online CPUs)\n"
+    "      --cache-slots N    shared cache entries per shard (x%d shards, default 1024)\n",
+    NTD_CACHE_SHARDS);
+}
+
+int main(int argc, char** argv) {
+  const char* path = NTD_DEFAULT_SOCKET;
+  int workers = 1;
+#if defined(_SC_NPROCESSORS_ONLN)
+  long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+  if (ncpu > 1) workers = (int)ncpu;
+#endif
+  for (int i = 1; i < argc; ++i) {
+    const char* a = argv[i];
+    const char* v = (i + 1 < argc) ? argv[i + 1] : NULL;
+    if ((!strcmp(a, "-s") || !strcmp(a, "--socket")) && v) { path = v; ++i; }
+    else if ((!strcmp(a, "-j") || !strcmp(a, "--workers")) && v) { workers = atoi(v); ++i; }
+    else if (!strcmp(a, "--cache-slots") && v) { g_cache_slots = (size_t)strtoul(v, NULL, 10); ++i; }
+    else { usage(); return (!strcmp(a, "-h") || !strcmp(a, "--help")) ? 0 : 1; }
+  }
+  if (workers < 1) workers = 1;
+  if (g_cache_slots < 1) g_cache_slots = 1;
+
+  for (int s = 0; s < NTD_CACHE_SHARDS; ++s) {
+    pthread_mutex_init(&g_cache[s].mu, NULL);
+    g_cache[s].slots = (ntd_cache_entry*)calloc(g_cache_slots, sizeof(ntd_cache_entry));
+    if (!g_cache[s].slots) { fprintf(stderr, "ntd: out of memory\n"); return 2; }
+  }
+  for (int i = 0; i < NTD_MAX_CONNS; ++i) g_conns[i].fd = -1;
+
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(addr.sun_path)) { fprintf(stderr, "ntd: socket path too long\n"); return 1; }
+  strcpy(addr.sun_path, path);
+  int lfd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (lfd < 0) { perror("ntd: socket"); return 1; }
+  unlink(path);
+  if (bind(lfd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(lfd, 128) != 0) {
+    fprintf(stderr, "ntd: cannot listen on %s: %s\n", path, strerror(errno));
+    return 1;
+  }
+  set_nonblocking(lfd);
+  if (pipe(g_wake) != 0) { perror("ntd: pipe"); return 1; }
+  set_nonblocking(g_wake[0]);
+  set_nonblocking(g_wake[1]);
+
+  signal(SIGPIPE, SIG_IGN);
+  signal(SIGINT, on_signal);
+  signal(SIGTERM, on_signal);
+
+  pthread_t* th = (pthread_t*)calloc((size_t)workers, sizeof(pthread_t));
+  if (!th) return 2;
+  int started = 0;
+  while (started < workers && pthread_create(&th[started], NULL, worker_main, NULL) == 0) ++started;
+  if (started < workers) {
+    fprintf(stderr, "ntd: cannot start worker threads\n");
+    g_quit = 1;
+  }
+
+  struct pollfd* pfd = (struct pollfd*)calloc(NTD_MAX_CONNS + 2, sizeof(struct pollfd));
+  int* slot_of = (int*)calloc(NTD_MAX_CONNS + 2, sizeof(int));
+  if (!pfd || !slot_of) return 2;
+  while (!g_quit) {
+    int n = 0;
+    pfd[n++] = (struct pollfd){g_wake[0], POLLIN, 0};
+    pfd[n++] = (struct pollfd){lfd, POLLIN, 0};
+    for (int i = 0; i < NTD_MAX_CONNS; ++i) {
+      ntd_conn* c = &g_conns[i];
+      if (c->fd < 0) continue;
+      short ev = 0;
+      if (conn_accepts_frames(c) && !c->closing) ev |= POLLIN;
+      if (c->out_off < c->out_len) ev |= POLLOUT;
+      slot_of[n] = i;
+      pfd[n++] = (struct pollfd){c->fd, ev, 0};
+    }
+    if (poll(pfd, (nfds_t)n, -1) < 0) {
+      if (errno == EINTR) continue;
+      perror("ntd: poll");
+      break;
+    }
+    if (pfd[0].revents) drain_completions();
+    if (pfd[1].revents & POLLIN) {
+      int fd;
+      while ((fd = accept(lfd, NULL, NULL)) >= 0) {
+        int slot = -1;
+        for (int i = 0; i < NTD_MAX_CONNS && slot < 0; ++i) if (g_conns[i].fd < 0) slot = i;
+        if (slot < 0) { close(fd); continue; }
+        set_nonblocking(fd);
+        g_conns[slot].fd = fd;
+        g_conns[slot].inflight = 0;
+        g_conns[slot].closing = 0;
+      }
+    }
+    for (int k = 2; k < n; ++k) {
+      ntd_conn* c = &g_conns[slot_of[k]];
+      if (c->fd != pfd[k].fd) continue;  // closed earlier in this pass
+      short re = pfd[k].revents;
+      if ((re & (POLLIN | POLLHUP | POLLERR)) && !conn_read(slot_of[k])) { conn_close(c); continue; }
+      if (c->out_off < c->out_len && !conn_flush(c)) { conn_close(c); continue; }
+      // Frames held back while the output was full can now be dispatched.
+      if (c->in_len >= NTD_HEADER_SIZE && (re & POLLOUT) && !conn_parse(slot_of[k])) { conn_close(c); continue; }
+      if (c->closing && c->inflight == 0 && c->out_off == c->out_len) conn_close(c);
+    }
+  }
+
+  pthread_mutex_lock(&g_jobs.mu);
+  g_jobs.stop = 1;
+  pthread_cond_broadcast(&g_jobs.cv);
+  pthread_mutex_unlock(&g_jobs.mu);
+  for (int i = 0; i < started; ++i) pthread_join(th[i], NULL);
+  for (int i = 0; i < NTD_MAX_CONNS; ++i) if (g_conns[i].fd >= 0) close(g_conns[i].fd);
+  close(lfd);
+  unlink(path);
+  return (started < workers) ? 2 : 0;
+}
@@ -0,0 +1,198 @@
+// ntd — blocking C client (see ntd_client.h for the protocol).
+#include "ntd_wire.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // macOS: SO_NOSIGPIPE is set on the socket instead
+#endif
+
+struct ntd_client {
+  int fd;
+  unsigned char* out;   // pending request frames
+  size_t out_len, out_cap;
+  unsigned char* in;    // current response payload
+  size_t in_cap;
+};
+
+size_t ntd_record_size(int op) { return ntd_wire_record_size(op); }
+
+uint64_t ntd_latency_quantile_us(const ntd_op_stats* s, double q) {
+  uint64_t total = 0;
+  for (int i = 0; i < NTD_HIST_BUCKETS; ++i) total += s->hist[i];
+  if (total == 0) return 0;
+  uint64_t rank = (uint64_t)(q * (double)total);
+  if (rank >= total) rank = total - 1;
+  uint64_t seen = 0;
+  for (int i = 0; i < NTD_HIST_BUCKETS; ++i) {
+    seen += s->hist[i];
+    if (seen > rank) return 2ULL << i;
+  }
+  return 2ULL << (NTD_HIST_BUCKETS - 1);
+}
+
+ntd_client* ntd_client_connect(const char* socket_path) {
+  if (!socket_path) socket_path = NTD_DEFAULT_SOCKET;
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen(socket_path) >= sizeof(addr.sun_path)) return NULL;
+  strcpy(addr.sun_path, socket_path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) return NULL;
+#ifdef SO_NOSIGPIPE
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+  if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+    close(fd);
+    return NULL;
+  }
+  ntd_client* c = (ntd_client*)calloc(1, sizeof(ntd_client));
+  if (!c) {
+    close(fd);
+    return NULL;
+  }
+  c->fd = fd;
+  return c;
+}
+
+void ntd_client_close(ntd_client* c) {
+  if (!c) return;
+  close(c->fd);
+  free(c->out);
+  free(c->in);
+  free(c);
+}
+
+static int write_all(int fd, const unsigned char* p, size_t n) {
+  while (n > 0) {
+    ssize_t w = send(fd, p, n, MSG_NOSIGNAL);
+    if (w < 0 && errno == EINTR) continue;
+    if (w <= 0) return 0;
+    p += w;
+    n -= (size_t)w;
+  }
+  return 1;
+}
+
+static int read_all(int fd, unsigned char* p, size_t n) {
+  while (n > 0) {
+    ssize_t r = read(fd, p, n);
+    if (r < 0 && errno == EINTR) continue;
+    if (r <= 0) return 0;
+    p += r;
+    n -= (size_t)r;
+  }
+  return 1;
+}
+
+nt_err ntd_client_send(ntd_client* c, uint32_t id, int op, const ntd_query* queries, size_t count) {
+  if (!c || (count > 0 && !queries)) return NT_ERR_INTERNAL;
+  if (count > NTD_MAX_BATCH) return NT_ERR_RANGE;
+  size_t need = NTD_HEADER_SIZE + count * NTD_QUERY_SIZE;
+  if (c->out_len + need > c->out_cap) {
+    size_t cap = c->out_cap ? c->out_cap : 4096;
+    while (cap < c->out_len + need) cap *= 2;
+    unsigned char* p = (unsigned char*)realloc(c->out, cap);
+    if (!p) return NT_ERR_INTERNAL;
+    c->out = p;
+    c->out_cap = cap;
+  }
+  unsigned char* p = c->out + c->out_len;
+  ntd_header h = {NTD_PROTOCOL_VERSION, (uint32_t)(count * NTD_QUERY_SIZE), id, (uint16_t)op, (uint16_t)count, 0};
+  ntd_put_header(p, &h);
+  for (size_t i = 0; i < count; ++i) ntd_put_query(p + NTD_HEADER_SIZE + i * NTD_QUERY_SIZE, &queries[i]);
+  c->out_len += need;
+  return NT_OK;
+}
+
+static nt_err flush_requests(ntd_client* c) {
+  if (c->out_len == 0) return NT_OK;
+  int ok = write_all(c->fd, c->out, c->out_len);
+  c->out_len = 0;
+  return ok ? NT_OK : NT_ERR_INTERNAL;
+}
+
+// Reads one frame into c->in; returns the header. NT_ERR_RANGE for a frame of
+// another protocol version (its layout cannot be trusted, so nothing more is read).
+static nt_err read_frame(ntd_client* c, ntd_header* h) {
+  unsigned char hb[NTD_HEADER_SIZE];
+  if (!read_all(c->fd, hb, sizeof(hb))) return NT_ERR_INTERNAL;
+  ntd_get_header(hb, h);
+  if (h->version != NTD_PROTOCOL_VERSION) return NT_ERR_RANGE;
+  if (h->payload_len > c->in_cap) {
+    unsigned char* p = (unsigned char*)realloc(c->in, h->payload_len);
+    if (!p) return NT_ERR_INTERNAL;
+    c->in = p;
+    c->in_cap = h->payload_len;
+  }
+  if (h->payload_len > 0 && !read_all(c->fd, c->in, h->payload_len)) return NT_ERR_INTERNAL;
+  return NT_OK;
+}
+
+nt_err ntd_client_recv(ntd_client* c, uint32_t* out_id, ntd_result* out, size_t capacity, size_t* out_count) {
+  if (!c || !out_id || !out_count) return NT_ERR_INTERNAL;
+  if (flush_requests(c) != NT_OK) return NT_ERR_INTERNAL;
+  ntd_header h;
+  nt_err e = read_frame(c, &h);
+  if (e != NT_OK) return e;
+  *out_id = h.id;
+  *out_count = h.count;
+  if (h.status != NT_OK) return (nt_err)h.status;
+  size_t rs = ntd_wire_record_size(h.op);
+  if (rs == 0 || h.count > capacity || h.payload_len != h.count * (8 + rs)) return NT_ERR_INTERNAL;
+  for (size_t i = 0; i < h.count; ++i) {
+    const unsigned char* p = c->in + i * (8 + rs);
+    memset(&out[i], 0, sizeof(out[i]));
+    out[i].status = (nt_err)(int32_t)ntd_get_u32(p);
+    if (out[i].status == NT_OK) ntd_get_record(p + 8, h.op, &out[i]);
+  }
+  return NT_OK;
+}
+
+nt_err ntd_client_query(ntd_client* c, int op, const ntd_query* queries, size_t count, ntd_result* out) {
+  static const uint32_t id = 1;
+  nt_err e = ntd_client_send(c, id, op, queries, count);
+  if (e != NT_OK) return e;
+  uint32_t got_id;
+  size_t got;
+  e = ntd_client_recv(c, &got_id, out, count, &got);
+  if (e != NT_OK) return e;
+  return (got_id == id && got == count) ? NT_OK : NT_ERR_INTERNAL;
+}
+
+nt_err ntd_client_stats(ntd_client* c, ntd_stats* out) {
+  if (!c || !out) return NT_ERR_INTERNAL;
+  nt_err e = ntd_client_send(c, 0, NTD_OP_STATS, NULL, 0);
+  if (e != NT_OK || flush_requests(c) != NT_OK) return NT_ERR_INTERNAL;
+  ntd_header h;
+  e = read_frame(c, &h);
+  if (e != NT_OK) return e;
+  if (h.op != NTD_OP_STATS || h.status != NT_OK || h.payload_len < 8) return NT_ERR_INTERNAL;
+  uint32_t ops = ntd_get_u32(c->in);
+  uint32_t buckets = ntd_get_u32(c->in + 4);
+  if (h.payload_len != 8 + (size_t)ops * (4 + buckets) * 8) return NT_ERR_INTERNAL;
+  memset(out, 0, sizeof(*out));
+  const unsigned char* p = c->in + 8;
+  for (uint32_t o = 0; o < ops; ++o) {
+    ntd_op_stats* s = (o < NTD_QUERY_OPS) ? &out->ops[o] : NULL;
+    uint64_t v[4];
+    for (int k = 0; k < 4; ++k, p += 8) v[k] = ntd_get_u64(p);
+    if (s) {
+      s->frames = v[0];
+      s->items = v[1];
+      s->cache_hits = v[2];
+      s->cache_misses = v[3];
+    }
+    for (uint32_t b = 0; b < buckets; ++b, p += 8) {
+      if (s && b < NTD_HIST_BUCKETS) s->hist[b] = ntd_get_u64(p);
+    }
+  }
+  return NT_OK;
+}
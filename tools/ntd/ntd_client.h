@@ -0,0 +1,108 @@
+// ntd — Natural Time query daemon: wire protocol and C client.
+//
+// The daemon serves the public API over a Unix domain socket so that several
+// local processes share one set of warm caches. Frames are little-endian and
+// fixed-layout, easy to speak from any language:
+//
+//   request  header (20 bytes): u16 version, u16 op, u32 payload_len, u32 id, u16 count, u16 0, u32 flags (0)
+//            payload: count × query { i64 unix_ms, f64 longitude, f64 latitude }  (24 bytes each)
+//   response header (20 bytes): u16 version, u16 op, u32 payload_len, u32 id, u16 count, u16 0, i32 status
+//            payload: count × { i32 status, u32 0, record }   (record size per op below)
+//
+// `version` is NTD_PROTOCOL_VERSION on both sides. The daemon answers a frame
+// of another version with an empty NT_ERR_RANGE response and closes the
+// connection; the client fails with NT_ERR_RANGE on a response of another
+// version. A connection may pipeline any number of requests; responses carry
+// the request id and can arrive out of order. `count` queries in one frame form
+// a batch answered by a single response in query order.
+#ifndef NTD_CLIENT_H
+#define NTD_CLIENT_H
+
+#include "natural_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NTD_DEFAULT_SOCKET "/tmp/ntd.sock"
+#define NTD_PROTOCOL_VERSION 1
+#define NTD_HEADER_SIZE 20
+#define NTD_QUERY_SIZE 24
+#define NTD_MAX_BATCH 4096
+#define NTD_HIST_BUCKETS 32   // bucket i: latency in [2^i, 2^(i+1)) µs (bucket 0 also holds < 1 µs)
+
+typedef enum {
+  NTD_OP_DATE          = 1,  // record: i32 year, moon, week, week_of_moon, day, day_of_year, day_of_moon,
+                             //   day_of_week, is_rainbow_day, year_duration; i64 unix_time, year_start, nadir;
+                             //   f64 longitude, time_deg (80 bytes)
+  NTD_OP_SUN_EVENTS    = 2,  // record: nt_sun_events as 6 × f64, u16 horizon/night/golden regime, u16 0 (56 bytes)
+  NTD_OP_MOON_POSITION = 3,  // record: nt_moon_position as 2 × f64 (16 bytes)
+  NTD_OP_MOON_EVENTS   = 4,  // record: nt_moon_events as 3 × f64, u32 horizon regime, u32 0 (32 bytes)
+  NTD_OP_MUSTACHES     = 5,  // record: nt_mustaches as 5 × f64 (40 bytes)
+  NTD_OP_STATS         = 16  // count 0; payload: u32 ops (5), u32 buckets, then per op 1..5:
+                             //   u64 frames, items, cache_hits, cache_misses, hist[buckets]
+} ntd_op;
+
+#define NTD_QUERY_OPS 5
+
+// Size in bytes of one result record for `op` (0 for unknown ops).
+size_t ntd_record_size(int op);
+
+typedef struct {
+  int64_t unix_ms;
+  double  longitude;
+  double  latitude;   // ignored by NTD_OP_DATE
+} ntd_query;
+
+typedef struct {
+  nt_err status;
+  union {
+    nt_natural_date  date;
+    nt_sun_events    sun;
+    nt_moon_position moon_position;
+    nt_moon_events   moon_events;
+    nt_mustaches     mustaches;
+  } u;
+} ntd_result;
+
+typedef struct {
+  uint64_t frames;
+  uint64_t items;
+  uint64_t cache_hits;
+  uint64_t cache_misses;
+  uint64_t hist[NTD_HIST_BUCKETS];
+} ntd_op_stats;
+
+typedef struct {
+  ntd_op_stats ops[NTD_QUERY_OPS];  // index = op - 1
+} ntd_stats;
+
+// Upper bound (µs) of the bucket holding quantile q (0..1) of the histogram; 0 when empty.
+uint64_t ntd_latency_quantile_us(const ntd_op_stats* s, double q);
+
+typedef struct ntd_client ntd_client;
+
+// Blocking client. One client per thread; requests may be pipelined with
+// ntd_client_send/ntd_client_recv. NULL socket_path selects NTD_DEFAULT_SOCKET.
+ntd_client* ntd_client_connect(const char* socket_path);
+void ntd_client_close(ntd_client* c);
+
+// Queues one request frame (flushed by ntd_client_recv). NT_ERR_RANGE when count > NTD_MAX_BATCH.
+nt_err ntd_client_send(ntd_client* c, uint32_t id, int op, const ntd_query* queries, size_t count);
+
+// Flushes pending requests and reads the next response. `out` must hold the
+// count of the matching request; *out_id/*out_count identify it. NT_ERR_RANGE
+// when the daemon speaks another protocol version (or refused ours).
+nt_err ntd_client_recv(ntd_client* c, uint32_t* out_id, ntd_result* out, size_t capacity, size_t* out_count);
+
+// Round trip for one batch.
+nt_err ntd_client_query(ntd_client* c, int op, const ntd_query* queries, size_t count, ntd_result* out);
+
+// Daemon-wide counters and latency histograms; call with no responses outstanding.
+nt_err ntd_client_stats(ntd_client* c, ntd_stats* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NTD_CLIENT_H
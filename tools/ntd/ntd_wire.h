@@ -0,0 +1,181 @@
+// ntd — little-endian encoding of frames and result records (shared by the
+// daemon and the C client; layout documented in ntd_client.h).
+#ifndef NTD_WIRE_H
+#define NTD_WIRE_H
+
+#include "ntd_client.h"
+#include <string.h>
+
+static inline void ntd_put_u16(unsigned char* p, uint16_t v) { p[0] = (unsigned char)v; p[1] = (unsigned char)(v >> 8); }
+static inline void ntd_put_u32(unsigned char* p, uint32_t v) { for (int i = 0; i < 4; ++i) p[i] = (unsigned char)(v >> (8 * i)); }
+static inline void ntd_put_u64(unsigned char* p, uint64_t v) { for (int i = 0; i < 8; ++i) p[i] = (unsigned char)(v >> (8 * i)); }
+static inline void ntd_put_f64(unsigned char* p, double d) { uint64_t v; memcpy(&v, &d, 8); ntd_put_u64(p, v); }
+
+static inline uint16_t ntd_get_u16(const unsigned char* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t ntd_get_u32(const unsigned char* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static inline uint64_t ntd_get_u64(const unsigned char* p) { return (uint64_t)ntd_get_u32(p) | ((uint64_t)ntd_get_u32(p + 4) << 32); }
+static inline double ntd_get_f64(const unsigned char* p) { uint64_t v = ntd_get_u64(p); double d; memcpy(&d, &v, 8); return d; }
+
+typedef struct {
+  uint16_t version;  // NTD_PROTOCOL_VERSION
+  uint32_t payload_len;
+  uint32_t id;
+  uint16_t op;
+  uint16_t count;
+  int32_t  status;  // requests: flags (0)
+} ntd_header;
+
+static inline void ntd_put_header(unsigned char* p, const ntd_header* h) {
+  ntd_put_u16(p, h->version);
+  ntd_put_u16(p + 2, h->op);
+  ntd_put_u32(p + 4, h->payload_len);
+  ntd_put_u32(p + 8, h->id);
+  ntd_put_u16(p + 12, h->count);
+  ntd_put_u16(p + 14, 0);
+  ntd_put_u32(p + 16, (uint32_t)h->status);
+}
+
+static inline void ntd_get_header(const unsigned char* p, ntd_header* h) {
+  h->version = ntd_get_u16(p);
+  h->op = ntd_get_u16(p + 2);
+  h->payload_len = ntd_get_u32(p + 4);
+  h->id = ntd_get_u32(p + 8);
+  h->count = ntd_get_u16(p + 12);
+  h->status = (int32_t)ntd_get_u32(p + 16);
+}
+
+static inline size_t ntd_wire_record_size(int op) {
+  switch (op) {
+    case NTD_OP_DATE: return 80;
+    case NTD_OP_SUN_EVENTS: return 56;
+    case NTD_OP_MOON_POSITION: return 16;
+    case NTD_OP_MOON_EVENTS: return 32;
+    case NTD_OP_MUSTACHES: return 40;
+    default: return 0;
+  }
+}
+
+static inline void ntd_put_query(unsigned char* p, const ntd_query* q) {
+  ntd_put_u64(p, (uint64_t)q->unix_ms);
+  ntd_put_f64(p + 8, q->longitude);
+  ntd_put_f64(p + 16, q->latitude);
+}
+
+static inline void ntd_get_query(const unsigned char* p, ntd_query* q) {
+  q->unix_ms = (int64_t)ntd_get_u64(p);
+  q->longitude = ntd_get_f64(p + 8);
+  q->latitude = ntd_get_f64(p + 16);
+}
+
+// Leading f64 fields of the non-date records (sun/moon events append their regimes).
+static inline size_t ntd_record_doubles(int op) {
+  switch (op) {
+    case NTD_OP_SUN_EVENTS: return 6;
+    case NTD_OP_MOON_POSITION: return 2;
+    case NTD_OP_MOON_EVENTS: return 3;
+    case NTD_OP_MUSTACHES: return 5;
+    default: return 0;
+  }
+}
+
+// f64 fields in wire order.
+static inline size_t ntd_record_to_doubles(int op, const ntd_result* r, double v[6]) {
+  switch (op) {
+    case NTD_OP_SUN_EVENTS: {
+      const nt_sun_events* s = &r->u.sun;
+      v[0] = s->sunrise_deg; v[1] = s->sunset_deg; v[2] = s->night_start_deg;
+      v[3] = s->night_end_deg; v[4] = s->morning_golden_deg; v[5] = s->evening_golden_deg;
+      return 6;
+    }
+    case NTD_OP_MOON_POSITION: v[0] = r->u.moon_position.altitude; v[1] = r->u.moon_position.phase_deg; return 2;
+    case NTD_OP_MOON_EVENTS:
+      v[0] = r->u.moon_events.moonrise_deg; v[1] = r->u.moon_events.moonset_deg; v[2] = r->u.moon_events.highest_altitude;
+      return 3;
+    case NTD_OP_MUSTACHES: {
+      const nt_mustaches* m = &r->u.mustaches;
+      v[0] = m->winter_sunrise_deg; v[1] = m->winter_sunset_deg; v[2] = m->summer_sunrise_deg;
+      v[3] = m->summer_sunset_deg; v[4] = m->average_angle_deg;
+      return 5;
+    }
+    default: return 0;
+  }
+}
+
+static inline void ntd_record_from_doubles(int op, const double v[6], ntd_result* r) {
+  switch (op) {
+    case NTD_OP_SUN_EVENTS: {
+      nt_sun_events* s = &r->u.sun;
+      s->sunrise_deg = v[0]; s->sunset_deg = v[1]; s->night_start_deg = v[2];
+      s->night_end_deg = v[3]; s->morning_golden_deg = v[4]; s->evening_golden_deg = v[5];
+      break;
+    }
+    case NTD_OP_MOON_POSITION: r->u.moon_position.altitude = v[0]; r->u.moon_position.phase_deg = v[1]; break;
+    case NTD_OP_MOON_EVENTS:
+      r->u.moon_events.moonrise_deg = v[0]; r->u.moon_events.moonset_deg = v[1]; r->u.moon_events.highest_altitude = v[2];
+      break;
+    case NTD_OP_MUSTACHES: {
+      nt_mustaches* m = &r->u.mustaches;
+      m->winter_sunrise_deg = v[0]; m->winter_sunset_deg = v[1]; m->summer_sunrise_deg = v[2];
+      m->summer_sunset_deg = v[3]; m->average_angle_deg = v[4];
+      break;
+    }
+    default: break;
+  }
+}
+
+static inline void ntd_put_record(unsigned char* p, int op, const ntd_result* r) {
+  if (op == NTD_OP_DATE) {
+    const nt_natural_date* d = &r->u.date;
+    const int32_t ints[10] = {d->year, d->moon, d->week, d->week_of_moon, d->day, d->day_of_year,
+                              d->day_of_moon, d->day_of_week, d->is_rainbow_day, d->year_duration};
+    for (int i = 0; i < 10; ++i) ntd_put_u32(p + 4 * i, (uint32_t)ints[i]);
+    ntd_put_u64(p + 40, (uint64_t)d->unix_time);
+    ntd_put_u64(p + 48, (uint64_t)d->year_start);
+    ntd_put_u64(p + 56, (uint64_t)d->nadir);
+    ntd_put_f64(p + 64, d->longitude);
+    ntd_put_f64(p + 72, d->time_deg);
+    return;
+  }
+  double v[6];
+  size_t n = ntd_record_to_doubles(op, r, v);
+  for (size_t i = 0; i < n; ++i) ntd_put_f64(p + 8 * i, v[i]);
+  if (op == NTD_OP_SUN_EVENTS) {
+    ntd_put_u16(p + 48, (uint16_t)r->u.sun.horizon_regime);
+    ntd_put_u16(p + 50, (uint16_t)r->u.sun.night_regime);
+    ntd_put_u16(p + 52, (uint16_t)r->u.sun.golden_regime);
+    ntd_put_u16(p + 54, 0);
+  } else if (op == NTD_OP_MOON_EVENTS) {
+    ntd_put_u32(p + 24, (uint32_t)r->u.moon_events.horizon_regime);
+    ntd_put_u32(p + 28, 0);
+  }
+}
+
+static inline void ntd_get_record(const unsigned char* p, int op, ntd_result* r) {
+  if (op == NTD_OP_DATE) {
+    nt_natural_date* d = &r->u.date;
+    int32_t* ints[10] = {&d->year, &d->moon, &d->week, &d->week_of_moon, &d->day, &d->day_of_year,
+                         &d->day_of_moon, &d->day_of_week, &d->is_rainbow_day, &d->year_duration};
+    for (int i = 0; i < 10; ++i) *ints[i] = (int32_t)ntd_get_u32(p + 4 * i);
+    d->unix_time = (int64_t)ntd_get_u64(p + 40);
+    d->year_start = (int64_t)ntd_get_u64(p + 48);
+    d->nadir = (int64_t)ntd_get_u64(p + 56);
+    d->longitude = ntd_get_f64(p + 64);
+    d->time_deg = ntd_get_f64(p + 72);
+    return;
+  }
+  double v[6];
+  size_t n = ntd_record_doubles(op);
+  for (size_t i = 0; i < n; ++i) v[i] = ntd_get_f64(p + 8 * i);
+  ntd_record_from_doubles(op, v, r);
+  if (op == NTD_OP_SUN_EVENTS) {
+    r->u.sun.horizon_regime = ntd_get_u16(p + 48);
+    r->u.sun.night_regime = ntd_get_u16(p + 50);
+    r->u.sun.golden_regime = ntd_get_u16(p + 52);
+  } else if (op == NTD_OP_MOON_EVENTS) {
+    r->u.moon_events.horizon_regime = (int32_t)ntd_get_u32(p + 24);
+  }
+}
+
+#endif // NTD_WIRE_H
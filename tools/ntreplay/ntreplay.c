@@ -0,0 +1,340 @@
+// ntreplay — replay a workload captured with nt_capture_start.
+//
+//   ntreplay [-j threads] [-r repeat] capture.ntcap
+//   ntreplay --anonymize grid_deg -o out.ntcap capture.ntcap
+//
+// Runs the recorded calls against this build, each worker starting with cold
+// caches, and reports throughput, latency percentiles per function and the
+// per-thread cache hit rates next to the ones seen while recording. With -j,
+// each recorded thread's calls stay in order on one worker (a trace with fewer
+// threads than workers is split into contiguous blocks instead).
+//
+// --anonymize snaps every latitude and longitude to a grid_deg grid and
+// renumbers the threads, for traces shared outside the team (nearby places
+// may then share cache entries they did not share before).
+#include "natural_time.h"
+#include "natural_time_capture.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define QUARTERS_CAP 64
+#define DAYS_CAP 400
+
+static const char* const CALL_NAMES[NT_CALL_KINDS] = {
+    "?",
+    "nt_make_natural_date",
+    "nt_make_natural_date_fixed",
+    "nt_sun_events_for_date",
+    "nt_sun_position_for_date",
+    "nt_moon_events_for_date",
+    "nt_moon_position_for_date",
+    "nt_mustaches_range",
+    "nt_moon_quarters_for_year",
+    "nt_moon_illumination_for_year",
+};
+
+enum { C_SEASONS, C_SUN, C_MUSTACHES, C_COUNT };
+static const char* const CACHE_NAMES[C_COUNT] = {"seasons", "sun events", "mustaches"};
+static const uint8_t CACHE_BITS[C_COUNT] = {NT_CACHE_HIT_SEASONS, NT_CACHE_HIT_SUN_EVENTS, NT_CACHE_HIT_MUSTACHES};
+
+typedef struct {
+  uint64_t hit_calls[C_COUNT];     // calls with at least one hit in the cache
+  uint64_t lookup_calls[C_COUNT];  // calls that looked it up at all
+} call_rates;
+
+typedef struct {
+  const nt_capture_record* records;
+  size_t* index;  // records this worker replays, in order
+  size_t count;
+  int repeat;
+  uint32_t* latency_ns;  // count * repeat
+  uint8_t* call;
+  uint64_t mismatches;   // status differs from the recorded one
+  call_rates rates;
+  nt_cache_stats lookups;
+} worker_t;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void count_rates(call_rates* r, uint8_t bits) {
+  for (int c = 0; c < C_COUNT; ++c) {
+    if (bits & (CACHE_BITS[c] | (CACHE_BITS[c] << 4))) r->lookup_calls[c]++;
+    if (bits & CACHE_BITS[c]) r->hit_calls[c]++;
+  }
+}
+
+static uint8_t cache_bits(const nt_cache_stats* a, const nt_cache_stats* b) {
+  uint8_t bits = 0;
+  if (b->seasons_hits > a->seasons_hits) bits |= NT_CACHE_HIT_SEASONS;
+  if (b->sun_events_hits > a->sun_events_hits) bits |= NT_CACHE_HIT_SUN_EVENTS;
+  if (b->mustaches_hits > a->mustaches_hits) bits |= NT_CACHE_HIT_MUSTACHES;
+  if (b->seasons_misses > a->seasons_misses) bits |= NT_CACHE_HIT_SEASONS << 4;
+  if (b->sun_events_misses > a->sun_events_misses) bits |= NT_CACHE_HIT_SUN_EVENTS << 4;
+  if (b->mustaches_misses > a->mustaches_misses) bits |= NT_CACHE_HIT_MUSTACHES << 4;
+  return bits;
+}
+
+// Calls taking a natural date get it rebuilt first, outside the timing.
+static nt_err replay_call(const nt_capture_record* r, uint32_t* ns, uint8_t* bits) {
+  static _Thread_local nt_moon_quarter quarters[QUARTERS_CAP];
+  static _Thread_local double days[DAYS_CAP];
+  nt_natural_date nd;
+  int with_date = r->call != NT_CALL_MAKE_NATURAL_DATE && r->call != NT_CALL_MAKE_NATURAL_DATE_FIXED;
+  if (with_date && nt_make_natural_date(r->unix_ms, r->longitude, &nd) != NT_OK) {
+    *ns = 0;
+    *bits = 0;
+    return (nt_err)r->status;  // the recorded call had no valid date either
+  }
+  nt_sun_events se;
+  nt_sun_position sp;
+  nt_moon_events me;
+  nt_moon_position mp;
+  nt_mustaches mu;
+  size_t n = 0;
+  nt_cache_stats before, after;
+  nt_err err = NT_ERR_INTERNAL;
+  nt_cache_counters(&before);
+  uint64_t t0 = now_ns();
+  switch (r->call) {
+    case NT_CALL_MAKE_NATURAL_DATE: err = nt_make_natural_date(r->unix_ms, r->longitude, &nd); break;
+    case NT_CALL_MAKE_NATURAL_DATE_FIXED: err = nt_make_natural_date_fixed(r->unix_ms, (int32_t)r->longitude, &nd); break;
+    case NT_CALL_SUN_EVENTS: err = nt_sun_events_for_date(&nd, r->latitude, &se); break;
+    case NT_CALL_SUN_POSITION: err = nt_sun_position_for_date(&nd, r->latitude, &sp); break;
+    case NT_CALL_MOON_EVENTS: err = nt_moon_events_for_date(&nd, r->latitude, &me); break;
+    case NT_CALL_MOON_POSITION: err = nt_moon_position_for_date(&nd, r->latitude, &mp); break;
+    case NT_CALL_MUSTACHES: err = nt_mustaches_range(&nd, r->latitude, &mu); break;
+    case NT_CALL_MOON_QUARTERS_FOR_YEAR: err = nt_moon_quarters_for_year(&nd, quarters, QUARTERS_CAP, &n); break;
+    case NT_CALL_MOON_ILLUMINATION_FOR_YEAR: err = nt_moon_illumination_for_year(&nd, days, DAYS_CAP, &n); break;
+    default: break;
+  }
+  uint64_t t = now_ns() - t0;
+  nt_cache_counters(&after);
+  *ns = (t > UINT32_MAX) ? UINT32_MAX : (uint32_t)t;
+  *bits = cache_bits(&before, &after);
+  return err;
+}
+
+static void* run_worker(void* arg) {
+  worker_t* w = (worker_t*)arg;
+  nt_cache_stats start, end;
+  nt_reset_caches();
+  nt_cache_counters(&start);
+  size_t k = 0;
+  for (int pass = 0; pass < w->repeat; ++pass) {
+    for (size_t i = 0; i < w->count; ++i, ++k) {
+      const nt_capture_record* r = &w->records[w->index[i]];
+      uint8_t bits = 0;
+      if ((int8_t)replay_call(r, &w->latency_ns[k], &bits) != r->status) w->mismatches++;
+      w->call[k] = r->call;
+      count_rates(&w->rates, bits);
+    }
+  }
+  nt_cache_counters(&end);
+  w->lookups.seasons_hits = end.seasons_hits - start.seasons_hits;
+  w->lookups.seasons_misses = end.seasons_misses - start.seasons_misses;
+  w->lookups.sun_events_hits = end.sun_events_hits - start.sun_events_hits;
+  w->lookups.sun_events_misses = end.sun_events_misses - start.sun_events_misses;
+  w->lookups.mustaches_hits = end.mustaches_hits - start.mustaches_hits;
+  w->lookups.mustaches_misses = end.mustaches_misses - start.mustaches_misses;
+  return NULL;
+}
+
+static int cmp_u32(const void* a, const void* b) {
+  uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+  return (x > y) - (x < y);
+}
+
+static double percentile_us(const uint32_t* sorted, size_t n, double p) {
+  if (n == 0) return 0.0;
+  size_t i = (size_t)ceil(p * (double)n);
+  return sorted[(i > 0 ? i : 1) - 1] / 1000.0;
+}
+
+static void print_latencies(const char* name, uint32_t* ns, size_t n) {
+  if (n == 0) return;
+  qsort(ns, n, sizeof(*ns), cmp_u32);
+  double sum = 0.0;
+  for (size_t i = 0; i < n; ++i) sum += ns[i];
+  printf("  %-30s %10zu %9.2f %9.2f %9.2f %9.2f %10.2f %10.2f\n", name, n, sum / n / 1000.0, percentile_us(ns, n, 0.50),
+         percentile_us(ns, n, 0.90), percentile_us(ns, n, 0.99), percentile_us(ns, n, 0.999), ns[n - 1] / 1000.0);
+}
+
+static double rate(uint64_t hits, uint64_t total) {
+  return total ? 100.0 * (double)hits / (double)total : 0.0;
+}
+
+static int anonymize(nt_capture_record* records, size_t count, double grid_deg, const char* out) {
+  uint8_t renumber[256];
+  int seen[256] = {0};
+  int next = 0;
+  for (size_t i = 0; i < count; ++i) {
+    nt_capture_record* r = &records[i];
+    double unit = (r->call == NT_CALL_MAKE_NATURAL_DATE_FIXED) ? 1e6 : 1.0;  // micro-degrees
+    r->longitude = fmax(-180.0 * unit, fmin(180.0 * unit, round(r->longitude / (grid_deg * unit)) * grid_deg * unit));
+    r->latitude = fmax(-90.0, fmin(90.0, round(r->latitude / grid_deg) * grid_deg));
+    if (!seen[r->thread]) {
+      seen[r->thread] = 1;
+      renumber[r->thread] = (uint8_t)next++;
+    }
+    r->thread = renumber[r->thread];
+  }
+  if (nt_capture_save(out, records, count) != NT_OK) {
+    fprintf(stderr, "ntreplay: cannot write %s\n", out);
+    return 1;
+  }
+  return 0;
+}
+
+static void usage(void) {
+  fprintf(stderr,
+          "usage: ntreplay [-j threads] [-r repeat] capture.ntcap\n"
+          "       ntreplay --anonymize grid_deg -o out.ntcap capture.ntcap\n");
+}
+
+int main(int argc, char** argv) {
+  int threads = 1, repeat = 1;
+  double grid_deg = 0.0;
+  const char* path = NULL;
+  const char* out = NULL;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--anonymize") == 0 && i + 1 < argc) grid_deg = atof(argv[++i]);
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) out = argv[++i];
+    else if (argv[i][0] != '-' && !path) path = argv[i];
+    else {
+      usage();
+      return 2;
+    }
+  }
+  if (!path || threads < 1 || threads > 256 || repeat < 1 || (out && !(grid_deg > 0.0)) || (grid_deg > 0.0 && !out)) {
+    usage();
+    return 2;
+  }
+
+  nt_capture_record* records = NULL;
+  size_t count = 0;
+  uint64_t dropped = 0;
+  nt_err err = nt_capture_load(path, &records, &count, &dropped);
+  if (err != NT_OK) {
+    fprintf(stderr, "ntreplay: cannot read %s (%s)\n", path, err == NT_ERR_RANGE ? "not a capture file" : "I/O error");
+    return 1;
+  }
+  if (out) {
+    int rc = anonymize(records, count, grid_deg, out);
+    nt_capture_free(records);
+    return rc;
+  }
+
+  // Recorded threads to workers.
+  int tags = 0, seen[256] = {0};
+  for (size_t i = 0; i < count; ++i) {
+    if (!seen[records[i].thread]) tags++;
+    seen[records[i].thread] = 1;
+  }
+  worker_t* workers = (worker_t*)calloc((size_t)threads, sizeof(worker_t));
+  size_t* index = (size_t*)malloc((count ? count : 1) * sizeof(size_t));
+  uint32_t* latency = (uint32_t*)malloc((count ? count : 1) * (size_t)repeat * sizeof(uint32_t));
+  uint8_t* call = (uint8_t*)malloc((count ? count : 1) * (size_t)repeat);
+  if (!workers || !index || !latency || !call) {
+    fprintf(stderr, "ntreplay: out of memory\n");
+    return 1;
+  }
+  size_t at = 0;
+  for (int w = 0; w < threads; ++w) {
+    worker_t* wk = &workers[w];
+    wk->records = records;
+    wk->repeat = repeat;
+    wk->index = index + at;
+    for (size_t i = 0; i < count; ++i) {
+      int mine = (tags >= threads) ? (records[i].thread % threads == w)
+                                   : (i * (size_t)threads / count == (size_t)w);
+      if (mine) index[at++] = i;
+    }
+    wk->count = (size_t)(index + at - wk->index);
+    wk->latency_ns = latency + (wk->index - index) * (size_t)repeat;
+    wk->call = call + (wk->index - index) * (size_t)repeat;
+  }
+
+  uint64_t t0 = now_ns();
+  if (threads == 1) {
+    run_worker(&workers[0]);
+  } else {
+    pthread_t* tids = (pthread_t*)malloc((size_t)threads * sizeof(pthread_t));
+    if (!tids) return 1;
+    for (int w = 0; w < threads; ++w) {
+      if (pthread_create(&tids[w], NULL, run_worker, &workers[w]) != 0) {
+        fprintf(stderr, "ntreplay: cannot start worker %d\n", w);
+        return 1;
+      }
+    }
+    for (int w = 0; w < threads; ++w) pthread_join(tids[w], NULL);
+    free(tids);
+  }
+  double wall_s = (double)(now_ns() - t0) * 1e-9;
+
+  // Report.
+  size_t total = count * (size_t)repeat;
+  uint64_t mismatches = 0;
+  call_rates recorded = {{0}, {0}}, replayed = {{0}, {0}};
+  nt_cache_stats lookups = {0};
+  for (size_t i = 0; i < count; ++i) count_rates(&recorded, records[i].caches);
+  for (int w = 0; w < threads; ++w) {
+    mismatches += workers[w].mismatches;
+    for (int c = 0; c < C_COUNT; ++c) {
+      replayed.hit_calls[c] += workers[w].rates.hit_calls[c];
+      replayed.lookup_calls[c] += workers[w].rates.lookup_calls[c];
+    }
+    lookups.seasons_hits += workers[w].lookups.seasons_hits;
+    lookups.seasons_misses += workers[w].lookups.seasons_misses;
+    lookups.sun_events_hits += workers[w].lookups.sun_events_hits;
+    lookups.sun_events_misses += workers[w].lookups.sun_events_misses;
+    lookups.mustaches_hits += workers[w].lookups.mustaches_hits;
+    lookups.mustaches_misses += workers[w].lookups.mustaches_misses;
+  }
+  printf("trace       %s: %zu calls from %d thread%s (%llu overwritten by the ring)\n", path, count, tags,
+         tags == 1 ? "" : "s", (unsigned long long)dropped);
+  printf("replay      %d worker%s x %d pass%s: %zu calls in %.3f s, %.0f calls/s, %llu status mismatches\n", threads,
+         threads == 1 ? "" : "s", repeat, repeat == 1 ? "" : "es", total, wall_s, wall_s > 0 ? total / wall_s : 0.0,
+         (unsigned long long)mismatches);
+
+  printf("\n%-32s %10s %9s %9s %9s %9s %10s %10s\n", "latency (us)", "calls", "mean", "p50", "p90", "p99", "p99.9",
+         "max");
+  uint32_t* scratch = (uint32_t*)malloc((total ? total : 1) * sizeof(uint32_t));
+  if (!scratch) return 1;
+  memcpy(scratch, latency, total * sizeof(uint32_t));
+  print_latencies("all", scratch, total);
+  for (int k = 1; k < NT_CALL_KINDS; ++k) {
+    size_t n = 0;
+    for (size_t i = 0; i < total; ++i) {
+      if (call[i] == k) scratch[n++] = latency[i];
+    }
+    print_latencies(CALL_NAMES[k], scratch, n);
+  }
+  free(scratch);
+
+  printf("\ncache hits  %-12s %14s %14s %18s\n", "", "recorded", "replayed", "replayed lookups");
+  const uint64_t hits[C_COUNT] = {lookups.seasons_hits, lookups.sun_events_hits, lookups.mustaches_hits};
+  const uint64_t misses[C_COUNT] = {lookups.seasons_misses, lookups.sun_events_misses, lookups.mustaches_misses};
+  for (int c = 0; c < C_COUNT; ++c) {
+    printf("  %-22s %13.1f%% %13.1f%% %8.1f%% of %llu\n", CACHE_NAMES[c],
+           rate(recorded.hit_calls[c], recorded.lookup_calls[c]), rate(replayed.hit_calls[c], replayed.lookup_calls[c]),
+           rate(hits[c], hits[c] + misses[c]), (unsigned long long)(hits[c] + misses[c]));
+  }
+  printf("  (recorded/replayed: calls with a hit among calls using the cache)\n");
+
+  free(call);
+  free(latency);
+  free(index);
+  free(workers);
+  nt_capture_free(records);
+  return 0;
+}